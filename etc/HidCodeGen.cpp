@@ -0,0 +1,493 @@
+/**
+ * @file HidCodeGen.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ *
+ * Generates straight-line pack and unpack functions per report from a HID descriptor source file.
+ * Usage: HidCodeGen [-n namespace] [-D name=value]... [-t test.cpp] input output.hpp
+ */
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../src/HidDescriptor.hpp"
+
+
+/** Parameter set from the command line. */
+typedef std::vector<std::pair<std::string, int64_t>> Params;
+
+
+/**
+ * Finds a parameter with the given name in the passed parameter set.
+ * The value of the last parameter with this name will be returned.
+ *
+ * @param[in] context - parameter set
+ * @param[in] token - parameter name token
+ * @return associated value
+ */
+static hid::detail::ParamMatch findParam(const void * context, const hid::detail::Token & token) noexcept {
+	hid::detail::ParamMatch res{0, false};
+	for (const auto & param : *static_cast<const Params *>(context)) {
+		if (param.first.size() == token.length && memcmp(param.first.data(), token.start, token.length) == 0) {
+			res = hid::detail::ParamMatch{param.second, true};
+		}
+	}
+	return res;
+}
+
+
+/** Collects the compiled HID descriptor bytes. */
+struct VectorWriter {
+	std::vector<uint8_t> data; /**< written bytes */
+
+	/**
+	 * Returns the current write position.
+	 *
+	 * @return write position
+	 */
+	inline size_t getPosition() const noexcept {
+		return this->data.size();
+	}
+
+	/**
+	 * Appends the given byte.
+	 *
+	 * @param[in] val - byte value to write
+	 * @return true on success, else false
+	 */
+	inline bool write(const uint8_t val) {
+		this->data.push_back(val);
+		return true;
+	}
+};
+
+
+/** Records the field annotations with their names. */
+struct AnnotationTracer : hid::NullTracer {
+	std::vector<std::pair<std::string, size_t>> names; /**< name and output position after the main item */
+
+	/**
+	 * @copydoc hid::detail::NullTracer::annotation()
+	 */
+	inline void annotation(const size_t /* pos */, const hid::detail::Token & name, const size_t outPos) {
+		this->names.emplace_back(std::string(name.start, name.length), outPos);
+	}
+};
+
+
+/** Single generated struct member. */
+struct Member {
+	std::string name; /**< member name */
+	hid::ReportField field; /**< associated report field */
+};
+
+
+/** Single report of the generated header. */
+struct Report {
+	std::string name; /**< report name (e.g. `input_1`) */
+	uint8_t type; /**< report type */
+	uint8_t reportId; /**< report ID or 0 if not used */
+	size_t size; /**< report size in bytes including the report ID */
+	std::vector<Member> members; /**< non-constant fields in report order */
+};
+
+
+/**
+ * Returns the C++ type of the given field values.
+ *
+ * @param[in] field - report field
+ * @return C++ type name
+ */
+static const char * valueType(const hid::ReportField & field) {
+	if (field.size <= 8) {
+		return field.isSigned() ? "int8_t" : "uint8_t";
+	} else if (field.size <= 16) {
+		return field.isSigned() ? "int16_t" : "uint16_t";
+	}
+	return field.isSigned() ? "int32_t" : "uint32_t";
+}
+
+
+/**
+ * Returns the given annotation name as valid C++ identifier.
+ *
+ * @param[in] name - annotation name
+ * @return identifier
+ */
+static std::string identifier(const std::string & name) {
+	std::string res;
+	for (const char c : name) {
+		res += (isalnum(static_cast<unsigned char>(c)) || c == '_') ? c : '_';
+	}
+	if (res.empty() || isdigit(static_cast<unsigned char>(res[0]))) {
+		res.insert(res.begin(), '_');
+	}
+	return res;
+}
+
+
+/**
+ * Returns the given value in hexadecimal notation.
+ *
+ * @param[in] val - value
+ * @return formatted value
+ */
+static std::string hex(const uint32_t val) {
+	char buf[16];
+	snprintf(buf, sizeof(buf), "0x%Xu", unsigned(val));
+	return std::string(buf);
+}
+
+
+/**
+ * Returns the expression which reads the given element from the report buffer `d`.
+ * The result is an unsigned value of `size` bits.
+ *
+ * @param[in] offset - bit offset including the report ID byte
+ * @param[in] size - size in bits
+ * @return C++ expression
+ */
+static std::string readExpr(const uint32_t offset, const uint32_t size) {
+	const uint32_t first = offset / 8;
+	const uint32_t span = ((offset + size - 1) / 8) - first + 1;
+	const uint32_t shift = offset % 8;
+	const char * word = (span > 4) ? "uint64_t" : "uint32_t";
+	std::string res;
+	for (uint32_t i = 0; i < span; i++) {
+		std::string byte = std::string(word) + "(d[" + std::to_string(first + i) + "])";
+		if (i > 0) {
+			byte = "(" + byte + " << " + std::to_string(8 * i) + ")";
+		}
+		res += (i > 0) ? (" | " + byte) : byte;
+	}
+	if (span > 1) {
+		res = "(" + res + ")";
+	}
+	if (shift > 0) {
+		res = "(" + res + " >> " + std::to_string(shift) + ")";
+	}
+	if (span > 4) {
+		res = "uint32_t" + res;
+	}
+	if (size < 32 && (shift + size) < (8 * span)) {
+		res = "(" + res + " & " + hex(uint32_t((uint64_t(1) << size) - 1)) + ")";
+	}
+	return res;
+}
+
+
+/**
+ * Collects all reports of the given compiled HID descriptor.
+ *
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] names - field annotations
+ * @return reports ordered by type and report ID
+ */
+static std::vector<Report> collectReports(const std::vector<uint8_t> & desc, const std::vector<std::pair<std::string, size_t>> & names) {
+	static const uint8_t types[] = {hid::RT_INPUT, hid::RT_OUTPUT, hid::RT_FEATURE};
+	static const char * typeName[] = {"input", "output", "feature"};
+	std::vector<Report> res;
+	for (size_t t = 0; t < 3; t++) {
+		const uint8_t type = types[t];
+		for (size_t id = 0; id < 256; id++) {
+			const size_t size = hid::reportSize(desc.data(), desc.size(), type, uint8_t(id));
+			if (size == 0) {
+				continue;
+			}
+			Report report{std::string(typeName[t]) + ((id != 0) ? ("_" + std::to_string(id)) : ""), type, uint8_t(id), size, {}};
+			hid::FieldReader fields(desc.data(), desc.size());
+			hid::ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+			while ( fields.next(field) ) {
+				if (field.type != type || field.reportId != id || field.isConstant() || field.size == 0 || field.size > 32) {
+					continue;
+				}
+				std::string name = "field" + std::to_string(report.members.size());
+				for (const auto & annotation : names) {
+					const hid::UsageMatch match = hid::detail::findField(desc.data(), desc.size(), uint32_t(annotation.second));
+					if (match.valid && match.field.item == field.item) {
+						name = identifier(annotation.first);
+					}
+				}
+				for (const Member & member : report.members) {
+					if (member.name == name) {
+						name += "_" + std::to_string(report.members.size());
+						break;
+					}
+				}
+				report.members.push_back(Member{name, field});
+			}
+			res.push_back(report);
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Writes the header with the report structs and their pack/unpack functions.
+ *
+ * @param[in,out] fd - output file
+ * @param[in] ns - namespace of the generated code
+ * @param[in] reports - reports to generate
+ */
+static void writeHeader(FILE * fd, const std::string & ns, const std::vector<Report> & reports) {
+	fprintf(fd, "/* generated by HidCodeGen; do not edit */\n");
+	fprintf(fd, "#ifndef __%s_HPP__\n#define __%s_HPP__\n\n#include <stddef.h>\n#include <stdint.h>\n\n\nnamespace %s {\n", ns.c_str(), ns.c_str(), ns.c_str());
+	for (const Report & report : reports) {
+		const char * name = report.name.c_str();
+		const uint32_t base = (report.reportId != 0) ? 8 : 0;
+		/* struct */
+		fprintf(fd, "\n\n/** Report `%s`. */\nstruct %s {\n", name, name);
+		for (const Member & member : report.members) {
+			if (member.field.count > 1) {
+				fprintf(fd, "\t%s %s[%u];\n", valueType(member.field), member.name.c_str(), unsigned(member.field.count));
+			} else {
+				fprintf(fd, "\t%s %s;\n", valueType(member.field), member.name.c_str());
+			}
+		}
+		fprintf(fd, "};\n\n\n/** Report `%s` size in bytes including the report ID byte if used. */\nconstexpr size_t %s_size = %u;\n", name, name, unsigned(report.size));
+		/* unpack */
+		fprintf(fd, "\n\n/**\n * Unpacks the report `%s`.\n * \n * @param[in] d - report data with `%s_size` bytes\n * @return unpacked report\n */\n", name, name);
+		fprintf(fd, "constexpr inline %s unpack_%s(const uint8_t * d) noexcept {\n\t%s r{};\n", name, name, name);
+		for (const Member & member : report.members) {
+			const hid::ReportField & f = member.field;
+			for (uint32_t i = 0; i < f.count; i++) {
+				const std::string target = "r." + member.name + ((f.count > 1) ? ("[" + std::to_string(i) + "]") : "");
+				const std::string value = readExpr(base + f.bitOffset + (i * f.size), f.size);
+				if ( ! f.isSigned() ) {
+					fprintf(fd, "\t%s = %s(%s);\n", target.c_str(), valueType(f), value.c_str());
+				} else if (f.size == 32) {
+					fprintf(fd, "\t%s = int32_t(%s);\n", target.c_str(), value.c_str());
+				} else {
+					/* sign extension without implementation defined shifts */
+					const std::string sign = hex(uint32_t(1) << (f.size - 1));
+					fprintf(fd, "\t%s = %s(int32_t(%s ^ %s) - int32_t(%s));\n", target.c_str(), valueType(f), value.c_str(), sign.c_str(), sign.c_str());
+				}
+			}
+		}
+		fprintf(fd, "\treturn r;\n}\n");
+		/* pack */
+		std::vector<std::string> bytes(report.size);
+		if (report.reportId != 0) {
+			bytes[0] = std::to_string(report.reportId) + "u";
+		}
+		for (const Member & member : report.members) {
+			const hid::ReportField & f = member.field;
+			for (uint32_t i = 0; i < f.count; i++) {
+				const uint32_t offset = base + f.bitOffset + (i * f.size);
+				const uint32_t shift = offset % 8;
+				std::string value = "uint32_t(r." + member.name + ((f.count > 1) ? ("[" + std::to_string(i) + "]") : "") + ")";
+				if (f.size < 32) {
+					value = "(" + value + " & " + hex(uint32_t((uint64_t(1) << f.size) - 1)) + ")";
+				}
+				for (uint32_t k = offset / 8; k <= (offset + f.size - 1) / 8; k++) {
+					const uint32_t bit = (8 * k) - (offset - shift);
+					std::string term = value;
+					if (bit < shift) {
+						term = "(" + value + " << " + std::to_string(shift - bit) + ")";
+					} else if (bit > shift) {
+						term = "(" + value + " >> " + std::to_string(bit - shift) + ")";
+					}
+					bytes[k] += bytes[k].empty() ? term : (" | " + term);
+				}
+			}
+		}
+		fprintf(fd, "\n\n/**\n * Packs the report `%s`. Constant fields are set to zero.\n * \n * @param[in] r - report values\n * @param[out] d - receives `%s_size` bytes\n */\n", name, name);
+		fprintf(fd, "constexpr inline void pack_%s(const %s & r, uint8_t * d) noexcept {\n", name, name);
+		for (size_t k = 0; k < bytes.size(); k++) {
+			fprintf(fd, "\td[%u] = uint8_t(%s);\n", unsigned(k), bytes[k].empty() ? "0" : bytes[k].c_str());
+		}
+		if ( report.members.empty() ) {
+			fprintf(fd, "\t(void)r;\n");
+		}
+		fprintf(fd, "}\n");
+	}
+	fprintf(fd, "\n\n} /* namespace %s */\n\n\n#endif /* __%s_HPP__ */\n", ns.c_str(), ns.c_str());
+}
+
+
+/**
+ * Writes the round-trip self-test of the generated header. The expected values are taken from
+ * the run-time layout of `HidDescriptor.hpp` to keep both in lockstep.
+ *
+ * @param[in,out] fd - output file
+ * @param[in] header - path of the generated header as included by the test
+ * @param[in] ns - namespace of the generated code
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] reports - generated reports
+ */
+static void writeTest(FILE * fd, const std::string & header, const std::string & ns, const std::vector<uint8_t> & desc, const std::vector<Report> & reports) {
+	fprintf(fd, "/* generated by HidCodeGen; do not edit */\n#include <cstdio>\n#include <cstdlib>\n#include <cstring>\n#include <HidDescriptor.hpp>\n#include \"%s\"\n\n\n", header.c_str());
+	fprintf(fd, "static const uint8_t desc[] = {");
+	for (size_t i = 0; i < desc.size(); i++) {
+		fprintf(fd, "%s0x%02X", ((i % 16) == 0) ? "\n\t" : " ", unsigned(desc[i]));
+		if ((i + 1) < desc.size()) {
+			fprintf(fd, ",");
+		}
+	}
+	fprintf(fd, "\n};\n\n\n");
+	fprintf(fd,
+		"/** Returns the expected values and data bit mask of the given report from the run-time layout. */\n"
+		"static size_t expect(const uint8_t type, const uint8_t reportId, const uint8_t * data, int64_t * values, uint8_t * mask) {\n"
+		"\thid::FieldReader fields(desc, sizeof(desc));\n"
+		"\thid::ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};\n"
+		"\tconst size_t skip = (reportId != 0) ? 1 : 0;\n"
+		"\tsize_t n = 0;\n"
+		"\tmask[0] = uint8_t((reportId != 0) ? 0xFF : mask[0]);\n"
+		"\twhile ( fields.next(field) ) {\n"
+		"\t\tif (field.type != type || field.reportId != reportId || field.isConstant() || field.size == 0 || field.size > 32) {\n"
+		"\t\t\tcontinue;\n"
+		"\t\t}\n"
+		"\t\tfor (uint32_t i = 0; i < field.count; i++) {\n"
+		"\t\t\tconst uint32_t offset = field.bitOffset + (i * field.size);\n"
+		"\t\t\tvalues[n++] = field.isSigned() ? int64_t(hid::readSignedBits(data + skip, offset, field.size)) : int64_t(hid::readBits(data + skip, offset, field.size));\n"
+		"\t\t\thid::writeBits(mask + skip, offset, field.size, 0xFFFFFFFF);\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\treturn n;\n"
+		"}\n"
+	);
+	for (const Report & report : reports) {
+		const char * name = report.name.c_str();
+		size_t count = 0;
+		for (const Member & member : report.members) {
+			count += member.field.count;
+		}
+		fprintf(fd, "\n\n/** Round-trip test of report `%s`. */\nstatic bool test_%s(uint32_t & seed) {\n", name, name);
+		fprintf(fd, "\tusing namespace %s;\n\tuint8_t data[%s_size], packed[%s_size], mask[%s_size];\n\tint64_t values[%u];\n", ns.c_str(), name, name, name, unsigned(count + 1));
+		fprintf(fd, "\tfor (size_t round = 0; round < 1000; round++) {\n");
+		fprintf(fd, "\t\tfor (uint8_t & value : data) {\n\t\t\tseed = (seed * 1103515245) + 12345;\n\t\t\tvalue = uint8_t(seed >> 16);\n\t\t}\n");
+		if (report.reportId != 0) {
+			fprintf(fd, "\t\tdata[0] = %u;\n", unsigned(report.reportId));
+		}
+		fprintf(fd, "\t\tmemset(mask, 0, sizeof(mask));\n");
+		fprintf(fd, "\t\tif (expect(%u, %u, data, values, mask) != %u) {\n\t\t\treturn false;\n\t\t}\n", unsigned(report.type), unsigned(report.reportId), unsigned(count));
+		fprintf(fd, "\t\tconst %s r = unpack_%s(data);\n", name, name);
+		size_t n = 0;
+		for (const Member & member : report.members) {
+			for (uint32_t i = 0; i < member.field.count; i++, n++) {
+				const std::string target = "r." + member.name + ((member.field.count > 1) ? ("[" + std::to_string(i) + "]") : "");
+				fprintf(fd, "\t\tif (int64_t(%s) != values[%u]) {\n\t\t\tprintf(\"Error: %s.%s differs.\\n\");\n\t\t\treturn false;\n\t\t}\n", target.c_str(), unsigned(n), name, target.c_str() + 2);
+			}
+		}
+		fprintf(fd, "\t\tpack_%s(r, packed);\n", name);
+		fprintf(fd, "\t\tfor (size_t i = 0; i < sizeof(data); i++) {\n\t\t\tif (packed[i] != (data[i] & mask[i])) {\n\t\t\t\tprintf(\"Error: %s byte %%u differs after packing.\\n\", unsigned(i));\n\t\t\t\treturn false;\n\t\t\t}\n\t\t}\n", name);
+		fprintf(fd, "\t}\n\treturn true;\n}\n");
+	}
+	fprintf(fd, "\n\nint main() {\n\tuint32_t seed = 1;\n\tbool ok = true;\n");
+	for (const Report & report : reports) {
+		fprintf(fd, "\tok = test_%s(seed) && ok;\n", report.name.c_str());
+	}
+	fprintf(fd, "\tprintf(\"%%s: %u reports\\n\", ok ? \"OK\" : \"FAILED\");\n\treturn ok ? EXIT_SUCCESS : EXIT_FAILURE;\n}\n", unsigned(reports.size()));
+}
+
+
+/**
+ * Reads the whole file.
+ *
+ * @param[in] path - file path
+ * @param[out] out - receives the file content
+ * @return true on success, else false
+ */
+static bool readFile(const char * path, std::string & out) {
+	FILE * fd = fopen(path, "rb");
+	if (fd == NULL) {
+		return false;
+	}
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fd)) > 0) {
+		out.append(buf, n);
+	}
+	const bool res = ferror(fd) == 0;
+	fclose(fd);
+	return res;
+}
+
+
+/** Prints the command-line usage. */
+static void printHelp() {
+	fprintf(stderr,
+		"HidCodeGen [-n namespace] [-D name=value]... [-t test.cpp] input output.hpp\n"
+		"\n"
+		"-n namespace\n"
+		"   Namespace and include guard of the generated code. Defaults to hid_report.\n"
+		"-D name=value\n"
+		"   Defines the parameter name with the given integer value.\n"
+		"-t test.cpp\n"
+		"   Also generates a round-trip self-test for the output header.\n"
+		"   It includes HidDescriptor.hpp which needs to be within the include path.\n"
+	);
+}
+
+
+int main(int argc, char ** argv) {
+	std::string ns = "hid_report";
+	const char * testPath = NULL;
+	Params params;
+	std::string code;
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-' && argv[i][1] != 0; i++) {
+		const char opt = argv[i][1];
+		if (argv[i][2] != 0 || (i + 1) >= argc || (opt != 'n' && opt != 'D' && opt != 't')) {
+			printHelp();
+			return EXIT_FAILURE;
+		}
+		const char * arg = argv[++i];
+		if (opt == 'n') {
+			ns = identifier(arg);
+		} else if (opt == 't') {
+			testPath = arg;
+		} else {
+			const char * sep = strchr(arg, '=');
+			if (sep == NULL) {
+				fprintf(stderr, "Error: Invalid parameter definition \"%s\".\n", arg);
+				return EXIT_FAILURE;
+			}
+			params.emplace_back(std::string(arg, size_t(sep - arg)), int64_t(strtoll(sep + 1, NULL, 0)));
+		}
+	}
+	if ((argc - i) != 2) {
+		printHelp();
+		return EXIT_FAILURE;
+	}
+	const char * inPath = argv[i];
+	const char * outPath = argv[i + 1];
+	if ( ! readFile(inPath, code) ) {
+		fprintf(stderr, "Error: Failed to read \"%s\".\n", inPath);
+		return EXIT_FAILURE;
+	}
+	/* compile at run-time and walk the result with the same field reader as the compile-time path */
+	VectorWriter out;
+	AnnotationTracer tracer;
+	hid::error::Info error;
+	const hid::SourceView source(code.data(), code.size(), &params, findParam);
+	if ( ! hid::compile(source, out, error, tracer) ) {
+		fprintf(stderr, "%s:%u:%u: error: %s\n", inPath, unsigned(error.line), unsigned(error.column), hid::error::EMessageStr[error.message]);
+		return EXIT_FAILURE;
+	}
+	const std::vector<Report> reports = collectReports(out.data, tracer.names);
+	FILE * fd = fopen(outPath, "wb");
+	if (fd == NULL) {
+		fprintf(stderr, "Error: Failed to create \"%s\".\n", outPath);
+		return EXIT_FAILURE;
+	}
+	writeHeader(fd, ns, reports);
+	fclose(fd);
+	if (testPath != NULL) {
+		fd = fopen(testPath, "wb");
+		if (fd == NULL) {
+			fprintf(stderr, "Error: Failed to create \"%s\".\n", testPath);
+			return EXIT_FAILURE;
+		}
+		const char * base = strrchr(outPath, '/');
+		writeTest(fd, (base != NULL) ? (base + 1) : outPath, ns, out.data, reports);
+		fclose(fd);
+	}
+	return EXIT_SUCCESS;
+}
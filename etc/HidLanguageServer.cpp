@@ -0,0 +1,1250 @@
+/**
+ * @file HidLanguageServer.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ *
+ * Language server for HID descriptor source files via stdio (Language Server Protocol 3.17).
+ * Provides diagnostics, completions and hover information.
+ * Usage: HidLanguageServer [-D name=value]...
+ */
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+#include "../src/HidDescriptor.hpp"
+
+
+/** Minimal JSON value. */
+struct Json {
+	enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+	Type type; /**< value type */
+	bool boolean; /**< boolean value */
+	double number; /**< numeric value */
+	std::string string; /**< string value */
+	std::vector<Json> items; /**< array items */
+	std::vector<std::pair<std::string, Json>> members; /**< object members */
+
+	/** Constructor. */
+	Json():
+		type{NUL},
+		boolean{false},
+		number{0}
+	{}
+
+	/**
+	 * Returns the member with the given name.
+	 *
+	 * @param[in] name - member name
+	 * @return member or null value if not found
+	 */
+	const Json & operator[] (const char * name) const {
+		static const Json null;
+		for (const auto & member : this->members) {
+			if (member.first == name) {
+				return member.second;
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Returns the numeric value as integer.
+	 *
+	 * @return integer value
+	 */
+	inline size_t toSize() const noexcept {
+		return (this->type == NUMBER && this->number > 0) ? size_t(this->number) : 0;
+	}
+};
+
+
+/** Recursive descent JSON parser. */
+class JsonParser {
+private:
+	const char * ptr; /**< current position */
+	const char * end; /**< end of input */
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param[in] s - JSON text
+	 * @param[in] len - JSON text length
+	 */
+	JsonParser(const char * s, const size_t len):
+		ptr{s},
+		end{s + len}
+	{}
+
+	/**
+	 * Parses the next value.
+	 *
+	 * @param[out] res - parsed value
+	 * @return true on success, else false
+	 */
+	bool parse(Json & res) {
+		this->skip();
+		if (this->ptr >= this->end) {
+			return false;
+		}
+		const char c = *this->ptr;
+		if (c == '{') {
+			res.type = Json::OBJECT;
+			this->ptr++;
+			this->skip();
+			if (this->ptr < this->end && *this->ptr == '}') {
+				this->ptr++;
+				return true;
+			}
+			for (;;) {
+				std::string name;
+				this->skip();
+				if ( ! this->parseString(name) ) {
+					return false;
+				}
+				this->skip();
+				if (this->ptr >= this->end || *this->ptr != ':') {
+					return false;
+				}
+				this->ptr++;
+				res.members.emplace_back(std::move(name), Json());
+				if ( ! this->parse(res.members.back().second) ) {
+					return false;
+				}
+				this->skip();
+				if (this->ptr < this->end && *this->ptr == ',') {
+					this->ptr++;
+				} else if (this->ptr < this->end && *this->ptr == '}') {
+					this->ptr++;
+					return true;
+				} else {
+					return false;
+				}
+			}
+		} else if (c == '[') {
+			res.type = Json::ARRAY;
+			this->ptr++;
+			this->skip();
+			if (this->ptr < this->end && *this->ptr == ']') {
+				this->ptr++;
+				return true;
+			}
+			for (;;) {
+				res.items.emplace_back();
+				if ( ! this->parse(res.items.back()) ) {
+					return false;
+				}
+				this->skip();
+				if (this->ptr < this->end && *this->ptr == ',') {
+					this->ptr++;
+				} else if (this->ptr < this->end && *this->ptr == ']') {
+					this->ptr++;
+					return true;
+				} else {
+					return false;
+				}
+			}
+		} else if (c == '"') {
+			res.type = Json::STRING;
+			return this->parseString(res.string);
+		} else if (this->literal("true")) {
+			res.type = Json::BOOL;
+			res.boolean = true;
+			return true;
+		} else if (this->literal("false")) {
+			res.type = Json::BOOL;
+			return true;
+		} else if (this->literal("null")) {
+			return true;
+		}
+		char * numEnd = NULL;
+		res.type = Json::NUMBER;
+		res.number = strtod(std::string(this->ptr, size_t(this->end - this->ptr) > 32 ? 32 : size_t(this->end - this->ptr)).c_str(), &numEnd);
+		const char * start = this->ptr;
+		while (this->ptr < this->end && (isdigit(static_cast<unsigned char>(*this->ptr)) || strchr("+-.eE", *this->ptr) != NULL)) {
+			this->ptr++;
+		}
+		return this->ptr > start;
+	}
+private:
+	/** Skips whitespaces. */
+	void skip() {
+		while (this->ptr < this->end && isspace(static_cast<unsigned char>(*this->ptr))) {
+			this->ptr++;
+		}
+	}
+
+	/**
+	 * Consumes the given literal.
+	 *
+	 * @param[in] str - literal
+	 * @return true if matched, else false
+	 */
+	bool literal(const char * str) {
+		const size_t len = strlen(str);
+		if (size_t(this->end - this->ptr) < len || memcmp(this->ptr, str, len) != 0) {
+			return false;
+		}
+		this->ptr += len;
+		return true;
+	}
+
+	/**
+	 * Appends the given code point as UTF-8.
+	 *
+	 * @param[in,out] out - output string
+	 * @param[in] cp - code point
+	 */
+	static void putUtf8(std::string & out, const uint32_t cp) {
+		if (cp < 0x80) {
+			out += char(cp);
+		} else if (cp < 0x800) {
+			out += char(0xC0 | (cp >> 6));
+			out += char(0x80 | (cp & 0x3F));
+		} else if (cp < 0x10000) {
+			out += char(0xE0 | (cp >> 12));
+			out += char(0x80 | ((cp >> 6) & 0x3F));
+			out += char(0x80 | (cp & 0x3F));
+		} else {
+			out += char(0xF0 | (cp >> 18));
+			out += char(0x80 | ((cp >> 12) & 0x3F));
+			out += char(0x80 | ((cp >> 6) & 0x3F));
+			out += char(0x80 | (cp & 0x3F));
+		}
+	}
+
+	/**
+	 * Parses a 4 digit hex value.
+	 *
+	 * @param[out] val - parsed value
+	 * @return true on success, else false
+	 */
+	bool parseHex4(uint32_t & val) {
+		if ((this->end - this->ptr) < 4) {
+			return false;
+		}
+		val = 0;
+		for (size_t i = 0; i < 4; i++, this->ptr++) {
+			const char c = *this->ptr;
+			if ( ! isxdigit(static_cast<unsigned char>(c)) ) {
+				return false;
+			}
+			val = (val << 4) | uint32_t((c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10));
+		}
+		return true;
+	}
+
+	/**
+	 * Parses a JSON string.
+	 *
+	 * @param[out] out - parsed string in UTF-8
+	 * @return true on success, else false
+	 */
+	bool parseString(std::string & out) {
+		if (this->ptr >= this->end || *this->ptr != '"') {
+			return false;
+		}
+		this->ptr++;
+		while (this->ptr < this->end && *this->ptr != '"') {
+			if (*this->ptr != '\\') {
+				out += *this->ptr++;
+				continue;
+			}
+			if (++this->ptr >= this->end) {
+				return false;
+			}
+			const char c = *this->ptr++;
+			switch (c) {
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+			case 'u': {
+					uint32_t cp = 0;
+					if ( ! this->parseHex4(cp) ) {
+						return false;
+					}
+					if (cp >= 0xD800 && cp <= 0xDBFF && (this->end - this->ptr) >= 6 && this->ptr[0] == '\\' && this->ptr[1] == 'u') {
+						/* UTF-16 surrogate pair */
+						this->ptr += 2;
+						uint32_t low = 0;
+						if ( ! this->parseHex4(low) ) {
+							return false;
+						}
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+					}
+					putUtf8(out, cp);
+				}
+				break;
+			default: out += c; break;
+			}
+		}
+		if (this->ptr >= this->end) {
+			return false;
+		}
+		this->ptr++;
+		return true;
+	}
+};
+
+
+/**
+ * Returns the given string as quoted JSON string.
+ *
+ * @param[in] str - UTF-8 string
+ * @return JSON string
+ */
+static std::string quote(const std::string & str) {
+	std::string res = "\"";
+	for (const char c : str) {
+		switch (c) {
+		case '"': res += "\\\""; break;
+		case '\\': res += "\\\\"; break;
+		case '\n': res += "\\n"; break;
+		case '\r': res += "\\r"; break;
+		case '\t': res += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04X", unsigned(c));
+				res += buf;
+			} else {
+				res += c;
+			}
+			break;
+		}
+	}
+	return res + "\"";
+}
+
+
+/** Single completion candidate. */
+struct Candidate {
+	std::string label; /**< inserted text */
+	std::string detail; /**< shown detail */
+};
+
+
+/**
+ * Prefix trie over the names of all encoding maps. Names are matched case-insensitive.
+ * Each encoding map has its own root node.
+ */
+class EncodingTrie {
+private:
+	/** Single trie node. */
+	struct Node {
+		std::vector<std::pair<char, uint32_t>> children; /**< lower case character and child node */
+		std::vector<uint32_t> candidates; /**< candidates ending at this node */
+	};
+
+	std::vector<Node> nodes; /**< all nodes */
+	std::vector<Candidate> candidates; /**< all candidates */
+	uint32_t roots[hid::detail::EncodingMapCount + 1]; /**< root node by map ID */
+public:
+	/** Constructor. Builds the trie from `hid::detail::encodingTable`. */
+	EncodingTrie() {
+		using hid::detail::encodingTable;
+		for (uint8_t map = 0; map <= hid::detail::EncodingMapCount; map++) {
+			this->roots[map] = uint32_t(this->nodes.size());
+			this->nodes.emplace_back();
+			if (map == 0) {
+				continue;
+			}
+			const size_t last = encodingTable.end(map);
+			for (size_t e = encodingTable.begin(map); e < last; e++) {
+				const hid::detail::Token name = encodingTable.name(e);
+				std::string label(name.start, name.length);
+				char detail[64];
+				const size_t idx = label.find('#');
+				if (idx != std::string::npos && (e + 1) < last) {
+					/* argument with index (range start and end) */
+					label.erase(idx);
+					snprintf(detail, sizeof(detail), "%s%u to %s%u", label.c_str(), unsigned(encodingTable.value[e]), label.c_str(), unsigned(encodingTable.value[e + 1]));
+					label += std::to_string(encodingTable.value[e]);
+					e++;
+				} else if (map == hid::detail::EM_INPUT_ARG || map == hid::detail::EM_OUTPUT_FEATURE_ARG) {
+					detail[0] = 0; /* flags are encoded as bit and set/clear type */
+				} else {
+					snprintf(detail, sizeof(detail), "0x%02X", unsigned(encodingTable.value[e]));
+				}
+				this->insert(this->roots[map], label, Candidate{label, detail});
+			}
+		}
+	}
+
+	/**
+	 * Returns the candidates of the given map which start with the passed prefix.
+	 *
+	 * @param[in] map - encoding map ID
+	 * @param[in] prefix - name prefix
+	 * @param[in] limit - maximum number of results
+	 * @return matching candidates in lexicographical order
+	 */
+	std::vector<const Candidate *> find(const uint8_t map, const std::string & prefix, const size_t limit) const {
+		std::vector<const Candidate *> res;
+		if (map > hid::detail::EncodingMapCount) {
+			return res;
+		}
+		uint32_t node = this->roots[map];
+		for (const char c : prefix) {
+			node = this->child(node, char(tolower(static_cast<unsigned char>(c))));
+			if (node == 0) {
+				return res;
+			}
+		}
+		this->collect(node, res, limit);
+		return res;
+	}
+private:
+	/**
+	 * Returns the child node for the given character.
+	 *
+	 * @param[in] node - parent node
+	 * @param[in] c - lower case character
+	 * @return child node or 0 if not found
+	 */
+	uint32_t child(const uint32_t node, const char c) const {
+		for (const auto & entry : this->nodes[node].children) {
+			if (entry.first == c) {
+				return entry.second;
+			}
+		}
+		return 0;
+	}
+
+	/**
+	 * Inserts the given candidate.
+	 *
+	 * @param[in] node - root node of the map
+	 * @param[in] name - candidate name
+	 * @param[in] candidate - candidate to insert
+	 */
+	void insert(uint32_t node, const std::string & name, const Candidate & candidate) {
+		for (const char ch : name) {
+			const char c = char(tolower(static_cast<unsigned char>(ch)));
+			uint32_t next = this->child(node, c);
+			if (next == 0) {
+				next = uint32_t(this->nodes.size());
+				this->nodes.emplace_back();
+				auto & children = this->nodes[node].children;
+				auto it = children.begin();
+				while (it != children.end() && it->first < c) {
+					++it;
+				}
+				children.insert(it, std::make_pair(c, next));
+			}
+			node = next;
+		}
+		this->nodes[node].candidates.push_back(uint32_t(this->candidates.size()));
+		this->candidates.push_back(candidate);
+	}
+
+	/**
+	 * Collects all candidates below the given node.
+	 *
+	 * @param[in] node - start node
+	 * @param[in,out] res - result list
+	 * @param[in] limit - maximum number of results
+	 */
+	void collect(const uint32_t node, std::vector<const Candidate *> & res, const size_t limit) const {
+		for (const uint32_t candidate : this->nodes[node].candidates) {
+			if (res.size() >= limit) {
+				return;
+			}
+			res.push_back(&this->candidates[candidate]);
+		}
+		for (const auto & entry : this->nodes[node].children) {
+			this->collect(entry.second, res, limit);
+		}
+	}
+};
+
+
+/** Parameter set from the command line. */
+typedef std::vector<std::pair<std::string, int64_t>> Params;
+
+
+/**
+ * Finds a parameter with the given name in the passed parameter set.
+ * The value of the last parameter with this name will be returned.
+ *
+ * @param[in] context - parameter set
+ * @param[in] token - parameter name token
+ * @return associated value
+ */
+static hid::detail::ParamMatch findParam(const void * context, const hid::detail::Token & token) noexcept {
+	hid::detail::ParamMatch res{0, false};
+	for (const auto & param : *static_cast<const Params *>(context)) {
+		if (param.first.size() == token.length && memcmp(param.first.data(), token.start, token.length) == 0) {
+			res = hid::detail::ParamMatch{param.second, true};
+		}
+	}
+	return res;
+}
+
+
+/** Source range of an item with its encoded bytes. */
+struct Span {
+	size_t start; /**< first source byte */
+	size_t end; /**< last source byte */
+	size_t out; /**< output position of the first encoded byte */
+};
+
+
+/** Compiler state at the start of a source line. */
+struct Checkpoint {
+	hid::detail::CompileState state; /**< compiler state */
+	size_t out; /**< output size */
+	size_t spans; /**< number of item spans */
+};
+
+
+/** Open text document with its compiled state. */
+struct Document {
+	std::string text; /**< source code */
+	std::vector<size_t> lines; /**< byte position of each line start */
+	std::vector<Checkpoint> checkpoints; /**< compiler state at each line start up to the first error */
+	std::vector<uint8_t> out; /**< compiled HID descriptor */
+	std::vector<Span> spans; /**< source ranges of the encoded items */
+	hid::error::Info error; /**< compile error */
+
+	/** Updates the line start positions. */
+	void updateLines() {
+		this->lines.assign(1, 0);
+		for (size_t i = 0; i < this->text.size(); i++) {
+			if (this->text[i] == '\n') {
+				this->lines.push_back(i + 1);
+			}
+		}
+	}
+
+	/**
+	 * Returns the end position of the given line including the line break.
+	 *
+	 * @param[in] line - line index
+	 * @return end position
+	 */
+	size_t lineEnd(const size_t line) const {
+		return ((line + 1) < this->lines.size()) ? this->lines[line + 1] : this->text.size();
+	}
+
+	/**
+	 * Converts the given LSP position into a byte position.
+	 *
+	 * @param[in] pos - LSP position (UTF-16 based)
+	 * @return byte position
+	 */
+	size_t offset(const Json & pos) const {
+		const size_t line = pos["line"].toSize();
+		if (line >= this->lines.size()) {
+			return this->text.size();
+		}
+		size_t units = pos["character"].toSize();
+		size_t n = this->lines[line];
+		const size_t end = this->lineEnd(line);
+		while (units > 0 && n < end && this->text[n] != '\n' && this->text[n] != '\r') {
+			const uint8_t lead = uint8_t(this->text[n]);
+			const size_t len = (lead < 0x80) ? 1 : ((lead & 0xE0) == 0xC0) ? 2 : ((lead & 0xF0) == 0xE0) ? 3 : 4;
+			const size_t width = (len == 4) ? 2 : 1;
+			if (units < width) {
+				break;
+			}
+			units -= width;
+			n += len;
+		}
+		return (n > end) ? end : n;
+	}
+
+	/**
+	 * Returns the LSP position of the given line and number of code points.
+	 *
+	 * @param[in] line - line index
+	 * @param[in] column - number of code points from the line start
+	 * @return LSP position as JSON
+	 */
+	std::string position(const size_t line, size_t column) const {
+		size_t units = 0;
+		if (line < this->lines.size()) {
+			const size_t end = this->lineEnd(line);
+			for (size_t n = this->lines[line]; column > 0 && n < end && this->text[n] != '\n'; column--) {
+				const uint8_t lead = uint8_t(this->text[n]);
+				const size_t len = (lead < 0x80) ? 1 : ((lead & 0xE0) == 0xC0) ? 2 : ((lead & 0xF0) == 0xE0) ? 3 : 4;
+				units += (len == 4) ? 2 : 1;
+				n += len;
+			}
+		}
+		return "{\"line\":" + std::to_string(line) + ",\"character\":" + std::to_string(units) + "}";
+	}
+};
+
+
+/** Records the source range and output position of each encoded item. */
+struct SpanTracer : hid::NullTracer {
+	Document & doc; /**< document to update */
+	size_t start; /**< start of the current item */
+
+	/**
+	 * Constructor.
+	 *
+	 * @param[in,out] d - document to update
+	 */
+	explicit SpanTracer(Document & d):
+		doc(d),
+		start{0}
+	{}
+
+	/**
+	 * @copydoc hid::detail::NullTracer::step()
+	 */
+	inline void step(const size_t pos, const size_t /* outPos */, const char c, const uint32_t state) {
+		if (state == hid::detail::TS_START && ( ! hid::detail::isWhitespace(c) )) {
+			this->start = pos;
+		}
+	}
+
+	/**
+	 * @copydoc hid::detail::NullTracer::item()
+	 */
+	inline void item(const size_t pos, const uint32_t /* prefix */, const uint32_t /* data */) {
+		this->doc.spans.push_back(Span{this->start, pos, this->doc.out.size()});
+	}
+
+	/**
+	 * @copydoc hid::detail::NullTracer::literal()
+	 */
+	inline void literal(const size_t pos, const uint32_t /* value */) {
+		this->doc.spans.push_back(Span{this->start, pos, this->doc.out.size()});
+	}
+};
+
+
+/** Appends the compiled bytes to the document output. */
+struct DocumentWriter {
+	std::vector<uint8_t> & data; /**< output */
+
+	/**
+	 * Returns the current write position.
+	 *
+	 * @return write position
+	 */
+	inline size_t getPosition() const noexcept {
+		return this->data.size();
+	}
+
+	/**
+	 * Appends the given byte.
+	 *
+	 * @param[in] val - byte value to write
+	 * @return true on success, else false
+	 */
+	inline bool write(const uint8_t val) {
+		this->data.push_back(val);
+		return true;
+	}
+};
+
+
+/**
+ * Checks whether both recorded string tables number the same strings. Strings beyond the
+ * recorded ones are not compared and make the tables differ.
+ *
+ * @param[in] lhsText - source code of `lhs`
+ * @param[in] lhs - left-hand table
+ * @param[in] rhsText - source code of `rhs`
+ * @param[in] rhs - right-hand table
+ * @return true if equal, else false
+ */
+static bool sameOrder(const char * lhsText, const hid::detail::StringOrder & lhs, const char * rhsText, const hid::detail::StringOrder & rhs) {
+	if (lhs.count != rhs.count || lhs.count > size_t(hid::detail::StringOrder::Capacity)) {
+		return false;
+	}
+	for (size_t i = 0; i < lhs.count; i++) {
+		/* recorded strings end with a quote */
+		const char * l = lhsText + lhs.start[i];
+		const char * r = rhsText + rhs.start[i];
+		while (*l == *r && *l != '"') {
+			l++;
+			r++;
+		}
+		if (*l != '"' || *r != '"') {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Checks whether both recorded name tables hold the same names.
+ *
+ * @param[in] lhsText - source code of `lhs`
+ * @param[in] lhs - left-hand table
+ * @param[in] rhsText - source code of `rhs`
+ * @param[in] rhs - right-hand table
+ * @return true if equal, else false
+ */
+static bool sameOrder(const char * lhsText, const hid::detail::NameOrder & lhs, const char * rhsText, const hid::detail::NameOrder & rhs) {
+	if (lhs.count != rhs.count || lhs.count > size_t(hid::detail::NameOrder::Capacity)) {
+		return false;
+	}
+	for (size_t i = 0; i < lhs.count; i++) {
+		const size_t len = hid::detail::nameLength(lhsText + lhs.start[i], lhs.lead);
+		if (lhs.hash[i] != rhs.hash[i] || len != hid::detail::nameLength(rhsText + rhs.start[i], rhs.lead)
+			|| std::memcmp(lhsText + lhs.start[i], rhsText + rhs.start[i], len) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Replaces the recorded positions of the given table which were already recorded in `before`
+ * by those of `now`. The remaining positions are moved by `delta`.
+ *
+ * @param[in,out] order - table to update
+ * @param[in] before - table of the previous compilation at the reused position
+ * @param[in] now - table of the current compilation at the reused position
+ * @param[in] delta - size difference in bytes caused by the change
+ * @tparam Order - `StringOrder` or `NameOrder`
+ */
+template <typename Order>
+static void moveOrder(Order & order, const Order & before, const Order & now, const ptrdiff_t delta) {
+	const size_t known = std::min(order.count, size_t(Order::Capacity));
+	for (size_t i = 0; i < known; i++) {
+		order.start[i] = (i < before.count) ? now.start[i] : uint32_t(ptrdiff_t(order.start[i]) + delta);
+	}
+}
+
+
+/**
+ * Checks whether both compiler states continue equally for the same remaining source code.
+ * Counters which are only compared relative to each other are compared by their difference.
+ * Recorded strings and names are compared by their content.
+ *
+ * @param[in] lhsText - source code of `lhs`
+ * @param[in] lhs - left-hand state
+ * @param[in] rhsText - source code of `rhs`
+ * @param[in] rhs - right-hand state
+ * @return true if equal, else false
+ */
+static bool sameState(const char * lhsText, const hid::detail::CompileState & lhs, const char * rhsText, const hid::detail::CompileState & rhs) {
+	return lhs.colLevel == rhs.colLevel
+		&& lhs.delimLevel == rhs.delimLevel
+		&& lhs.usageAtLevel == rhs.usageAtLevel
+		&& (lhs.reportSizes - lhs.reportCounts) == (rhs.reportSizes - rhs.reportCounts)
+		&& lhs.physicalSets == rhs.physicalSets
+		&& lhs.hasUsagePage == rhs.hasUsagePage
+		&& lhs.afterMain == rhs.afterMain
+		&& lhs.withinComment == rhs.withinComment
+		&& lhs.usagePage.value == rhs.usagePage.value
+		&& lhs.usagePage.arg == rhs.usagePage.arg
+		&& sameOrder(lhsText, lhs.strings, rhsText, rhs.strings)
+		&& sameOrder(lhsText, lhs.designators, rhsText, rhs.designators)
+		&& sameOrder(lhsText, lhs.names, rhsText, rhs.names);
+}
+
+
+/** Language server state. */
+class Server {
+private:
+	Params params; /**< parameter set */
+	EncodingTrie trie; /**< completion candidates */
+	std::map<std::string, Document> documents; /**< open documents by URI */
+	bool shutdown; /**< true after the shutdown request */
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param[in] p - parameter set
+	 */
+	explicit Server(const Params & p):
+		params(p),
+		trie{},
+		documents{},
+		shutdown{false}
+	{}
+
+	/**
+	 * Processes messages from stdin until the exit notification.
+	 *
+	 * @return process exit code
+	 */
+	int run() {
+		std::string body;
+		while ( readMessage(body) ) {
+			Json msg;
+			if ( ! JsonParser(body.data(), body.size()).parse(msg) ) {
+				send("{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32700,\"message\":\"Parse error\"}}");
+				continue;
+			}
+			const std::string & method = msg["method"].string;
+			if (method == "exit") {
+				return this->shutdown ? EXIT_SUCCESS : EXIT_FAILURE;
+			}
+			this->dispatch(method, msg);
+		}
+		return EXIT_FAILURE;
+	}
+private:
+	/**
+	 * Reads the next message body.
+	 *
+	 * @param[out] body - message body
+	 * @return true on success, else false
+	 */
+	static bool readMessage(std::string & body) {
+		size_t length = 0;
+		bool header = false;
+		char line[256];
+		for (;;) {
+			if (fgets(line, sizeof(line), stdin) == NULL) {
+				return false;
+			}
+			if (line[0] == '\r' || line[0] == '\n') {
+				if ( ! header ) {
+					continue; /* line breaks between messages */
+				}
+				break;
+			}
+			header = true;
+			if (strncmp(line, "Content-Length:", 15) == 0) {
+				length = size_t(strtoul(line + 15, NULL, 10));
+			}
+		}
+		body.resize(length);
+		return length == 0 || fread(&body[0], 1, length, stdin) == length;
+	}
+
+	/**
+	 * Sends the given message body.
+	 *
+	 * @param[in] body - JSON message
+	 */
+	static void send(const std::string & body) {
+		printf("Content-Length: %u\r\n\r\n%s", unsigned(body.size()), body.c_str());
+		fflush(stdout);
+	}
+
+	/**
+	 * Sends the result of the given request.
+	 *
+	 * @param[in] msg - request
+	 * @param[in] result - JSON result
+	 */
+	static void reply(const Json & msg, const std::string & result) {
+		send("{\"jsonrpc\":\"2.0\",\"id\":" + requestId(msg) + ",\"result\":" + result + "}");
+	}
+
+	/**
+	 * Returns the ID of the given request.
+	 *
+	 * @param[in] msg - request
+	 * @return JSON request ID
+	 */
+	static std::string requestId(const Json & msg) {
+		const Json & id = msg["id"];
+		return (id.type == Json::STRING) ? quote(id.string) : std::to_string(int64_t(id.number));
+	}
+
+	/**
+	 * Handles the given message.
+	 *
+	 * @param[in] method - method name
+	 * @param[in] msg - message
+	 */
+	void dispatch(const std::string & method, const Json & msg) {
+		const Json & args = msg["params"];
+		const std::string & uri = args["textDocument"]["uri"].string;
+		if (method == "initialize") {
+			reply(msg, "{\"capabilities\":{\"positionEncoding\":\"utf-16\",\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+				"\"completionProvider\":{\"triggerCharacters\":[\"(\",\",\"]},\"hoverProvider\":true},"
+				"\"serverInfo\":{\"name\":\"HidLanguageServer\"}}");
+		} else if (method == "shutdown") {
+			this->shutdown = true;
+			reply(msg, "null");
+		} else if (method == "textDocument/didOpen") {
+			Document & doc = this->documents[uri];
+			doc.text = args["textDocument"]["text"].string;
+			this->update(doc, std::string(), 0, 0, 0, false);
+			this->publish(uri, doc);
+		} else if (method == "textDocument/didChange") {
+			auto it = this->documents.find(uri);
+			if (it == this->documents.end()) {
+				return;
+			}
+			for (const Json & change : args["contentChanges"].items) {
+				this->change(it->second, change);
+			}
+			this->publish(uri, it->second);
+		} else if (method == "textDocument/didClose") {
+			this->documents.erase(uri);
+			send("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":" + quote(uri) + ",\"diagnostics\":[]}}");
+		} else if (method == "textDocument/completion") {
+			auto it = this->documents.find(uri);
+			reply(msg, (it != this->documents.end()) ? this->complete(it->second, it->second.offset(args["position"])) : "null");
+		} else if (method == "textDocument/hover") {
+			auto it = this->documents.find(uri);
+			reply(msg, (it != this->documents.end()) ? this->hover(it->second, it->second.offset(args["position"])) : "null");
+		} else if (msg["id"].type != Json::NUL) {
+			send("{\"jsonrpc\":\"2.0\",\"id\":" + requestId(msg) + ",\"error\":{\"code\":-32601,\"message\":\"Method not found\"}}");
+		}
+	}
+
+	/**
+	 * Applies the given content change and updates the compiled state.
+	 *
+	 * @param[in,out] doc - document to change
+	 * @param[in] change - LSP content change
+	 */
+	void change(Document & doc, const Json & change) {
+		const Json & range = change["range"];
+		const std::string & text = change["text"].string;
+		if (range.type != Json::OBJECT) {
+			/* full document update */
+			doc.text = text;
+			this->update(doc, std::string(), 0, 0, 0, false);
+			return;
+		}
+		const size_t start = doc.offset(range["start"]);
+		size_t end = doc.offset(range["end"]);
+		if (end < start) {
+			end = start;
+		}
+		const size_t line = size_t(std::upper_bound(doc.lines.begin(), doc.lines.end(), start) - doc.lines.begin()) - 1;
+		const std::string oldText = doc.text;
+		doc.text.replace(start, end - start, text);
+		this->update(doc, oldText, line, start + text.size(), ptrdiff_t(text.size()) - ptrdiff_t(end - start), true);
+	}
+
+	/**
+	 * Compiles the document from the given line on. Compilation stops early once the compiler
+	 * state at a line start after the changed range matches the previous one. The remaining
+	 * output is reused in this case.
+	 *
+	 * @param[in,out] doc - document to compile
+	 * @param[in] oldText - source code of the previous result
+	 * @param[in] first - first changed line
+	 * @param[in] changeEnd - end of the changed range within the new source code
+	 * @param[in] delta - size difference in bytes caused by the change
+	 * @param[in] reuse - true to allow reusing the previous result
+	 */
+	void update(Document & doc, const std::string & oldText, size_t first, const size_t changeEnd, const ptrdiff_t delta, bool reuse) {
+		const std::vector<size_t> oldLines = std::move(doc.lines);
+		doc.updateLines();
+		if (first >= doc.checkpoints.size()) {
+			/* compilation previously stopped at an error before this line */
+			first = doc.checkpoints.empty() ? 0 : (doc.checkpoints.size() - 1);
+		}
+		if ( doc.checkpoints.empty() ) {
+			doc.checkpoints.push_back(Checkpoint{hid::detail::CompileState(), 0, 0});
+		}
+		reuse = reuse && ( ! oldLines.empty() );
+		const ptrdiff_t lineDelta = ptrdiff_t(doc.lines.size()) - ptrdiff_t(oldLines.size());
+		std::vector<Checkpoint> oldCheckpoints;
+		std::vector<uint8_t> oldOut;
+		std::vector<Span> oldSpans;
+		const hid::error::Info oldError = doc.error;
+		if ( reuse ) {
+			oldCheckpoints.assign(doc.checkpoints.begin() + ptrdiff_t(first), doc.checkpoints.end());
+			oldOut = doc.out;
+			oldSpans = doc.spans;
+		}
+		const Checkpoint start = doc.checkpoints[first];
+		doc.checkpoints.resize(first + 1);
+		doc.out.resize(start.out);
+		doc.spans.resize(start.spans);
+		doc.error = hid::error::Info();
+		hid::detail::CompileState state = start.state;
+		DocumentWriter out{doc.out};
+		SpanTracer tracer(doc);
+		for (size_t line = first; line < doc.lines.size(); line++) {
+			const hid::SourceView view = this->source(doc, doc.lineEnd(line));
+			if ( ! hid::detail::compile(view, out, doc.error, state, hid::detail::CM_PARTIAL, tracer) ) {
+				return;
+			}
+			doc.checkpoints.push_back(Checkpoint{state, doc.out.size(), doc.spans.size()});
+			if (( ! reuse ) || doc.lineEnd(line) < changeEnd || (line + 1) >= doc.lines.size()) {
+				continue;
+			}
+			/* reuse the previous result if the compiler state matches again at a line start */
+			const ptrdiff_t oldIndex = ptrdiff_t(line + 1) - lineDelta - ptrdiff_t(first);
+			if (oldIndex <= 0 || size_t(oldIndex) >= oldCheckpoints.size()) {
+				continue;
+			}
+			const Checkpoint & old = oldCheckpoints[size_t(oldIndex)];
+			if (state.position != doc.lines[line + 1] || ptrdiff_t(old.state.position) + delta != ptrdiff_t(state.position) || ( ! sameState(oldText.c_str(), old.state, doc.text.c_str(), state) )) {
+				continue;
+			}
+			const ptrdiff_t outDelta = ptrdiff_t(doc.out.size()) - ptrdiff_t(old.out);
+			const ptrdiff_t spanDelta = ptrdiff_t(doc.spans.size()) - ptrdiff_t(old.spans);
+			doc.out.insert(doc.out.end(), oldOut.begin() + ptrdiff_t(old.out), oldOut.end());
+			for (size_t i = old.spans; i < oldSpans.size(); i++) {
+				const Span & span = oldSpans[i];
+				doc.spans.push_back(Span{size_t(ptrdiff_t(span.start) + delta), size_t(ptrdiff_t(span.end) + delta), size_t(ptrdiff_t(span.out) + outDelta)});
+			}
+			for (size_t i = size_t(oldIndex) + 1; i < oldCheckpoints.size(); i++) {
+				Checkpoint cp = oldCheckpoints[i];
+				cp.state.position = size_t(ptrdiff_t(cp.state.position) + delta);
+				cp.state.reportSizes = cp.state.reportSizes + state.reportSizes - old.state.reportSizes;
+				cp.state.reportCounts = cp.state.reportCounts + state.reportCounts - old.state.reportCounts;
+				cp.state.annotations = cp.state.annotations + state.annotations - old.state.annotations;
+				moveOrder(cp.state.strings, old.state.strings, state.strings, delta);
+				moveOrder(cp.state.designators, old.state.designators, state.designators, delta);
+				moveOrder(cp.state.names, old.state.names, state.names, delta);
+				cp.out = size_t(ptrdiff_t(cp.out) + outDelta);
+				cp.spans = size_t(ptrdiff_t(cp.spans) + spanDelta);
+				doc.checkpoints.push_back(cp);
+			}
+			doc.error = oldError;
+			if (doc.error.message != hid::error::E_NO_ERROR) {
+				doc.error.line = size_t(ptrdiff_t(doc.error.line) + lineDelta);
+				doc.error.character = size_t(ptrdiff_t(doc.error.character) + delta);
+			}
+			return;
+		}
+		/* complete the last item and check the final state */
+		const hid::SourceView view = this->source(doc, doc.text.size());
+		hid::detail::compile(view, out, doc.error, state, hid::detail::CM_ALL, tracer);
+	}
+
+	/**
+	 * Returns the source code of the given document up to the passed position.
+	 *
+	 * @param[in] doc - document
+	 * @param[in] end - end of the visible source code
+	 * @return source code view
+	 */
+	hid::SourceView source(const Document & doc, const size_t end) const {
+		/* the parameter set is only read by findParam() */
+		return hid::SourceView(doc.text.data(), end, const_cast<Params *>(&this->params), findParam);
+	}
+
+	/**
+	 * Publishes the diagnostics of the given document.
+	 *
+	 * @param[in] uri - document URI
+	 * @param[in] doc - document
+	 */
+	void publish(const std::string & uri, const Document & doc) {
+		std::string diagnostics = "[]";
+		if (doc.error.message != hid::error::E_NO_ERROR) {
+			const size_t line = (doc.error.line > 0) ? (doc.error.line - 1) : 0;
+			const size_t column = (doc.error.column > 0) ? (doc.error.column - 1) : 0;
+			diagnostics = "[{\"range\":{\"start\":" + doc.position(line, column) + ",\"end\":" + doc.position(line, column + 1) + "},"
+				"\"severity\":1,\"source\":\"hid\",\"message\":" + quote(hid::error::EMessageStr[doc.error.message]) + "}]";
+		}
+		send("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":" + quote(uri) + ",\"diagnostics\":" + diagnostics + "}}");
+	}
+
+	/**
+	 * Returns the completion items at the given position.
+	 *
+	 * @param[in] doc - document
+	 * @param[in] pos - byte position of the cursor
+	 * @return JSON completion list
+	 */
+	std::string complete(const Document & doc, const size_t pos) const {
+		using namespace hid::detail;
+		const std::string & text = doc.text;
+		size_t lineStart = pos;
+		while (lineStart > 0 && text[lineStart - 1] != '\n') {
+			lineStart--;
+		}
+		bool quoted = false;
+		for (size_t n = lineStart; n < pos; n++) {
+			if (text[n] == '"') {
+				quoted = ! quoted;
+			} else if (( ! quoted ) && isComment(text[n])) {
+				/* no completions within comments */
+				return "null";
+			}
+		}
+		if ( quoted ) {
+			return "null";
+		}
+		size_t wordStart = pos;
+		while (wordStart > 0 && (isArgChar(text[wordStart - 1]))) {
+			wordStart--;
+		}
+		const std::string prefix = text.substr(wordStart, pos - wordStart);
+		/* find the opening parenthesis of the enclosing argument list */
+		size_t n = wordStart;
+		uint8_t map = EM_ITEM;
+		int kind = 14; /* Keyword */
+		while (n > 0 && (isArgChar(text[n - 1]) || isWhitespace(text[n - 1]) || text[n - 1] == ',' || text[n - 1] == '-' || text[n - 1] == '^')) {
+			n--;
+		}
+		if (n > 0 && text[n - 1] == '(') {
+			size_t itemEnd = n - 1;
+			while (itemEnd > 0 && isWhitespace(text[itemEnd - 1])) {
+				itemEnd--;
+			}
+			size_t itemStart = itemEnd;
+			while (itemStart > 0 && isItemChar(text[itemStart - 1])) {
+				itemStart--;
+			}
+			const Token item{text.data() + itemStart, itemEnd - itemStart};
+			EncodingRef enc;
+			hid::error::EMessage error = hid::error::E_NO_ERROR;
+			kind = 20; /* EnumMember */
+			if ( findEncoding(item, EM_ITEM, enc, error) ) {
+				map = enc.arg;
+				if (map == EM_USAGE_PAGE) {
+					kind = 9; /* Module */
+				} else if (map == EM_USAGE_ARG) {
+					map = this->usagePageAt(doc, itemStart).arg;
+				}
+			} else if ( findEncoding(item, EM_UNIT_SYSTEM, enc, error) ) {
+				map = enc.arg;
+			} else {
+				return "null";
+			}
+		}
+		std::vector<const Candidate *> candidates = this->trie.find(map, prefix, 201);
+		const bool incomplete = candidates.size() > 200;
+		if ( incomplete ) {
+			candidates.pop_back();
+		}
+		std::string res = std::string("{\"isIncomplete\":") + (incomplete ? "true" : "false") + ",\"items\":[";
+		bool firstItem = true;
+		for (const Candidate * candidate : candidates) {
+			res += firstItem ? "" : ",";
+			res += "{\"label\":" + quote(candidate->label) + ",\"kind\":" + std::to_string(kind);
+			res += candidate->detail.empty() ? "}" : (",\"detail\":" + quote(candidate->detail) + "}");
+			firstItem = false;
+		}
+		return res + "]}";
+	}
+
+	/**
+	 * Returns the usage page which applies to the item at the given position.
+	 *
+	 * @param[in] doc - document
+	 * @param[in] pos - byte position of the item
+	 * @return usage page encoding
+	 */
+	hid::detail::EncodingRef usagePageAt(const Document & doc, const size_t pos) const {
+		const size_t line = size_t(std::upper_bound(doc.lines.begin(), doc.lines.end(), pos) - doc.lines.begin()) - 1;
+		const Checkpoint & cp = doc.checkpoints[(line < doc.checkpoints.size()) ? line : (doc.checkpoints.size() - 1)];
+		hid::detail::CompileState state = cp.state;
+		hid::detail::NullWriter out;
+		hid::detail::NullTracer tracer;
+		hid::error::Info error;
+		const hid::SourceView view = this->source(doc, pos);
+		hid::detail::compile(view, out, error, state, hid::detail::CM_PARTIAL, tracer);
+		return state.usagePage;
+	}
+
+	/**
+	 * Returns the hover information at the given position.
+	 *
+	 * @param[in] doc - document
+	 * @param[in] pos - byte position of the cursor
+	 * @return JSON hover result
+	 */
+	std::string hover(const Document & doc, const size_t pos) const {
+		auto it = std::upper_bound(doc.spans.begin(), doc.spans.end(), pos, [](const size_t p, const Span & span) { return p < span.start; });
+		if (it == doc.spans.begin()) {
+			return "null";
+		}
+		--it;
+		const Span & span = *it;
+		if (pos > span.end) {
+			return "null";
+		}
+		const size_t end = ((it + 1) != doc.spans.end()) ? (it + 1)->out : doc.out.size();
+		std::string value = "`";
+		for (size_t i = span.out; i < end; i++) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), (i > span.out) ? " 0x%02X" : "0x%02X", unsigned(doc.out[i]));
+			value += buf;
+		}
+		value += "` at descriptor offset " + std::to_string(span.out);
+		/* running bit offset by report type and ID (unlike FieldReader not limited in the number of reports) */
+		std::vector<uint32_t> offsets(3 * 256, 0);
+		hid::detail::GlobalTracker global;
+		for (size_t p = 0; p < doc.out.size(); ) {
+			const hid::detail::Item item = hid::detail::readItem(doc.out.data(), doc.out.size(), p);
+			if (item.tag != hid::RT_INPUT && item.tag != hid::RT_OUTPUT && item.tag != hid::RT_FEATURE) {
+				global.update(item);
+				p = item.next();
+				continue;
+			}
+			static const char * typeName[] = {"Input", "Output", "", "Feature"};
+			const hid::detail::GlobalItems & g = global.get();
+			const uint32_t bits = g.reportSize * g.reportCount;
+			uint32_t & offset = offsets[size_t((item.tag == hid::RT_INPUT) ? 0 : (item.tag == hid::RT_OUTPUT) ? 1 : 2) * 256 + g.reportId];
+			if (p == span.out) {
+				char buf[160];
+				const unsigned first = unsigned(offset + ((g.reportId != 0) ? 8 : 0));
+				if (bits > 0) {
+					snprintf(buf, sizeof(buf), "\n\n%s report %u: bits %u to %u (%u x %u bits)", typeName[(item.tag >> 4) & 3], unsigned(g.reportId), first, unsigned(first + bits - 1), unsigned(g.reportCount), unsigned(g.reportSize));
+				} else {
+					snprintf(buf, sizeof(buf), "\n\n%s report %u: no bits at bit %u", typeName[(item.tag >> 4) & 3], unsigned(g.reportId), first);
+				}
+				value += buf;
+				break;
+			}
+			offset += bits;
+			p = item.next();
+		}
+		const size_t line = size_t(std::upper_bound(doc.lines.begin(), doc.lines.end(), span.start) - doc.lines.begin()) - 1;
+		size_t startColumn = 0, endColumn = 0;
+		for (size_t n = doc.lines[line]; n <= span.end && n < doc.text.size(); n++) {
+			if ((uint8_t(doc.text[n]) & 0xC0) != 0x80) {
+				startColumn += (n < span.start) ? 1 : 0;
+				endColumn++;
+			}
+		}
+		return "{\"contents\":{\"kind\":\"markdown\",\"value\":" + quote(value) + "},\"range\":{\"start\":" + doc.position(line, startColumn) + ",\"end\":" + doc.position(line, endColumn) + "}}";
+	}
+};
+
+
+/** Prints the command-line usage. */
+static void printHelp() {
+	fprintf(stderr,
+		"HidLanguageServer [-D name=value]...\n"
+		"\n"
+		"Language server for HID descriptor source files via stdio.\n"
+		"\n"
+		"-D name=value\n"
+		"   Defines the parameter name with the given integer value.\n"
+	);
+}
+
+
+int main(int argc, char ** argv) {
+	Params params;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-D") != 0 || (i + 1) >= argc) {
+			printHelp();
+			return EXIT_FAILURE;
+		}
+		const char * arg = argv[++i];
+		const char * sep = strchr(arg, '=');
+		if (sep == NULL) {
+			fprintf(stderr, "Error: Invalid parameter definition \"%s\".\n", arg);
+			return EXIT_FAILURE;
+		}
+		params.emplace_back(std::string(arg, size_t(sep - arg)), int64_t(strtoll(sep + 1, NULL, 0)));
+	}
+#ifdef _WIN32
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	return Server(params).run();
+}
@@ -1,9 +1,9 @@
 /**
  * @file HidDescriptor.hpp
  * @author Daniel Starke
- * @copyright Copyright 2022-2023 Daniel Starke
+ * @copyright Copyright 2022-2026 Daniel Starke
  * @date 2022-04-20
- * @version 2023-11-05
+ * @version 2026-10-17
  * 
  * Helper functions to build a USB HID descriptor. Use `DEF_HID_DESCRIPTOR_AS()`.
  * 
@@ -18,7 +18,7 @@
  * @see   - https://www.usb.org/sites/default/files/pos1_02.pdf
  * @see   - https://www.usb.org/sites/default/files/oaaddataformatsv6.pdf
  * @see ::hid::detail::compile()
- * @remarks Define `HID_DESCRIPTOR_DEBUG` for runtime debugging (not compile time).
+ * @remarks Define `HID_DESCRIPTOR_DEBUG` to trace `compile()` via `PrintTracer` at runtime (not compile time).
  * @note The usage names are derived from the standard by applying the following rules:
  * - replace leading `+` by `Plus`
  * - replace `/second/second` by `PerSecondSquared`
@@ -64,20 +64,133 @@ extern "C" {
  * @param name - HID descriptor variable name (may contain additional qualifiers like 'static')
  * @param desc - HID descriptor source code
  * @note Make sure to assign the result to a variable with `constexpr` attribute.
+ * @note Each top-level collection is compiled within its own constant expression evaluation.
+ * This keeps large descriptors within the compiler's constexpr evaluation limits.
  * @see ::hid::detail::Descriptor
  * @remarks Define `HID_DESCRIPTOR_NO_ERROR_REPORT` to suppress error reporting.
  */
 #ifdef HID_DESCRIPTOR_NO_ERROR_REPORT
 #define DEF_HID_DESCRIPTOR_AS(name, desc) \
-	constexpr const auto name = ::hid::Descriptor<::hid::compiledSize(::hid::fromSource desc)>(::hid::fromSource desc)
+	struct HID_DESC_CAT(_hid_source_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr const auto name = ::hid::detail::chunkedDescriptor<HID_DESC_CAT(_hid_source_, __LINE__)>()
 #else /* not HID_DESCRIPTOR_NO_ERROR_REPORT */
 #define DEF_HID_DESCRIPTOR_AS(name, desc) \
-	constexpr static const ::hid::Error HID_DESC_CAT(_hid_error_, __LINE__) = ::hid::compileError(::hid::fromSource desc); \
+	struct HID_DESC_CAT(_hid_source_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr static const ::hid::Error HID_DESC_CAT(_hid_error_, __LINE__) = ::hid::detail::chunkedError<HID_DESC_CAT(_hid_source_, __LINE__)>(); \
 	constexpr static const size_t HID_DESC_CAT(HID_DESC_CAT(_hid_error_, __LINE__), _num) = ::hid::reporter<HID_DESC_CAT(_hid_error_, __LINE__).line, HID_DESC_CAT(_hid_error_, __LINE__).column, HID_DESC_CAT(_hid_error_, __LINE__).message>(); \
-	constexpr const auto name = ::hid::Descriptor<::hid::compiledSize(::hid::fromSource desc)>(::hid::fromSource desc)
+	constexpr const auto name = ::hid::detail::chunkedDescriptor<HID_DESC_CAT(_hid_source_, __LINE__)>()
 #endif /* not HID_DESCRIPTOR_NO_ERROR_REPORT */
 
 
+/**
+ * @def DEF_HID_STRINGS_AS
+ * Creates the USB string descriptors of all string arguments within the given source code
+ * (e.g. `StringIndex("Left Trigger")`). Pass the same source code as to `DEF_HID_DESCRIPTOR_AS`.
+ * 
+ * @param name - string table variable name (may contain additional qualifiers like 'static')
+ * @param desc - HID descriptor source code
+ * @see ::hid::detail::StringTable
+ */
+#define DEF_HID_STRINGS_AS(name, desc) \
+	struct HID_DESC_CAT(_hid_strings_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr const auto name = ::hid::StringTable< \
+		::hid::stringCount(HID_DESC_CAT(_hid_strings_, __LINE__)::get()), \
+		::hid::stringTableSize(HID_DESC_CAT(_hid_strings_, __LINE__)::get()) \
+	>(HID_DESC_CAT(_hid_strings_, __LINE__)::get())
+
+
+/**
+ * @def DEF_HID_PHYSICAL_AS
+ * Creates the HID physical descriptor sets of all `PhysicalSet` and `Designator` items within
+ * the given source code. Pass the same source code as to `DEF_HID_DESCRIPTOR_AS`.
+ * 
+ * @param name - physical descriptor table variable name (may contain additional qualifiers like 'static')
+ * @param desc - HID descriptor source code
+ * @see ::hid::detail::PhysicalTable
+ */
+#define DEF_HID_PHYSICAL_AS(name, desc) \
+	struct HID_DESC_CAT(_hid_physical_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr const auto name = ::hid::PhysicalTable< \
+		::hid::physicalSetCount(HID_DESC_CAT(_hid_physical_, __LINE__)::get()), \
+		::hid::designatorCount(HID_DESC_CAT(_hid_physical_, __LINE__)::get()) \
+	>(HID_DESC_CAT(_hid_physical_, __LINE__)::get())
+
+
+/**
+ * @def DEF_HID_ITEM_LIST_AS
+ * Lowers the HID descriptor source code to an item list with unresolved parameters. Bind
+ * each parameter set with `bind()` to get the HID descriptor for this set.
+ * 
+ * @param name - item list variable name (may contain additional qualifiers like 'static')
+ * @param desc - HID descriptor source code
+ * @see ::hid::detail::ItemList
+ * @remarks Define `HID_DESCRIPTOR_NO_ERROR_REPORT` to suppress error reporting.
+ */
+#ifdef HID_DESCRIPTOR_NO_ERROR_REPORT
+#define DEF_HID_ITEM_LIST_AS(name, desc) \
+	struct HID_DESC_CAT(_hid_items_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr static const ::hid::detail::LoweredSize HID_DESC_CAT(_hid_lowered_, __LINE__) = ::hid::loweredSize(HID_DESC_CAT(_hid_items_, __LINE__)::get()); \
+	constexpr const auto name = ::hid::ItemList< \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).size, \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).items, \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).refs \
+	>(HID_DESC_CAT(_hid_items_, __LINE__)::get())
+#else /* not HID_DESCRIPTOR_NO_ERROR_REPORT */
+#define DEF_HID_ITEM_LIST_AS(name, desc) \
+	struct HID_DESC_CAT(_hid_items_, __LINE__) { \
+		static constexpr auto get() noexcept { return ::hid::fromSource desc; } \
+	}; \
+	constexpr static const ::hid::detail::LoweredSize HID_DESC_CAT(_hid_lowered_, __LINE__) = ::hid::loweredSize(HID_DESC_CAT(_hid_items_, __LINE__)::get()); \
+	constexpr static const size_t HID_DESC_CAT(HID_DESC_CAT(_hid_lowered_, __LINE__), _num) = ::hid::reporter<HID_DESC_CAT(_hid_lowered_, __LINE__).error.line, HID_DESC_CAT(_hid_lowered_, __LINE__).error.column, HID_DESC_CAT(_hid_lowered_, __LINE__).error.message>(); \
+	constexpr const auto name = ::hid::ItemList< \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).size, \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).items, \
+		HID_DESC_CAT(_hid_lowered_, __LINE__).refs \
+	>(HID_DESC_CAT(_hid_items_, __LINE__)::get())
+#endif /* not HID_DESCRIPTOR_NO_ERROR_REPORT */
+
+
+/**
+ * @def HID_REPORT_STATS_SOURCE
+ * Source code of the vendor defined Feature report which provides the `ReportStats` values.
+ * Append it to the HID descriptor source and pass the parameters `hidStatsId` (report ID)
+ * and `hidStatsCount` (`ReportStats::ValueCount`).
+ * 
+ * @see ::hid::detail::ReportStats
+ */
+#define HID_REPORT_STATS_SOURCE \
+	"\nUsagePage(0xFF00) Usage(0x01) Collection(Application) ReportId({hidStatsId}) Usage(0x02) " \
+	"LogicalMinimum(0) LogicalMaximum(0x7FFFFFFF) ReportSize(32) ReportCount({hidStatsCount}) Feature(Data, Var, Abs) EndCollection\n"
+
+
+/**
+ * @def DEF_HID_FAMILY_AS
+ * Stores the given compiled HID descriptors as deduplicated fragments.
+ * 
+ * @param name - descriptor family variable name (may contain additional qualifiers like 'static')
+ * @param family - array of `::hid::DescriptorRef` with static storage duration
+ * @see ::hid::detail::DescriptorFamily
+ */
+#define DEF_HID_FAMILY_AS(name, family) \
+	static_assert(::hid::familyLayout(family).largest <= 0xFFFF, "Descriptor family member exceeds the 16-bit size limit."); \
+	constexpr const auto name = ::hid::DescriptorFamily< \
+		(sizeof(family) / sizeof(*(family))), \
+		::hid::familyLayout(family).fragments, \
+		::hid::familyLayout(family).pool, \
+		::hid::familyLayout(family).list \
+	>(family)
+
+
 namespace hid {
 namespace error {
 
@@ -93,6 +206,7 @@ enum EMessage {
 	E_Parameter_value_out_of_range,
 	E_Unexpected_end_of_source,
 	E_Expected_valid_parameter_name_here,
+	E_Ambiguous_parameter_name,
 	E_Invalid_item_name,
 	E_Missing_argument,
 	E_Missing_named_UsagePage,
@@ -117,7 +231,18 @@ enum EMessage {
 	E_Missing_ReportCount,
 	E_Invalid_hex_value,
 	E_Invalid_numeric_value,
-	E_Negative_numbers_are_not_allowed_in_this_context
+	E_Negative_numbers_are_not_allowed_in_this_context,
+	E_Input_buffer_overflow,
+	E_Output_buffer_overflow,
+	E_Missing_main_item_for_annotation,
+	E_Invalid_annotation_name,
+	E_Ambiguous_annotation_name,
+	E_Strings_are_not_allowed_in_this_context,
+	E_Missing_closing_quote,
+	E_Invalid_string,
+	E_Missing_PhysicalSet,
+	E_Missing_designator_name,
+	E_Unknown_designator_name
 };
 
 
@@ -132,6 +257,7 @@ static constexpr const char * EMessageStr[] __attribute__((unused)) = {
 	"Parameter value out of range.",
 	"Unexpected end of source.",
 	"Expected valid parameter name here.",
+	"Parameter name hash collides with another parameter name.",
 	"Invalid item name.",
 	"Missing argument.",
 	"Missing named UsagePage.",
@@ -156,7 +282,18 @@ static constexpr const char * EMessageStr[] __attribute__((unused)) = {
 	"Missing ReportCount.",
 	"Invalid hex value.",
 	"Invalid numeric value.",
-	"Negative numbers are not allowed in this context."
+	"Negative numbers are not allowed in this context.",
+	"Input buffer overflow.",
+	"Output buffer overflow.",
+	"Missing main item for annotation.",
+	"Invalid annotation name.",
+	"Annotation name hash collides with another annotation name.",
+	"Strings are not allowed in this context.",
+	"Missing closing quote.",
+	"Invalid string.",
+	"Missing PhysicalSet.",
+	"Missing designator name.",
+	"Unknown designator name."
 };
 
 
@@ -205,6 +342,7 @@ class ErrorWriter {
 private:
 	const char * source;
 	Info & error;
+	Info origin;
 public:
 	/**
 	 * Constructor.
@@ -214,36 +352,64 @@ public:
 	 */
 	constexpr inline explicit ErrorWriter(const char * s, Info & e) noexcept:
 		source{s},
-		error{e}
+		error{e},
+		origin{}
+	{
+		this->origin.line = 1;
+		this->origin.column = 1;
+	}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] s - source code base pointer
+	 * @param[out] e - error output variable
+	 * @param[in] o - source code position of the base pointer
+	 */
+	constexpr inline explicit ErrorWriter(const char * s, Info & e, const Info & o) noexcept:
+		source{s},
+		error{e},
+		origin{o}
 	{}
 	
 	/**
-	 * Sets the error output variable to the given position and error message.
+	 * Advances the given position by the passed source code.
 	 * 
-	 * @param[in] pos - source code position
-	 * @param[in] msg - error message to output
-	 * @return false
+	 * @param[in,out] position - source code position to advance
+	 * @param[in] s - source code
+	 * @param[in] len - number of bytes to advance
 	 */
-	constexpr inline bool at(const size_t pos, const EMessage msg) noexcept {
-		this->error.character = 0;
-		this->error.line = 1;
-		this->error.column = 1;
-		this->error.message = msg;
-		for (size_t n = 0; n < pos; n++) {
-			const int c = int(this->source[n]);
+	constexpr static inline void advance(Info & position, const char * s, const size_t len) noexcept {
+		for (size_t n = 0; n < len; n++) {
+			const int c = int(s[n]);
 			if ((c & 0xC0) != 0x80) {
-				this->error.character++;
+				position.character++;
 			}
 			if (c == '\n') {
-				this->error.line++;
-				this->error.column = 1;
+				position.line++;
+				position.column = 1;
 			} else if (c != '\r') {
 				/* we only count the first byte of a UTF-8 character */
 				if ((c & 0xC0) != 0x80) {
-					this->error.column++;
+					position.column++;
 				}
 			}
 		}
+	}
+	
+	/**
+	 * Sets the error output variable to the given position and error message.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] msg - error message to output
+	 * @return false
+	 */
+	constexpr inline bool at(const size_t pos, const EMessage msg) noexcept {
+		this->error.character = this->origin.character;
+		this->error.line = this->origin.line;
+		this->error.column = this->origin.column;
+		this->error.message = msg;
+		advance(this->error, this->source, pos);
 		return false;
 	}
 };
@@ -460,6 +626,66 @@ constexpr inline bool equalsI(const Token & token, const char * str) noexcept {
 }
 
 
+/**
+ * Compares the given tokens. Both are compared case sensitive.
+ * The tokens need to match exactly and completely to return true.
+ * 
+ * @param[in] left - token to compare
+ * @param[in] right - compare with this token
+ * @return true on match, else false
+ */
+constexpr inline bool equals(const Token & left, const Token & right) noexcept {
+	if (left.length != right.length) {
+		return false;
+	}
+	for (size_t n = 0; n < left.length; n++) {
+		if (left.start[n] != right.start[n]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Compares the given tokens. Both are compared case in-sensitive.
+ * The tokens need to match exactly and completely to return true.
+ * 
+ * @param[in] left - token to compare
+ * @param[in] right - compare with this token
+ * @return true on match, else false
+ */
+constexpr inline bool equalsI(const Token & left, const Token & right) noexcept {
+	if (left.length != right.length) {
+		return false;
+	}
+	for (size_t n = 0; n < left.length; n++) {
+		if (toUpper(left.start[n]) != toUpper(right.start[n])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Searches for the given character in the passed token.
+ * The character position is returned on success, or -1 if not found.
+ * 
+ * @param[in] token - input token
+ * @param[in] c - character to search for
+ * @return position of first character occurrence or -1 if not found
+ */
+constexpr inline int strFindChr(const Token & token, const int c) noexcept {
+	for (size_t n = 0; n < token.length; n++) {
+		if (token.start[n] == c) {
+			return int(n);
+		}
+	}
+	return -1;
+}
+
+
 /**
  * Checks whether the given character is a start of comment character.
  * 
@@ -585,7 +811,7 @@ struct Source {
     enum { Count = P }; /**< Parameter count. */
 	
 	/** Default constructor. */
-    constexpr inline Source() noexcept: code{0}, params{0} {}
+    constexpr inline Source() noexcept: code{0}, params{} {}
 	
 	/**
 	 * Returns a pointer to the source code.
@@ -645,9 +871,9 @@ struct Source {
 	 * @return associated value
 	 */
 	constexpr inline ParamMatch find(const Token & token) const noexcept {
-		for (int p = P - 1; p >= 0; p--) {
-			if ( equals(token, this->params[p].name) ) {
-				return ParamMatch{this->params[p].value, true};
+		for (size_t p = P; p > 0; p--) {
+			if ( equals(token, this->params[p - 1].name) ) {
+				return ParamMatch{this->params[p - 1].value, true};
 			}
 		}
 		return ParamMatch{0, false};
@@ -760,6 +986,142 @@ public:
 };
 
 
+/** Caller supplied memory region for bump allocation of runtime compiled descriptors. */
+class Arena {
+private:
+	uint8_t * const data; /**< memory region */
+	const size_t size; /**< memory region size in bytes */
+	size_t used; /**< allocated bytes */
+	friend class ArenaWriter;
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] d - data pointer
+	 * @param[in] s - data length
+	 */
+	constexpr inline explicit Arena(uint8_t * d, const size_t s) noexcept:
+		data(d),
+		size(s),
+		used(0)
+	{}
+	
+	/**
+	 * Allocates the given number of bytes.
+	 * 
+	 * @param[in] len - number of bytes
+	 * @return pointer to the allocated bytes or `nullptr` if not enough space is left
+	 */
+	constexpr inline uint8_t * allocate(const size_t len) noexcept {
+		if (len > (this->size - this->used)) return nullptr;
+		uint8_t * res = this->data + this->used;
+		this->used += len;
+		return res;
+	}
+	
+	/**
+	 * Returns the number of allocated bytes.
+	 * 
+	 * @return allocated bytes
+	 */
+	constexpr inline size_t getUsed() const noexcept {
+		return this->used;
+	}
+	
+	/**
+	 * Returns the number of bytes left for allocation.
+	 * 
+	 * @return available bytes
+	 */
+	constexpr inline size_t getAvailable() const noexcept {
+		return this->size - this->used;
+	}
+	
+	/**
+	 * Releases all allocations.
+	 */
+	constexpr inline void reset() noexcept {
+		this->used = 0;
+	}
+};
+
+
+/**
+ * Writes bytes to the free space of an arena. The output grows until the end of the arena
+ * and is allocated with its exact size by `commit()`. Hence, a single compile pass suffices
+ * if the output size is not known in advance. No other allocation shall be made from the
+ * same arena before `commit()`.
+ */
+class ArenaWriter {
+private:
+	Arena & arena; /**< arena to allocate from */
+	uint8_t * const start; /**< first output byte */
+	uint8_t * ptr; /**< next output byte */
+	uint8_t * const end; /**< end of the arena */
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in,out] a - arena to allocate from
+	 */
+	constexpr inline explicit ArenaWriter(Arena & a) noexcept:
+		arena(a),
+		start(a.data + a.used),
+		ptr(a.data + a.used),
+		end(a.data + a.size)
+	{}
+	
+	/**
+	 * Returns the current write position.
+	 * 
+	 * @return write position
+	 */
+	constexpr inline size_t getPosition() const noexcept {
+		return size_t(this->ptr - this->start);
+	}
+	
+	/**
+	 * Writes the given byte to the arena.
+	 * 
+	 * @param[in] val - byte value to write
+	 * @return true on success, false if the arena is full
+	 */
+	constexpr inline bool write(const uint8_t val) noexcept {
+		if (this->ptr == this->end) return false;
+		*(this->ptr++) = val;
+		return true;
+	}
+	
+	/**
+	 * Checks whether the given number of bytes can be written via `put()`.
+	 * 
+	 * @param[in] len - number of bytes
+	 * @return true if enough space is left, else false
+	 */
+	constexpr inline bool reserve(const size_t len) const noexcept {
+		return size_t(this->end - this->ptr) >= len;
+	}
+	
+	/**
+	 * Writes the given byte to the arena without any check. Call `reserve()` first.
+	 * 
+	 * @param[in] val - byte value to write
+	 */
+	constexpr inline void put(const uint8_t val) noexcept {
+		*(this->ptr++) = val;
+	}
+	
+	/**
+	 * Allocates the written bytes from the arena.
+	 * 
+	 * @return pointer to the written bytes
+	 */
+	constexpr inline const uint8_t * commit() noexcept {
+		return this->arena.allocate(this->getPosition());
+	}
+};
+
+
 /**
  * Returns the number of bytes needed at least to encode the given unsigned integer.
  * 
@@ -804,27 +1166,66 @@ constexpr inline uint32_t encodedSizeValue(const size_t val) noexcept {
 }
 
 
+/**
+ * Encodes the given value with the given length in little-endian format via `Writer::put()`
+ * with a single check of the output space via `Writer::reserve()`.
+ * 
+ * @param[in,out] out - write encoded value using this object
+ * @param[in] val - value to encode
+ * @param[in] len - value length in bytes
+ * @return true if written, false if not enough space is left
+ */
+template <typename Writer>
+constexpr inline auto putValue(Writer & out, const uint32_t val, const size_t len, int) noexcept -> decltype(out.reserve(len), out.put(uint8_t(0)), bool()) {
+	if ( ! out.reserve(len) ) return false;
+	out.put(uint8_t(val & 0xFF));
+	if (len > 1) {
+		out.put(uint8_t((val >> 8) & 0xFF));
+		if (len > 2) {
+			out.put(uint8_t((val >> 16) & 0xFF));
+			out.put(uint8_t((val >> 24) & 0xFF));
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Writers without `reserve()` and `put()` are written byte by byte.
+ * 
+ * @return false
+ */
+template <typename Writer>
+constexpr inline bool putValue(Writer & /* out */, const uint32_t /* val */, const size_t /* len */, long) noexcept {
+	return false;
+}
+
+
 /**
  * Encodes the given value with the given length in little-endian format.
  * 
  * @param[in,out] out - write encoded value using this object
  * @param[in] val - value to encode
  * @param[in] len - value length in bytes
- * @return encoded number of bytes
+ * @return encoded number of bytes or 0 if the writer failed
  * @tparam Write - shell implement `write(uint8_t)`
  * @see HID 1.11 ch. 5.8
  */
 template <typename Writer>
 constexpr inline size_t encodeValue(Writer & out, const uint32_t val, const size_t len) noexcept {
-	out.write(uint8_t(val & 0xFF));
+	if ( putValue(out, val, len, 0) ) {
+		return len;
+	}
+	/* writes what fits if `putValue()` is not supported or the output is about to overflow */
+	bool ok = out.write(uint8_t(val & 0xFF));
 	if (len > 1) {
-		out.write(uint8_t((val >> 8) & 0xFF));
+		ok = out.write(uint8_t((val >> 8) & 0xFF)) && ok;
 		if (len > 2) {
-			out.write(uint8_t((val >> 16) & 0xFF));
-			out.write(uint8_t((val >> 24) & 0xFF));
+			ok = out.write(uint8_t((val >> 16) & 0xFF)) && ok;
+			ok = out.write(uint8_t((val >> 24) & 0xFF)) && ok;
 		}
 	}
-	return len;
+	return ok ? len : 0;
 }
 
 
@@ -833,7 +1234,7 @@ constexpr inline size_t encodeValue(Writer & out, const uint32_t val, const size
  * 
  * @param[in,out] out - write encoded value using this object
  * @param[in] val - value to encode
- * @return encoded number of bytes
+ * @return encoded number of bytes or 0 if the writer failed
  * @see ::hid::detail::encodedSize()
  * @tparam Write - shell implement `write(uint8_t)`
  * @see HID 1.11 ch. 5.8
@@ -849,7 +1250,7 @@ constexpr inline size_t encodeUnsigned(Writer & out, const uint32_t val) noexcep
  * 
  * @param[in,out] out - write encoded value using this object
  * @param[in] val - value to encode
- * @return encoded number of bytes
+ * @return encoded number of bytes or 0 if the writer failed
  * @see ::hid::detail::encodedSize()
  * @tparam Write - shell implement `write(uint8_t)`
  * @see HID 1.11 ch. 5.8
@@ -1085,6 +1486,80 @@ constexpr const Encoding delimMap[] = {
 };
 
 
+/**
+ * Physical descriptor set bias argument token encoding map. The bias is stored in bits 5 to 7
+ * of `bPhysicalInfo`. A numeric argument sets the preference in bits 0 to 4.
+ * 
+ * @see HID 1.11 ch. 6.2.3
+ */
+constexpr const Encoding physicalBiasMap[] = {
+	{"None"      , 0x00},
+	{"RightHand" , 0x20},
+	{"LeftHand"  , 0x40},
+	{"BothHands" , 0x60},
+	{"EitherHand", 0x80},
+	endOfMap
+};
+
+
+/**
+ * Physical descriptor designator and qualifier argument token encoding map. The designator is
+ * stored in bits 8 to 15 and the qualifier in bits 5 to 7. A numeric argument sets the effort
+ * in bits 0 to 4.
+ * 
+ * @see HID 1.11 ch. 6.2.3
+ */
+constexpr const Encoding designatorMap[] = {
+	{"None"        , 0x0000},
+	{"Hand"        , 0x0100},
+	{"Eyeball"     , 0x0200},
+	{"Eyebrow"     , 0x0300},
+	{"Eyelid"      , 0x0400},
+	{"Ear"         , 0x0500},
+	{"Nose"        , 0x0600},
+	{"Mouth"       , 0x0700},
+	{"UpperLip"    , 0x0800},
+	{"LowerLip"    , 0x0900},
+	{"Jaw"         , 0x0A00},
+	{"Neck"        , 0x0B00},
+	{"UpperArm"    , 0x0C00},
+	{"Elbow"       , 0x0D00},
+	{"Forearm"     , 0x0E00},
+	{"Wrist"       , 0x0F00},
+	{"Palm"        , 0x1000},
+	{"Thumb"       , 0x1100},
+	{"IndexFinger" , 0x1200},
+	{"MiddleFinger", 0x1300},
+	{"RingFinger"  , 0x1400},
+	{"LittleFinger", 0x1500},
+	{"Head"        , 0x1600},
+	{"Shoulder"    , 0x1700},
+	{"Hip"         , 0x1800},
+	{"Waist"       , 0x1900},
+	{"Thigh"       , 0x1A00},
+	{"Knee"        , 0x1B00},
+	{"Calf"        , 0x1C00},
+	{"Ankle"       , 0x1D00},
+	{"Foot"        , 0x1E00},
+	{"Heel"        , 0x1F00},
+	{"BallOfFoot"  , 0x2000},
+	{"BigToe"      , 0x2100},
+	{"SecondToe"   , 0x2200},
+	{"ThirdToe"    , 0x2300},
+	{"FourthToe"   , 0x2400},
+	{"LittleToe"   , 0x2500},
+	{"Brow"        , 0x2600},
+	{"Cheek"       , 0x2700},
+	/* qualifiers */
+	{"Right"       , 0x20},
+	{"Left"        , 0x40},
+	{"Both"        , 0x60},
+	{"Either"      , 0x80},
+	{"Center"      , 0xA0},
+	endOfMap
+};
+
+
 /**
  * HID descriptor usage generic desktop argument token encoding map.
  * 
@@ -4125,316 +4600,2029 @@ constexpr const Encoding itemMap[] = {
 	{"StringMinimum"    , 0x88, numArg},
 	{"StringMaximum"    , 0x98, numArg},
 	{"Delimiter"        , 0xA8, delimMap},
+	/* HID 1.11 ch. 6.2.3 (physical descriptor sets; not written to the report descriptor) */
+	{"PhysicalSet"      , 0x0C, physicalBiasMap},
+	{"Designator"       , 0x1C, designatorMap},
 	endOfMap
 };
 
 
 /**
- * Searches for an encoding in the given map which matches the passed
- * token. The token is matched case in-sensitive.
+ * All encoding maps in the order of their map ID. Map ID 0 refers to
+ * no argument map.
+ */
+constexpr const Encoding * const encodingMaps[] = {
+	numArg, signedNumArg, clearArg, usageArg, endCol, colArgMap, inputArgMap, outputFeatureArgMap,
+	unitExpMap, unitMap, unitSystemMap, delimMap, physicalBiasMap, designatorMap, genDeskMap, simCtrlMap,
+	vrCtrlMap, sportCtrlMap, gameCtrlMap, genDevCtrlMap, keyboardMap, ledMap, buttonMap, ordinalMap,
+	telDevMap, consumerMap, digitizersMap, hapticsMap, pidMap, unicodeMap, eyeHeadMap, auxDisplayMap,
+	sensorMap, medInstMap, brailleMap, lightMap, monitorMap, monitorEnumMap, vesaCtrlMap, pwrDevMap,
+	barcodeMap, weightDevMap, msrMap, cameraCtrlMap, arcadeMap, fidoMap, usagePageMap, itemMap
+};
+
+
+/**
+ * Returns the map ID of the given encoding map.
  * 
- * @param[in] token - token to find
- * @param[in] map - search within this map
- * @param[out] res - variable to store dynamic results
- * @param[in,out] error - variable to receive a possible parsing error
- * @return map entry pointer if found or NULL
+ * @param[in] map - encoding map
+ * @return map ID, 0 for NULL or `EncodingMapCount + 1` for unknown maps
  */
-constexpr static const Encoding * findEncoding(const Token & token, const Encoding * map, Encoding & res, error::EMessage & error) noexcept {
-	using namespace ::hid::error;
-	if (token.length == 0) {
-		return NULL;
+constexpr inline uint8_t encodingMapId(const Encoding * map) noexcept {
+	constexpr size_t count = sizeof(encodingMaps) / sizeof(*encodingMaps);
+	if (map == NULL) {
+		return 0;
 	}
-	size_t i = 0;
-	while (map->name != NULL) {
-		if ( equalsI(token, map->name) ) {
-			error = E_NO_ERROR;
-			return map;
+	for (size_t i = 0; i < count; i++) {
+		if (encodingMaps[i] == map) {
+			return uint8_t(i + 1);
 		}
-		if (i < 3) {
-			const int idx = strFindChr(map->name, '#');
-			if (idx >= 0) {
-				/* handle argument with index */
-				if (map->name[idx + 1] != 0 || ( ! equals(map[0].name, map[1].name) )) {
-					/* invalid index map item */
-					error = E_Internal_error;
-					return NULL;
-				}
-				if (token.length <= size_t(idx) || ( ! startWidthIN(map->name, size_t(idx), token.start) )) {
-					/* name does not match */
-					error = E_Invalid_argument_name;
-					return NULL;
-				}
-				uint32_t num = 0;
-				for (size_t n = size_t(idx); n < token.length; n++) {
-					const char c = token.start[n];
-					if ( ! isDigit(c) ) {
-						/* not a numeric value */
-						error = E_Unexpected_argument_name_character;
-						return NULL;
-					}
-					const uint32_t oldNum = num;
-					num = uint32_t((num * 10) + c - '0');
-					if (oldNum > num) {
-						/* number overflow */
-						error = E_Argument_index_out_of_range;
-						return NULL;
-					}
-				}
-				if (num < map[0].value || num > map[1].value) {
-					/* out of allowed value range */
-					error = E_Argument_index_out_of_range;
-					return NULL;
-				}
-				if (num != 0 && token.start[idx] == '0') {
-					/* leading zeros are not allowed */
-					error = E_Invalid_argument_name;
-					return NULL;
-				}
-				res.name = map->name;
-				res.value = num;
-				error = E_NO_ERROR;
-				return &res;
-			}
+	}
+	return uint8_t(count + 1);
+}
+
+
+/**
+ * Encoding map IDs as used by `compile()`.
+ */
+enum EncodingMapId : uint8_t {
+	EM_NONE = 0,
+	EM_NUM_ARG = encodingMapId(numArg),
+	EM_SIGNED_NUM_ARG = encodingMapId(signedNumArg),
+	EM_CLEAR_ARG = encodingMapId(clearArg),
+	EM_USAGE_ARG = encodingMapId(usageArg),
+	EM_END_COL = encodingMapId(endCol),
+	EM_COL_ARG = encodingMapId(colArgMap),
+	EM_INPUT_ARG = encodingMapId(inputArgMap),
+	EM_OUTPUT_FEATURE_ARG = encodingMapId(outputFeatureArgMap),
+	EM_UNIT_EXP = encodingMapId(unitExpMap),
+	EM_UNIT_SYSTEM = encodingMapId(unitSystemMap),
+	EM_DELIM = encodingMapId(delimMap),
+	EM_PHYSICAL_SET = encodingMapId(physicalBiasMap),
+	EM_DESIGNATOR = encodingMapId(designatorMap),
+	EM_USAGE_PAGE = encodingMapId(usagePageMap),
+	EM_ITEM = encodingMapId(itemMap),
+	EncodingMapCount = uint8_t(sizeof(encodingMaps) / sizeof(*encodingMaps))
+};
+
+
+/**
+ * Returns the total number of entries of all encoding maps.
+ * 
+ * @return number of entries without end of map markers
+ */
+constexpr inline size_t encodingEntryCount() noexcept {
+	size_t res = 0;
+	for (size_t m = 0; m < EncodingMapCount; m++) {
+		for (const Encoding * enc = encodingMaps[m]; enc->name != NULL; enc++) {
+			res++;
 		}
-		map++;
-		i++;
 	}
-	return NULL;
+	return res;
 }
 
 
 /**
- * Compiles the HID description into the given buffer.
+ * Returns the total name length of all encoding map entries.
  * 
- * @param[in] source - source code description
- * @param[out] out - output writer instance
- * @param[out] error - possible error
- * @return true on success, else false
- * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
- * @tparam Writer - shall implement `write(uint8_t)`
+ * @return number of name characters without null-terminators
  */
-template <typename Source, typename Writer>
-constexpr bool compile(const Source & source, Writer & out, ::hid::error::Info & error) noexcept {
-	using namespace ::hid::error;
-	enum State {
-		HID_START                 = 0x000,
-		HID_WITHIN_COMMENT        = 0x001,
-		HID_WITHIN_ITEM           = 0x002,
-		HID_WITHIN_ARG_LIST       = 0x004,
-		HID_WITHIN_ARG            = 0x008,
-		HID_WITHIN_PARAM          = 0x010,
-		HID_WITHIN_HEX_LIT        = 0x020,
-		HID_WITHIN_NUM_LIT        = 0x040,
-		HID_WITHIN_UNIT_SYS       = 0x080,
-		HID_WITHIN_UNIT_DESC      = 0x100,
-		HID_WITHIN_UNIT           = 0x200,
-		HID_WITHIN_UNIT_EXP       = 0x400
-	};
-#define _HID_WITHIN(x) ((flags & HID_WITHIN_##x) != 0)
-	int colLevel = 0;
-	int delimLevel = 0;
-	int usageAtLevel = -1;
-	size_t reportSizes = 0;
-	size_t reportCounts = 0;
-	const char * ptr = source.data();
-	const size_t len = source.size();
-	ErrorWriter errorMsg{ptr, error};
-	Token tItem = {ptr, 0};
-	Token tArg = {ptr, 0};
-	bool hasUsagePage{false};
-	bool hasArg{false};
-	bool multiArg{false};
-	bool negLit{false};
-	EMessage subError{E_NO_ERROR};
-	Encoding dynMap;
-	const Encoding * encMap{NULL}; /* current */
-	const Encoding * usagePage{NULL}; /* current; used for all subsequent Usage items, regardless of the hierarchy */
-	const Encoding * encUnit{NULL}; /* current */
-	uint32_t flags = HID_START;
-	uint32_t item{0}, arg{0}, lit{0};
-	size_t n{0};
-	for (; n < len && *ptr != 0; ) {
-#ifdef HID_DESCRIPTOR_DEBUG
-		constexpr const char * flagsStr[] = {"COMMENT", "ITEM", "ARG_LIST", "ARG", "PARAM", "HEX_LIT", "NUM_LIT", "UNIT_SYS", "UNIT_DESC", "UNIT", "UNIT_EXP"};
-		printf("in: %3u, out: %3u, c:", unsigned(n), unsigned(out.getPosition()));
-		if (isprint(*ptr) != 0) {
-			printf(" '%c'", *ptr);
-		} else {
-			printf("    ");
+constexpr inline size_t encodingNameSize() noexcept {
+	size_t res = 0;
+	for (size_t m = 0; m < EncodingMapCount; m++) {
+		for (const Encoding * enc = encodingMaps[m]; enc->name != NULL; enc++) {
+			res += strLen(enc->name);
 		}
-		if (flags == HID_START) {
-			printf(", flags = START");
-		} else {
-			bool first = true;
-			for (size_t i = 0; i < (sizeof(flagsStr) / sizeof(*flagsStr)); i++) {
-				if (((flags >> i) & 1) != 0) {
-					printf("%s%s", first ? ", flags = " : " | ", flagsStr[i]);
-					first = false;
-				}
-			}
-			if ( multiArg ) {
-				printf(" | MULTI_ARG");
-			}
-			if ( negLit ) {
-				printf(" | NEG_LIT");
+	}
+	return res;
+}
+
+
+/**
+ * Returns the number of distinct usage types of all encoding map entries.
+ * 
+ * @return number of usage types including `UT_NONE` (at most 257)
+ */
+constexpr inline size_t encodingTypeCount() noexcept {
+	uint32_t types[256] = {UT_NONE};
+	size_t res = 1;
+	for (size_t m = 0; m < EncodingMapCount; m++) {
+		for (const Encoding * enc = encodingMaps[m]; enc->name != NULL; enc++) {
+			size_t idx = 0;
+			while (idx < res && types[idx] != enc->type) {
+				idx++;
 			}
-			if ( hasArg ) {
-				printf(" | HAS_ARG");
+			if (idx == res) {
+				if (res < 256) {
+					types[res] = enc->type;
+				}
+				res++;
 			}
 		}
-		printf("\n");
-#endif /* HID_DESCRIPTOR_DEBUG */
-		if (flags == HID_START) {
-			if ( isItemChar(*ptr) ) {
-				/* start of item name */
-				flags = HID_WITHIN_ITEM;
-				tItem.start = ptr;
-				tItem.length = 1;
-			} else if (*ptr == '{') {
-				/* start of user parameter */
-				flags = HID_WITHIN_PARAM;
-				tArg.start = ptr + 1;
-				tArg.length = 0;
-			} else if (ptr[0] == '0' && (n + 1) < len && ptr[1] == 'x') {
-				/* start of hex literal */
-				flags = HID_WITHIN_HEX_LIT;
-				if ((n + 2) >= len) {
-					return errorMsg.at(n + 2, E_Unexpected_end_of_source);
+	}
+	return res;
+}
+
+
+/**
+ * Compact string pool representation of all encoding maps.
+ * The entries are stored as structure of arrays in the order of the
+ * encoding maps. All names are concatenated without null-terminator.
+ * 
+ * @tparam Names - total name length
+ * @tparam Entries - number of entries
+ * @tparam Types - number of distinct usage types
+ * @see encodingMaps
+ */
+template <size_t Names, size_t Entries, size_t Types>
+struct EncodingTable {
+	char names[Names]; /**< concatenated entry names */
+	uint16_t nameOffset[Entries]; /**< entry name offset within `names` */
+	uint8_t nameLength[Entries]; /**< entry name length */
+	uint16_t value[Entries]; /**< encoded value */
+	uint8_t type[Entries]; /**< index into `types` */
+	uint8_t arg[Entries]; /**< argument map ID */
+	uint16_t mapStart[EncodingMapCount + 2]; /**< first entry index by map ID */
+	uint32_t types[Types]; /**< distinct usage types */
+	bool valid; /**< true if all values fit into the compact representation */
+	
+	/** Default constructor. Generates the table from `encodingMaps`. */
+	constexpr inline EncodingTable() noexcept:
+		names{0},
+		nameOffset{0},
+		nameLength{0},
+		value{0},
+		type{0},
+		arg{0},
+		mapStart{0},
+		types{UT_NONE},
+		valid{Names <= 0xFFFF && Entries <= 0xFFFF && Types <= 0x100}
+	{
+		size_t e = 0, n = 0, t = 1;
+		for (size_t m = 0; m < EncodingMapCount; m++) {
+			this->mapStart[m + 1] = uint16_t(e);
+			for (const Encoding * enc = encodingMaps[m]; enc->name != NULL; enc++, e++) {
+				const size_t len = strLen(enc->name);
+				this->nameOffset[e] = uint16_t(n);
+				this->nameLength[e] = uint8_t(len);
+				for (size_t i = 0; i < len; i++) {
+					this->names[n++] = enc->name[i];
 				}
-				if ( ! isHexDigit(ptr[2]) ) {
-					return errorMsg.at(n + 2, E_Invalid_hex_value);
+				this->value[e] = uint16_t(enc->value);
+				size_t idx = 0;
+				while (idx < t && this->types[idx] != enc->type) {
+					idx++;
 				}
-				lit = 0;
-				n++;
-				ptr++;
-			} else if ( isDigit(*ptr) ) {
-				/* start of number literal */
-				/* note: negative number literals are only allowed as argument */
-				flags = HID_WITHIN_NUM_LIT;
-				lit = 0;
-				continue; /* re-parse as number literal */
-			} else if (*ptr == '-') {
-				return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
-			} else if ( isComment(*ptr) ) {
-				flags = HID_WITHIN_COMMENT;
-			} else if ( ! isWhitespace(*ptr) ) {
-				return errorMsg.at(n, E_Unexpected_token);
-			}
-		} else if ( _HID_WITHIN(COMMENT) ) {
-			if (*ptr == '\r' || *ptr == '\n') {
-				flags = HID_START;
-			}
-		} else if ( _HID_WITHIN(PARAM) ) {
-			if (*ptr == '}') {
-				/* end of user parameter */
-				flags &= ~HID_WITHIN_PARAM;
-				const ParamMatch & param = source.find(tArg);
-				if ( ! param.valid ) {
-					return errorMsg.at(n, E_Expected_valid_parameter_name_here);
+				if (idx == t && t < Types) {
+					this->types[t++] = enc->type;
 				}
-				if ( _HID_WITHIN(ARG_LIST) ) {
-					/* merge multiple arguments via OR */
-					if (encMap->arg == signedNumArg) {
-						if (param.value < INT64_C(-0x80000000) || param.value > INT64_C(0x7FFFFFFF)) {
-							return errorMsg.at(n, E_Parameter_value_out_of_range);
-						}
-					} else {
-						if (param.value < 0 || param.value > UINT32_C(0xFFFFFFFF)) {
-							return errorMsg.at(n, E_Parameter_value_out_of_range);
-						}
-					}
-					arg |= uint32_t(param.value);
-					hasArg = true;
-				} else {
-					/* encode as literal */
-					if (param.value < 0) {
-						return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
-					}
-					if (param.value > UINT32_C(0xFFFFFFFF)) {
-						return errorMsg.at(n, E_Parameter_value_out_of_range);
-					}
-					encodeUnsigned(out, uint32_t(param.value));
+				this->type[e] = uint8_t(idx);
+				this->arg[e] = encodingMapId(enc->arg);
+				if (len > 0xFF || enc->value > 0xFFFF || this->arg[e] > EncodingMapCount) {
+					this->valid = false;
 				}
-			} else {
-				tArg.length++;
 			}
-		} else if ( _HID_WITHIN(ITEM) ) {
-			if ( isItemChar(*ptr) ) {
-				tItem.length++;
-			} else if (isWhitespace(*ptr) || *ptr == '(') {
-				/* skip whitespaces */
-				if ( isWhitespace(*ptr) ) {
-					while ((n + 1) < len && isWhitespace(ptr[1])) {
-						n++;
-						ptr++;
-					}
-					if ((n + 1) < len && ptr[1] == '(') {
-						n++;
-						ptr++;
-					}
+		}
+		this->mapStart[EncodingMapCount + 1] = uint16_t(e);
+	}
+	
+	/**
+	 * Returns the first entry index of the given map.
+	 * 
+	 * @param[in] map - map ID
+	 * @return first entry index
+	 */
+	constexpr inline size_t begin(const uint8_t map) const noexcept {
+		return this->mapStart[(map > EncodingMapCount) ? 0 : map];
+	}
+	
+	/**
+	 * Returns the entry index after the last entry of the given map.
+	 * 
+	 * @param[in] map - map ID
+	 * @return end entry index
+	 */
+	constexpr inline size_t end(const uint8_t map) const noexcept {
+		return (map == 0 || map > EncodingMapCount) ? this->mapStart[0] : this->mapStart[map + 1];
+	}
+	
+	/**
+	 * Returns the name of the given entry as token.
+	 * 
+	 * @param[in] entry - entry index
+	 * @return entry name
+	 */
+	constexpr inline Token name(const size_t entry) const noexcept {
+		return Token{this->names + this->nameOffset[entry], this->nameLength[entry]};
+	}
+};
+
+
+/** Generated compact representation of all encoding maps. */
+constexpr const EncodingTable<encodingNameSize(), encodingEntryCount(), encodingTypeCount()> encodingTable;
+
+
+static_assert(encodingTable.valid, "Encoding maps exceed the compact table representation.");
+
+
+/**
+ * Single encoding as found by `findEncoding()`.
+ */
+struct EncodingRef {
+	uint32_t value; /**< encoded value */
+	uint32_t type; /**< usage type (in case of a usage type element) */
+	uint8_t arg; /**< argument map ID or EM_NONE */
+	
+	/** Default constructor. */
+	constexpr inline EncodingRef() noexcept:
+		value{0},
+		type{UT_NONE},
+		arg{EM_NONE}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] entry - encoding table entry index
+	 */
+	constexpr inline explicit EncodingRef(const size_t entry) noexcept:
+		value{encodingTable.value[entry]},
+		type{encodingTable.types[encodingTable.type[entry]]},
+		arg{encodingTable.arg[entry]}
+	{}
+	
+	/**
+	 * Checks whether the argument map has any named entries.
+	 * 
+	 * @return true if named arguments exist, else false
+	 */
+	constexpr inline bool hasNamedArgs() const noexcept {
+		return encodingTable.end(this->arg) > encodingTable.begin(this->arg);
+	}
+};
+
+
+/**
+ * Searches for an encoding in the given map which matches the passed
+ * token. The token is matched case in-sensitive.
+ * 
+ * @param[in] token - token to find
+ * @param[in] map - search within this map (see `EncodingMapId`)
+ * @param[out] res - variable to receive the found encoding
+ * @param[in,out] error - variable to receive a possible parsing error
+ * @param[out] probes - variable to receive the number of compared map entries
+ * @return true if found, else false
+ */
+constexpr static bool findEncoding(const Token & token, const uint8_t map, EncodingRef & res, error::EMessage & error, size_t & probes) noexcept {
+	using namespace ::hid::error;
+	probes = 0;
+	if (token.length == 0) {
+		return false;
+	}
+	const size_t first = encodingTable.begin(map);
+	const size_t last = encodingTable.end(map);
+	for (size_t e = first; e < last; e++) {
+		const Token name = encodingTable.name(e);
+		probes++;
+		if ( equalsI(token, name) ) {
+			error = E_NO_ERROR;
+			res = EncodingRef(e);
+			return true;
+		}
+		if ((e - first) < 3) {
+			const int idx = strFindChr(name, '#');
+			if (idx >= 0) {
+				/* handle argument with index */
+				if (size_t(idx + 1) != name.length || (e + 1) >= last || ( ! equals(name, encodingTable.name(e + 1)) )) {
+					/* invalid index map item */
+					error = E_Internal_error;
+					return false;
 				}
-				flags &= ~HID_WITHIN_ITEM;
-				subError = E_Invalid_item_name;
-				encMap = findEncoding(tItem, itemMap, dynMap, subError);
-				if (encMap == NULL) {
-					return errorMsg.at(n, subError);
-				} else if (encMap->arg == colArgMap) {
-					/* Collection */
-					if (usageAtLevel != colLevel) {
-						return errorMsg.at(n, E_Missing_Usage_for_Collection);
-					}
-					colLevel++;
-				} else if (encMap->arg == endCol) {
-					/* EndCollection */
-					if (colLevel <= 0) {
-						return errorMsg.at(n, E_Unexpected_EndCollection);
-					}
-					if (reportSizes < reportCounts) {
-						return errorMsg.at(n, E_Missing_ReportSize);
-					} else if (reportCounts < reportSizes) {
-						return errorMsg.at(n, E_Missing_ReportCount);
-					}
-					colLevel--;
-					usageAtLevel--;
-				} else if ( equalsI(tItem, "Usage") ) {
-					/* needed to check if there is a Usage item for every Collection */
-					usageAtLevel = colLevel;
+				if (token.length <= size_t(idx) || ( ! startWidthIN(name.start, size_t(idx), token.start) )) {
+					/* name does not match */
+					error = E_Invalid_argument_name;
+					return false;
 				}
-				if (*ptr == '(') {
-					/* start of argument list */
-					flags |= HID_WITHIN_ARG_LIST;
-					if (encMap->arg == NULL) {
-						return errorMsg.at(n, E_This_item_has_no_arguments);
-					} else if (encMap->arg == unitSystemMap) {
-						/* Unit */
-						flags |= HID_WITHIN_UNIT_SYS;
+				uint32_t num = 0;
+				for (size_t n = size_t(idx); n < token.length; n++) {
+					const char c = token.start[n];
+					if ( ! isDigit(c) ) {
+						/* not a numeric value */
+						error = E_Unexpected_argument_name_character;
+						return false;
 					}
-					/* standard item */
-					item = encMap->value;
-					arg = 0;
-					hasArg = false;
-					multiArg = (encMap->arg == inputArgMap || encMap->arg == outputFeatureArgMap);
-				} else {
-					/* end of item */
-					if (encMap->arg != NULL && (encMap->arg->name != NULL || encMap->arg == usageArg)) {
-						return errorMsg.at(n, E_Missing_argument);
+					const uint32_t oldNum = num;
+					num = uint32_t((num * 10) + c - '0');
+					if (oldNum > num) {
+						/* number overflow */
+						error = E_Argument_index_out_of_range;
+						return false;
 					}
-					encodeUnsigned(out, encMap->value);
 				}
-			} else {
-				return errorMsg.at(n, E_Unexpected_item_name_character);
-			}
-		} else if ( _HID_WITHIN(ARG) ) {
-			if ( _HID_WITHIN(UNIT_DESC) ) {
-				if ( _HID_WITHIN(UNIT) ) {
-					if ( isAlpha(*ptr) ) {
-						tArg.length++;
-					} else if (isWhitespace(*ptr) || *ptr == ')' || *ptr == '^') {
-						/* end of unit name */
+				if (num < encodingTable.value[e] || num > encodingTable.value[e + 1]) {
+					/* out of allowed value range */
+					error = E_Argument_index_out_of_range;
+					return false;
+				}
+				if (num != 0 && token.start[idx] == '0') {
+					/* leading zeros are not allowed */
+					error = E_Invalid_argument_name;
+					return false;
+				}
+				res = EncodingRef(e);
+				res.value = num;
+				error = E_NO_ERROR;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Searches for an encoding in the given map which matches the passed
+ * token. The token is matched case in-sensitive.
+ * 
+ * @param[in] token - token to find
+ * @param[in] map - search within this map (see `EncodingMapId`)
+ * @param[out] res - variable to receive the found encoding
+ * @param[in,out] error - variable to receive a possible parsing error
+ * @return true if found, else false
+ */
+constexpr static bool findEncoding(const Token & token, const uint8_t map, EncodingRef & res, error::EMessage & error) noexcept {
+	size_t probes = 0;
+	return findEncoding(token, map, res, error, probes);
+}
+
+
+/**
+ * Compiler states as passed to the tracer. The `TS_WITHIN_*` values may be combined.
+ * 
+ * @see ::hid::detail::NullTracer
+ */
+enum TraceState : uint32_t {
+	TS_START            = 0x0000, /**< outside of any token */
+	TS_WITHIN_COMMENT   = 0x0001, /**< within a comment */
+	TS_WITHIN_ITEM      = 0x0002, /**< within an item name */
+	TS_WITHIN_ARG_LIST  = 0x0004, /**< within an argument list */
+	TS_WITHIN_ARG       = 0x0008, /**< within an argument name */
+	TS_WITHIN_PARAM     = 0x0010, /**< within a user parameter */
+	TS_WITHIN_HEX_LIT   = 0x0020, /**< within a hex literal */
+	TS_WITHIN_NUM_LIT   = 0x0040, /**< within a number literal */
+	TS_WITHIN_UNIT_SYS  = 0x0080, /**< within a unit system name */
+	TS_WITHIN_UNIT_DESC = 0x0100, /**< within a unit description */
+	TS_WITHIN_UNIT      = 0x0200, /**< within a unit name */
+	TS_WITHIN_UNIT_EXP  = 0x0400, /**< within a unit exponent */
+	TS_MULTI_ARG        = 0x0800, /**< item allows multiple arguments */
+	TS_NEG_LIT          = 0x1000, /**< negative number literal */
+	TS_HAS_ARG          = 0x2000, /**< argument has been given */
+	TraceStateCount     = 14 /**< number of state bits */
+};
+
+
+/**
+ * Tracer which does nothing. This is the default tracer of `compile()` and defines the
+ * interface of all tracers. Each hook is called by `compile()` at the corresponding event.
+ * 
+ * @see ::hid::detail::compile()
+ */
+struct NullTracer {
+	/**
+	 * Called for every parsed input character. Characters may be parsed more than once.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] outPos - output position
+	 * @param[in] c - input character
+	 * @param[in] state - compiler state (see `TraceState`)
+	 */
+	constexpr inline void step(const size_t /* pos */, const size_t /* outPos */, const char /* c */, const uint32_t /* state */) noexcept {}
+	
+	/**
+	 * Called before an item is written.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] prefix - item prefix
+	 * @param[in] data - item data
+	 */
+	constexpr inline void item(const size_t /* pos */, const uint32_t /* prefix */, const uint32_t /* data */) noexcept {}
+	
+	/**
+	 * Called before a literal value is written.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] value - literal value
+	 */
+	constexpr inline void literal(const size_t /* pos */, const uint32_t /* value */) noexcept {}
+	
+	/**
+	 * Called before a named argument clears bits of the current argument (e.g. `Data` within
+	 * `Input(Data, Var, Abs)`).
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] mask - cleared bits
+	 */
+	constexpr inline void clear(const size_t /* pos */, const uint32_t /* mask */) noexcept {}
+	
+	/**
+	 * Called after each lookup in an encoding map.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] map - encoding map (see `EncodingMapId`)
+	 * @param[in] probes - number of compared map entries
+	 * @param[in] found - true if a matching entry was found
+	 */
+	constexpr inline void lookup(const size_t /* pos */, const uint8_t /* map */, const size_t /* probes */, const bool /* found */) noexcept {}
+	
+	/**
+	 * Called for each field annotation (e.g. `@leftStick`).
+	 * 
+	 * @param[in] pos - source code position of the `@`
+	 * @param[in] name - annotation name
+	 * @param[in] outPos - output position right after the annotated main item
+	 */
+	constexpr inline void annotation(const size_t /* pos */, const Token & /* name */, const size_t /* outPos */) noexcept {}
+	
+	/**
+	 * Called for each string argument (e.g. `StringIndex("Left Trigger")`).
+	 * 
+	 * @param[in] pos - source code position of the opening quote
+	 * @param[in] str - string without quotes
+	 * @param[in] index - assigned string descriptor index
+	 */
+	constexpr inline void string(const size_t /* pos */, const Token & /* str */, const size_t /* index */) noexcept {}
+	
+	/**
+	 * Called for each `PhysicalSet` and `Designator` item. These are not written to the
+	 * report descriptor.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] prefix - pseudo item prefix (0x0C for `PhysicalSet`, 0x1C for `Designator`)
+	 * @param[in] index - physical descriptor set index or designator index
+	 * @param[in] value - `bPhysicalInfo` or `bDesignator << 8 | bFlags`
+	 */
+	constexpr inline void physical(const size_t /* pos */, const uint32_t /* prefix */, const size_t /* index */, const uint32_t /* value */) noexcept {}
+	
+	/**
+	 * Called once a compile error was detected.
+	 * 
+	 * @param[in] pos - source code position of the error
+	 * @param[in] error - compile error
+	 */
+	constexpr inline void error(const size_t /* pos */, const ::hid::error::Info & /* error */) noexcept {}
+};
+
+
+/**
+ * Tracer which counts the parsed characters per compiler state.
+ * 
+ * @see ::hid::detail::NullTracer
+ */
+struct StateCounter : NullTracer {
+	uint32_t start; /**< characters parsed in `TS_START` */
+	uint32_t states[TraceStateCount]; /**< characters parsed with the corresponding `TraceState` bit set */
+	uint32_t transitions; /**< number of state changes */
+	uint32_t last; /**< last state */
+	
+	/**
+	 * Constructor.
+	 */
+	constexpr inline StateCounter() noexcept:
+		start{0},
+		states{0},
+		transitions{0},
+		last{TS_START}
+	{}
+	
+	/**
+	 * @copydoc NullTracer::step()
+	 */
+	constexpr inline void step(const size_t /* pos */, const size_t /* outPos */, const char /* c */, const uint32_t state) noexcept {
+		if (state == TS_START) {
+			this->start++;
+		}
+		for (size_t i = 0; i < TraceStateCount; i++) {
+			if (((state >> i) & 1) != 0) {
+				this->states[i]++;
+			}
+		}
+		if (state != this->last) {
+			this->transitions++;
+			this->last = state;
+		}
+	}
+};
+
+
+/**
+ * Tracer which creates a histogram of the encoding map lookup lengths.
+ * Bucket `i` counts lookups with `2^(i-1) < probes <= 2^i` compared map entries.
+ * 
+ * @see ::hid::detail::NullTracer
+ */
+struct LookupHistogram : NullTracer {
+	enum { Buckets = 16 }; /**< Number of histogram buckets. */
+	uint32_t buckets[Buckets]; /**< number of lookups per bucket */
+	uint32_t found; /**< number of successful lookups */
+	uint32_t missed; /**< number of failed lookups */
+	
+	/**
+	 * Constructor.
+	 */
+	constexpr inline LookupHistogram() noexcept:
+		buckets{0},
+		found{0},
+		missed{0}
+	{}
+	
+	/**
+	 * @copydoc NullTracer::lookup()
+	 */
+	constexpr inline void lookup(const size_t /* pos */, const uint8_t /* map */, const size_t probes, const bool success) noexcept {
+		size_t bucket = 0;
+		while (bucket < (Buckets - 1) && (size_t(1) << bucket) < probes) {
+			bucket++;
+		}
+		this->buckets[bucket]++;
+		if ( success ) {
+			this->found++;
+		} else {
+			this->missed++;
+		}
+	}
+};
+
+
+/**
+ * Event types of the `EventLog`.
+ */
+enum TraceEvent : uint8_t {
+	TE_STATE   = 1, /**< state change; value is the new `TraceState` */
+	TE_ITEM    = 2, /**< item written; value is the item prefix */
+	TE_LITERAL = 3, /**< literal written; value is the literal */
+	TE_LOOKUP  = 4, /**< map lookup; value is `(probes << 8) | map` */
+	TE_MISS    = 5, /**< failed map lookup; value is `(probes << 8) | map` */
+	TE_ERROR   = 6  /**< compile error; value is the error message */
+};
+
+
+/**
+ * Decoded `EventLog` entry.
+ */
+struct Event {
+	uint8_t type; /**< event type (see `TraceEvent`) */
+	size_t position; /**< source code position */
+	uint32_t value; /**< event value */
+};
+
+
+/**
+ * Tracer which records all events in a compact binary log. Each event is stored as
+ * type byte followed by the source position delta and the value as LEB128 encoded numbers.
+ * Recording stops once the log is full.
+ * 
+ * @tparam Size - log size in bytes
+ * @see ::hid::detail::NullTracer
+ */
+template <size_t Size>
+struct EventLog : NullTracer {
+	uint8_t data[Size]; /**< recorded events */
+	size_t length; /**< number of used bytes */
+	bool overflow; /**< true if events were dropped */
+	size_t lastPos; /**< source position of the last event */
+	uint32_t lastState; /**< last state */
+	
+	/**
+	 * Constructor.
+	 */
+	constexpr inline EventLog() noexcept:
+		data{0},
+		length{0},
+		overflow{false},
+		lastPos{0},
+		lastState{TS_START}
+	{}
+	
+	/**
+	 * @copydoc NullTracer::step()
+	 */
+	constexpr inline void step(const size_t pos, const size_t /* outPos */, const char /* c */, const uint32_t state) noexcept {
+		if (state != this->lastState) {
+			this->lastState = state;
+			this->add(TE_STATE, pos, state);
+		}
+	}
+	
+	/**
+	 * @copydoc NullTracer::item()
+	 */
+	constexpr inline void item(const size_t pos, const uint32_t prefix, const uint32_t /* data */) noexcept {
+		this->add(TE_ITEM, pos, prefix);
+	}
+	
+	/**
+	 * @copydoc NullTracer::literal()
+	 */
+	constexpr inline void literal(const size_t pos, const uint32_t value) noexcept {
+		this->add(TE_LITERAL, pos, value);
+	}
+	
+	/**
+	 * @copydoc NullTracer::lookup()
+	 */
+	constexpr inline void lookup(const size_t pos, const uint8_t map, const size_t probes, const bool found) noexcept {
+		this->add(found ? TE_LOOKUP : TE_MISS, pos, uint32_t((probes << 8) | map));
+	}
+	
+	/**
+	 * @copydoc NullTracer::error()
+	 */
+	constexpr inline void error(const size_t pos, const ::hid::error::Info & err) noexcept {
+		this->add(TE_ERROR, pos, uint32_t(err.message));
+	}
+	
+	/**
+	 * Decodes the event at the given log offset.
+	 * 
+	 * @param[in,out] offset - log offset; set to the next event on success
+	 * @param[in,out] event - previous event on input (zero for the first); decoded event on output
+	 * @return true on success, false at the end of the log
+	 */
+	constexpr inline bool next(size_t & offset, Event & event) const noexcept {
+		if (offset >= this->length) {
+			return false;
+		}
+		event.type = this->data[offset++];
+		event.position += size_t(this->read(offset));
+		event.value = uint32_t(this->read(offset));
+		return true;
+	}
+private:
+	/**
+	 * Appends the given event.
+	 * 
+	 * @param[in] type - event type
+	 * @param[in] pos - source code position
+	 * @param[in] value - event value
+	 */
+	constexpr inline void add(const TraceEvent type, const size_t pos, const uint32_t value) noexcept {
+		uint8_t buf[16] = {0};
+		size_t n = 0;
+		buf[n++] = type;
+		n = this->encode(buf, n, uint64_t(pos - this->lastPos));
+		n = this->encode(buf, n, value);
+		if (this->overflow || (this->length + n) > Size) {
+			this->overflow = true;
+			return;
+		}
+		for (size_t i = 0; i < n; i++) {
+			this->data[this->length++] = buf[i];
+		}
+		this->lastPos = pos;
+	}
+	
+	/**
+	 * Encodes the given value as LEB128.
+	 * 
+	 * @param[out] buf - output buffer
+	 * @param[in] n - output position
+	 * @param[in] value - value to encode
+	 * @return new output position
+	 */
+	constexpr static inline size_t encode(uint8_t * buf, size_t n, uint64_t value) noexcept {
+		do {
+			const uint8_t byte = uint8_t(value & 0x7F);
+			value >>= 7;
+			buf[n++] = uint8_t(byte | ((value != 0) ? 0x80 : 0));
+		} while (value != 0);
+		return n;
+	}
+	
+	/**
+	 * Decodes a LEB128 value.
+	 * 
+	 * @param[in,out] offset - log offset
+	 * @return decoded value
+	 */
+	constexpr inline uint64_t read(size_t & offset) const noexcept {
+		uint64_t res = 0;
+		for (unsigned shift = 0; offset < this->length && shift < 64; shift += 7) {
+			const uint8_t byte = this->data[offset++];
+			res |= uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				break;
+			}
+		}
+		return res;
+	}
+};
+
+
+#ifdef HID_DESCRIPTOR_DEBUG
+/**
+ * Tracer which prints the compiler state for every parsed character.
+ * 
+ * @see ::hid::detail::NullTracer
+ */
+struct PrintTracer : NullTracer {
+	/**
+	 * @copydoc NullTracer::step()
+	 */
+	inline void step(const size_t pos, const size_t outPos, const char c, const uint32_t state) noexcept {
+		static const char * flagsStr[] = {"COMMENT", "ITEM", "ARG_LIST", "ARG", "PARAM", "HEX_LIT", "NUM_LIT", "UNIT_SYS", "UNIT_DESC", "UNIT", "UNIT_EXP", "MULTI_ARG", "NEG_LIT", "HAS_ARG"};
+		printf("in: %3u, out: %3u, c:", unsigned(pos), unsigned(outPos));
+		if (isprint(c) != 0) {
+			printf(" '%c'", c);
+		} else {
+			printf("    ");
+		}
+		if (state == TS_START) {
+			printf(", flags = START");
+		} else {
+			bool first = true;
+			for (size_t i = 0; i < (sizeof(flagsStr) / sizeof(*flagsStr)); i++) {
+				if (((state >> i) & 1) != 0) {
+					printf("%s%s", first ? ", flags = " : " | ", flagsStr[i]);
+					first = false;
+				}
+			}
+		}
+		printf("\n");
+	}
+	
+	/**
+	 * @copydoc NullTracer::annotation()
+	 */
+	inline void annotation(const size_t pos, const Token & name, const size_t outPos) noexcept {
+		printf("in: %3u, out: %3u, annotation: %.*s\n", unsigned(pos), unsigned(outPos), int(name.length), name.start);
+	}
+	
+	/**
+	 * @copydoc NullTracer::string()
+	 */
+	inline void string(const size_t pos, const Token & str, const size_t index) noexcept {
+		printf("in: %3u, string %u: \"%.*s\"\n", unsigned(pos), unsigned(index), int(str.length), str.start);
+	}
+	
+	/**
+	 * @copydoc NullTracer::physical()
+	 */
+	inline void physical(const size_t pos, const uint32_t prefix, const size_t index, const uint32_t value) noexcept {
+		printf("in: %3u, %s %u: 0x%04X\n", unsigned(pos), (prefix == 0x0C) ? "physical set" : "designator", unsigned(index), unsigned(value));
+	}
+};
+
+
+/** Tracer used by `compile()` if none was given. */
+typedef PrintTracer DefaultTracer;
+#else /* not HID_DESCRIPTOR_DEBUG */
+/** Tracer used by `compile()` if none was given. */
+typedef NullTracer DefaultTracer;
+#endif /* not HID_DESCRIPTOR_DEBUG */
+
+
+/**
+ * Error output helper which also reports the error to the tracer.
+ * 
+ * @tparam Tracer - tracer type (see `NullTracer`)
+ */
+template <typename Tracer>
+class TraceErrorWriter {
+private:
+	::hid::error::ErrorWriter writer;
+	::hid::error::Info & error;
+	Tracer & tracer;
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] s - source code base pointer
+	 * @param[out] e - error output variable
+	 * @param[in] o - source code position of the base pointer
+	 * @param[in,out] t - tracer
+	 */
+	constexpr inline explicit TraceErrorWriter(const char * s, ::hid::error::Info & e, const ::hid::error::Info & o, Tracer & t) noexcept:
+		writer{s, e, o},
+		error{e},
+		tracer{t}
+	{}
+	
+	/**
+	 * Sets the error output variable to the given position and error message.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] msg - error message to output
+	 * @return false
+	 */
+	constexpr inline bool at(const size_t pos, const ::hid::error::EMessage msg) noexcept {
+		this->writer.at(pos, msg);
+		this->tracer.error(pos, this->error);
+		return false;
+	}
+};
+
+
+/**
+ * Searches for an encoding and reports the lookup to the given tracer.
+ * 
+ * @param[in] token - token to find
+ * @param[in] map - search within this map (see `EncodingMapId`)
+ * @param[out] res - variable to receive the found encoding
+ * @param[in,out] error - variable to receive a possible parsing error
+ * @param[in,out] tracer - tracer
+ * @param[in] pos - source code position
+ * @return true if found, else false
+ */
+template <typename Tracer>
+constexpr inline bool findEncoding(const Token & token, const uint8_t map, EncodingRef & res, error::EMessage & error, Tracer & tracer, const size_t pos) noexcept {
+	size_t probes = 0;
+	const bool found = findEncoding(token, map, res, error, probes);
+	tracer.lookup(pos, map, probes, found);
+	return found;
+}
+
+
+/**
+ * Compile policy with all language features and semantic checks. This is the default policy
+ * of `compile()` and defines the interface of all policies. Disabled feature groups are
+ * removed from the compiler at compile time. Their syntax is reported as invalid token.
+ * 
+ * @see ::hid::detail::compile()
+ */
+struct FullPolicy {
+	static constexpr bool units = true; /**< unit syntax (e.g. `Unit(SiLin(Length^2))`) */
+	static constexpr bool params = true; /**< user parameters (e.g. `{id}`) */
+	static constexpr bool hex = true; /**< hex literals (e.g. `0x1F`) */
+	static constexpr bool comments = true; /**< comments */
+	static constexpr bool checks = true; /**< collection, delimiter, Usage and ReportSize/ReportCount checks */
+};
+
+
+/**
+ * Compile policy for vetted sources on small targets. Only keeps named items and arguments as
+ * well as decimal literals. Units need to be given numerically (e.g. `Unit(0x11)` is invalid
+ * but `Unit(17)` is fine).
+ * 
+ * @see ::hid::detail::compile()
+ */
+struct LeanPolicy {
+	static constexpr bool units = false; /**< see `FullPolicy` */
+	static constexpr bool params = false; /**< see `FullPolicy` */
+	static constexpr bool hex = false; /**< see `FullPolicy` */
+	static constexpr bool comments = false; /**< see `FullPolicy` */
+	static constexpr bool checks = false; /**< see `FullPolicy` */
+};
+
+
+/**
+ * Possible compile modes.
+ * 
+ * @see ::hid::detail::compile()
+ */
+enum CompileMode {
+	CM_ALL, /**< compile until the end of the source code */
+	CM_CHUNK, /**< stop after the next top-level collection */
+	CM_PARTIAL /**< source code continues after its end; stop before the first incomplete item */
+};
+
+
+/**
+ * Checks whether the given item prefix belongs to an Input, Output or Feature item.
+ * 
+ * @param[in] prefix - item prefix
+ * @return true on match, else false
+ * @see HID 1.11 ch. 6.2.2.4
+ */
+constexpr inline bool isMainItem(const uint32_t prefix) noexcept {
+	return (prefix & 0xFC) == 0x80 || (prefix & 0xFC) == 0x90 || (prefix & 0xFC) == 0xB0;
+}
+
+
+/**
+ * Decodes the UTF-8 sequence at the given position.
+ * 
+ * @param[in] str - UTF-8 string
+ * @param[in] len - remaining string length in bytes
+ * @param[out] cp - decoded code point
+ * @return sequence length in bytes or 0 if invalid
+ */
+constexpr inline size_t decodeUtf8(const char * str, const size_t len, uint32_t & cp) noexcept {
+	const uint8_t lead = uint8_t(str[0]);
+	size_t follow = 0;
+	uint32_t min = 0;
+	if (lead < 0x80) {
+		cp = lead;
+		return 1;
+	} else if ((lead & 0xE0) == 0xC0) {
+		follow = 1;
+		min = 0x80;
+		cp = lead & 0x1F;
+	} else if ((lead & 0xF0) == 0xE0) {
+		follow = 2;
+		min = 0x800;
+		cp = lead & 0x0F;
+	} else if ((lead & 0xF8) == 0xF0) {
+		follow = 3;
+		min = 0x10000;
+		cp = lead & 0x07;
+	} else {
+		return 0;
+	}
+	if (follow >= len) {
+		return 0;
+	}
+	for (size_t i = 1; i <= follow; i++) {
+		if ((uint8_t(str[i]) & 0xC0) != 0x80) {
+			return 0;
+		}
+		cp = (cp << 6) | (uint8_t(str[i]) & 0x3F);
+	}
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+		/* overlong encoding, out of range or surrogate */
+		return 0;
+	}
+	return follow + 1;
+}
+
+
+/**
+ * Returns the size of the USB string descriptor for the given UTF-8 string.
+ * 
+ * @param[in] str - UTF-8 string
+ * @return descriptor size in bytes or 0 if the string is invalid or too long
+ * @see USB 2.0 ch. 9.6.7
+ */
+constexpr inline size_t stringDescriptorSize(const Token & str) noexcept {
+	size_t res = 2;
+	for (size_t n = 0; n < str.length; ) {
+		uint32_t cp = 0;
+		const size_t step = decodeUtf8(str.start + n, str.length - n, cp);
+		if (step == 0) {
+			return 0;
+		}
+		/* UTF-16 surrogate pair above the BMP */
+		res += (cp > 0xFFFF) ? 4 : 2;
+		n += step;
+	}
+	return (res > 0xFF) ? 0 : res;
+}
+
+
+/**
+ * Possible uses of string arguments.
+ */
+enum StringKind : uint8_t {
+	SK_NONE,      /**< reference (e.g. `DesignatorIndex("Trigger")`) */
+	SK_STRING,    /**< string descriptor (e.g. `StringIndex("Left Trigger")`) */
+	SK_DESIGNATOR /**< designator name (e.g. `Designator("Trigger", IndexFinger)`) */
+};
+
+
+/**
+ * Returns the use of the string argument at the given position. String arguments are
+ * always the first argument of their item.
+ * 
+ * @param[in] src - source code
+ * @param[in] pos - position of the opening quote within `src`
+ * @return string argument use
+ */
+constexpr inline StringKind stringKind(const char * src, size_t pos) noexcept {
+	while (pos > 0 && isWhitespace(src[pos - 1])) {
+		pos--;
+	}
+	if (pos == 0 || src[pos - 1] != '(') {
+		return SK_NONE;
+	}
+	pos--;
+	while (pos > 0 && isWhitespace(src[pos - 1])) {
+		pos--;
+	}
+	size_t start = pos;
+	while (start > 0 && isItemChar(src[start - 1])) {
+		start--;
+	}
+	const Token item{src + start, pos - start};
+	if (equalsI(item, "StringIndex") || equalsI(item, "StringMinimum") || equalsI(item, "StringMaximum")) {
+		return SK_STRING;
+	} else if ( equalsI(item, "Designator") ) {
+		return SK_DESIGNATOR;
+	}
+	return SK_NONE;
+}
+
+
+/**
+ * Iterates over the string arguments of the given kind (e.g. `StringIndex("Left Trigger")`) of
+ * the given source code. The source code is expected to be valid up to the given end.
+ */
+class StringReader {
+private:
+	const char * src; /**< source code */
+	size_t pos; /**< current position */
+	size_t end; /**< end position */
+	StringKind kind; /**< string arguments to return */
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] s - source code
+	 * @param[in] e - stop at this position
+	 * @param[in] k - string arguments to return
+	 */
+	constexpr inline explicit StringReader(const char * s, const size_t e, const StringKind k = SK_STRING) noexcept:
+		src{s},
+		pos{0},
+		end{e},
+		kind{k}
+	{}
+	
+	/**
+	 * Returns the next string argument.
+	 * 
+	 * @param[out] str - string without quotes
+	 * @return true if a string was found, else false
+	 */
+	constexpr inline bool next(Token & str) noexcept {
+		bool comment = false;
+		for (; this->pos < this->end && this->src[this->pos] != 0; this->pos++) {
+			const char c = this->src[this->pos];
+			if ( comment ) {
+				comment = (c != '\r' && c != '\n');
+			} else if ( isComment(c) ) {
+				comment = true;
+			} else if (c == '"') {
+				size_t n = this->pos + 1;
+				while (n < this->end && this->src[n] != 0 && this->src[n] != '"') {
+					n++;
+				}
+				if (n >= this->end || this->src[n] == 0) {
+					this->pos = this->end;
+					return false;
+				}
+				if (stringKind(this->src, this->pos) != this->kind) {
+					this->pos = n;
+					continue;
+				}
+				str = Token{this->src + this->pos + 1, n - this->pos - 1};
+				this->pos = n + 1;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+
+/**
+ * Checks whether the given string argument is the first one with this content.
+ * 
+ * @param[in] src - source code
+ * @param[in] str - string argument within `src`
+ * @param[in] kind - string arguments to compare with
+ * @return true if no equal string argument precedes it, else false
+ */
+constexpr inline bool isFirstString(const char * src, const Token & str, const StringKind kind = SK_STRING) noexcept {
+	StringReader strings(src, size_t(str.start - src) - 1, kind);
+	Token other{src, 0};
+	while ( strings.next(other) ) {
+		if ( equals(other, str) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Returns the string descriptor index of the given string. Distinct strings are numbered
+ * from 1 in the order of their first occurrence. Equal strings share the same index.
+ * 
+ * @param[in] src - source code
+ * @param[in] end - position of the string argument within `src`
+ * @param[in] str - string without quotes
+ * @param[in] kind - string arguments to number
+ * @return string descriptor index or designator index
+ */
+constexpr inline size_t stringIndex(const char * src, const size_t end, const Token & str, const StringKind kind = SK_STRING) noexcept {
+	StringReader strings(src, end, kind);
+	Token other{src, 0};
+	size_t res = 1;
+	while ( strings.next(other) ) {
+		if ( equals(other, str) ) {
+			break;
+		} else if ( isFirstString(src, other, kind) ) {
+			res++;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Returns the designator index of the given designator name. Designator names are numbered
+ * like string descriptors (see `stringIndex()`).
+ * 
+ * @param[in] src - source code
+ * @param[in] end - position of the string argument within `src`
+ * @param[in] str - designator name without quotes
+ * @param[in] define - true to number new names, false to return 0 for them
+ * @return designator index or 0 if unknown
+ */
+constexpr inline size_t designatorIndex(const char * src, const size_t end, const Token & str, const bool define) noexcept {
+	StringReader names(src, end, SK_DESIGNATOR);
+	Token other{src, 0};
+	size_t res = 1;
+	while ( names.next(other) ) {
+		if ( equals(other, str) ) {
+			return res;
+		} else if ( isFirstString(src, other, SK_DESIGNATOR) ) {
+			res++;
+		}
+	}
+	return define ? res : 0;
+}
+
+
+/**
+ * Returns the hash of the given field annotation name (FNV-1a).
+ * 
+ * @param[in] name - annotation name
+ * @param[in] len - name length in characters
+ * @return name hash
+ */
+constexpr inline uint32_t nameHash(const char * name, const size_t len) noexcept {
+	uint32_t res = UINT32_C(0x811C9DC5);
+	for (size_t i = 0; i < len; i++) {
+		res = (res ^ uint8_t(name[i])) * UINT32_C(0x01000193);
+	}
+	return res;
+}
+
+
+/**
+ * Returns the hash of the given null-terminated field annotation name (FNV-1a).
+ * 
+ * @param[in] name - annotation name
+ * @return name hash
+ */
+constexpr inline uint32_t nameHash(const char * name) noexcept {
+	size_t len = 0;
+	while (name[len] != 0) {
+		len++;
+	}
+	return nameHash(name, len);
+}
+
+
+/**
+ * Distinct string arguments of one kind in the order of their first occurrence. `compile()`
+ * records them while parsing to number strings without rescanning the source code before them.
+ * Strings beyond the first `Capacity` distinct ones are checked and numbered by scanning the
+ * source code (see `isFirstString()` and `stringIndex()`). `stringCount()`, `stringTableSize()`,
+ * `StringTable` and `designatorCount()` use it in the same way.
+ */
+struct StringOrder {
+	enum { Capacity = 16 }; /**< maximum number of recorded strings */
+	uint32_t start[Capacity]; /**< source position of the first character of each recorded string */
+	size_t count; /**< number of distinct strings seen */
+	
+	/**
+	 * Constructor.
+	 */
+	constexpr inline StringOrder() noexcept:
+		start{0},
+		count{0}
+	{}
+	
+	/**
+	 * Returns the index of the given string and records new strings.
+	 * 
+	 * @param[in] src - source code
+	 * @param[in] pos - position of the string argument within `src`
+	 * @param[in] str - string without quotes within `src`
+	 * @param[in] kind - string arguments to number
+	 * @param[in] define - true to number new strings, false to return 0 for them
+	 * @return string descriptor index or designator index; 0 if unknown and `define` is false
+	 */
+	constexpr inline size_t index(const char * src, const size_t pos, const Token & str, const StringKind kind, const bool define) noexcept {
+		size_t res = this->find(src, str);
+		if (res != 0) {
+			return res;
+		}
+		if (this->count > size_t(Capacity) && ( ! isFirstString(src, str, kind) )) {
+			/* equals one of the distinct strings which were not recorded */
+			return (kind == SK_DESIGNATOR) ? designatorIndex(src, pos, str, define) : stringIndex(src, pos, str, kind);
+		}
+		if ( ! define ) {
+			return 0;
+		}
+		this->add(src, str);
+		return this->count;
+	}
+	
+	/**
+	 * Records the given string argument and checks whether it is the first one with this content
+	 * (see `isFirstString()`). String arguments are expected in source code order.
+	 * 
+	 * @param[in] src - source code
+	 * @param[in] str - string argument within `src`
+	 * @param[in] kind - string arguments to compare with
+	 * @return true if no equal string argument preceded it, else false
+	 */
+	constexpr inline bool isFirst(const char * src, const Token & str, const StringKind kind) noexcept {
+		if (this->find(src, str) != 0 || (this->count > size_t(Capacity) && ( ! isFirstString(src, str, kind) ))) {
+			return false;
+		}
+		this->add(src, str);
+		return true;
+	}
+private:
+	/**
+	 * Returns the index of the given string among the recorded ones.
+	 * 
+	 * @param[in] src - source code
+	 * @param[in] str - string without quotes within `src`
+	 * @return index or 0 if not recorded
+	 */
+	constexpr inline size_t find(const char * src, const Token & str) const noexcept {
+		const size_t known = (this->count < size_t(Capacity)) ? this->count : size_t(Capacity);
+		for (size_t i = 0; i < known; i++) {
+			/* recorded strings end with a quote */
+			const char * other = src + this->start[i];
+			size_t n = 0;
+			while (n < str.length && other[n] == str.start[n]) {
+				n++;
+			}
+			if (n == str.length && other[n] == '"') {
+				return i + 1;
+			}
+		}
+		return 0;
+	}
+	
+	/**
+	 * Adds the given string as new distinct string.
+	 * 
+	 * @param[in] src - source code
+	 * @param[in] str - string without quotes within `src`
+	 */
+	constexpr inline void add(const char * src, const Token & str) noexcept {
+		if (this->count < size_t(Capacity)) {
+			this->start[this->count] = uint32_t(str.start - src);
+		}
+		this->count++;
+	}
+};
+
+
+/**
+ * Returns the length of the name at the given position.
+ * 
+ * @param[in] name - field annotation name or parameter name
+ * @param[in] lead - `@` for field annotations or `{` for parameters
+ * @return name length in characters
+ */
+constexpr inline size_t nameLength(const char * name, const char lead) noexcept {
+	size_t len = 0;
+	while (lead == '{' ? (name[len] != 0 && name[len] != '}') : isArgChar(name[len])) {
+		len++;
+	}
+	return len;
+}
+
+
+/**
+ * Checks whether a name with the same hash precedes the given one. Field annotation names
+ * need to be unique. Parameter names may repeat. The source code is expected to be valid up to
+ * the given end.
+ * 
+ * @param[in] src - source code
+ * @param[in] end - position of the given name within `src`
+ * @param[in] name - field annotation name or parameter name without `lead`
+ * @param[in] lead - `@` for field annotations or `{` for parameters
+ * @return true if the name hash is ambiguous, else false
+ */
+constexpr inline bool hasNameClash(const char * src, const size_t end, const Token & name, const char lead) noexcept {
+	const uint32_t hash = nameHash(name.start, name.length);
+	bool comment = false;
+	for (size_t n = 0; n < end; n++) {
+		const char c = src[n];
+		if ( comment ) {
+			comment = (c != '\r' && c != '\n');
+		} else if ( isComment(c) ) {
+			comment = true;
+		} else if (c == '"') {
+			n++;
+			while (n < end && src[n] != '"') {
+				n++;
+			}
+		} else if (c == lead) {
+			const Token other{src + n + 1, nameLength(src + n + 1, lead)};
+			if (nameHash(other.start, other.length) == hash && (lead == '@' || ( ! equals(other, name) ))) {
+				return true;
+			}
+			n += other.length;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Distinct field annotation or parameter names in the order of their first occurrence.
+ * `FieldNames` and `ItemList` only keep the name hashes. `compile()` and `ItemRecorder`
+ * therefore record the names while parsing to reject different names with the same hash and
+ * repeated field annotation names. Names beyond the first `Capacity` distinct ones are checked by scanning the source code
+ * (see `hasNameClash()`).
+ */
+struct NameOrder {
+	enum { Capacity = 16 }; /**< maximum number of recorded names */
+	uint32_t hash[Capacity]; /**< hash of each recorded name (see `nameHash()`) */
+	uint32_t start[Capacity]; /**< source position of the first character of each recorded name */
+	size_t count; /**< number of distinct names seen */
+	char lead; /**< `@` for field annotations or `{` for parameters */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] l - `@` for field annotations or `{` for parameters
+	 */
+	constexpr inline explicit NameOrder(const char l = '@') noexcept:
+		hash{0},
+		start{0},
+		count{0},
+		lead{l}
+	{}
+	
+	/**
+	 * Checks the given name against the names seen so far and records new names.
+	 * 
+	 * @param[in] src - source code
+	 * @param[in] pos - position of the leading character within `src`
+	 * @param[in] name - name without the leading character within `src`
+	 * @return true if a different name with the same hash or the same field annotation name
+	 * was seen, else false
+	 */
+	constexpr inline bool clashes(const char * src, const size_t pos, const Token & name) noexcept {
+		const uint32_t h = nameHash(name.start, name.length);
+		const size_t known = (this->count < size_t(Capacity)) ? this->count : size_t(Capacity);
+		for (size_t i = 0; i < known; i++) {
+			if (this->hash[i] == h) {
+				const Token other{src + this->start[i], nameLength(src + this->start[i], this->lead)};
+				return this->lead == '@' || ( ! equals(other, name) );
+			}
+		}
+		if (this->count > size_t(Capacity) && hasNameClash(src, pos, name, this->lead)) {
+			/* not all distinct names were recorded */
+			return true;
+		}
+		if (this->count < size_t(Capacity)) {
+			this->hash[this->count] = h;
+			this->start[this->count] = uint32_t(name.start - src);
+		}
+		this->count++;
+		return false;
+	}
+};
+
+
+/**
+ * Compiler state which is carried between separately compiled chunks of the same source.
+ * A chunk always starts and ends outside of any token.
+ * 
+ * @see ::hid::detail::compile()
+ */
+struct CompileState {
+	size_t position; /**< source position of the next chunk */
+	size_t size; /**< compiled size of the last chunk in bytes */
+	int colLevel; /**< collection nesting level */
+	int delimLevel; /**< delimiter nesting level */
+	int usageAtLevel; /**< collection level of the last Usage item */
+	size_t reportSizes; /**< number of ReportSize items */
+	size_t reportCounts; /**< number of ReportCount items */
+	size_t annotations; /**< number of field annotations */
+	size_t physicalSets; /**< number of physical descriptor sets */
+	bool hasUsagePage; /**< true if a UsagePage item was given */
+	bool afterMain; /**< true if the last written item was an unannotated main item */
+	bool withinComment; /**< true if the chunk starts within a comment */
+	bool finished; /**< true if the end of the source or an error was reached */
+	StringOrder strings; /**< string arguments seen so far */
+	StringOrder designators; /**< designator names seen so far */
+	NameOrder names; /**< field annotation names seen so far */
+	EncodingRef usagePage; /**< current usage page */
+	::hid::error::Info origin; /**< line and column of the source code start */
+	::hid::error::Info error; /**< error of the last chunk */
+	
+	/**
+	 * Constructor.
+	 */
+	constexpr inline CompileState() noexcept:
+		position{0},
+		size{0},
+		colLevel{0},
+		delimLevel{0},
+		usageAtLevel{-1},
+		reportSizes{0},
+		reportCounts{0},
+		annotations{0},
+		physicalSets{0},
+		hasUsagePage{false},
+		afterMain{false},
+		withinComment{false},
+		finished{false},
+		strings{},
+		designators{},
+		names{},
+		usagePage{},
+		origin{},
+		error{}
+	{
+		this->origin.line = 1;
+		this->origin.column = 1;
+	}
+};
+
+
+/**
+ * Returns the string descriptor index via `Source::stringIndex()` with the strings seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - string without quotes
+ * @param[in,out] order - strings seen so far
+ * @return string descriptor index
+ */
+template <typename Source>
+constexpr inline auto sourceStringIndex(const Source & source, const size_t pos, const Token & str, StringOrder & order, int) noexcept -> decltype(source.stringIndex(pos, str, order)) {
+	return source.stringIndex(pos, str, order);
+}
+
+
+/**
+ * Returns the string descriptor index via `Source::stringIndex()` for sources which
+ * only see a part of the source code.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - string without quotes
+ * @return string descriptor index
+ */
+template <typename Source>
+constexpr inline auto sourceStringIndex(const Source & source, const size_t pos, const Token & str, StringOrder & /* order */, long) noexcept -> decltype(source.stringIndex(pos, str)) {
+	return source.stringIndex(pos, str);
+}
+
+
+/**
+ * Returns the string descriptor index from the strings seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - string without quotes
+ * @param[in,out] order - strings seen so far
+ * @return string descriptor index
+ */
+template <typename Source>
+constexpr inline size_t sourceStringIndex(const Source & source, const size_t pos, const Token & str, StringOrder & order, ...) noexcept {
+	return order.index(source.data(), pos, str, SK_STRING, true);
+}
+
+
+/**
+ * Returns the designator index via `Source::designatorIndex()` with the designator names seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - designator name without quotes
+ * @param[in] define - true to number new names, false to return 0 for them
+ * @param[in,out] order - designator names seen so far
+ * @return designator index or 0 if unknown
+ */
+template <typename Source>
+constexpr inline auto sourceDesignatorIndex(const Source & source, const size_t pos, const Token & str, const bool define, StringOrder & order, int) noexcept -> decltype(source.designatorIndex(pos, str, define, order)) {
+	return source.designatorIndex(pos, str, define, order);
+}
+
+
+/**
+ * Returns the designator index via `Source::designatorIndex()` for sources which
+ * only see a part of the source code.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - designator name without quotes
+ * @param[in] define - true to number new names, false to return 0 for them
+ * @return designator index or 0 if unknown
+ */
+template <typename Source>
+constexpr inline auto sourceDesignatorIndex(const Source & source, const size_t pos, const Token & str, const bool define, StringOrder & /* order */, long) noexcept -> decltype(source.designatorIndex(pos, str, define)) {
+	return source.designatorIndex(pos, str, define);
+}
+
+
+/**
+ * Returns the designator index from the designator names seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the string argument
+ * @param[in] str - designator name without quotes
+ * @param[in] define - true to number new names, false to return 0 for them
+ * @param[in,out] order - designator names seen so far
+ * @return designator index or 0 if unknown
+ */
+template <typename Source>
+constexpr inline size_t sourceDesignatorIndex(const Source & source, const size_t pos, const Token & str, const bool define, StringOrder & order, ...) noexcept {
+	return order.index(source.data(), pos, str, SK_DESIGNATOR, define);
+}
+
+
+/**
+ * Checks the given annotation name via `Source::nameClash()` against the names seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the annotation
+ * @param[in] name - annotation name without `@`
+ * @param[in,out] order - annotation names seen so far
+ * @return true if a different name with the same hash was seen, else false
+ */
+template <typename Source>
+constexpr inline auto sourceNameClash(const Source & source, const size_t pos, const Token & name, NameOrder & order, int) noexcept -> decltype(source.nameClash(pos, name, order)) {
+	return source.nameClash(pos, name, order);
+}
+
+
+/**
+ * Checks the given annotation name against the names seen so far.
+ * 
+ * @param[in] source - source code description
+ * @param[in] pos - position of the annotation
+ * @param[in] name - annotation name without `@`
+ * @param[in,out] order - annotation names seen so far
+ * @return true if a different name with the same hash was seen, else false
+ */
+template <typename Source>
+constexpr inline bool sourceNameClash(const Source & source, const size_t pos, const Token & name, NameOrder & order, ...) noexcept {
+	return order.clashes(source.data(), pos, name);
+}
+
+
+/**
+ * Non-template source code description. Parameters are resolved from a parameter table or via
+ * the given lookup function. All sources passed as `SourceView` share the same `compile()`
+ * instantiation per writer and tracer.
+ */
+struct SourceView {
+	/** Parameter lookup function. */
+	typedef ParamMatch (* FindFn)(const void * context, const Token & token);
+	/** String descriptor index function (see `stringIndex()`). */
+	typedef size_t (* StringIndexFn)(void * context, const size_t pos, const Token & str);
+	/** Designator index function (see `designatorIndex()`). */
+	typedef size_t (* DesignatorIndexFn)(void * context, const size_t pos, const Token & str, const bool define);
+	
+	const char * code; /**< source code */
+	size_t length; /**< source code size in bytes */
+	const Param * params; /**< parameter table if `findFn` is NULL */
+	size_t count; /**< parameter table size */
+	void * context; /**< context passed to the functions below */
+	FindFn findFn; /**< parameter lookup function or NULL */
+	StringIndexFn stringIndexFn; /**< string index function or NULL to scan `code` */
+	DesignatorIndexFn designatorIndexFn; /**< designator index function or NULL to scan `code` */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] c - source code
+	 * @param[in] l - source code size in bytes
+	 * @param[in] p - parameter table
+	 * @param[in] n - parameter table size
+	 */
+	constexpr inline SourceView(const char * c, const size_t l, const Param * p = NULL, const size_t n = 0) noexcept:
+		code{c},
+		length{l},
+		params{p},
+		count{n},
+		context{NULL},
+		findFn{NULL},
+		stringIndexFn{NULL},
+		designatorIndexFn{NULL}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] c - source code
+	 * @param[in] l - source code size in bytes
+	 * @param[in] ctx - context passed to the given functions
+	 * @param[in] f - parameter lookup function
+	 * @param[in] s - string index function or NULL to scan the source code
+	 * @param[in] d - designator index function or NULL to scan the source code
+	 */
+	constexpr inline SourceView(const char * c, const size_t l, void * ctx, FindFn f, StringIndexFn s = NULL, DesignatorIndexFn d = NULL) noexcept:
+		code{c},
+		length{l},
+		params{NULL},
+		count{0},
+		context{ctx},
+		findFn{f},
+		stringIndexFn{s},
+		designatorIndexFn{d}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code with parameter set
+	 */
+	template <size_t S, size_t P>
+	constexpr inline explicit SourceView(const ::hid::detail::Source<S, P> & source) noexcept:
+		SourceView(source.code, S, source.params, P)
+	{}
+	
+	/**
+	 * Returns a pointer to the source code.
+	 * 
+	 * @return source code pointer
+	 */
+	constexpr inline const char * data() const noexcept {
+		return this->code;
+	}
+	
+	/**
+	 * Returns the source code size in bytes.
+	 * 
+	 * @return source code size in bytes
+	 */
+	constexpr inline size_t size() const noexcept {
+		return this->length;
+	}
+	
+	/**
+	 * Finds a parameter with the given name.
+	 * The value of the last parameter with this name will be returned.
+	 * 
+	 * @param[in] token - parameter name token
+	 * @return associated value
+	 */
+	constexpr inline ParamMatch find(const Token & token) const noexcept {
+		if (this->findFn != NULL) {
+			return this->findFn(this->context, token);
+		}
+		for (size_t p = this->count; p > 0; p--) {
+			if ( equals(token, this->params[p - 1].name) ) {
+				return ParamMatch{this->params[p - 1].value, true};
+			}
+		}
+		return ParamMatch{0, false};
+	}
+	
+	/**
+	 * Returns the string descriptor index of the given string.
+	 * 
+	 * @param[in] pos - position of the string argument
+	 * @param[in] str - string without quotes
+	 * @param[in,out] order - strings seen so far
+	 * @return string descriptor index
+	 */
+	constexpr inline size_t stringIndex(const size_t pos, const Token & str, StringOrder & order) const noexcept {
+		if (this->stringIndexFn != NULL) {
+			return this->stringIndexFn(this->context, pos, str);
+		}
+		return order.index(this->code, pos, str, SK_STRING, true);
+	}
+	
+	/**
+	 * Returns the designator index of the given designator name.
+	 * 
+	 * @param[in] pos - position of the string argument
+	 * @param[in] str - designator name without quotes
+	 * @param[in] define - true to number new names, false to return 0 for them
+	 * @param[in,out] order - designator names seen so far
+	 * @return designator index or 0 if unknown
+	 */
+	constexpr inline size_t designatorIndex(const size_t pos, const Token & str, const bool define, StringOrder & order) const noexcept {
+		if (this->designatorIndexFn != NULL) {
+			return this->designatorIndexFn(this->context, pos, str, define);
+		}
+		return order.index(this->code, pos, str, SK_DESIGNATOR, define);
+	}
+	
+	/**
+	 * Checks the given annotation name against the names seen so far. Sources with a string
+	 * index function only see a part of the source code (e.g. `Compiler`) and keep no field
+	 * annotations. They accept all names.
+	 * 
+	 * @param[in] pos - position of the annotation
+	 * @param[in] name - annotation name without `@`
+	 * @param[in,out] order - annotation names seen so far
+	 * @return true if a different name with the same hash was seen, else false
+	 */
+	constexpr inline bool nameClash(const size_t pos, const Token & name, NameOrder & order) const noexcept {
+		if (this->stringIndexFn != NULL) {
+			return false;
+		}
+		return order.clashes(this->code, pos, name);
+	}
+};
+
+
+/**
+ * Compiles the HID description into the given buffer.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @param[in,out] state - compiler state to start from and to update
+ * @param[in] mode - compile mode
+ * @param[in,out] tracer - tracer
+ * @return true on success, else false
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * (e.g. `SourceView` to share a single instantiation between sources);
+ * may implement `size_t stringIndex(size_t, Token)` (see `stringIndex()`),
+ * `size_t designatorIndex(size_t, Token, bool)` (see `designatorIndex()`) and
+ * `bool nameClash(size_t, Token, NameOrder &)` (see `NameOrder`)
+ * @tparam Writer - shall implement `write(uint8_t)` and `size_t getPosition()`
+ * @tparam Tracer - see `NullTracer`
+ * @tparam Policy - enabled feature groups (see `FullPolicy`)
+ * @remarks `state.finished` is set once the end of the source code has been reached.
+ * `state.position` points to the start of the next chunk otherwise.
+ * Compilation stops with `E_Output_buffer_overflow` once `write()` fails.
+ */
+template <typename Policy, typename Source, typename Writer, typename Tracer>
+constexpr bool compile(const Source & source, Writer & out, ::hid::error::Info & error, CompileState & state, const CompileMode mode, Tracer & tracer) noexcept {
+	using namespace ::hid::error;
+	enum State {
+		HID_START                 = TS_START,
+		HID_WITHIN_COMMENT        = TS_WITHIN_COMMENT,
+		HID_WITHIN_ITEM           = TS_WITHIN_ITEM,
+		HID_WITHIN_ARG_LIST       = TS_WITHIN_ARG_LIST,
+		HID_WITHIN_ARG            = TS_WITHIN_ARG,
+		HID_WITHIN_PARAM          = TS_WITHIN_PARAM,
+		HID_WITHIN_HEX_LIT        = TS_WITHIN_HEX_LIT,
+		HID_WITHIN_NUM_LIT        = TS_WITHIN_NUM_LIT,
+		HID_WITHIN_UNIT_SYS       = TS_WITHIN_UNIT_SYS,
+		HID_WITHIN_UNIT_DESC      = TS_WITHIN_UNIT_DESC,
+		HID_WITHIN_UNIT           = TS_WITHIN_UNIT,
+		HID_WITHIN_UNIT_EXP       = TS_WITHIN_UNIT_EXP
+	};
+#define _HID_WITHIN(x) ((flags & HID_WITHIN_##x) != 0)
+	/* consumes the following characters as long as `cond` holds for `ptr[1]` */
+#define _HID_RUN(cond, count) \
+	while ((n + 1) < len && (cond)) { \
+		n++; \
+		ptr++; \
+		count; \
+		tracer.step(n, out.getPosition(), *ptr, traceState); \
+	}
+	int colLevel = state.colLevel;
+	int delimLevel = state.delimLevel;
+	int usageAtLevel = state.usageAtLevel;
+	size_t reportSizes = state.reportSizes;
+	size_t reportCounts = state.reportCounts;
+	const char * ptr = source.data() + state.position;
+	const size_t len = source.size();
+	TraceErrorWriter<Tracer> errorMsg{source.data(), error, state.origin, tracer};
+	Token tItem = {ptr, 0};
+	Token tArg = {ptr, 0};
+	size_t annotations = state.annotations;
+	size_t physicalSets = state.physicalSets;
+	size_t designator{0}; /* designator index of the current Designator item */
+	bool hasUsagePage{state.hasUsagePage};
+	bool afterMain{state.afterMain};
+	bool hasArg{false};
+	bool multiArg{false};
+	bool negLit{false};
+	bool colEnd{false};
+	bool suspend{false};
+	EMessage subError{E_NO_ERROR};
+	EncodingRef encMap; /* current */
+	EncodingRef usagePage{state.usagePage}; /* current; used for all subsequent Usage items, regardless of the hierarchy */
+	EncodingRef encUnit; /* current */
+	uint32_t flags = state.withinComment ? uint32_t(HID_WITHIN_COMMENT) : uint32_t(HID_START);
+	uint32_t item{0}, arg{0}, lit{0};
+	size_t n{state.position};
+	for (;;) {
+		if (mode == CM_PARTIAL && (flags == HID_START || flags == HID_WITHIN_COMMENT)) {
+			/* possible start of the next chunk */
+			state.position = n;
+			state.colLevel = colLevel;
+			state.delimLevel = delimLevel;
+			state.usageAtLevel = usageAtLevel;
+			state.reportSizes = reportSizes;
+			state.reportCounts = reportCounts;
+			state.annotations = annotations;
+			state.physicalSets = physicalSets;
+			state.hasUsagePage = hasUsagePage;
+			state.afterMain = afterMain;
+			state.withinComment = (flags != HID_START);
+			state.usagePage = usagePage;
+		}
+		if (n >= len || *ptr == 0) {
+			break;
+		}
+		const uint32_t traceState = (flags == HID_START) ? uint32_t(TS_START) : (flags | (multiArg ? uint32_t(TS_MULTI_ARG) : 0) | (negLit ? uint32_t(TS_NEG_LIT) : 0) | (hasArg ? uint32_t(TS_HAS_ARG) : 0));
+		tracer.step(n, out.getPosition(), *ptr, traceState);
+		if (flags == HID_START) {
+			if ( isItemChar(*ptr) ) {
+				/* start of item name */
+				flags = HID_WITHIN_ITEM;
+				tItem.start = ptr;
+				tItem.length = 1;
+			} else if (Policy::params && *ptr == '{') {
+				/* start of user parameter */
+				flags = HID_WITHIN_PARAM;
+				tArg.start = ptr + 1;
+				tArg.length = 0;
+			} else if (Policy::hex && ptr[0] == '0' && (n + 1) < len && ptr[1] == 'x') {
+				/* start of hex literal */
+				flags = HID_WITHIN_HEX_LIT;
+				if ((n + 2) >= len) {
+					if (mode == CM_PARTIAL) {
+						/* more source code is needed to check the hex literal */
+						suspend = true;
+						break;
+					}
+					return errorMsg.at(n + 2, E_Unexpected_end_of_source);
+				}
+				if ( ! isHexDigit(ptr[2]) ) {
+					return errorMsg.at(n + 2, E_Invalid_hex_value);
+				}
+				lit = 0;
+				n++;
+				ptr++;
+			} else if ( isDigit(*ptr) ) {
+				/* start of number literal */
+				/* note: negative number literals are only allowed as argument */
+				flags = HID_WITHIN_NUM_LIT;
+				lit = 0;
+				continue; /* re-parse as number literal */
+			} else if (*ptr == '-') {
+				return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
+			} else if (*ptr == '@') {
+				/* field annotation of the previous main item */
+				size_t run = 1;
+				while ((n + run) < len && isArgChar(ptr[run])) {
+					run++;
+				}
+				if (mode == CM_PARTIAL && (n + run) >= len) {
+					/* more source code is needed to complete the annotation name */
+					suspend = true;
+					break;
+				}
+				if ( ! afterMain ) {
+					return errorMsg.at(n, E_Missing_main_item_for_annotation);
+				}
+				if (run < 2 || ( ! isItemChar(ptr[1]) )) {
+					return errorMsg.at(n + 1, E_Invalid_annotation_name);
+				}
+				if ( sourceNameClash(source, n, Token{ptr + 1, run - 1}, state.names, 0) ) {
+					return errorMsg.at(n + 1, E_Ambiguous_annotation_name);
+				}
+				tracer.annotation(n, Token{ptr + 1, run - 1}, out.getPosition());
+				afterMain = false;
+				annotations++;
+				n += run - 1;
+				ptr += run - 1;
+			} else if (Policy::comments && isComment(*ptr)) {
+				flags = HID_WITHIN_COMMENT;
+			} else if ( isWhitespace(*ptr) ) {
+				_HID_RUN(isWhitespace(ptr[1]), (void)0)
+			} else {
+				return errorMsg.at(n, E_Unexpected_token);
+			}
+		} else if (Policy::comments && _HID_WITHIN(COMMENT)) {
+			if (*ptr == '\r' || *ptr == '\n') {
+				flags = HID_START;
+			} else {
+				_HID_RUN(ptr[1] != 0 && ptr[1] != '\r' && ptr[1] != '\n', (void)0)
+			}
+		} else if (Policy::params && _HID_WITHIN(PARAM)) {
+			if (*ptr == '}') {
+				/* end of user parameter */
+				flags &= ~HID_WITHIN_PARAM;
+				const ParamMatch & param = source.find(tArg);
+				if ( ! param.valid ) {
+					return errorMsg.at(n, E_Expected_valid_parameter_name_here);
+				}
+				if ( _HID_WITHIN(ARG_LIST) ) {
+					/* merge multiple arguments via OR */
+					if (encMap.arg == EM_SIGNED_NUM_ARG) {
+						if (param.value < INT64_C(-0x80000000) || param.value > INT64_C(0x7FFFFFFF)) {
+							return errorMsg.at(n, E_Parameter_value_out_of_range);
+						}
+					} else {
+						if (param.value < 0 || param.value > UINT32_C(0xFFFFFFFF)) {
+							return errorMsg.at(n, E_Parameter_value_out_of_range);
+						}
+					}
+					arg |= uint32_t(param.value);
+					hasArg = true;
+				} else {
+					/* encode as literal */
+					if (param.value < 0) {
+						return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
+					}
+					if (param.value > UINT32_C(0xFFFFFFFF)) {
+						return errorMsg.at(n, E_Parameter_value_out_of_range);
+					}
+					afterMain = false;
+					tracer.literal(n, uint32_t(param.value));
+					if (encodeUnsigned(out, uint32_t(param.value)) == 0) {
+						return errorMsg.at(n, E_Output_buffer_overflow);
+					}
+				}
+			} else {
+				tArg.length++;
+				_HID_RUN(ptr[1] != 0 && ptr[1] != '}', tArg.length++)
+			}
+		} else if ( _HID_WITHIN(ITEM) ) {
+			if ( isItemChar(*ptr) ) {
+				tItem.length++;
+				_HID_RUN(isItemChar(ptr[1]), tItem.length++)
+			} else if (isWhitespace(*ptr) || *ptr == '(') {
+				/* skip whitespaces */
+				if ( isWhitespace(*ptr) ) {
+					while ((n + 1) < len && isWhitespace(ptr[1])) {
+						n++;
+						ptr++;
+					}
+					if (mode == CM_PARTIAL && (n + 1) >= len) {
+						/* more source code is needed to check for an argument list */
+						suspend = true;
+						break;
+					}
+					if ((n + 1) < len && ptr[1] == '(') {
+						n++;
+						ptr++;
+					}
+				}
+				flags &= ~HID_WITHIN_ITEM;
+				subError = E_Invalid_item_name;
+				if ( ! findEncoding(tItem, EM_ITEM, encMap, subError, tracer, n) ) {
+					return errorMsg.at(n, subError);
+				} else if (encMap.arg == EM_COL_ARG) {
+					/* Collection */
+					if (Policy::checks && usageAtLevel != colLevel) {
+						return errorMsg.at(n, E_Missing_Usage_for_Collection);
+					}
+					colLevel++;
+				} else if (encMap.arg == EM_END_COL) {
+					/* EndCollection */
+					if (Policy::checks && colLevel <= 0) {
+						return errorMsg.at(n, E_Unexpected_EndCollection);
+					}
+					if ( Policy::checks ) {
+						if (reportSizes < reportCounts) {
+							return errorMsg.at(n, E_Missing_ReportSize);
+						} else if (reportCounts < reportSizes) {
+							return errorMsg.at(n, E_Missing_ReportCount);
+						}
+					}
+					colLevel--;
+					usageAtLevel--;
+					colEnd = (colLevel == 0);
+				} else if (Policy::checks && equalsI(tItem, "Usage")) {
+					/* needed to check if there is a Usage item for every Collection */
+					usageAtLevel = colLevel;
+				}
+				if (*ptr == '(') {
+					/* start of argument list */
+					flags |= HID_WITHIN_ARG_LIST;
+					if (encMap.arg == EM_NONE) {
+						return errorMsg.at(n, E_This_item_has_no_arguments);
+					} else if (Policy::units && encMap.arg == EM_UNIT_SYSTEM) {
+						/* Unit */
+						flags |= HID_WITHIN_UNIT_SYS;
+					}
+					/* standard item */
+					item = encMap.value;
+					arg = 0;
+					hasArg = false;
+					designator = 0;
+					multiArg = (encMap.arg == EM_INPUT_ARG || encMap.arg == EM_OUTPUT_FEATURE_ARG || encMap.arg == EM_PHYSICAL_SET || encMap.arg == EM_DESIGNATOR);
+				} else {
+					/* end of item */
+					if (encMap.arg != EM_NONE && (encMap.hasNamedArgs() || encMap.arg == EM_USAGE_ARG)) {
+						return errorMsg.at(n, E_Missing_argument);
+					}
+					afterMain = isMainItem(encMap.value);
+					tracer.item(n, encMap.value, 0);
+					if (encodeUnsigned(out, encMap.value) == 0) {
+						return errorMsg.at(n, E_Output_buffer_overflow);
+					}
+				}
+			} else {
+				return errorMsg.at(n, E_Unexpected_item_name_character);
+			}
+		} else if ( _HID_WITHIN(ARG) ) {
+			if (Policy::units && _HID_WITHIN(UNIT_DESC)) {
+				if ( _HID_WITHIN(UNIT) ) {
+					if ( isAlpha(*ptr) ) {
+						tArg.length++;
+						_HID_RUN(isAlpha(ptr[1]), tArg.length++)
+					} else if (isWhitespace(*ptr) || *ptr == ')' || *ptr == '^') {
+						/* end of unit name */
 						flags &= ~HID_WITHIN_UNIT;
 						subError = E_Invalid_unit_name;
-						encUnit = findEncoding(tArg, encMap->arg, dynMap, subError);
-						if (encUnit == NULL) {
+						if ( ! findEncoding(tArg, encMap.arg, encUnit, subError, tracer, n) ) {
 							return errorMsg.at(n, subError);
 						}
 						if (*ptr == '^') {
@@ -4443,456 +6631,4783 @@ constexpr bool compile(const Source & source, Writer & out, ::hid::error::Info &
 							tArg.start = ptr + 1;
 							tArg.length = 0;
 						} else {
-							/* end of unit without exponent (treat as exponent == 1) */
-							const uint32_t offset = 4 * encUnit->value;
-							arg &= ~uint32_t(0xF << offset);
-							arg |= uint32_t(1 << offset);
-							continue; /* re-parse as unit description */
+							/* end of unit without exponent (treat as exponent == 1) */
+							const uint32_t offset = 4 * encUnit.value;
+							arg &= ~uint32_t(0xF << offset);
+							arg |= uint32_t(1 << offset);
+							continue; /* re-parse as unit description */
+						}
+					} else {
+						return errorMsg.at(n, E_Unexpected_unit_name_character);
+					}
+				} else if ( _HID_WITHIN(UNIT_EXP) ) {
+					if (*ptr == '-') {
+						/* sign is only allowed at the beginning of the exponent */
+						if (tArg.length > 0) {
+							return errorMsg.at(n, E_Invalid_unit_exponent);
+						}
+						tArg.length++;
+					} else if ( isDigit(*ptr) ) {
+						tArg.length++;
+						_HID_RUN(isDigit(ptr[1]), tArg.length++)
+					} else {
+						/* end of unit exponent */
+						flags &= ~HID_WITHIN_UNIT_EXP;
+						subError = E_Invalid_unit_exponent;
+						EncodingRef encUnitExp;
+						if ( ! findEncoding(tArg, encUnit.arg, encUnitExp, subError, tracer, n) ) {
+							return errorMsg.at(n, subError);
+						}
+						/* the unit exponent for the current unit is stored at the specific nipple */
+						const uint32_t offset = 4 * encUnit.value;
+						arg &= ~uint32_t(0xF << offset);
+						arg |= uint32_t(encUnitExp.value << offset);
+						flags |= HID_WITHIN_UNIT_DESC;
+						continue; /* re-parse as unit description */
+					}
+				} else if ( isAlpha(*ptr) ) {
+					/* start of unit name */
+					flags |= HID_WITHIN_UNIT;
+					tArg.start = ptr;
+					tArg.length = 1;
+				} else if (*ptr == ')') {
+					/* end of unit description */
+					flags &= ~(HID_WITHIN_ARG | HID_WITHIN_UNIT_SYS | HID_WITHIN_UNIT_DESC);
+				} else if ( ! isWhitespace(*ptr) ) {
+					return errorMsg.at(n, E_Unexpected_unit_name_character);
+				}
+			} else if ( isArgChar(*ptr) ) {
+				tArg.length++;
+				_HID_RUN(isArgChar(ptr[1]), tArg.length++)
+			} else if (Policy::units && _HID_WITHIN(UNIT_SYS)) {
+				if ( hasArg ) {
+					/* invalid internal state */
+					return errorMsg.at(n, E_Internal_error);
+				} else if (isWhitespace(*ptr) || *ptr == '(') {
+					/* skip whitespaces */
+					if ( isWhitespace(*ptr) ) {
+						while ((n + 1) < len && isWhitespace(ptr[1])) {
+							n++;
+							ptr++;
+						}
+						if (mode == CM_PARTIAL && (n + 1) >= len) {
+							/* more source code is needed to check for an argument list */
+							suspend = true;
+							break;
+						}
+						if ((n + 1) < len && ptr[1] == '(') {
+							n++;
+							ptr++;
+						}
+					}
+					/* start of unit description for the given unit system */
+					subError = E_Invalid_unit_system_name;
+					EncodingRef encUnitSys;
+					if ( ! findEncoding(tArg, encMap.arg, encUnitSys, subError, tracer, n) ) {
+						return errorMsg.at(n, subError);
+					}
+					flags |= HID_WITHIN_UNIT_DESC;
+					arg = encUnitSys.value;
+					encMap = encUnitSys;
+					hasArg = true;
+				} else if (*ptr == ')') {
+					/* end of unit system */
+					flags &= ~HID_WITHIN_UNIT_SYS;
+					continue; /* re-parse as argument */
+				} else {
+					return errorMsg.at(n, E_Unexpected_argument_name_character);
+				}
+			} else if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
+				/* end of argument */
+				flags &= ~HID_WITHIN_ARG;
+				/* possible Usage|UsageMinimum|UsageMaximum argument according to current UsagePage */
+				if (encMap.arg == EM_USAGE_ARG) {
+					if (usagePage.arg == EM_NONE) {
+						if ( hasUsagePage ) {
+							return errorMsg.at(n, E_Missing_named_UsagePage);
+						} else {
+							return errorMsg.at(n, E_Missing_UsagePage);
+						}
+					}
+					encMap = usagePage;
+				}
+				subError = E_Invalid_argument_name;
+				EncodingRef encItem;
+				if ( ! findEncoding(tArg, encMap.arg, encItem, subError, tracer, n) ) {
+					return errorMsg.at(n, subError);
+				} else if (encMap.arg == EM_USAGE_PAGE) {
+					/* Usage map from UsagePage argument */
+					usagePage = encItem;
+				}
+				if (encItem.arg == EM_CLEAR_ARG) {
+					tracer.clear(n, encItem.value);
+					arg &= ~(encItem.value);
+				} else {
+					/* merge multiple arguments via OR if unspecified */
+					arg |= encItem.value;
+				}
+				hasArg = ( ! multiArg ) || *ptr != ',';
+				if (*ptr == ')') {
+					continue; /* re-parse as argument list */
+				}
+			} else {
+				return errorMsg.at(n, E_Unexpected_argument_name_character);
+			}
+		} else if (Policy::hex && _HID_WITHIN(HEX_LIT)) {
+			if ( isHexDigit(*ptr) ) {
+				const uint32_t oldLit = lit;
+				lit <<= 4;
+				if (lit < oldLit) {
+					return errorMsg.at(n, E_Number_overflow);
+				}
+				if (*ptr < 'A') {
+					lit |= uint32_t(*ptr - '0');
+				} else if (*ptr < 'a') {
+					lit |= uint32_t(*ptr - 'A' + 10);
+				} else {
+					lit |= uint32_t(*ptr - 'a' + 10);
+				}
+			} else if ( _HID_WITHIN(ARG_LIST) ) {
+				if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
+					/* end of hex literal */
+					flags &= ~HID_WITHIN_HEX_LIT;
+					/* merge multiple arguments via OR */
+					if (encMap.arg == EM_SIGNED_NUM_ARG && lit > 0x7FFFFFFFUL) {
+						return errorMsg.at(n, E_Number_overflow);
+					}
+					arg |= lit;
+					hasArg = ( ! multiArg ) || *ptr != ',';
+					if (*ptr == ')') {
+						continue; /* re-parse as argument list */
+					}
+				} else {
+					return errorMsg.at(n, E_Invalid_hex_value);
+				}
+			} else if ( isWhitespace(*ptr) ) {
+				/* end of hex literal */
+				flags &= ~HID_WITHIN_HEX_LIT;
+				afterMain = false;
+				tracer.literal(n, lit);
+				if (encodeUnsigned(out, lit) == 0) {
+					return errorMsg.at(n, E_Output_buffer_overflow);
+				}
+			} else {
+				return errorMsg.at(n, E_Invalid_hex_value);
+			}
+		} else if ( _HID_WITHIN(NUM_LIT) ) {
+			if ( isDigit(*ptr) ) {
+				const uint32_t oldLit = lit;
+				lit *= 10;
+				if (lit < oldLit) {
+					return errorMsg.at(n, E_Number_overflow);
+				}
+				lit += uint32_t(*ptr - '0');
+				if (lit < oldLit) {
+					return errorMsg.at(n, E_Number_overflow);
+				}
+			} else if ( _HID_WITHIN(ARG_LIST) ) {
+				if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
+					/* end of number literal */
+					flags &= ~HID_WITHIN_NUM_LIT;
+					/* merge multiple arguments via OR */
+					if ( negLit ) {
+						if (lit > 0x80000000UL) {
+							return errorMsg.at(n, E_Number_overflow);
 						}
+						arg |= uint32_t(-int32_t(lit));
+						negLit = false;
 					} else {
-						return errorMsg.at(n, E_Unexpected_unit_name_character);
+						if (encMap.arg == EM_SIGNED_NUM_ARG && lit > 0x7FFFFFFFUL) {
+							return errorMsg.at(n, E_Number_overflow);
+						}
+						arg |= lit;
 					}
-				} else if ( _HID_WITHIN(UNIT_EXP) ) {
-					if (*ptr == '-') {
-						/* sign is only allowed at the beginning of the exponent */
-						if (tArg.length > 0) {
-							return errorMsg.at(n, E_Invalid_unit_exponent);
+					hasArg = ( ! multiArg ) || *ptr != ',';
+					if (*ptr == ')') {
+						continue; /* re-parse as argument list */
+					}
+				} else {
+					return errorMsg.at(n, E_Invalid_numeric_value);
+				}
+			} else if ( isWhitespace(*ptr) ) {
+				/* end of number literal */
+				flags &= ~HID_WITHIN_NUM_LIT;
+				afterMain = false;
+				tracer.literal(n, lit);
+				if (encodeUnsigned(out, lit) == 0) {
+					return errorMsg.at(n, E_Output_buffer_overflow);
+				}
+			} else {
+				return errorMsg.at(n, E_Invalid_numeric_value);
+			}
+		} else if ( _HID_WITHIN(ARG_LIST) ) {
+			if ( hasArg ) {
+				if (*ptr == ')') {
+					/* end of argument list */
+					flags &= ~(HID_WITHIN_ARG_LIST | HID_WITHIN_UNIT_SYS);
+					if (encMap.arg == EM_SIGNED_NUM_ARG) {
+						item |= encodedSizeValue(encodedSize(int32_t(arg)));
+						afterMain = isMainItem(item);
+						tracer.item(n, item, arg);
+						if (encodeUnsigned(out, item) == 0 || encodeSigned(out, int32_t(arg)) == 0) {
+							return errorMsg.at(n, E_Output_buffer_overflow);
 						}
-						tArg.length++;
-					} else if ( isDigit(*ptr) ) {
-						tArg.length++;
+					} else if (encMap.arg == EM_UNIT_EXP) {
+						/* UnitExponent */
+						const int32_t sArg = int32_t(arg);
+						if (sArg > 7 || sArg < -8) {
+							return errorMsg.at(n, E_Argument_value_out_of_range);
+						}
+						afterMain = false;
+						tracer.item(n, item | 1, uint32_t(sArg & 0xF));
+						/* encoding one byte data; see unitExpMap */
+						if (encodeUnsigned(out, item | 1) == 0 || encodeUnsigned(out, uint32_t(sArg & 0xF)) == 0) {
+							return errorMsg.at(n, E_Output_buffer_overflow);
+						}
+					} else if (encMap.arg == EM_PHYSICAL_SET) {
+						/* PhysicalSet */
+						if (arg > 0xFF || physicalSets >= 0xFF) {
+							return errorMsg.at(n, E_Argument_value_out_of_range);
+						}
+						physicalSets++;
+						afterMain = false;
+						tracer.physical(n, item, physicalSets, arg);
+					} else if (encMap.arg == EM_DESIGNATOR) {
+						/* Designator */
+						if (physicalSets == 0) {
+							return errorMsg.at(n, E_Missing_PhysicalSet);
+						} else if (designator == 0) {
+							return errorMsg.at(n, E_Missing_designator_name);
+						} else if (arg > 0xFFFF) {
+							return errorMsg.at(n, E_Argument_value_out_of_range);
+						}
+						afterMain = false;
+						tracer.physical(n, item, designator, arg);
 					} else {
-						/* end of unit exponent */
-						flags &= ~HID_WITHIN_UNIT_EXP;
-						subError = E_Invalid_unit_exponent;
-						const Encoding * encUnitExp = findEncoding(tArg, encUnit->arg, dynMap, subError);
-						if (encUnitExp == NULL) {
-							return errorMsg.at(n, subError);
+						if (Policy::checks && encMap.arg == EM_DELIM) {
+							if (arg == 0) {
+								/* Delimiter(Close) */
+								if (delimLevel <= 0) {
+									return errorMsg.at(n, E_Unexpected_DelimiterClose);
+								}
+								delimLevel--;
+							} else if (arg == 1) {
+								/* Delimiter(Open) */
+								delimLevel++;
+							} else {
+								return errorMsg.at(n, E_Unexpected_Delimiter_value);
+							}
+						} else if (encMap.arg == EM_USAGE_PAGE || encMap.arg == EM_USAGE_ARG) {
+							/* UsagePage/Usage/UsageMinimum/UsageMaximum */
+							if (arg > 0xFFFF) {
+								return errorMsg.at(n, E_Argument_value_out_of_range);
+							}
+							if (encMap.arg == EM_USAGE_PAGE) {
+								/* UsagePage */
+								hasUsagePage = true;
+							}
+						} else if (Policy::checks && encMap.value == 0x74) {
+							/* ReportSize */
+							reportSizes++;
+						} else if (Policy::checks && encMap.value == 0x94) {
+							/* ReportCount */
+							reportCounts++;
+						}
+						item |= encodedSizeValue(encodedSize(arg));
+						afterMain = isMainItem(item);
+						tracer.item(n, item, arg);
+						if (encodeUnsigned(out, item) == 0 || encodeUnsigned(out, arg) == 0) {
+							return errorMsg.at(n, E_Output_buffer_overflow);
 						}
-						/* the unit exponent for the current unit is stored at the specific nipple */
-						const uint32_t offset = 4 * encUnit->value;
-						arg &= ~uint32_t(0xF << offset);
-						arg |= uint32_t(encUnitExp->value << offset);
-						flags |= HID_WITHIN_UNIT_DESC;
-						continue; /* re-parse as unit description */
 					}
-				} else if ( isAlpha(*ptr) ) {
-					/* start of unit name */
-					flags |= HID_WITHIN_UNIT;
+					/* commas are only allowed within argument lists */
+					multiArg = false;
+				} else if (multiArg && *ptr == ',') {
+					hasArg = false;
+				} else if ( ! isWhitespace(*ptr) ) {
+					return errorMsg.at(n, E_Unexpected_token);
+				}
+			} else {
+				if ( isItemChar(*ptr) ) {
+					/* start of argument */
+					flags |= HID_WITHIN_ARG;
 					tArg.start = ptr;
 					tArg.length = 1;
+				} else if (Policy::hex && ptr[0] == '0' && (n + 1) < len && ptr[1] == 'x') {
+					/* start of hex literal */
+					flags |= HID_WITHIN_HEX_LIT;
+					if ((n + 2) >= len) {
+						if (mode == CM_PARTIAL) {
+							/* more source code is needed to check the hex literal */
+							suspend = true;
+							break;
+						}
+						return errorMsg.at(n + 2, E_Unexpected_end_of_source);
+					}
+					if ( ! isHexDigit(ptr[2]) ) {
+						return errorMsg.at(n + 2, E_Invalid_hex_value);
+					}
+					lit = 0;
+					n++;
+					ptr++;
+				} else if (*ptr == '-') {
+					/* start of negative number literal */
+					if (encMap.arg != EM_SIGNED_NUM_ARG && encMap.arg != EM_UNIT_EXP) {
+						return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
+					}
+					flags |= HID_WITHIN_NUM_LIT;
+					lit = 0;
+					negLit = true;
+				} else if ( isDigit(*ptr) ) {
+					/* start of number literal */
+					flags |= HID_WITHIN_NUM_LIT;
+					lit = 0;
+					continue; /* re-parse as number literal */
+				} else if (Policy::params && *ptr == '{') {
+					/* start of user parameter */
+					flags |= HID_WITHIN_PARAM;
+					tArg.start = ptr + 1;
+					tArg.length = 0;
+				} else if (*ptr == '"') {
+					/* string argument of StringIndex|StringMinimum|StringMaximum, designator name or reference */
+					const bool isName = (encMap.arg == EM_DESIGNATOR);
+					const bool isRef = (encMap.value == 0x38 || encMap.value == 0x48 || encMap.value == 0x58);
+					if (encMap.value != 0x78 && encMap.value != 0x88 && encMap.value != 0x98 && ( ! isName ) && ( ! isRef )) {
+						return errorMsg.at(n, E_Strings_are_not_allowed_in_this_context);
+					}
+					if (isName && (designator != 0 || stringKind(source.data(), n) != SK_DESIGNATOR)) {
+						/* the designator name needs to be the first argument */
+						return errorMsg.at(n, E_Strings_are_not_allowed_in_this_context);
+					}
+					size_t run = 1;
+					while ((n + run) < len && ptr[run] != 0 && ptr[run] != '"' && ptr[run] != '\r' && ptr[run] != '\n') {
+						run++;
+					}
+					if ((n + run) >= len || ptr[run] == 0) {
+						if (mode == CM_PARTIAL) {
+							/* more source code is needed to complete the string */
+							suspend = true;
+							break;
+						}
+						return errorMsg.at(n + run, E_Missing_closing_quote);
+					} else if (ptr[run] != '"') {
+						return errorMsg.at(n + run, E_Missing_closing_quote);
+					}
+					const Token str{ptr + 1, run - 1};
+					if (stringDescriptorSize(str) == 0) {
+						return errorMsg.at(n + 1, E_Invalid_string);
+					}
+					if ( isName ) {
+						designator = sourceDesignatorIndex(source, n, str, true, state.designators, 0);
+						if (designator > 0xFF) {
+							return errorMsg.at(n, E_Argument_value_out_of_range);
+						}
+					} else if ( isRef ) {
+						/* DesignatorIndex|DesignatorMinimum|DesignatorMaximum */
+						const size_t index = sourceDesignatorIndex(source, n, str, false, state.designators, 0);
+						if (index == 0) {
+							return errorMsg.at(n + 1, E_Unknown_designator_name);
+						}
+						arg |= uint32_t(index);
+					} else {
+						const size_t index = sourceStringIndex(source, n, str, state.strings, 0);
+						if (index > 0xFF) {
+							return errorMsg.at(n, E_Argument_value_out_of_range);
+						}
+						tracer.string(n, str, index);
+						arg |= uint32_t(index);
+					}
+					hasArg = true;
+					n += run;
+					ptr += run;
 				} else if (*ptr == ')') {
-					/* end of unit description */
-					flags &= ~(HID_WITHIN_ARG | HID_WITHIN_UNIT_SYS | HID_WITHIN_UNIT_DESC);
+					/* end of argument list */
+					return errorMsg.at(n, E_Missing_argument);
 				} else if ( ! isWhitespace(*ptr) ) {
-					return errorMsg.at(n, E_Unexpected_unit_name_character);
+					return errorMsg.at(n, E_Unexpected_argument_name_character);
+				}
+			}
+		}
+		n++;
+		ptr++;
+		if ( colEnd ) {
+			colEnd = false;
+			if (mode == CM_CHUNK && flags == HID_START) {
+				/* end of top-level collection */
+				state.position = n;
+				state.colLevel = colLevel;
+				state.delimLevel = delimLevel;
+				state.usageAtLevel = usageAtLevel;
+				state.reportSizes = reportSizes;
+				state.reportCounts = reportCounts;
+				state.annotations = annotations;
+				state.physicalSets = physicalSets;
+				state.hasUsagePage = hasUsagePage;
+				state.afterMain = afterMain;
+				state.usagePage = usagePage;
+				error = ::hid::error::Info();
+				return true;
+			}
+		}
+	}
+	if (mode == CM_PARTIAL && (suspend || n >= len)) {
+		/* more source code is needed to complete the current item */
+		error = ::hid::error::Info();
+		return true;
+	}
+	/* end of source code */
+	if (_HID_WITHIN(HEX_LIT) || _HID_WITHIN(NUM_LIT)) {
+		/* end of hex/number literal */
+		flags &= ~(HID_WITHIN_HEX_LIT | HID_WITHIN_NUM_LIT);
+		if (flags == HID_START) {
+			tracer.literal(n, lit);
+			if (encodeUnsigned(out, lit) == 0) {
+				return errorMsg.at(n, E_Output_buffer_overflow);
+			}
+		}
+	}
+	if ( _HID_WITHIN(ITEM) ) {
+		flags &= ~HID_WITHIN_ITEM;
+		subError = E_Invalid_item_name;
+		if ( ! findEncoding(tItem, EM_ITEM, encMap, subError, tracer, n) ) {
+			return errorMsg.at(n, subError);
+		} else if (encMap.arg == EM_COL_ARG) {
+			/* Collection */
+			if (Policy::checks && usageAtLevel != colLevel) {
+				return errorMsg.at(n, E_Missing_Usage_for_Collection);
+			}
+			colLevel++;
+		} else if (encMap.arg == EM_END_COL) {
+			/* EndCollection */
+			if (Policy::checks && colLevel <= 0) {
+				return errorMsg.at(n, E_Unexpected_EndCollection);
+			}
+			if ( Policy::checks ) {
+				if (reportSizes < reportCounts) {
+					return errorMsg.at(n, E_Missing_ReportSize);
+				} else if (reportCounts < reportSizes) {
+					return errorMsg.at(n, E_Missing_ReportCount);
+				}
+			}
+			colLevel--;
+			usageAtLevel--;
+		}
+		/* end of item */
+		if (encMap.arg != EM_NONE && (encMap.hasNamedArgs() || encMap.arg == EM_USAGE_ARG)) {
+			return errorMsg.at(n, E_Missing_argument);
+		}
+		if (flags == HID_START) {
+			tracer.item(n, encMap.value, 0);
+			if (encodeUnsigned(out, encMap.value) == 0) {
+				return errorMsg.at(n, E_Output_buffer_overflow);
+			}
+		}
+	}
+	if (Policy::checks && colLevel > 0) {
+		return errorMsg.at(n, E_Missing_EndCollection);
+	}
+	if (Policy::checks && delimLevel > 0) {
+		return errorMsg.at(n, E_Missing_DelimiterClose);
+	}
+	if (flags != HID_START && flags != HID_WITHIN_COMMENT) {
+		return errorMsg.at(n, E_Unexpected_end_of_source);
+	}
+	state.position = n;
+	state.annotations = annotations;
+	state.physicalSets = physicalSets;
+	state.finished = true;
+	error = ::hid::error::Info();
+	return true;
+#undef _HID_RUN
+#undef _HID_WITHIN
+}
+
+
+/**
+ * Compiles the HID description into the given buffer with all language features and checks.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @param[in,out] state - compiler state to start from and to update
+ * @param[in] mode - compile mode
+ * @param[in,out] tracer - tracer
+ * @return true on success, else false
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * @tparam Writer - shall implement `write(uint8_t)` and `size_t getPosition()`
+ * @tparam Tracer - see `NullTracer`
+ * @see FullPolicy
+ */
+template <typename Source, typename Writer, typename Tracer>
+constexpr inline bool compile(const Source & source, Writer & out, ::hid::error::Info & error, CompileState & state, const CompileMode mode, Tracer & tracer) noexcept {
+	return compile<FullPolicy>(source, out, error, state, mode, tracer);
+}
+
+
+/**
+ * Compiles the HID description into the given buffer. Forwards to `compile()` with `SourceView`
+ * to avoid an instantiation per source code size and parameter count.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @param[in,out] state - compiler state to start from and to update
+ * @param[in] mode - compile mode
+ * @param[in,out] tracer - tracer
+ * @return true on success, else false
+ * @tparam S - source size in characters
+ * @tparam P - parameter count
+ * @tparam Writer - shall implement `write(uint8_t)` and `size_t getPosition()`
+ * @tparam Tracer - see `NullTracer`
+ */
+template <size_t S, size_t P, typename Writer, typename Tracer>
+constexpr inline bool compile(const ::hid::detail::Source<S, P> & source, Writer & out, ::hid::error::Info & error, CompileState & state, const CompileMode mode, Tracer & tracer) noexcept {
+	return compile(SourceView(source), out, error, state, mode, tracer);
+}
+
+
+/**
+ * Compiles the HID description into the given buffer without tracing.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @param[in,out] state - compiler state to start from and to update
+ * @param[in] mode - compile mode
+ * @return true on success, else false
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * @tparam Writer - shall implement `write(uint8_t)`
+ */
+template <typename Source, typename Writer>
+constexpr inline bool compile(const Source & source, Writer & out, ::hid::error::Info & error, CompileState & state, const CompileMode mode) noexcept {
+	NullTracer tracer;
+	return compile(source, out, error, state, mode, tracer);
+}
+
+
+/**
+ * Compiles the HID description into the given buffer and reports all compiler events to
+ * the given tracer.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @param[in,out] tracer - tracer
+ * @return true on success, else false
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * @tparam Writer - shall implement `write(uint8_t)`
+ * @tparam Tracer - see `NullTracer`
+ */
+template <typename Source, typename Writer, typename Tracer>
+constexpr inline bool compile(const Source & source, Writer & out, ::hid::error::Info & error, Tracer & tracer) noexcept {
+	CompileState state;
+	return compile(source, out, error, state, CM_ALL, tracer);
+}
+
+
+/**
+ * Compiles the HID description into the given buffer.
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @return true on success, else false
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * @tparam Writer - shall implement `write(uint8_t)`
+ * @remarks Uses `DefaultTracer`, which prints every compiler step if `HID_DESCRIPTOR_DEBUG` is defined.
+ */
+template <typename Source, typename Writer>
+constexpr inline bool compile(const Source & source, Writer & out, ::hid::error::Info & error) noexcept {
+	DefaultTracer tracer;
+	return compile(source, out, error, tracer);
+}
+
+
+/**
+ * Compiles the HID description into the given buffer with the given compile policy
+ * (e.g. `compile<LeanPolicy>(source, out, error)`).
+ * 
+ * @param[in] source - source code description
+ * @param[out] out - output writer instance
+ * @param[out] error - possible error
+ * @return true on success, else false
+ * @tparam Policy - enabled feature groups (see `FullPolicy`)
+ * @tparam Source - shall implement `size_t size()`, `const char * data()` and `ParamMatch find(Token)`
+ * @tparam Writer - shall implement `write(uint8_t)`
+ * @remarks Uses `DefaultTracer`, which prints every compiler step if `HID_DESCRIPTOR_DEBUG` is defined.
+ */
+template <typename Policy, typename Source, typename Writer>
+constexpr inline bool compile(const Source & source, Writer & out, ::hid::error::Info & error) noexcept {
+	CompileState state;
+	DefaultTracer tracer;
+	return compile<Policy>(source, out, error, state, CM_ALL, tracer);
+}
+
+
+/**
+ * Returns the byte size of the compiled HID descriptor.
+ * 
+ * @param[in] source - source code description
+ * @return compiled HID descriptor size
+ */
+template <size_t S, size_t P>
+constexpr inline size_t compiledSize(const ::hid::detail::Source<S, P> & source) noexcept {
+	::hid::error::Info error;
+	SizeEstimator out;
+	NullTracer tracer;
+	compile(SourceView(source), out, error, tracer);
+	return out.getPosition();
+}
+
+
+/**
+ * Returns the byte size of the compiled HID descriptor.
+ * 
+ * @param[in] source - source code description
+ * @return compiled HID descriptor size
+ */
+template <size_t S, size_t P>
+constexpr inline ::hid::error::Info compileError(const ::hid::detail::Source<S, P> & source) noexcept {
+	::hid::error::Info error;
+	NullWriter out;
+	NullTracer tracer;
+	compile(SourceView(source), out, error, tracer);
+	return error;
+}
+
+
+/**
+ * Compiles the chunk which follows the given compiler state.
+ * 
+ * @param[in] source - source code description
+ * @param[in] prev - compiler state after the previous chunk
+ * @return compiler state after this chunk
+ */
+constexpr inline CompileState compileChunk(const SourceView & source, const CompileState & prev) noexcept {
+	CompileState state{prev};
+	state.size = 0;
+	if ( state.finished ) {
+		return state;
+	}
+	SizeEstimator out;
+	if ( ! compile(source, out, state.error, state, CM_CHUNK) ) {
+		state.finished = true;
+	}
+	state.size = out.getPosition();
+	return state;
+}
+
+
+/**
+ * Source code of a chunked compiled HID descriptor. The source code is instantiated only once to
+ * allow each chunk to refer to it without copying it.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ */
+template <typename Gen>
+struct ChunkSource {
+	static constexpr const decltype(Gen::get()) value = Gen::get(); /**< Source code. */
+};
+
+
+template <typename Gen>
+constexpr const decltype(Gen::get()) ChunkSource<Gen>::value;
+
+
+/**
+ * Compiler state before the chunk with the given index. Every chunk is compiled within its own
+ * constant expression to stay within the compiler's evaluation limits for large descriptors.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @tparam I - chunk index
+ */
+template <typename Gen, size_t I>
+struct ChunkState {
+	static constexpr const CompileState value = compileChunk(SourceView(ChunkSource<Gen>::value), ChunkState<Gen, I - 1>::value); /**< Compiler state. */
+};
+
+
+template <typename Gen, size_t I>
+constexpr const CompileState ChunkState<Gen, I>::value;
+
+
+/**
+ * Compiler state before the first chunk.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ */
+template <typename Gen>
+struct ChunkState<Gen, 0> {
+	static constexpr const CompileState value{}; /**< Compiler state. */
+};
+
+
+template <typename Gen>
+constexpr const CompileState ChunkState<Gen, 0>::value;
+
+
+/**
+ * Number of chunks within the source code.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ */
+template <typename Gen, size_t I = 1, bool Finished = ChunkState<Gen, I>::value.finished>
+struct ChunkCount {
+	enum { value = ChunkCount<Gen, I + 1>::value }; /**< Number of chunks. */
+};
+
+
+template <typename Gen, size_t I>
+struct ChunkCount<Gen, I, true> {
+	enum { value = I }; /**< Number of chunks. */
+};
+
+
+/**
+ * Compiled size of the chunks I to K.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @tparam I - first chunk index
+ * @tparam K - last chunk index
+ */
+template <typename Gen, size_t I, size_t K>
+struct ChunkSize {
+	enum { value = ChunkState<Gen, I + 1>::value.size + ChunkSize<Gen, I + 1, K>::value }; /**< Size in bytes. */
+};
+
+
+template <typename Gen, size_t K>
+struct ChunkSize<Gen, K, K> {
+	enum { value = ChunkState<Gen, K + 1>::value.size }; /**< Size in bytes. */
+};
+
+
+/**
+ * List of chunk indices.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @tparam I - chunk indices
+ */
+template <typename Gen, size_t... I>
+struct ChunkList {};
+
+
+template <typename Gen, size_t K, size_t... I>
+struct MakeChunkList {
+	typedef typename MakeChunkList<Gen, K - 1, K - 1, I...>::Type Type;
+};
+
+
+template <typename Gen, size_t... I>
+struct MakeChunkList<Gen, 0, I...> {
+	typedef ChunkList<Gen, I...> Type;
+};
+
+
+template <typename Gen, size_t I>
+struct ChunkData;
+
+
+/**
+ * Single report field as defined by one Input, Output or Feature item.
+ * 
+ * @see HID 1.11 ch. 6.2.2.5 and 8.4
+ */
+struct ReportField {
+	size_t item; /**< byte position of the main item */
+	size_t locals; /**< byte position of the first item after the previous main item */
+	uint32_t localsPage; /**< UsagePage at `locals` */
+	uint32_t bitOffset; /**< bit offset within the report excluding the report ID byte */
+	uint32_t size; /**< ReportSize in bits */
+	uint32_t count; /**< ReportCount */
+	int32_t logicalMinimum; /**< LogicalMinimum */
+	int32_t logicalMaximum; /**< LogicalMaximum */
+	uint16_t flags; /**< main item data (see inputArgMap) */
+	uint8_t type; /**< RT_INPUT, RT_OUTPUT or RT_FEATURE */
+	uint8_t reportId; /**< report ID or 0 if not used */
+	
+	/** Returns true for constant (padding) fields. */
+	constexpr inline bool isConstant() const noexcept {
+		return (this->flags & 0x001) != 0;
+	}
+	
+	/** Returns true for variable fields and false for array fields. */
+	constexpr inline bool isVariable() const noexcept {
+		return (this->flags & 0x002) != 0;
+	}
+	
+	/** Returns true for relative fields and false for absolute fields. */
+	constexpr inline bool isRelative() const noexcept {
+		return (this->flags & 0x004) != 0;
+	}
+	
+	/** Returns true if the field values need to be sign extended. */
+	constexpr inline bool isSigned() const noexcept {
+		return this->logicalMinimum < 0;
+	}
+	
+	/** Returns the total field size in bits. */
+	constexpr inline uint32_t bits() const noexcept {
+		return this->size * this->count;
+	}
+};
+
+
+/**
+ * Report field element matching a searched usage.
+ */
+struct UsageMatch {
+	ReportField field; /**< report field containing the usage */
+	uint32_t index; /**< element index within the field */
+	uint32_t bitOffset; /**< element bit offset within the report */
+	bool valid; /**< true if a matching field was found */
+};
+
+
+/**
+ * Field annotation (e.g. `@leftStick`) of a compiled HID descriptor.
+ */
+struct FieldName {
+	uint32_t hash; /**< name hash (see `nameHash()`) */
+	uint32_t end; /**< output position right after the annotated main item */
+};
+
+
+/**
+ * Field annotations of a compiled HID descriptor.
+ * 
+ * @tparam A - number of annotations
+ */
+template <size_t A>
+struct FieldNames {
+	FieldName names[A]; /**< field annotations in source code order */
+	
+	/** Default constructor. */
+	constexpr inline FieldNames() noexcept:
+		names{}
+	{}
+	
+	/**
+	 * Returns the field annotations.
+	 * 
+	 * @return field annotations
+	 */
+	constexpr inline FieldName * getNames() noexcept {
+		return this->names;
+	}
+	
+	/**
+	 * Returns the field annotations.
+	 * 
+	 * @return field annotations
+	 */
+	constexpr inline const FieldName * getNames() const noexcept {
+		return this->names;
+	}
+	
+	/**
+	 * Returns the output position right after the main item with the given annotation.
+	 * 
+	 * @param[in] hash - name hash
+	 * @return output position or 0 if not found
+	 */
+	constexpr inline uint32_t findName(const uint32_t hash) const noexcept {
+		for (size_t i = 0; i < A; i++) {
+			if (this->names[i].hash == hash) {
+				return this->names[i].end;
+			}
+		}
+		return 0;
+	}
+};
+
+
+/**
+ * Field annotations of a compiled HID descriptor without any.
+ */
+template <>
+struct FieldNames<0> {
+	/**
+	 * Returns the field annotations.
+	 * 
+	 * @return `nullptr`
+	 */
+	constexpr inline FieldName * getNames() noexcept {
+		return nullptr;
+	}
+	
+	/**
+	 * Returns the field annotations.
+	 * 
+	 * @return `nullptr`
+	 */
+	constexpr inline const FieldName * getNames() const noexcept {
+		return nullptr;
+	}
+	
+	/**
+	 * Returns the output position right after the main item with the given annotation.
+	 * 
+	 * @return 0
+	 */
+	constexpr inline uint32_t findName(const uint32_t) const noexcept {
+		return 0;
+	}
+};
+
+
+/**
+ * Tracer which records the field annotations.
+ * 
+ * @tparam A - maximum number of annotations
+ * @see ::hid::detail::NullTracer
+ */
+template <size_t A>
+struct NameRecorder : NullTracer {
+	FieldName * names; /**< output array with `A` elements */
+	size_t count; /**< number of recorded annotations */
+	size_t offset; /**< added to each output position */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[out] n - output array with `A` elements
+	 * @param[in] o - added to each output position
+	 */
+	constexpr inline explicit NameRecorder(FieldName * n, const size_t o = 0) noexcept:
+		names{n},
+		count{0},
+		offset{o}
+	{}
+	
+	/**
+	 * @copydoc NullTracer::annotation()
+	 */
+	constexpr inline void annotation(const size_t /* pos */, const Token & name, const size_t outPos) noexcept {
+		if (this->count < A) {
+			this->names[this->count] = FieldName{nameHash(name.start, name.length), uint32_t(outPos + this->offset)};
+			this->count++;
+		}
+	}
+};
+
+
+/**
+ * Returns the number of field annotations within the given source code.
+ * 
+ * @param[in] source - source code description
+ * @return number of field annotations
+ */
+template <size_t S, size_t P>
+constexpr inline size_t annotationCount(const ::hid::detail::Source<S, P> & source) noexcept {
+	::hid::error::Info error;
+	NullWriter out;
+	NullTracer tracer;
+	CompileState state;
+	compile(SourceView(source), out, error, state, CM_ALL, tracer);
+	return state.annotations;
+}
+
+
+constexpr inline UsageMatch findField(const uint8_t * desc, const size_t len, const uint32_t end) noexcept;
+template <size_t N, size_t A = 0>
+struct Descriptor;
+
+
+/**
+ * Compiled HID descriptor instance.
+ * 
+ * @tparam N - HID descriptor size
+ * @tparam A - number of field annotations (see `annotationCount()`)
+ */
+template <size_t N, size_t A>
+struct Descriptor : FieldNames<A> {
+    uint8_t data[N]; /**< Compiled HID descriptor data. */
+    enum { Size = N }; /**< Data size. */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 * @see ::hid::detail::compile()
+	 */
+	template <size_t S, size_t P>
+    constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & source) noexcept:
+		FieldNames<A>(),
+		data{0}
+	{
+		::hid::error::Info error;
+		BufferWriter out(this->data, N);
+		NameRecorder<A> tracer(this->getNames());
+		compile(SourceView(source), out, error, tracer);
+	}
+	
+	/**
+	 * Constructor. Compiles the chunk which follows the given compiler state.
+	 * 
+	 * @param[in] source - source code description
+	 * @param[in] state - compiler state after the previous chunk
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 * @see ::hid::detail::compile()
+	 */
+	template <size_t S, size_t P>
+	constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & source, const CompileState & state) noexcept:
+		FieldNames<A>(),
+		data{0}
+	{
+		CompileState next{state};
+		BufferWriter out(this->data, N);
+		NameRecorder<A> tracer(this->getNames());
+		if ( ! next.finished ) {
+			compile(SourceView(source), out, next.error, next, CM_CHUNK, tracer);
+		}
+	}
+	
+	/**
+	 * Constructor. Concatenates the given compiled chunks.
+	 * 
+	 * @param[in] chunks - chunk list
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 * @see DEF_HID_DESCRIPTOR_AS
+	 */
+	template <typename Gen, size_t... I>
+	constexpr inline explicit Descriptor(const ChunkList<Gen, I...> & /* chunks */) noexcept:
+		FieldNames<A>(),
+		data{0}
+	{
+		size_t pos = 0;
+		size_t name = 0;
+		const bool res[] = {this->append(pos, name, ChunkData<Gen, I>::value)...};
+		static_cast<void>(res);
+	}
+	
+	/**
+	 * Returns the data size.
+	 * 
+	 * @return data size
+	 */
+	constexpr inline size_t size() const {
+		return N;
+	}
+	
+	/**
+	 * Returns the report field with the given annotation (e.g. `field("leftStick")` for
+	 * `Input(Data, Var, Abs) @leftStick`).
+	 * 
+	 * @param[in] name - annotation name
+	 * @return found field with `index` 0 (check `valid`)
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 * Names are compared by hash. `compile()` rejects repeated annotation names and different
+	 * ones with the same hash, but a name which is not part of the source code may still match
+	 * by hash.
+	 */
+	constexpr inline UsageMatch field(const char * name) const noexcept {
+		return findField(this->data, N, this->findName(nameHash(name)));
+	}
+private:
+	/**
+	 * Appends the given chunk data and its field annotations.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in,out] name - field annotation index
+	 * @param[in] chunk - compiled chunk
+	 * @return true
+	 */
+	template <size_t M, size_t B>
+	constexpr inline bool append(size_t & pos, size_t & name, const Descriptor<M, B> & chunk) noexcept {
+		for (size_t i = 0; i < B && name < A; i++, name++) {
+			this->getNames()[name] = FieldName{chunk.getNames()[i].hash, uint32_t(chunk.getNames()[i].end + pos)};
+		}
+		for (size_t i = 0; i < M && pos < N; i++, pos++) {
+			this->data[pos] = chunk.data[i];
+		}
+		return true;
+	}
+};
+
+
+/**
+ * Compiled HID descriptor instance.
+ * 
+ * @tparam N - HID descriptor size
+ */
+template <>
+struct Descriptor<0> : FieldNames<0> {
+    uint8_t * data; /**< Compiled HID descriptor data. */
+    enum { Size = 0 }; /**< Data size. */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 * @see ::hid::detail::compile()
+	 */
+	template <size_t S, size_t P>
+    constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & /* source */) noexcept:
+		data{NULL}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @param[in] state - compiler state after the previous chunk
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	template <size_t S, size_t P>
+	constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & /* source */, const CompileState & /* state */) noexcept:
+		data{NULL}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] chunks - chunk list
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	template <typename Gen, size_t... I>
+	constexpr inline explicit Descriptor(const ChunkList<Gen, I...> & /* chunks */) noexcept:
+		data{NULL}
+	{}
+	
+	/**
+	 * Returns the data size.
+	 * 
+	 * @return data size
+	 */
+	constexpr inline size_t size() const noexcept {
+		return 0;
+	}
+	
+	/**
+	 * Returns the report field with the given annotation.
+	 * 
+	 * @return invalid field
+	 */
+	constexpr inline UsageMatch field(const char *) const noexcept {
+		return findField(nullptr, 0, 0);
+	}
+};
+
+
+/**
+ * Compiled data of the chunk with the given index.
+ * 
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @tparam I - chunk index
+ */
+template <typename Gen, size_t I>
+struct ChunkData {
+	static constexpr const Descriptor<ChunkState<Gen, I + 1>::value.size, ChunkState<Gen, I + 1>::value.annotations - ChunkState<Gen, I>::value.annotations> value{ChunkSource<Gen>::value, ChunkState<Gen, I>::value}; /**< Chunk data. */
+};
+
+
+template <typename Gen, size_t I>
+constexpr const Descriptor<ChunkState<Gen, I + 1>::value.size, ChunkState<Gen, I + 1>::value.annotations - ChunkState<Gen, I>::value.annotations> ChunkData<Gen, I>::value;
+
+
+/**
+ * Returns the compile error of a chunked compiled HID descriptor.
+ * 
+ * @return compile error
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @see DEF_HID_DESCRIPTOR_AS
+ */
+template <typename Gen>
+constexpr inline ::hid::error::Info chunkedError() noexcept {
+	return ChunkState<Gen, ChunkCount<Gen>::value>::value.error;
+}
+
+
+/**
+ * Compiles the HID descriptor chunk by chunk. The source code is split after each top-level
+ * collection and each chunk is compiled within its own constant expression evaluation.
+ * 
+ * @return compiled HID descriptor
+ * @tparam Gen - provides the source code via `static constexpr Source get()`
+ * @see DEF_HID_DESCRIPTOR_AS
+ */
+template <typename Gen>
+constexpr inline Descriptor<ChunkSize<Gen, 0, ChunkCount<Gen>::value - 1>::value, ChunkState<Gen, ChunkCount<Gen>::value>::value.annotations> chunkedDescriptor() noexcept {
+	return Descriptor<ChunkSize<Gen, 0, ChunkCount<Gen>::value - 1>::value, ChunkState<Gen, ChunkCount<Gen>::value>::value.annotations>(typename MakeChunkList<Gen, ChunkCount<Gen>::value>::Type());
+}
+
+
+/**
+ * Possible kinds of parameter dependent items.
+ * 
+ * @see ::hid::detail::ItemList
+ */
+enum ParamItemKind : uint8_t {
+	PK_UNSIGNED, /**< unsigned item argument */
+	PK_SIGNED,   /**< signed item argument (e.g. `LogicalMinimum`) */
+	PK_USAGE,    /**< usage or usage page argument (up to 16 bits) */
+	PK_UNIT_EXP, /**< `UnitExponent` argument (4 bits) */
+	PK_LITERAL   /**< top-level parameter literal (e.g. `{value}`) */
+};
+
+
+/**
+ * Item of a lowered HID descriptor whose argument depends on parameters.
+ * 
+ * @see ::hid::detail::ItemList
+ */
+struct ParamItem {
+	uint32_t offset; /**< position within the lowered data */
+	uint32_t arg; /**< parameter independent part of the argument */
+	uint8_t prefix; /**< item prefix without size bits */
+	uint8_t size; /**< encoded size within the lowered data in bytes (prefix and argument) */
+	uint8_t kind; /**< see `ParamItemKind` */
+	::hid::error::Info position; /**< source code position of the item end */
+};
+
+
+/**
+ * Parameter reference of a `ParamItem`.
+ * 
+ * @see ::hid::detail::ItemList
+ */
+struct ParamRef {
+	uint32_t hash; /**< parameter name hash (see `nameHash()`) */
+	uint32_t item; /**< index of the referencing item */
+	uint32_t keep; /**< argument bits not cleared by subsequent named arguments */
+	::hid::error::Info position; /**< source code position of the parameter end */
+};
+
+
+/**
+ * Tracer which records the parameter dependent items while lowering a HID descriptor
+ * with `LoweringSource`. Records beyond the given capacities are only counted.
+ * 
+ * @tparam Writer - writer passed to `compile()`
+ * @see ::hid::detail::NullTracer
+ */
+template <typename Writer>
+struct ItemRecorder : NullTracer {
+	const Writer & out; /**< writer passed to `compile()` */
+	const char * source; /**< source code */
+	ParamItem * items; /**< output array with `itemCapacity` elements */
+	ParamRef * refs; /**< output array with `refCapacity` elements */
+	size_t itemCapacity; /**< capacity of `items` */
+	size_t refCapacity; /**< capacity of `refs` */
+	size_t itemCount; /**< number of recorded items */
+	size_t refCount; /**< number of recorded parameter references */
+	size_t pending; /**< parameter references of the current item */
+	size_t cursorPos; /**< source code position of `cursor` */
+	NameOrder names; /**< parameter names seen so far */
+	::hid::error::Info cursor; /**< last computed source code position */
+	::hid::error::Info failure; /**< parameter related lowering error */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] o - writer passed to `compile()`
+	 * @param[in] s - source code
+	 * @param[out] i - output array with `ic` elements
+	 * @param[in] ic - capacity of `i`
+	 * @param[out] r - output array with `rc` elements
+	 * @param[in] rc - capacity of `r`
+	 */
+	constexpr inline explicit ItemRecorder(const Writer & o, const char * s, ParamItem * i, const size_t ic, ParamRef * r, const size_t rc) noexcept:
+		out(o),
+		source{s},
+		items{i},
+		refs{r},
+		itemCapacity{ic},
+		refCapacity{rc},
+		itemCount{0},
+		refCount{0},
+		pending{0},
+		cursorPos{0},
+		names('{'),
+		cursor{},
+		failure{}
+	{
+		this->cursor.line = 1;
+		this->cursor.column = 1;
+	}
+	
+	/**
+	 * Returns the line and column of the given source code position. Positions are expected
+	 * in ascending order.
+	 * 
+	 * @param[in] pos - source code position
+	 * @return source code position with line and column
+	 */
+	constexpr inline ::hid::error::Info positionOf(const size_t pos) noexcept {
+		::hid::error::ErrorWriter::advance(this->cursor, this->source + this->cursorPos, pos - this->cursorPos);
+		this->cursorPos = pos;
+		return this->cursor;
+	}
+	
+	/**
+	 * Records a parameter reference of the current item.
+	 * 
+	 * @param[in] token - parameter name token
+	 */
+	constexpr inline void param(const Token & token) noexcept {
+		const size_t pos = size_t(token.start - this->source);
+		const ::hid::error::Info position = this->positionOf(pos + token.length);
+		if (this->names.clashes(this->source, pos - 1, token) && this->failure.message == ::hid::error::E_NO_ERROR) {
+			/* parameter references only keep the name hash */
+			this->failure = position;
+			this->failure.message = ::hid::error::E_Ambiguous_parameter_name;
+		}
+		if (this->refCount < this->refCapacity) {
+			this->refs[this->refCount] = ParamRef{nameHash(token.start, token.length), uint32_t(this->itemCount), UINT32_C(0xFFFFFFFF), position};
+		}
+		this->refCount++;
+		this->pending++;
+	}
+	
+	/**
+	 * @copydoc NullTracer::clear()
+	 */
+	constexpr inline void clear(const size_t /* pos */, const uint32_t mask) noexcept {
+		for (size_t r = this->refCount - this->pending; r < this->refCount && r < this->refCapacity; r++) {
+			this->refs[r].keep &= ~mask;
+		}
+	}
+	
+	/**
+	 * @copydoc NullTracer::item()
+	 */
+	constexpr inline void item(const size_t pos, const uint32_t prefix, const uint32_t data) noexcept {
+		if (this->pending == 0) {
+			return;
+		}
+		const uint8_t base = uint8_t(prefix & 0xFC);
+		uint8_t kind = PK_UNSIGNED;
+		uint32_t arg = data;
+		if (base == 0x14 || base == 0x24 || base == 0x34 || base == 0x44) {
+			kind = PK_SIGNED;
+		} else if (base == 0x04 || base == 0x08 || base == 0x18 || base == 0x28) {
+			kind = PK_USAGE;
+		} else if (base == 0x54) {
+			kind = PK_UNIT_EXP;
+			arg = ((data & 0x8) != 0) ? (data | UINT32_C(0xFFFFFFF0)) : data;
+		} else if (base == 0xA8 && this->failure.message == ::hid::error::E_NO_ERROR) {
+			/* the delimiter nesting needs to be parameter independent */
+			this->failure = this->positionOf(pos);
+			this->failure.message = ::hid::error::E_Unexpected_Delimiter_value;
+		}
+		this->record(pos, base, uint8_t((prefix & 3) == 3 ? 5 : (prefix & 3) + 1), kind, arg);
+	}
+	
+	/**
+	 * @copydoc NullTracer::literal()
+	 */
+	constexpr inline void literal(const size_t pos, const uint32_t value) noexcept {
+		if (this->pending > 0) {
+			this->record(pos, 0, uint8_t(encodedSize(value)), PK_LITERAL, value);
+		}
+	}
+	
+	/**
+	 * @copydoc NullTracer::physical()
+	 */
+	constexpr inline void physical(const size_t /* pos */, const uint32_t /* prefix */, const size_t /* index */, const uint32_t /* value */) noexcept {
+		/* physical descriptor sets are not part of the report descriptor */
+		this->refCount -= this->pending;
+		this->pending = 0;
+	}
+private:
+	/**
+	 * Records the current item with its pending parameter references.
+	 * 
+	 * @param[in] pos - source code position
+	 * @param[in] prefix - item prefix without size bits
+	 * @param[in] size - encoded size in bytes
+	 * @param[in] kind - item kind (see `ParamItemKind`)
+	 * @param[in] arg - parameter independent part of the argument
+	 */
+	constexpr inline void record(const size_t pos, const uint8_t prefix, const uint8_t size, const uint8_t kind, const uint32_t arg) noexcept {
+		if (this->itemCount < this->itemCapacity) {
+			this->items[this->itemCount] = ParamItem{uint32_t(this->out.getPosition()), arg, prefix, size, kind, this->positionOf(pos)};
+		}
+		this->itemCount++;
+		this->pending = 0;
+	}
+};
+
+
+/**
+ * Source code wrapper which leaves all parameters unresolved. Each parameter is reported to
+ * the given recorder and evaluates to 0.
+ * 
+ * @tparam Recorder - see `ItemRecorder`
+ */
+template <typename Recorder>
+struct LoweringSource {
+	const SourceView & source; /**< wrapped source code */
+	Recorder & recorder; /**< receives the parameter references */
+	
+	/**
+	 * Returns a pointer to the source code.
+	 * 
+	 * @return source code pointer
+	 */
+	constexpr inline const char * data() const noexcept {
+		return this->source.data();
+	}
+	
+	/**
+	 * Returns the source code size in bytes.
+	 * 
+	 * @return source code size in characters
+	 */
+	constexpr inline size_t size() const noexcept {
+		return this->source.size();
+	}
+	
+	/**
+	 * Records the given parameter reference.
+	 * 
+	 * @param[in] token - parameter name token
+	 * @return valid match with value 0
+	 */
+	constexpr inline ParamMatch find(const Token & token) const noexcept {
+		this->recorder.param(token);
+		return ParamMatch{0, true};
+	}
+	
+	/**
+	 * @copydoc SourceView::stringIndex()
+	 */
+	constexpr inline size_t stringIndex(const size_t pos, const Token & str, StringOrder & order) const noexcept {
+		return this->source.stringIndex(pos, str, order);
+	}
+	
+	/**
+	 * @copydoc SourceView::designatorIndex()
+	 */
+	constexpr inline size_t designatorIndex(const size_t pos, const Token & str, const bool define, StringOrder & order) const noexcept {
+		return this->source.designatorIndex(pos, str, define, order);
+	}
+	
+	/**
+	 * @copydoc SourceView::nameClash()
+	 */
+	constexpr inline bool nameClash(const size_t pos, const Token & name, NameOrder & order) const noexcept {
+		return this->source.nameClash(pos, name, order);
+	}
+};
+
+
+/**
+ * Number of elements needed to lower a HID descriptor.
+ * 
+ * @see ::hid::detail::ItemList
+ */
+struct LoweredSize {
+	size_t size; /**< lowered data size in bytes */
+	size_t items; /**< number of parameter dependent items */
+	size_t refs; /**< number of parameter references */
+	::hid::error::Info error; /**< lowering error */
+};
+
+
+/**
+ * Returns the number of elements needed to lower the given HID descriptor and the lowering
+ * error like `ItemList::error`.
+ * 
+ * @param[in] source - source code description
+ * @return lowered size
+ */
+constexpr inline LoweredSize loweredSize(const SourceView & source) noexcept {
+	::hid::error::Info error;
+	SizeEstimator out;
+	ItemRecorder<SizeEstimator> recorder(out, source.data(), nullptr, 0, nullptr, 0);
+	const LoweringSource<ItemRecorder<SizeEstimator>> lowering{source, recorder};
+	if (compile(lowering, out, error, recorder) && recorder.failure.message != ::hid::error::E_NO_ERROR) {
+		error = recorder.failure;
+	}
+	return LoweredSize{out.getPosition(), recorder.itemCount, recorder.refCount, error};
+}
+
+
+/**
+ * Returns the number of elements needed to lower the given HID descriptor.
+ * 
+ * @param[in] source - source code description
+ * @return lowered size
+ */
+template <size_t S, size_t P>
+constexpr inline LoweredSize loweredSize(const ::hid::detail::Source<S, P> & source) noexcept {
+	return loweredSize(SourceView(source));
+}
+
+
+/**
+ * HID descriptor lowered to an intermediate item list. Lowering compiles the source code once
+ * with all parameters left unresolved. The output is kept as pre-encoded data and each item
+ * with parameters is recorded with its parameter independent argument. Binding a parameter set
+ * copies the parameter independent data and re-encodes only these items. Arguments which
+ * change their width are re-encoded with minimal length like `compile()` does.
+ * 
+ * @tparam N - lowered data capacity in bytes
+ * @tparam I - parameter dependent item capacity
+ * @tparam R - parameter reference capacity
+ * @remarks The lowered data is the descriptor compiled with all parameters set to 0.
+ * Parameters within `Delimiter` items are rejected as the delimiter nesting is checked during
+ * lowering. Parameters passed with the source code are ignored. Only the parameter name hashes
+ * are kept. Different parameter names with the same hash are rejected during lowering.
+ * @see DEF_HID_ITEM_LIST_AS
+ */
+template <size_t N, size_t I, size_t R>
+struct ItemList {
+	uint8_t data[N + 1]; /**< lowered data */
+	ParamItem items[I + 1]; /**< parameter dependent items */
+	ParamRef refs[R + 1]; /**< parameter references */
+	size_t size; /**< lowered data size in bytes */
+	size_t itemCount; /**< number of parameter dependent items */
+	size_t refCount; /**< number of parameter references */
+	::hid::error::Info error; /**< lowering error */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @remarks This can be processed at compile time (i.e. used as constexpr).
+	 * Fails with `E_Output_buffer_overflow` if any capacity is exceeded.
+	 */
+	constexpr inline explicit ItemList(const SourceView & source) noexcept:
+		data{0},
+		items{},
+		refs{},
+		size{0},
+		itemCount{0},
+		refCount{0},
+		error{}
+	{
+		BufferWriter out(this->data, N);
+		ItemRecorder<BufferWriter> recorder(out, source.data(), this->items, I, this->refs, R);
+		const LoweringSource<ItemRecorder<BufferWriter>> lowering{source, recorder};
+		if ( ! compile(lowering, out, this->error, recorder) ) {
+			return;
+		}
+		if (recorder.failure.message != ::hid::error::E_NO_ERROR) {
+			this->error = recorder.failure;
+		} else if (recorder.itemCount > I || recorder.refCount > R) {
+			this->error.message = ::hid::error::E_Output_buffer_overflow;
+		} else {
+			this->size = out.getPosition();
+			this->itemCount = recorder.itemCount;
+			this->refCount = recorder.refCount;
+		}
+	}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @remarks This can be processed at compile time (i.e. used as constexpr).
+	 */
+	template <size_t S, size_t P>
+	constexpr inline explicit ItemList(const ::hid::detail::Source<S, P> & source) noexcept:
+		ItemList(SourceView(source))
+	{}
+	
+	/**
+	 * Binds the given parameter set and writes the HID descriptor. The output is equal to
+	 * the output of `compile()` with the same source code and parameter set.
+	 * 
+	 * @param[in] params - parameter set; the last parameter with a given name is used
+	 * @param[in] count - number of parameters
+	 * @param[out] out - output writer instance
+	 * @param[out] err - possible error
+	 * @return true on success, else false
+	 * @tparam Writer - shall implement `write(uint8_t)`
+	 * @remarks Use `SizeEstimator` to get the output size for the given parameter set.
+	 * Parameters are matched by name hash. Fails with `E_Ambiguous_parameter_name` if the
+	 * parameter set contains a different name with the same hash as a referenced one.
+	 */
+	template <typename Writer>
+	constexpr inline bool bind(const Param * params, const size_t count, Writer & out, ::hid::error::Info & err) const noexcept {
+		using namespace ::hid::error;
+		if (this->error.message != E_NO_ERROR) {
+			err = this->error;
+			return false;
+		}
+		err = Info();
+		size_t pos = 0;
+		size_t ref = 0;
+		for (size_t i = 0; i < this->itemCount; i++) {
+			const ParamItem & item = this->items[i];
+			/* parameter independent data up to this item */
+			for (; pos < item.offset; pos++) {
+				if ( ! out.write(this->data[pos]) ) {
+					err.message = E_Output_buffer_overflow;
+					return false;
 				}
-			} else if ( isArgChar(*ptr) ) {
-				tArg.length++;
-			} else if (_HID_WITHIN(UNIT_SYS)) {
-				if ( hasArg ) {
-					/* invalid internal state */
-					return errorMsg.at(n, E_Internal_error);
-				} else if (isWhitespace(*ptr) || *ptr == '(') {
-					/* skip whitespaces */
-					if ( isWhitespace(*ptr) ) {
-						while ((n + 1) < len && isWhitespace(ptr[1])) {
-							n++;
-							ptr++;
-						}
-						if ((n + 1) < len && ptr[1] == '(') {
-							n++;
-							ptr++;
-						}
-					}
-					/* start of unit description for the given unit system */
-					subError = E_Invalid_unit_system_name;
-					const Encoding * encUnitSys = findEncoding(tArg, encMap->arg, dynMap, subError);
-					if (encUnitSys == NULL) {
-						return errorMsg.at(n, subError);
-					}
-					flags |= HID_WITHIN_UNIT_DESC;
-					arg = encUnitSys->value;
-					encMap = encUnitSys;
-					hasArg = true;
-				} else if (*ptr == ')') {
-					/* end of unit system */
-					flags &= ~HID_WITHIN_UNIT_SYS;
-					continue; /* re-parse as argument */
-				} else {
-					return errorMsg.at(n, E_Unexpected_argument_name_character);
+			}
+			uint32_t arg = item.arg;
+			for (; ref < this->refCount && this->refs[ref].item == i; ref++) {
+				const ParamRef & r = this->refs[ref];
+				size_t p = count;
+				while (p > 0 && nameHash(params[p - 1].name) != r.hash) {
+					p--;
 				}
-			} else if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
-				/* end of argument */
-				flags &= ~HID_WITHIN_ARG;
-				/* possible Usage|UsageMinimum|UsageMaximum argument according to current UsagePage */
-				if (encMap->arg == usageArg) {
-					if (usagePage == NULL || usagePage->arg == NULL) {
-						if ( hasUsagePage ) {
-							return errorMsg.at(n, E_Missing_named_UsagePage);
-						} else {
-							return errorMsg.at(n, E_Missing_UsagePage);
-						}
+				EMessage msg = E_NO_ERROR;
+				if (p == 0) {
+					msg = E_Expected_valid_parameter_name_here;
+				} else if ( hasParamClash(params, p - 1, r.hash) ) {
+					msg = E_Ambiguous_parameter_name;
+				} else {
+					const int64_t value = params[p - 1].value;
+					if (item.kind == PK_LITERAL && value < 0) {
+						msg = E_Negative_numbers_are_not_allowed_in_this_context;
+					} else if (item.kind == PK_SIGNED ? (value < INT64_C(-0x80000000) || value > INT64_C(0x7FFFFFFF)) : (value < 0 || value > UINT32_C(0xFFFFFFFF))) {
+						msg = E_Parameter_value_out_of_range;
 					}
-					encMap = usagePage;
+					arg |= uint32_t(value) & r.keep;
 				}
-				subError = E_Invalid_argument_name;
-				const Encoding * encItem = findEncoding(tArg, encMap->arg, dynMap, subError);
-				if (encItem == NULL) {
-					return errorMsg.at(n, subError);
-				} else if (encMap->arg == usagePageMap) {
-					/* Usage map from UsagePage argument */
-					usagePage = encItem;
+				if (msg != E_NO_ERROR) {
+					err = r.position;
+					err.message = msg;
+					return false;
+				}
+			}
+			pos += item.size;
+			bool ok = true;
+			switch (item.kind) {
+			case PK_LITERAL:
+				ok = encodeUnsigned(out, arg) != 0;
+				break;
+			case PK_SIGNED:
+				ok = encodeUnsigned(out, item.prefix | encodedSizeValue(encodedSize(int32_t(arg)))) != 0 && encodeSigned(out, int32_t(arg)) != 0;
+				break;
+			case PK_UNIT_EXP:
+				if (int32_t(arg) > 7 || int32_t(arg) < -8) {
+					err = item.position;
+					err.message = E_Argument_value_out_of_range;
+					return false;
+				}
+				ok = encodeUnsigned(out, uint32_t(item.prefix | 1)) != 0 && encodeUnsigned(out, arg & 0xF) != 0;
+				break;
+			default:
+				if (item.kind == PK_USAGE && arg > 0xFFFF) {
+					err = item.position;
+					err.message = E_Argument_value_out_of_range;
+					return false;
+				}
+				ok = encodeUnsigned(out, item.prefix | encodedSizeValue(encodedSize(arg))) != 0 && encodeUnsigned(out, arg) != 0;
+				break;
+			}
+			if ( ! ok ) {
+				err = item.position;
+				err.message = E_Output_buffer_overflow;
+				return false;
+			}
+		}
+		for (; pos < this->size; pos++) {
+			if ( ! out.write(this->data[pos]) ) {
+				err.message = E_Output_buffer_overflow;
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	/**
+	 * Binds the parameter set of the given source code and writes the HID descriptor.
+	 * 
+	 * @param[in] source - source code description with parameter set
+	 * @param[out] out - output writer instance
+	 * @param[out] err - possible error
+	 * @return true on success, else false
+	 * @tparam Writer - shall implement `write(uint8_t)`
+	 * @remarks Only the parameters of `source` are used. The source code itself is ignored.
+	 */
+	template <size_t S, size_t P, typename Writer>
+	constexpr inline bool bind(const ::hid::detail::Source<S, P> & source, Writer & out, ::hid::error::Info & err) const noexcept {
+		return this->bind(source.params, P, out, err);
+	}
+private:
+	/**
+	 * Checks whether a parameter before the given one has a different name with the same hash.
+	 * 
+	 * @param[in] params - parameter set
+	 * @param[in] p - index of the matched parameter
+	 * @param[in] hash - name hash of the matched parameter
+	 * @return true if the name hash is ambiguous, else false
+	 */
+	constexpr static inline bool hasParamClash(const Param * params, const size_t p, const uint32_t hash) noexcept {
+		size_t len = 0;
+		while (params[p].name[len] != 0) {
+			len++;
+		}
+		const Token name{params[p].name, len};
+		for (size_t q = p; q > 0; q--) {
+			if (nameHash(params[q - 1].name) == hash && ( ! equals(name, params[q - 1].name) )) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+
+/**
+ * Parameter set without any parameters.
+ */
+struct NoParams {
+	/**
+	 * Finds a parameter with the given name.
+	 * 
+	 * @param[in] token - parameter name token
+	 * @return no match
+	 */
+	constexpr inline ParamMatch find(const Token & /* token */) const noexcept {
+		return ParamMatch{0, false};
+	}
+};
+
+
+/**
+ * String descriptor indices of the strings seen so far. Used if the source code before the
+ * current position is no longer available. The strings are kept in a pool and compared by
+ * their hash first.
+ * 
+ * @tparam M - maximum number of distinct strings
+ * @tparam P - maximum total length of all distinct strings in bytes
+ */
+template <size_t M, size_t P>
+class StringHistory {
+private:
+	uint32_t hashes[M + 1]; /**< string hashes in order of first occurrence */
+	size_t offsets[M + 1]; /**< start of each string within `pool`; the next entry marks its end */
+	char pool[P + 1]; /**< concatenated strings */
+	size_t count; /**< number of distinct strings */
+	
+	/**
+	 * Returns the index of the given string.
+	 * 
+	 * @param[in] str - string without quotes
+	 * @param[in] hash - string hash
+	 * @return index or 0 if the string was not seen yet
+	 */
+	constexpr inline size_t lookup(const Token & str, const uint32_t hash) const noexcept {
+		for (size_t i = 0; i < this->count; i++) {
+			if (this->hashes[i] == hash && equals(Token{this->pool + this->offsets[i], this->offsets[i + 1] - this->offsets[i]}, str)) {
+				return i + 1;
+			}
+		}
+		return 0;
+	}
+public:
+	/** Default constructor. */
+	constexpr inline StringHistory() noexcept:
+		hashes{0},
+		offsets{0},
+		pool{0},
+		count{0}
+	{}
+	
+	/**
+	 * Returns the string descriptor index of the given string and records new strings.
+	 * 
+	 * @param[in] str - string without quotes
+	 * @return string descriptor index or a value above 255 if the history is full
+	 */
+	constexpr inline size_t index(const Token & str) noexcept {
+		const uint32_t hash = nameHash(str.start, str.length);
+		const size_t res = this->lookup(str, hash);
+		if (res != 0) {
+			return res;
+		}
+		const size_t start = this->offsets[this->count];
+		if (this->count >= M || str.length > (P - start)) {
+			return 0x100;
+		}
+		for (size_t i = 0; i < str.length; i++) {
+			this->pool[start + i] = str.start[i];
+		}
+		this->hashes[this->count] = hash;
+		this->count++;
+		this->offsets[this->count] = start + str.length;
+		return this->count;
+	}
+	
+	/**
+	 * Returns the index of the given string without recording it.
+	 * 
+	 * @param[in] str - string without quotes
+	 * @return index or 0 if the string was not seen yet
+	 */
+	constexpr inline size_t find(const Token & str) const noexcept {
+		return this->lookup(str, nameHash(str.start, str.length));
+	}
+};
+
+
+/**
+ * Resumable HID descriptor compiler. The source code is passed in arbitrary pieces via `feed()`
+ * and the compilation is completed via `finish()`. Tokens may be split across pieces.
+ * Input is kept in a fixed-size buffer until the item it belongs to is complete. Hence, the memory
+ * use does not depend on the source code size.
+ * 
+ * @tparam Writer - shall implement `write(uint8_t)`
+ * @tparam Params - shall implement `ParamMatch find(Token)`
+ * @tparam BufferSize - input buffer size in bytes (limits the size of a single item with its arguments)
+ * @tparam MaxStrings - maximum number of distinct string arguments (e.g. `StringIndex("Left Trigger")`)
+ * and of distinct designator names each
+ * @tparam StringPoolSize - maximum total length in bytes of the distinct string arguments and of
+ * the distinct designator names each
+ * @see ::hid::detail::compile()
+ */
+template <typename Writer, typename Params = NoParams, size_t BufferSize = 256, size_t MaxStrings = 16, size_t StringPoolSize = MaxStrings * 16>
+class Compiler {
+private:
+	/**
+	 * Finds a parameter with the given name. Used as `SourceView::FindFn`.
+	 * 
+	 * @param[in] context - compiler instance
+	 * @param[in] token - parameter name token
+	 * @return associated value
+	 */
+	static inline ParamMatch findParam(const void * context, const Token & token) noexcept {
+		return static_cast<const Compiler *>(context)->params.find(token);
+	}
+	
+	/**
+	 * Returns the string descriptor index of the given string. Used as `SourceView::StringIndexFn`.
+	 * 
+	 * @param[in,out] context - compiler instance
+	 * @param[in] str - string without quotes
+	 * @return string descriptor index
+	 */
+	static inline size_t stringIndexOf(void * context, const size_t /* pos */, const Token & str) noexcept {
+		return static_cast<Compiler *>(context)->strings.index(str);
+	}
+	
+	/**
+	 * Returns the designator index of the given designator name. Used as `SourceView::DesignatorIndexFn`.
+	 * 
+	 * @param[in,out] context - compiler instance
+	 * @param[in] str - designator name without quotes
+	 * @param[in] define - true to number new names, false to return 0 for them
+	 * @return designator index or 0 if unknown
+	 */
+	static inline size_t designatorIndexOf(void * context, const size_t /* pos */, const Token & str, const bool define) noexcept {
+		Compiler * self = static_cast<Compiler *>(context);
+		return define ? self->designators.index(str) : self->designators.find(str);
+	}
+	
+	Writer & out; /**< output writer */
+	Params params; /**< parameter set */
+	StringHistory<MaxStrings, StringPoolSize> strings; /**< strings seen so far */
+	StringHistory<MaxStrings, StringPoolSize> designators; /**< designator names seen so far */
+	char buffer[BufferSize + 2]; /**< input buffer (with null-termination) */
+	size_t fill; /**< number of bytes in the input buffer */
+	CompileState state; /**< compiler state at the start of the input buffer */
+	::hid::error::Info error; /**< compile error */
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[out] o - output writer instance
+	 * @param[in] p - parameter set
+	 */
+	constexpr inline explicit Compiler(Writer & o, const Params & p = Params()) noexcept:
+		out(o),
+		params(p),
+		strings{},
+		designators{},
+		buffer{0},
+		fill{0},
+		state{},
+		error{}
+	{}
+	
+	/**
+	 * Compiles the next piece of source code.
+	 * 
+	 * @param[in] source - source code piece
+	 * @param[in] length - source code piece size in bytes
+	 * @return true on success, else false
+	 */
+	constexpr inline bool feed(const char * source, size_t length) noexcept {
+		while (length > 0 && ! this->state.finished) {
+			size_t count = BufferSize - this->fill;
+			if (count > length) {
+				count = length;
+			}
+			for (size_t i = 0; i < count; i++) {
+				this->buffer[this->fill + i] = source[i];
+			}
+			this->fill += count;
+			source += count;
+			length -= count;
+			if ( ! this->process(CM_PARTIAL) ) {
+				return false;
+			}
+		}
+		return this->error.message == ::hid::error::E_NO_ERROR;
+	}
+	
+	/**
+	 * Completes the compilation. No source code can be passed afterwards.
+	 * 
+	 * @return true on success, else false
+	 */
+	constexpr inline bool finish() noexcept {
+		if ( ! this->state.finished ) {
+			this->process(CM_ALL);
+		}
+		return this->error.message == ::hid::error::E_NO_ERROR;
+	}
+	
+	/**
+	 * Returns the compile error.
+	 * 
+	 * @return compile error
+	 */
+	constexpr inline const ::hid::error::Info & getError() const noexcept {
+		return this->error;
+	}
+private:
+	/**
+	 * Compiles the buffered source code and drops the processed part.
+	 * 
+	 * @param[in] mode - compile mode
+	 * @return true on success, else false
+	 */
+	constexpr inline bool process(const CompileMode mode) noexcept {
+		this->buffer[this->fill] = 0;
+		this->buffer[this->fill + 1] = 0;
+		/* the window over the input buffer shares its compile() instantiation with all other compilers */
+		const SourceView window(this->buffer, this->fill, this, &Compiler::findParam, &Compiler::stringIndexOf, &Compiler::designatorIndexOf);
+		if ( ! compile(window, this->out, this->error, this->state, mode) ) {
+			this->state.finished = true;
+			return false;
+		}
+		if ( this->state.finished ) {
+			return true;
+		}
+		const size_t used = this->state.position;
+		if (used == 0 && this->fill >= BufferSize) {
+			/* single item exceeds the input buffer */
+			::hid::error::ErrorWriter(this->buffer, this->error, this->state.origin).at(0, ::hid::error::E_Input_buffer_overflow);
+			this->state.finished = true;
+			return false;
+		}
+		::hid::error::ErrorWriter::advance(this->state.origin, this->buffer, used);
+		for (size_t i = used; i < this->fill; i++) {
+			this->buffer[i - used] = this->buffer[i];
+		}
+		this->fill -= used;
+		this->state.position = 0;
+		return true;
+	}
+};
+
+
+/**
+ * Report types as encoded in the main item prefix.
+ * 
+ * @see HID 1.11 ch. 6.2.2.4
+ */
+enum ReportType : uint8_t {
+	RT_INPUT   = 0x80, /**< Input report */
+	RT_OUTPUT  = 0x90, /**< Output report */
+	RT_FEATURE = 0xB0  /**< Feature report */
+};
+
+
+/**
+ * Single item of a compiled HID descriptor.
+ * 
+ * @see HID 1.11 ch. 6.2.2.2
+ */
+struct Item {
+	size_t pos; /**< byte position of the item prefix */
+	size_t length; /**< item length in bytes including the prefix */
+	uint8_t tag; /**< item prefix without the size bits (0xFE for long items) */
+	uint8_t size; /**< item data size in bytes */
+	uint32_t data; /**< item data (short items only) */
+	
+	/**
+	 * Returns the item data as sign extended value.
+	 * 
+	 * @return signed item data
+	 */
+	constexpr inline int32_t signedData() const noexcept {
+		switch (this->size) {
+		case 1: return int32_t(int8_t(uint8_t(this->data)));
+		case 2: return int32_t(int16_t(uint16_t(this->data)));
+		case 4: return int32_t(this->data);
+		default: return 0;
+		}
+	}
+	
+	/**
+	 * Returns the byte position of the next item.
+	 * 
+	 * @return next item position
+	 */
+	constexpr inline size_t next() const noexcept {
+		return this->pos + this->length;
+	}
+};
+
+
+/**
+ * Decodes the item at the given position of a compiled HID descriptor.
+ * Truncated items are limited to the descriptor end.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] pos - item byte position
+ * @return decoded item (zero length if `pos` is out of range)
+ * @see HID 1.11 ch. 6.2.2.2 and 6.2.2.3
+ */
+constexpr inline Item readItem(const uint8_t * desc, const size_t len, const size_t pos) noexcept {
+	Item res{pos, 0, 0, 0, 0};
+	if (pos >= len) {
+		return res;
+	}
+	const uint8_t prefix = desc[pos];
+	if (prefix == 0xFE) {
+		/* long item */
+		res.tag = 0xFE;
+		res.size = uint8_t(((pos + 1) < len) ? desc[pos + 1] : 0);
+		res.length = size_t(3 + res.size);
+	} else {
+		res.tag = uint8_t(prefix & 0xFC);
+		res.size = uint8_t(((prefix & 3) == 3) ? 4 : (prefix & 3));
+		res.length = size_t(1 + res.size);
+		for (size_t i = 0; i < res.size && (pos + 1 + i) < len; i++) {
+			res.data |= uint32_t(desc[pos + 1 + i]) << (8 * i);
+		}
+	}
+	if ((len - pos) < res.length) {
+		res.length = len - pos;
+	}
+	return res;
+}
+
+
+/**
+ * Global item state needed to derive the report layout.
+ * 
+ * @see HID 1.11 ch. 6.2.2.7
+ */
+struct GlobalItems {
+	uint32_t usagePage; /**< UsagePage */
+	Item logicalMinimum; /**< LogicalMinimum */
+	Item logicalMaximum; /**< LogicalMaximum */
+	uint32_t reportSize; /**< ReportSize */
+	uint32_t reportCount; /**< ReportCount */
+	uint8_t reportId; /**< ReportId */
+};
+
+
+/**
+ * Tracks the global item state including Push/Pop.
+ * 
+ * @see HID 1.11 ch. 6.2.2.7
+ */
+class GlobalTracker {
+private:
+	enum { StackSize = 4 }; /**< maximum Push depth */
+	GlobalItems current; /**< current global state */
+	GlobalItems stack[StackSize]; /**< pushed global states */
+	size_t depth; /**< number of pushed global states */
+public:
+	/** Default constructor. */
+	constexpr inline GlobalTracker() noexcept:
+		current{0, Item{0, 0, 0, 0, 0}, Item{0, 0, 0, 0, 0}, 0, 0, 0},
+		stack{},
+		depth{0}
+	{}
+	
+	/**
+	 * Returns the current global state.
+	 * 
+	 * @return global state
+	 */
+	constexpr inline const GlobalItems & get() const noexcept {
+		return this->current;
+	}
+	
+	/**
+	 * Updates the global state from the given item.
+	 * Pushes beyond the supported depth are ignored.
+	 * 
+	 * @param[in] item - item to process
+	 * @return true if the item was a global item, else false
+	 */
+	constexpr inline bool update(const Item & item) noexcept {
+		switch (item.tag) {
+		case 0x04: this->current.usagePage = item.data; break;
+		case 0x14: this->current.logicalMinimum = item; break;
+		case 0x24: this->current.logicalMaximum = item; break;
+		case 0x74: this->current.reportSize = item.data; break;
+		case 0x84: this->current.reportId = uint8_t(item.data); break;
+		case 0x94: this->current.reportCount = item.data; break;
+		case 0xA4:
+			/* Push */
+			if (this->depth < StackSize) {
+				this->stack[this->depth] = this->current;
+			}
+			this->depth++;
+			break;
+		case 0xB4:
+			/* Pop */
+			if (this->depth > 0) {
+				this->depth--;
+				if (this->depth < StackSize) {
+					this->current = this->stack[this->depth];
 				}
-				if (encItem->arg == clearArg) {
-					arg &= ~(encItem->value);
-				} else {
-					/* merge multiple arguments via OR if unspecified */
-					arg |= encItem->value;
+			}
+			break;
+		default:
+			return (item.tag & 0x0C) == 0x04;
+		}
+		return true;
+	}
+};
+
+
+/**
+ * Iterates over the report fields of a compiled HID descriptor.
+ * 
+ * @see HID 1.11 ch. 8.4
+ */
+class FieldReader {
+private:
+	enum { OffsetCacheSize = 16 }; /**< number of cached report offsets */
+	/** Current bit offset of a single report. */
+	struct Offset {
+		uint8_t type; /**< report type */
+		uint8_t reportId; /**< report ID */
+		uint32_t bits; /**< current bit offset */
+	};
+	const uint8_t * desc; /**< compiled HID descriptor */
+	size_t len; /**< descriptor length in bytes */
+	size_t pos; /**< current item position */
+	size_t locals; /**< position of the first item after the previous main item */
+	uint32_t localsPage; /**< UsagePage at `locals` */
+	GlobalTracker global; /**< global item state */
+	Offset offsets[OffsetCacheSize]; /**< current report bit offsets */
+	size_t offsetCount; /**< number of used `offsets` */
+	
+	/**
+	 * Sums up the field sizes of the given report before the passed position.
+	 * This is only used if the report offset cache is exhausted.
+	 * 
+	 * @param[in] type - report type
+	 * @param[in] reportId - report ID
+	 * @param[in] end - stop at this item position
+	 * @return report bit offset at `end`
+	 */
+	constexpr inline uint32_t bitsBefore(const uint8_t type, const uint8_t reportId, const size_t end) const noexcept {
+		GlobalTracker tracker;
+		uint32_t res = 0;
+		for (size_t p = 0; p < end; ) {
+			const Item item = readItem(this->desc, this->len, p);
+			if ((item.tag == RT_INPUT || item.tag == RT_OUTPUT || item.tag == RT_FEATURE) && item.tag == type && tracker.get().reportId == reportId) {
+				res += tracker.get().reportSize * tracker.get().reportCount;
+			} else {
+				tracker.update(item);
+			}
+			p = item.next();
+		}
+		return res;
+	}
+	
+	/**
+	 * Returns the current bit offset of the given report and advances it by `bits`.
+	 * 
+	 * @param[in] type - report type
+	 * @param[in] reportId - report ID
+	 * @param[in] bits - field size in bits
+	 * @return report bit offset before the field
+	 */
+	constexpr inline uint32_t advance(const uint8_t type, const uint8_t reportId, const uint32_t bits) noexcept {
+		for (size_t i = 0; i < this->offsetCount; i++) {
+			Offset & offset = this->offsets[i];
+			if (offset.type == type && offset.reportId == reportId) {
+				const uint32_t res = offset.bits;
+				offset.bits += bits;
+				return res;
+			}
+		}
+		if (this->offsetCount < OffsetCacheSize) {
+			this->offsets[this->offsetCount++] = Offset{type, reportId, bits};
+			return 0;
+		}
+		return bitsBefore(type, reportId, this->pos);
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] d - compiled HID descriptor
+	 * @param[in] l - descriptor length in bytes
+	 */
+	constexpr inline explicit FieldReader(const uint8_t * d, const size_t l) noexcept:
+		desc{d},
+		len{l},
+		pos{0},
+		locals{0},
+		localsPage{0},
+		global{},
+		offsets{},
+		offsetCount{0}
+	{}
+	
+	/**
+	 * Reads the next report field.
+	 * 
+	 * @param[out] field - receives the next field
+	 * @return true if a field was read, false at the end of the descriptor
+	 */
+	constexpr inline bool next(ReportField & field) noexcept {
+		while (this->pos < this->len) {
+			const Item item = readItem(this->desc, this->len, this->pos);
+			if (item.tag == RT_INPUT || item.tag == RT_OUTPUT || item.tag == RT_FEATURE) {
+				const GlobalItems & g = this->global.get();
+				field.item = this->pos;
+				field.locals = this->locals;
+				field.localsPage = this->localsPage;
+				field.size = g.reportSize;
+				field.count = g.reportCount;
+				field.logicalMinimum = g.logicalMinimum.signedData();
+				field.logicalMaximum = g.logicalMaximum.signedData();
+				if (field.logicalMinimum >= 0 && field.logicalMaximum < field.logicalMinimum) {
+					/* common mistake: unsigned encoded LogicalMaximum */
+					field.logicalMaximum = int32_t(g.logicalMaximum.data);
 				}
-				hasArg = ( ! multiArg ) || *ptr != ',';
-				if (*ptr == ')') {
-					continue; /* re-parse as argument list */
+				field.flags = uint16_t(item.data);
+				field.type = item.tag;
+				field.reportId = g.reportId;
+				field.bitOffset = advance(item.tag, g.reportId, field.bits());
+				this->pos = item.next();
+				this->locals = this->pos;
+				this->localsPage = g.usagePage;
+				return true;
+			}
+			this->global.update(item);
+			if (item.tag == 0xA0 || item.tag == 0xC0) {
+				/* local items end at Collection and EndCollection, too */
+				this->locals = item.next();
+				this->localsPage = this->global.get().usagePage;
+			}
+			this->pos = item.next();
+		}
+		return false;
+	}
+};
+
+
+/**
+ * Iterates over the usages of a report field. Each call returns the next
+ * usage range whereas a single usage is returned as range of one usage.
+ * All usages are extended to 32-bit (usage page in the upper 16 bits).
+ * Only the first usage of each delimiter set is considered.
+ * 
+ * @see HID 1.11 ch. 6.2.2.8
+ */
+class UsageReader {
+private:
+	const uint8_t * desc; /**< compiled HID descriptor */
+	size_t len; /**< descriptor length in bytes */
+	size_t pos; /**< current item position */
+	size_t end; /**< position of the field main item */
+	uint32_t page; /**< current UsagePage */
+	uint32_t minimum; /**< pending UsageMinimum */
+	uint32_t maximum; /**< pending UsageMaximum */
+	uint8_t pending; /**< bit 0: UsageMinimum, bit 1: UsageMaximum */
+	int delimLevel; /**< Delimiter nesting level */
+	bool delimUsed; /**< true if the current delimiter set returned a usage */
+	
+	/**
+	 * Extends the given usage item data to a 32-bit usage.
+	 * 
+	 * @param[in] item - Usage, UsageMinimum or UsageMaximum item
+	 * @return extended usage
+	 */
+	constexpr inline uint32_t extended(const Item & item) const noexcept {
+		return (item.size == 4) ? item.data : ((this->page << 16) | (item.data & 0xFFFF));
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] d - compiled HID descriptor
+	 * @param[in] l - descriptor length in bytes
+	 * @param[in] field - iterate the usages of this field
+	 */
+	constexpr inline explicit UsageReader(const uint8_t * d, const size_t l, const ReportField & field) noexcept:
+		desc{d},
+		len{l},
+		pos{field.locals},
+		end{field.item},
+		page{field.localsPage},
+		minimum{0},
+		maximum{0},
+		pending{0},
+		delimLevel{0},
+		delimUsed{false}
+	{}
+	
+	/**
+	 * Reads the next usage range.
+	 * 
+	 * @param[out] first - first usage of the range
+	 * @param[out] last - last usage of the range
+	 * @return true if a range was read, false at the end of the local items
+	 */
+	constexpr inline bool next(uint32_t & first, uint32_t & last) noexcept {
+		while (this->pos < this->end && this->pos < this->len) {
+			const Item item = readItem(this->desc, this->len, this->pos);
+			this->pos = item.next();
+			const bool skip = this->delimLevel > 0 && this->delimUsed;
+			switch (item.tag) {
+			case 0x04:
+				this->page = item.data;
+				break;
+			case 0x08:
+				if ( skip ) break;
+				this->delimUsed = true;
+				first = last = extended(item);
+				return true;
+			case 0x18:
+				this->minimum = extended(item);
+				this->pending |= 1;
+				break;
+			case 0x28:
+				this->maximum = extended(item);
+				this->pending |= 2;
+				break;
+			case 0xA8:
+				this->delimLevel += (item.data != 0) ? 1 : -1;
+				this->delimUsed = false;
+				break;
+			default:
+				break;
+			}
+			if (this->pending == 3) {
+				this->pending = 0;
+				if ( skip ) continue;
+				this->delimUsed = true;
+				first = this->minimum;
+				last = (this->maximum < this->minimum) ? this->minimum : this->maximum;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+
+/**
+ * Returns the usage assigned to the given index of a report field.
+ * The last usage applies to all remaining indices.
+ * For variable fields the index is the element index. For array fields
+ * the index is the element value minus LogicalMinimum.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] field - report field
+ * @param[in] index - usage index
+ * @return extended usage or 0 if the field has no usages
+ * @see HID 1.11 ch. 6.2.2.8
+ */
+constexpr inline uint32_t usageAt(const uint8_t * desc, const size_t len, const ReportField & field, const uint32_t index) noexcept {
+	UsageReader usages(desc, len, field);
+	uint32_t first{0}, last{0}, res{0}, n{0};
+	while ( usages.next(first, last) ) {
+		if ((index - n) <= (last - first)) {
+			return first + (index - n);
+		}
+		n += last - first + 1;
+		res = last;
+	}
+	return res;
+}
+
+
+/**
+ * Finds the first variable report field element with the given usage.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] type - report type
+ * @param[in] usage - extended usage (usage page in the upper 16 bits)
+ * @return found element (check `valid`)
+ */
+constexpr inline UsageMatch findUsage(const uint8_t * desc, const size_t len, const uint8_t type, const uint32_t usage) noexcept {
+	FieldReader fields(desc, len);
+	UsageMatch res{ReportField{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0, false};
+	while ( fields.next(res.field) ) {
+		if (res.field.type != type || res.field.isConstant() || ( ! res.field.isVariable() )) {
+			continue;
+		}
+		UsageReader usages(desc, len, res.field);
+		uint32_t first{0}, last{0}, n{0};
+		while (n < res.field.count && usages.next(first, last)) {
+			if (usage >= first && usage <= last && (n + (usage - first)) < res.field.count) {
+				res.index = n + (usage - first);
+				res.bitOffset = res.field.bitOffset + (res.index * res.field.size);
+				res.valid = true;
+				return res;
+			}
+			n += last - first + 1;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Finds the report field of the main item which ends at the given position.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] end - position right after the main item (see `FieldName`)
+ * @return found field with `index` 0 (check `valid`)
+ */
+constexpr inline UsageMatch findField(const uint8_t * desc, const size_t len, const uint32_t end) noexcept {
+	FieldReader fields(desc, len);
+	UsageMatch res{ReportField{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0, false};
+	if (end == 0) {
+		return res;
+	}
+	while ( fields.next(res.field) ) {
+		const uint8_t prefix = desc[res.field.item];
+		if ((res.field.item + 1 + (((prefix & 3) == 3) ? 4 : (prefix & 3))) == end) {
+			res.bitOffset = res.field.bitOffset;
+			res.valid = true;
+			return res;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Returns the number of report fields.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @return number of Input, Output and Feature items
+ */
+constexpr inline size_t fieldCount(const uint8_t * desc, const size_t len) noexcept {
+	FieldReader fields(desc, len);
+	ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	size_t res = 0;
+	while ( fields.next(field) ) {
+		res++;
+	}
+	return res;
+}
+
+
+/**
+ * Returns the report size in bytes including the report ID byte if used.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] type - report type
+ * @param[in] reportId - report ID
+ * @return report size in bytes or 0 if no such report exists
+ * @see HID 1.11 ch. 8.4
+ */
+constexpr inline size_t reportSize(const uint8_t * desc, const size_t len, const uint8_t type, const uint8_t reportId) noexcept {
+	FieldReader fields(desc, len);
+	ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	size_t bits = 0;
+	bool found = false;
+	while ( fields.next(field) ) {
+		if (field.type == type && field.reportId == reportId) {
+			bits = field.bitOffset + field.bits();
+			found = true;
+		}
+	}
+	if ( ! found ) {
+		return 0;
+	}
+	return ((bits + 7) / 8) + ((reportId != 0) ? 1 : 0);
+}
+
+
+/**
+ * Returns the largest report size of the given type in bytes including
+ * the report ID byte if used.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] type - report type
+ * @return maximum report size in bytes or 0 if no such report exists
+ */
+constexpr inline size_t maxReportSize(const uint8_t * desc, const size_t len, const uint8_t type) noexcept {
+	FieldReader fields(desc, len);
+	ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	size_t res = 0;
+	while ( fields.next(field) ) {
+		if (field.type == type) {
+			const size_t size = ((field.bitOffset + field.bits() + 7) / 8) + ((field.reportId != 0) ? 1 : 0);
+			if (size > res) {
+				res = size;
+			}
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Returns the number of distinct report IDs of the given report type.
+ * Reports without report ID count as report ID 0.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] type - report type
+ * @return number of distinct report IDs
+ */
+constexpr inline size_t reportIdCount(const uint8_t * desc, const size_t len, const uint8_t type) noexcept {
+	FieldReader fields(desc, len);
+	ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint32_t seen[8] = {0};
+	size_t res = 0;
+	while ( fields.next(field) ) {
+		const uint32_t bit = uint32_t(1) << (field.reportId & 31);
+		if (field.type == type && (seen[field.reportId >> 5] & bit) == 0) {
+			seen[field.reportId >> 5] |= bit;
+			res++;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Reads an unsigned value from the given bit position of a report.
+ * 
+ * @param[in] data - report data without report ID
+ * @param[in] offset - bit offset
+ * @param[in] bits - number of bits to read (at most 32)
+ * @return read value
+ * @see HID 1.11 ch. 8.4
+ */
+constexpr inline uint32_t readBits(const uint8_t * data, const uint32_t offset, const uint32_t bits) noexcept {
+	uint32_t res = 0;
+	for (uint32_t done = 0; done < bits && done < 32; ) {
+		const uint32_t pos = offset + done;
+		const uint32_t shift = pos & 7;
+		const uint32_t take = ((8 - shift) < (bits - done)) ? (8 - shift) : (bits - done);
+		res |= ((uint32_t(data[pos >> 3]) >> shift) & ((uint32_t(1) << take) - 1)) << done;
+		done += take;
+	}
+	return res;
+}
+
+
+/**
+ * Reads a sign extended value from the given bit position of a report.
+ * 
+ * @param[in] data - report data without report ID
+ * @param[in] offset - bit offset
+ * @param[in] bits - number of bits to read (1 to 32)
+ * @return read value
+ */
+constexpr inline int32_t readSignedBits(const uint8_t * data, const uint32_t offset, const uint32_t bits) noexcept {
+	const uint32_t res = readBits(data, offset, bits);
+	if (bits > 0 && bits < 32 && ((res >> (bits - 1)) & 1) != 0) {
+		return int32_t(res | ~((uint32_t(1) << bits) - 1));
+	}
+	return int32_t(res);
+}
+
+
+/**
+ * Writes a value to the given bit position of a report.
+ * 
+ * @param[in,out] data - report data without report ID
+ * @param[in] offset - bit offset
+ * @param[in] bits - number of bits to write (at most 32)
+ * @param[in] val - value to write (excess bits are ignored)
+ */
+constexpr inline void writeBits(uint8_t * data, const uint32_t offset, const uint32_t bits, const uint32_t val) noexcept {
+	for (uint32_t done = 0; done < bits && done < 32; ) {
+		const uint32_t pos = offset + done;
+		const uint32_t shift = pos & 7;
+		const uint32_t take = ((8 - shift) < (bits - done)) ? (8 - shift) : (bits - done);
+		const uint32_t mask = ((uint32_t(1) << take) - 1) << shift;
+		data[pos >> 3] = uint8_t((data[pos >> 3] & ~mask) | (((val >> done) << shift) & mask));
+		done += take;
+	}
+}
+
+
+/**
+ * Merges queued Input reports of mice, dials and similar devices. The merge function is derived
+ * at compile time from the Rel/Abs flags of the Input items of one report: values of relative
+ * variable fields are summed up with saturation at LogicalMinimum/LogicalMaximum, all other
+ * fields take the value of the latest report.
+ * 
+ * @tparam ReportSize - maximum report size in bytes including the report ID
+ * @tparam MaxFields - maximum number of relative fields
+ */
+template <size_t ReportSize, size_t MaxFields = 8>
+class ReportMerger {
+public:
+	enum {
+		Size = ReportSize, /**< maximum report size in bytes including the report ID */
+		FieldLimit = MaxFields /**< maximum number of relative fields */
+	};
+private:
+	static_assert(ReportSize > 0, "ReportSize needs to be at least 1.");
+	static_assert(MaxFields > 0, "MaxFields needs to be at least 1.");
+	/** Single relative variable field. */
+	struct RelField {
+		uint32_t bitOffset; /**< bit offset within the report excluding the report ID byte */
+		uint32_t size; /**< ReportSize in bits */
+		uint32_t count; /**< ReportCount */
+		int32_t minimum; /**< LogicalMinimum */
+		int32_t maximum; /**< LogicalMaximum */
+	};
+	RelField fields[MaxFields]; /**< relative fields */
+	uint8_t relMask[ReportSize]; /**< bits of relative fields including the report ID byte */
+	size_t fieldCount; /**< number of used `fields` */
+	size_t length; /**< report length in bytes including the report ID */
+	uint8_t reportId; /**< report ID or 0 */
+	bool complete; /**< false if the report exceeds `ReportSize` or `MaxFields` */
+	
+	/**
+	 * Returns the sum of the given field element values. Unsigned fields are read unsigned.
+	 * 
+	 * @param[in] field - relative field
+	 * @param[in] offset - bit offset of the element
+	 * @param[in] a - first report data without report ID
+	 * @param[in] b - second report data without report ID
+	 * @return sum of both values
+	 */
+	static constexpr inline int64_t sum(const RelField & field, const uint32_t offset, const uint8_t * a, const uint8_t * b) noexcept {
+		if (field.minimum < 0) {
+			return int64_t(readSignedBits(a, offset, field.size)) + int64_t(readSignedBits(b, offset, field.size));
+		}
+		return int64_t(readBits(a, offset, field.size)) + int64_t(readBits(b, offset, field.size));
+	}
+	
+	/**
+	 * Checks the report ID and length of both reports.
+	 * 
+	 * @param[in] pending - queued report including the report ID
+	 * @param[in] latest - latest report including the report ID
+	 * @param[in] len - report length in bytes including the report ID
+	 * @return true if both reports belong to this merger, else false
+	 */
+	constexpr inline bool matches(const uint8_t * pending, const uint8_t * latest, const size_t len) const noexcept {
+		if (( ! this->complete ) || len != this->length) {
+			return false;
+		}
+		return this->reportId == 0 || (pending[0] == this->reportId && latest[0] == this->reportId);
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 * @param[in] id - report ID of the Input report to merge or 0 if not used
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	constexpr inline explicit ReportMerger(const uint8_t * desc, const size_t len, const uint8_t id = 0) noexcept:
+		fields{},
+		relMask{0},
+		fieldCount{0},
+		length{0},
+		reportId{id},
+		complete{true}
+	{
+		FieldReader reader(desc, len);
+		ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		const uint32_t base = (id != 0) ? 8 : 0;
+		while ( reader.next(field) ) {
+			if (field.type != RT_INPUT || field.reportId != id) {
+				continue;
+			}
+			const size_t end = ((base + field.bitOffset + field.bits() + 7) / 8);
+			if (end > this->length) {
+				this->length = end;
+			}
+			if (end > ReportSize) {
+				this->complete = false;
+				continue;
+			}
+			if (field.isConstant() || ( ! field.isVariable() ) || ( ! field.isRelative() ) || field.bits() == 0) {
+				continue;
+			}
+			if (this->fieldCount >= MaxFields || field.size > 32) {
+				this->complete = false;
+				continue;
+			}
+			this->fields[this->fieldCount++] = RelField{field.bitOffset, field.size, field.count, field.logicalMinimum, field.logicalMaximum};
+			for (uint32_t bit = base + field.bitOffset; bit < (base + field.bitOffset + field.bits()); bit++) {
+				this->relMask[bit >> 3] = uint8_t(this->relMask[bit >> 3] | (1 << (bit & 7)));
+			}
+		}
+		if (this->length == 0) {
+			this->complete = false;
+		}
+	}
+	
+	/**
+	 * Returns the report ID of the merged Input report.
+	 * 
+	 * @return report ID or 0 if not used
+	 */
+	constexpr inline uint8_t getReportId() const noexcept {
+		return this->reportId;
+	}
+	
+	/**
+	 * Returns the length of the merged Input report.
+	 * 
+	 * @return report length in bytes including the report ID or 0 if the report does not exist
+	 */
+	constexpr inline size_t getLength() const noexcept {
+		return this->length;
+	}
+	
+	/**
+	 * Returns the number of relative fields.
+	 * 
+	 * @return relative fields
+	 */
+	constexpr inline size_t getFieldCount() const noexcept {
+		return this->fieldCount;
+	}
+	
+	/**
+	 * Checks whether the relative values of both reports can be summed up without saturation.
+	 * 
+	 * @param[in] pending - queued report including the report ID
+	 * @param[in] latest - latest report including the report ID
+	 * @param[in] len - report length in bytes including the report ID
+	 * @return true if `merge()` would succeed without loss, else false
+	 */
+	constexpr inline bool fits(const uint8_t * pending, const uint8_t * latest, const size_t len) const noexcept {
+		if ( ! this->matches(pending, latest, len) ) {
+			return false;
+		}
+		const size_t skip = (this->reportId != 0) ? 1 : 0;
+		for (size_t i = 0; i < this->fieldCount; i++) {
+			const RelField & field = this->fields[i];
+			for (uint32_t n = 0; n < field.count; n++) {
+				const int64_t val = sum(field, field.bitOffset + (n * field.size), pending + skip, latest + skip);
+				if (field.minimum <= field.maximum && (val < field.minimum || val > field.maximum)) {
+					return false;
 				}
-			} else {
-				return errorMsg.at(n, E_Unexpected_argument_name_character);
 			}
-		} else if ( _HID_WITHIN(HEX_LIT) ) {
-			if ( isHexDigit(*ptr) ) {
-				const uint32_t oldLit = lit;
-				lit <<= 4;
-				if (lit < oldLit) {
-					return errorMsg.at(n, E_Number_overflow);
+		}
+		return true;
+	}
+	
+	/**
+	 * Merges the latest report into the queued one. Relative values are summed up with
+	 * saturation at LogicalMinimum/LogicalMaximum. All other bits are taken from `latest`.
+	 * 
+	 * @param[in,out] pending - queued report including the report ID
+	 * @param[in] latest - latest report including the report ID
+	 * @param[in] len - report length in bytes including the report ID
+	 * @return true on success, false if the report ID or length does not match
+	 */
+	constexpr inline bool merge(uint8_t * pending, const uint8_t * latest, const size_t len) const noexcept {
+		if ( ! this->matches(pending, latest, len) ) {
+			return false;
+		}
+		const size_t skip = (this->reportId != 0) ? 1 : 0;
+		for (size_t i = 0; i < this->fieldCount; i++) {
+			const RelField & field = this->fields[i];
+			for (uint32_t n = 0; n < field.count; n++) {
+				const uint32_t offset = field.bitOffset + (n * field.size);
+				int64_t val = sum(field, offset, pending + skip, latest + skip);
+				if (field.minimum <= field.maximum) {
+					val = (val < field.minimum) ? field.minimum : ((val > field.maximum) ? field.maximum : val);
 				}
-				if (*ptr < 'A') {
-					lit |= uint32_t(*ptr - '0');
-				} else if (*ptr < 'a') {
-					lit |= uint32_t(*ptr - 'A' + 10);
-				} else {
-					lit |= uint32_t(*ptr - 'a' + 10);
+				writeBits(pending + skip, offset, field.size, uint32_t(val));
+			}
+		}
+		for (size_t i = 0; i < len; i++) {
+			pending[i] = uint8_t((pending[i] & this->relMask[i]) | (latest[i] & ~this->relMask[i]));
+		}
+		return true;
+	}
+};
+
+
+/**
+ * Loads the given variable which is shared between main loop and interrupt service
+ * routine or between two threads.
+ * 
+ * @param[in] var - variable to load
+ * @return loaded value
+ * @remarks Without GCC compatible atomic built-ins only a volatile access is performed.
+ */
+template <typename T>
+inline T loadAcquire(const volatile T & var) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&var, __ATOMIC_ACQUIRE);
+#else
+	return var;
+#endif
+}
+
+
+/**
+ * Stores the given variable which is shared between main loop and interrupt service
+ * routine or between two threads. All previous writes are visible before this one.
+ * 
+ * @param[out] var - variable to store
+ * @param[in] val - value to store
+ * @remarks Without GCC compatible atomic built-ins only a volatile access is performed.
+ */
+template <typename T>
+inline void storeRelease(volatile T & var, const T val) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&var, val, __ATOMIC_RELEASE);
+#else
+	var = val;
+#endif
+}
+
+
+/**
+ * Stores the given flag and makes it visible before any subsequent load. Together with
+ * `loadSequential()` this allows two parties to claim a resource without compare-and-swap.
+ * 
+ * @param[out] var - flag to store
+ * @param[in] val - value to store
+ * @remarks Without GCC compatible atomic built-ins only a volatile access is performed.
+ */
+template <typename T>
+inline void storeSequential(volatile T & var, const T val) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&var, val, __ATOMIC_SEQ_CST);
+#else
+	var = val;
+#endif
+}
+
+
+/**
+ * Loads the given flag stored via `storeSequential()`.
+ * 
+ * @param[in] var - flag to load
+ * @return loaded value
+ * @remarks Without GCC compatible atomic built-ins only a volatile access is performed.
+ */
+template <typename T>
+inline T loadSequential(const volatile T & var) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&var, __ATOMIC_SEQ_CST);
+#else
+	return var;
+#endif
+}
+
+
+/**
+ * Default statistics of `ReportQueue`. All hooks are empty and compile away.
+ * Derive from this class to only implement the needed hooks.
+ * 
+ * @see ::hid::detail::ReportStats
+ */
+struct NullReportStats {
+	enum { SlotLimit = 128 }; /**< maximum number of supported queue slots */
+	
+	/**
+	 * Called by the producer after a report was queued in the given slot.
+	 * 
+	 * @param[in] slot - queue slot
+	 * @param[in] reportId - report ID or 0 if not used
+	 */
+	inline void built(const size_t /* slot */, const uint8_t /* reportId */) noexcept {}
+	
+	/**
+	 * Called by the consumer before the report in the given slot is removed by `pop()`.
+	 * 
+	 * @param[in] slot - queue slot
+	 * @param[in] reportId - report ID or 0 if not used
+	 */
+	inline void sent(const size_t /* slot */, const uint8_t /* reportId */) noexcept {}
+	
+	/**
+	 * Called by the producer if a report could not be queued.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 */
+	inline void dropped(const uint8_t /* reportId */) noexcept {}
+	
+	/**
+	 * Called by the producer after a report was merged into a queued one.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 */
+	inline void coalesced(const uint8_t /* reportId */) noexcept {}
+	
+	/**
+	 * Called by the producer for each queued report replaced by `pushLatest()`.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 */
+	inline void suppressed(const uint8_t /* reportId */) noexcept {}
+};
+
+
+/**
+ * Per report ID statistics of `ReportQueue`. Counts the queued (built), sent, dropped, coalesced
+ * and suppressed reports and creates a histogram of the latency from `built()` to `sent()`.
+ * Bucket 0 counts zero ticks, bucket `i` counts `2^(i-1) <= ticks < 2^i` and the last bucket
+ * everything above. The report IDs are taken from the Input reports of the descriptor in ascending
+ * order. Reports with other IDs are not counted. The producer counters and the consumer counters
+ * have a single writer each. `write()` provides the values of the `HID_REPORT_STATS_SOURCE` Feature
+ * report. Values read concurrently to an update may be inconsistent.
+ * 
+ * @tparam Ids - number of report IDs; use `reportIdCount(desc.data, desc.size(), RT_INPUT)`
+ * @tparam Clock - type with `static uint32_t now()` returning monotonic ticks
+ * @tparam Slots - number of queue slots (see `ReportQueue`)
+ * @tparam Buckets - number of latency histogram buckets
+ */
+template <size_t Ids, typename Clock, size_t Slots, size_t Buckets = 8>
+class ReportStats {
+private:
+	static_assert(Ids > 0 && Ids <= 256, "Ids needs to be between 1 and 256.");
+	static_assert(Buckets >= 2 && Buckets <= 33, "Buckets needs to be between 2 and 33.");
+	uint8_t ids[Ids]; /**< report IDs in ascending order */
+	uint32_t counters[Ids][5]; /**< counters (see `ReportCounter`); `RC_SENT` is only written by the consumer */
+	uint32_t latency[Ids][Buckets]; /**< latency histogram; only written by the consumer */
+	uint32_t stamps[Slots]; /**< `Clock::now()` at `built()` per queue slot */
+	
+	/**
+	 * Returns the index of the given report ID.
+	 * 
+	 * @param[in] reportId - report ID
+	 * @return index or `Ids` if not found
+	 */
+	inline size_t indexOf(const uint8_t reportId) const noexcept {
+		size_t i = 0;
+		while (i < Ids && this->ids[i] != reportId) {
+			i++;
+		}
+		return i;
+	}
+	
+	/**
+	 * Increments the given counter of the given report ID.
+	 * 
+	 * @param[in] reportId - report ID
+	 * @param[in] counter - counter index
+	 */
+	inline void count(const uint8_t reportId, const size_t counter) noexcept {
+		const size_t i = this->indexOf(reportId);
+		if (i < Ids) {
+			this->counters[i][counter]++;
+		}
+	}
+public:
+	/** Counter indices as used by `get()` and `write()`. */
+	enum ReportCounter {
+		RC_BUILT, /**< queued reports */
+		RC_SENT, /**< sent reports */
+		RC_DROPPED, /**< reports not queued */
+		RC_COALESCED, /**< reports merged into a queued one */
+		RC_SUPPRESSED /**< queued reports replaced by a later one */
+	};
+	
+	enum {
+		SlotLimit = Slots, /**< maximum number of supported queue slots */
+		IdCount = Ids, /**< number of report IDs */
+		BucketCount = Buckets, /**< number of latency histogram buckets */
+		ValueCount = Ids * (5 + Buckets), /**< number of 32-bit values in the Feature report */
+		ReportSize = ValueCount * 4 /**< Feature report size in bytes without report ID */
+	};
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 */
+	constexpr inline ReportStats(const uint8_t * desc, const size_t len) noexcept:
+		ids{0},
+		counters{},
+		latency{},
+		stamps{0}
+	{
+		FieldReader fields(desc, len);
+		ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		uint32_t seen[8] = {0};
+		while ( fields.next(field) ) {
+			if (field.type == RT_INPUT) {
+				seen[field.reportId >> 5] |= uint32_t(1) << (field.reportId & 31);
+			}
+		}
+		size_t n = 0;
+		for (size_t id = 0; id < 256 && n < Ids; id++) {
+			if (((seen[id >> 5] >> (id & 31)) & 1) != 0) {
+				this->ids[n++] = uint8_t(id);
+			}
+		}
+		/* unused entries repeat the last ID to never match another one */
+		for (; n > 0 && n < Ids; n++) {
+			this->ids[n] = this->ids[n - 1];
+		}
+	}
+	
+	/**
+	 * Returns the report ID at the given index.
+	 * 
+	 * @param[in] index - report ID index
+	 * @return report ID
+	 */
+	constexpr inline uint8_t reportId(const size_t index) const noexcept {
+		return this->ids[index];
+	}
+	
+	/**
+	 * Returns the given counter value.
+	 * 
+	 * @param[in] reportId - report ID
+	 * @param[in] counter - counter (see `ReportCounter`)
+	 * @return counter value or 0 if the report ID is not counted
+	 */
+	inline uint32_t get(const uint8_t reportId, const ReportCounter counter) const noexcept {
+		const size_t i = this->indexOf(reportId);
+		return (i < Ids) ? this->counters[i][counter] : 0;
+	}
+	
+	/**
+	 * Returns the given latency histogram bucket.
+	 * 
+	 * @param[in] reportId - report ID
+	 * @param[in] bucket - histogram bucket
+	 * @return number of sent reports within the bucket or 0 if the report ID is not counted
+	 */
+	inline uint32_t histogram(const uint8_t reportId, const size_t bucket) const noexcept {
+		const size_t i = this->indexOf(reportId);
+		return (i < Ids && bucket < Buckets) ? this->latency[i][bucket] : 0;
+	}
+	
+	/**
+	 * Writes the Feature report of `HID_REPORT_STATS_SOURCE`. Each report ID provides its
+	 * counters in the order of `ReportCounter` followed by its latency histogram. All values
+	 * are 32-bit little endian and wrap at LogicalMaximum.
+	 * 
+	 * @param[out] report - report data without report ID
+	 * @param[in] len - available bytes in `report`
+	 * @return written bytes or 0 if `len` is less than `ReportSize`
+	 */
+	inline size_t write(uint8_t * report, const size_t len) const noexcept {
+		if (len < ReportSize) {
+			return 0;
+		}
+		for (size_t i = 0; i < Ids; i++) {
+			for (size_t n = 0; n < (5 + Buckets); n++) {
+				const uint32_t val = ((n < 5) ? this->counters[i][n] : this->latency[i][n - 5]) & 0x7FFFFFFF;
+				writeBits(report, uint32_t(((i * (5 + Buckets)) + n) * 32), 32, val);
+			}
+		}
+		return ReportSize;
+	}
+	
+	/**
+	 * @copydoc NullReportStats::built()
+	 */
+	inline void built(const size_t slot, const uint8_t reportId) noexcept {
+		this->stamps[slot] = Clock::now();
+		this->count(reportId, RC_BUILT);
+	}
+	
+	/**
+	 * @copydoc NullReportStats::sent()
+	 */
+	inline void sent(const size_t slot, const uint8_t reportId) noexcept {
+		const size_t i = this->indexOf(reportId);
+		if (i >= Ids) {
+			return;
+		}
+		const uint32_t ticks = uint32_t(Clock::now() - this->stamps[slot]);
+		size_t bucket = 0;
+		while (bucket < (Buckets - 1) && (ticks >> bucket) != 0) {
+			bucket++;
+		}
+		this->latency[i][bucket]++;
+		this->counters[i][RC_SENT]++;
+	}
+	
+	/**
+	 * @copydoc NullReportStats::dropped()
+	 */
+	inline void dropped(const uint8_t reportId) noexcept {
+		this->count(reportId, RC_DROPPED);
+	}
+	
+	/**
+	 * @copydoc NullReportStats::coalesced()
+	 */
+	inline void coalesced(const uint8_t reportId) noexcept {
+		this->count(reportId, RC_COALESCED);
+	}
+	
+	/**
+	 * @copydoc NullReportStats::suppressed()
+	 */
+	inline void suppressed(const uint8_t reportId) noexcept {
+		this->count(reportId, RC_SUPPRESSED);
+	}
+};
+
+
+/**
+ * Wait-free single producer single consumer queue of Input reports. The producer (e.g. main loop)
+ * adds reports via `push()`, `pushLatest()` or `pushMerged()`, the consumer (e.g. USB interrupt
+ * service routine) sends them via `front()` and `pop()`. The report ID prefix is added automatically.
+ * The indices and flags are single bytes to allow lock-free access on 8-bit targets. Each flag has
+ * a single writer; slots are claimed via a store/load handshake instead of compare-and-swap.
+ * 
+ * @tparam Slots - number of report slots (power of two, at most 128)
+ * @tparam SlotSize - slot size in bytes; use `maxReportSize(desc.data, desc.size(), RT_INPUT)`
+ * @tparam Stats - report statistics (see `NullReportStats` and `ReportStats`)
+ */
+template <size_t Slots, size_t SlotSize, typename Stats = NullReportStats>
+class ReportQueue : private Stats {
+private:
+	static_assert(Slots >= 2 && Slots <= 128 && (Slots & (Slots - 1)) == 0, "Slots needs to be a power of two between 2 and 128.");
+	static_assert(SlotSize > 0 && SlotSize <= 0xFFFF, "SlotSize needs to be between 1 and 65535.");
+	static_assert(Slots <= size_t(Stats::SlotLimit), "Stats supports less than Slots queue slots.");
+	uint8_t data[Slots][SlotSize]; /**< report data including the report ID */
+	uint16_t length[Slots]; /**< report length in bytes including the report ID */
+	uint8_t id[Slots]; /**< report ID */
+	volatile uint8_t replaced[Slots]; /**< non-zero if replaced by a later report; only written by the producer */
+	volatile uint8_t claimed[Slots]; /**< non-zero while being merged; only written by the producer */
+	volatile uint8_t taken[Slots]; /**< non-zero once returned by `front()`; only written by the consumer */
+	volatile uint8_t head; /**< next slot to read; only written by the consumer */
+	volatile uint8_t tail; /**< next slot to write; only written by the producer */
+public:
+	enum {
+		SlotCount = Slots, /**< number of report slots */
+		ReportSize = SlotSize /**< maximum report size in bytes including the report ID */
+	};
+	
+	/**
+	 * Constructor.
+	 */
+	inline ReportQueue() noexcept:
+		Stats{},
+		data{},
+		length{0},
+		id{0},
+		replaced{0},
+		claimed{0},
+		taken{0},
+		head{0},
+		tail{0}
+	{}
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] stats - initial report statistics (e.g. `ReportStats` with the report IDs)
+	 */
+	inline explicit ReportQueue(const Stats & stats) noexcept:
+		Stats(stats),
+		data{},
+		length{0},
+		id{0},
+		replaced{0},
+		claimed{0},
+		taken{0},
+		head{0},
+		tail{0}
+	{}
+	
+	/**
+	 * Returns the report statistics.
+	 * 
+	 * @return report statistics
+	 */
+	inline const Stats & stats() const noexcept {
+		return *this;
+	}
+	
+	/**
+	 * Adds a report. Shall only be called by the producer.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @param[in] report - report data without report ID
+	 * @param[in] len - report data length in bytes
+	 * @return true on success, false if the queue is full or the report is too large
+	 */
+	inline bool push(const uint8_t reportId, const uint8_t * report, const size_t len) noexcept {
+		const uint8_t t = this->tail;
+		const size_t total = len + ((reportId != 0) ? 1 : 0);
+		if (total > SlotSize || uint8_t(t - loadAcquire(this->head)) >= Slots) {
+			this->dropped(reportId);
+			return false;
+		}
+		const size_t slot = t & (Slots - 1);
+		uint8_t * out = this->data[slot];
+		if (reportId != 0) {
+			*out++ = reportId;
+		}
+		for (size_t i = 0; i < len; i++) {
+			out[i] = report[i];
+		}
+		this->length[slot] = uint16_t(total);
+		this->id[slot] = reportId;
+		this->built(slot, reportId);
+		storeRelease(this->replaced[slot], uint8_t(0));
+		storeRelease(this->tail, uint8_t(t + 1));
+		return true;
+	}
+	
+	/**
+	 * Adds a report and drops all queued reports with the same report ID which were not yet
+	 * taken by `front()`. Use this for reports where only the latest state matters.
+	 * Shall only be called by the producer.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @param[in] report - report data without report ID
+	 * @param[in] len - report data length in bytes
+	 * @return true on success, false if the queue is full or the report is too large
+	 */
+	inline bool pushLatest(const uint8_t reportId, const uint8_t * report, const size_t len) noexcept {
+		if ( ! this->push(reportId, report, len) ) {
+			return false;
+		}
+		/* the new report is visible first to never leave the consumer without any */
+		const uint8_t last = uint8_t(this->tail - 1);
+		const uint8_t h = loadAcquire(this->head);
+		for (uint8_t i = h; i != last; i++) {
+			const size_t slot = i & (Slots - 1);
+			if (this->id[slot] != reportId || this->replaced[slot] != 0) {
+				continue;
+			}
+			storeSequential(this->claimed[slot], uint8_t(1));
+			/* the consumer resets `taken` after advancing `head` in `pop()` */
+			if (loadSequential(this->taken[slot]) == 0 && uint8_t(loadAcquire(this->head) - h) <= uint8_t(i - h)) {
+				storeRelease(this->replaced[slot], uint8_t(1));
+				this->suppressed(reportId);
+			}
+			storeRelease(this->claimed[slot], uint8_t(0));
+		}
+		return true;
+	}
+	
+	/**
+	 * Merges the report into the latest queued report if that one has the same report ID and
+	 * was not yet taken by `front()`. Otherwise, the report is added like with `push()`.
+	 * Merging is skipped if a relative value would saturate to never lose any motion.
+	 * This keeps the queue depth constant while the host does not fetch any reports.
+	 * Shall only be called by the producer.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @param[in] report - report data without report ID
+	 * @param[in] len - report data length in bytes
+	 * @param[in] merger - merger of the given report (see `ReportMerger`)
+	 * @return true on success, false if the queue is full or the report is too large
+	 * @tparam Merger - report merger type
+	 */
+	template <typename Merger>
+	inline bool pushMerged(const uint8_t reportId, const uint8_t * report, const size_t len, const Merger & merger) noexcept {
+		const uint8_t t = this->tail;
+		const size_t total = len + ((reportId != 0) ? 1 : 0);
+		const size_t slot = uint8_t(t - 1) & (Slots - 1);
+		if (total > SlotSize || t == loadAcquire(this->head) || this->id[slot] != reportId || this->length[slot] != total || this->replaced[slot] != 0) {
+			return this->push(reportId, report, len);
+		}
+		uint8_t latest[SlotSize] = {0};
+		latest[0] = reportId;
+		for (size_t i = 0; i < len; i++) {
+			latest[i + total - len] = report[i];
+		}
+		bool merged = false;
+		storeSequential(this->claimed[slot], uint8_t(1));
+		/* the consumer resets `taken` after advancing `head` in `pop()` */
+		if (loadSequential(this->taken[slot]) == 0 && t != loadAcquire(this->head) && merger.fits(this->data[slot], latest, total)) {
+			merged = merger.merge(this->data[slot], latest, total);
+		}
+		storeRelease(this->claimed[slot], uint8_t(0));
+		if ( merged ) {
+			this->coalesced(reportId);
+			return true;
+		}
+		return this->push(reportId, report, len);
+	}
+	
+	/**
+	 * Returns the next report to send. Replaced reports are skipped.
+	 * The report is not returned while the producer merges into it via `pushMerged()`.
+	 * Call this function again later in that case (e.g. from the main loop).
+	 * Shall only be called by the consumer.
+	 * 
+	 * @param[out] len - receives the report length in bytes including the report ID
+	 * @return pointer to the report data or `nullptr` if no report is ready
+	 */
+	inline const uint8_t * front(size_t & len) noexcept {
+		const uint8_t t = loadAcquire(this->tail);
+		uint8_t h = this->head;
+		len = 0;
+		for (; h != t; h++) {
+			const size_t slot = h & (Slots - 1);
+			if (this->taken[slot] == 0) {
+				if (loadAcquire(this->replaced[slot]) != 0) {
+					continue;
 				}
-			} else if ( _HID_WITHIN(ARG_LIST) ) {
-				if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
-					/* end of hex literal */
-					flags &= ~HID_WITHIN_HEX_LIT;
-					/* merge multiple arguments via OR */
-					if (encMap->arg == signedNumArg && lit > 0x7FFFFFFFUL) {
-						return errorMsg.at(n, E_Number_overflow);
-					}
-					arg |= lit;
-					hasArg = ( ! multiArg ) || *ptr != ',';
-					if (*ptr == ')') {
-						continue; /* re-parse as argument list */
-					}
-				} else {
-					return errorMsg.at(n, E_Invalid_hex_value);
+				storeSequential(this->taken[slot], uint8_t(1));
+				if (loadSequential(this->claimed[slot]) != 0) {
+					storeRelease(this->taken[slot], uint8_t(0));
+					break;
 				}
-			} else if ( isWhitespace(*ptr) ) {
-				/* end of hex literal */
-				flags &= ~HID_WITHIN_HEX_LIT;
-				encodeUnsigned(out, lit);
+				/* `pushLatest()` may have replaced it between the first check and `taken` */
+				if (loadAcquire(this->replaced[slot]) != 0) {
+					storeRelease(this->taken[slot], uint8_t(0));
+					continue;
+				}
+			}
+			storeRelease(this->head, h);
+			len = this->length[slot];
+			return this->data[slot];
+		}
+		storeRelease(this->head, h);
+		return nullptr;
+	}
+	
+	/**
+	 * Removes the report returned by `front()`. Shall only be called by the consumer.
+	 */
+	inline void pop() noexcept {
+		const uint8_t h = this->head;
+		if (h != loadAcquire(this->tail)) {
+			const size_t slot = h & (Slots - 1);
+			this->sent(slot, this->id[slot]);
+			storeRelease(this->head, uint8_t(h + 1));
+			storeRelease(this->taken[slot], uint8_t(0));
+		}
+	}
+	
+	/**
+	 * Returns the number of queued reports including replaced ones.
+	 * 
+	 * @return queued reports
+	 */
+	inline size_t size() const noexcept {
+		return uint8_t(loadAcquire(this->tail) - loadAcquire(this->head));
+	}
+	
+	/**
+	 * Checks whether no report is queued.
+	 * 
+	 * @return true if empty, else false
+	 */
+	inline bool empty() const noexcept {
+		return this->size() == 0;
+	}
+};
+
+
+} /* anonymous namespace */
+} /* namespace detail */
+
+
+using Error = ::hid::error::Info;
+using ::hid::error::reporter;
+using ::hid::detail::compile;
+using ::hid::detail::SourceView;
+using ::hid::detail::compiledSize;
+using ::hid::detail::annotationCount;
+using ::hid::detail::compileError;
+using ::hid::detail::Descriptor;
+using ::hid::detail::ItemList;
+using ::hid::detail::loweredSize;
+using ::hid::detail::Compiler;
+using ::hid::detail::TraceState;
+using ::hid::detail::FullPolicy;
+using ::hid::detail::LeanPolicy;
+using ::hid::detail::NullTracer;
+using ::hid::detail::StateCounter;
+using ::hid::detail::LookupHistogram;
+using ::hid::detail::TraceEvent;
+using ::hid::detail::TE_STATE;
+using ::hid::detail::TE_ITEM;
+using ::hid::detail::TE_LITERAL;
+using ::hid::detail::TE_LOOKUP;
+using ::hid::detail::TE_MISS;
+using ::hid::detail::TE_ERROR;
+using ::hid::detail::Event;
+using ::hid::detail::EventLog;
+#ifdef HID_DESCRIPTOR_DEBUG
+using ::hid::detail::PrintTracer;
+#endif /* HID_DESCRIPTOR_DEBUG */
+using ::hid::detail::DefaultTracer;
+
+
+/**
+ * Creates a HidDescriptor source instance from the given source code.
+ * Fill out the parameters (if any) and call compile on it to create
+ * the byte representation.
+ * 
+ * @param[in] source - HID descriptor source code
+ * @return HID descriptor source code object
+ */
+template <size_t N>
+static constexpr ::hid::detail::Source<N + 1> fromSource(const char (&source)[N]) noexcept {
+	::hid::detail::Source<N + 1> tmp;
+	for (size_t n = 0; n < N; n++) {
+		tmp.code[n] = source[n];
+	}
+	tmp.code[N] = 0; /* ensure null-termination */
+	return tmp;
+}
+
+
+namespace detail {
+namespace {
+
+
+/**
+ * Boot protocol keyboard report descriptor source.
+ * 
+ * The variable is a template to compile it only on use.
+ * 
+ * @tparam T - unused
+ * @see HID 1.11 appendix B.1
+ */
+template <typename T = void>
+constexpr const auto bootKeyboardSource = ::hid::fromSource(R"(
+UsagePage(GenericDesktop)
+Usage(Keyboard)
+Collection(Application)
+	ReportSize(1)
+	ReportCount(8)
+	UsagePage(Keyboard)
+	UsageMinimum(224)
+	UsageMaximum(231)
+	LogicalMinimum(0)
+	LogicalMaximum(1)
+	Input(Data, Var, Abs) # Modifier byte
+	ReportCount(1)
+	ReportSize(8)
+	Input(Cnst) # Reserved byte
+	ReportCount(5)
+	ReportSize(1)
+	UsagePage(Led)
+	UsageMinimum(1)
+	UsageMaximum(5)
+	Output(Data, Var, Abs) # LED report
+	ReportCount(1)
+	ReportSize(3)
+	Output(Cnst) # LED report padding
+	ReportCount(6)
+	ReportSize(8)
+	LogicalMinimum(0)
+	LogicalMaximum(255)
+	UsagePage(Keyboard)
+	UsageMinimum(0)
+	UsageMaximum(255)
+	Input(Data, Ary)
+EndCollection
+)");
+
+
+/**
+ * Boot protocol mouse report descriptor source.
+ * 
+ * The variable is a template to compile it only on use.
+ * 
+ * @tparam T - unused
+ * @see HID 1.11 appendix B.2
+ */
+template <typename T = void>
+constexpr const auto bootMouseSource = ::hid::fromSource(R"(
+UsagePage(GenericDesktop)
+Usage(Mouse)
+Collection(Application)
+	Usage(Pointer)
+	Collection(Physical)
+		ReportCount(3)
+		ReportSize(1)
+		UsagePage(Button)
+		UsageMinimum(Button1)
+		UsageMaximum(Button3)
+		LogicalMinimum(0)
+		LogicalMaximum(1)
+		Input(Data, Var, Abs) # Buttons
+		ReportCount(1)
+		ReportSize(5)
+		Input(Cnst) # Padding
+		ReportSize(8)
+		ReportCount(2)
+		UsagePage(GenericDesktop)
+		Usage(X)
+		Usage(Y)
+		LogicalMinimum(-127)
+		LogicalMaximum(127)
+		Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+)");
+
+
+/**
+ * Compiled boot protocol keyboard report descriptor (e.g. `bootKeyboardDescriptor<>`).
+ * 
+ * @tparam T - unused
+ */
+template <typename T = void>
+constexpr const Descriptor<compiledSize(bootKeyboardSource<T>)> bootKeyboardDescriptor{bootKeyboardSource<T>};
+
+/**
+ * Compiled boot protocol mouse report descriptor (e.g. `bootMouseDescriptor<>`).
+ * 
+ * @tparam T - unused
+ */
+template <typename T = void>
+constexpr const Descriptor<compiledSize(bootMouseSource<T>)> bootMouseDescriptor{bootMouseSource<T>};
+
+
+/**
+ * Converts Input reports of a keyboard into the boot protocol format.
+ * The conversion is derived at compile time from the report descriptor
+ * of the keyboard. Modifier keys are taken from the Keyboard usages
+ * LeftControl to RightGui. Other keys are taken from the first Keyboard
+ * bitmap (e.g. NKRO) or array field. More than 6 pressed keys result in
+ * `ErrorRollOver` for all key slots.
+ * 
+ * @see HID 1.11 appendix B.1
+ */
+class BootKeyboard {
+public:
+	enum {
+		Size = 8, /**< boot protocol report size in bytes */
+		NoField = 0xFFFFFFFF /**< bit offset of missing fields */
+	};
+private:
+	uint32_t modifiers[8]; /**< bit offset of each modifier key or `NoField` */
+	uint32_t keys; /**< bit offset of the key bitmap or array or `NoField` */
+	uint32_t keySize; /**< bits per key array element (1 for bitmaps) */
+	uint32_t keyCount; /**< number of bitmap bits or array elements */
+	uint32_t keyBase; /**< usage of the first bitmap bit or usage minus value of array elements */
+	uint8_t reportId; /**< main report ID or 0 */
+	bool keyArray; /**< true if `keys` refers to an array field */
+	
+	/**
+	 * Finds the main report field with the key bitmap or array.
+	 * 
+	 * @param[in] desc - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 */
+	constexpr inline void findKeys(const uint8_t * desc, const size_t len) noexcept {
+		FieldReader fields(desc, len);
+		ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		while ( fields.next(field) ) {
+			if (field.type != RT_INPUT || field.isConstant()) {
+				continue;
+			}
+			if ( field.isVariable() ) {
+				const uint32_t first = usageAt(desc, len, field, 0);
+				if (field.size != 1 || (first >> 16) != 0x07 || (first & 0xFFFF) >= 0xE0) {
+					continue;
+				}
+				this->keyBase = first & 0xFFFF;
 			} else {
-				return errorMsg.at(n, E_Invalid_hex_value);
+				const uint32_t first = usageAt(desc, len, field, 0);
+				if ((first >> 16) != 0x07 || field.size > 32) {
+					continue;
+				}
+				this->keyBase = uint32_t(int32_t(first & 0xFFFF) - field.logicalMinimum);
+				this->keyArray = true;
 			}
-		} else if ( _HID_WITHIN(NUM_LIT) ) {
-			if ( isDigit(*ptr) ) {
-				const uint32_t oldLit = lit;
-				lit *= 10;
-				if (lit < oldLit) {
-					return errorMsg.at(n, E_Number_overflow);
+			this->keys = field.bitOffset;
+			this->keySize = field.size;
+			this->keyCount = field.count;
+			this->reportId = field.reportId;
+			return;
+		}
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID descriptor of the keyboard
+	 * @param[in] len - descriptor length in bytes
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	constexpr inline explicit BootKeyboard(const uint8_t * desc, const size_t len) noexcept:
+		modifiers{NoField, NoField, NoField, NoField, NoField, NoField, NoField, NoField},
+		keys{NoField},
+		keySize{0},
+		keyCount{0},
+		keyBase{0},
+		reportId{0},
+		keyArray{false}
+	{
+		this->findKeys(desc, len);
+		for (uint32_t i = 0; i < 8; i++) {
+			const UsageMatch match = findUsage(desc, len, RT_INPUT, 0x700E0 + i);
+			if (match.valid && (this->keys == NoField || match.field.reportId == this->reportId)) {
+				this->modifiers[i] = match.bitOffset;
+				this->reportId = match.field.reportId;
+			}
+		}
+	}
+	
+	/**
+	 * Returns the report ID of the converted Input report.
+	 * 
+	 * @return report ID or 0 if not used
+	 */
+	constexpr inline uint8_t getReportId() const noexcept {
+		return this->reportId;
+	}
+	
+	/**
+	 * Converts the given Input report into a boot protocol report.
+	 * 
+	 * @param[in] report - Input report including the report ID (if used)
+	 * @param[in] len - report size in bytes
+	 * @param[out] boot - receives `Size` bytes of boot protocol report
+	 * @return true on success, false if the report ID or size does not match
+	 */
+	constexpr inline bool convert(const uint8_t * report, const size_t len, uint8_t * boot) const noexcept {
+		size_t avail = len;
+		if (this->reportId != 0) {
+			if (avail < 1 || report[0] != this->reportId) {
+				return false;
+			}
+			report++;
+			avail--;
+		}
+		uint32_t needed = 0;
+		for (uint32_t i = 0; i < 8; i++) {
+			if (this->modifiers[i] != NoField && this->modifiers[i] >= needed) {
+				needed = this->modifiers[i] + 1;
+			}
+		}
+		if (this->keys != NoField && (this->keys + (this->keySize * this->keyCount)) > needed) {
+			needed = this->keys + (this->keySize * this->keyCount);
+		}
+		if (((needed + 7) / 8) > avail) {
+			return false;
+		}
+		uint8_t mods = 0;
+		for (uint32_t i = 0; i < 8; i++) {
+			if (this->modifiers[i] != NoField) {
+				mods = uint8_t(mods | (readBits(report, this->modifiers[i], 1) << i));
+			}
+		}
+		for (size_t i = 1; i < Size; i++) {
+			boot[i] = 0;
+		}
+		size_t n = 0;
+		if (this->keys == NoField) {
+			/* modifiers only */
+		} else if ( this->keyArray ) {
+			for (uint32_t i = 0; i < this->keyCount; i++) {
+				const uint32_t usage = readBits(report, this->keys + (i * this->keySize), this->keySize) + this->keyBase;
+				if (usage == 0 || usage > 0xFF || (usage >= 0xE0 && usage <= 0xE7)) {
+					continue;
 				}
-				lit += uint32_t(*ptr - '0');
-				if (lit < oldLit) {
-					return errorMsg.at(n, E_Number_overflow);
+				if (n < 6) {
+					boot[2 + n] = uint8_t(usage);
 				}
-			} else if ( _HID_WITHIN(ARG_LIST) ) {
-				if (isWhitespace(*ptr) || *ptr == ')' || (multiArg && *ptr == ',')) {
-					/* end of number literal */
-					flags &= ~HID_WITHIN_NUM_LIT;
-					/* merge multiple arguments via OR */
-					if ( negLit ) {
-						if (lit > 0x80000000UL) {
-							return errorMsg.at(n, E_Number_overflow);
-						}
-						arg |= uint32_t(-int32_t(lit));
-						negLit = false;
-					} else {
-						if (encMap->arg == signedNumArg && lit > 0x7FFFFFFFUL) {
-							return errorMsg.at(n, E_Number_overflow);
-						}
-						arg |= lit;
+				n += (usage <= 0x03) ? 7 : 1; /* propagate error codes as roll over */
+			}
+		} else {
+			for (uint32_t bit = 0; bit < this->keyCount; bit += 8) {
+				const uint32_t width = ((this->keyCount - bit) < 8) ? (this->keyCount - bit) : 8;
+				uint32_t pressed = readBits(report, this->keys + bit, width);
+				for (uint32_t usage = this->keyBase + bit; pressed != 0; pressed >>= 1, usage++) {
+					if ((pressed & 1) == 0 || usage > 0xFF || (usage >= 0xE0 && usage <= 0xE7)) {
+						continue;
 					}
-					hasArg = ( ! multiArg ) || *ptr != ',';
-					if (*ptr == ')') {
-						continue; /* re-parse as argument list */
+					if (n < 6) {
+						boot[2 + n] = uint8_t(usage);
 					}
-				} else {
-					return errorMsg.at(n, E_Invalid_numeric_value);
+					n++;
 				}
-			} else if ( isWhitespace(*ptr) ) {
-				/* end of number literal */
-				flags &= ~HID_WITHIN_NUM_LIT;
-				encodeUnsigned(out, lit);
+			}
+		}
+		if (n > 6) {
+			/* ErrorRollOver */
+			for (size_t i = 2; i < Size; i++) {
+				boot[i] = 0x01;
+			}
+		}
+		boot[0] = mods;
+		return true;
+	}
+};
+
+
+/**
+ * Converts Input reports of a mouse into the boot protocol format.
+ * The conversion is derived at compile time from the report descriptor
+ * of the mouse. Buttons 1 to 3 and the X and Y axes are mapped. Wider
+ * axis values are clamped to the 8-bit range of the boot protocol.
+ * 
+ * @see HID 1.11 appendix B.2
+ */
+class BootMouse {
+public:
+	enum {
+		Size = 3, /**< boot protocol report size in bytes */
+		NoField = 0xFFFFFFFF /**< bit offset of missing fields */
+	};
+private:
+	uint32_t buttons[3]; /**< bit offset of each button or `NoField` */
+	uint32_t axes[2]; /**< bit offset of X and Y or `NoField` */
+	uint32_t axisSize[2]; /**< bit size of X and Y */
+	bool axisSigned[2]; /**< true if X or Y are signed */
+	uint8_t reportId; /**< main report ID or 0 */
+	uint32_t needed; /**< minimum report size in bits excluding the report ID */
+	
+	/**
+	 * Records the given match if it belongs to the converted report.
+	 * 
+	 * @param[in] match - found usage
+	 * @param[out] offset - receives the bit offset
+	 * @return true if recorded, else false
+	 */
+	constexpr inline bool record(const UsageMatch & match, uint32_t & offset) noexcept {
+		if (( ! match.valid ) || (this->needed != 0 && match.field.reportId != this->reportId)) {
+			return false;
+		}
+		offset = match.bitOffset;
+		this->reportId = match.field.reportId;
+		if ((match.bitOffset + match.field.size) > this->needed) {
+			this->needed = match.bitOffset + match.field.size;
+		}
+		return true;
+	}
+	
+	/**
+	 * Clamps the given value to the boot protocol axis range.
+	 * 
+	 * @param[in] val - value to clamp
+	 * @return clamped value
+	 */
+	static constexpr inline uint8_t clamp(const int32_t val) noexcept {
+		return uint8_t(int8_t((val < -127) ? -127 : ((val > 127) ? 127 : val)));
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID descriptor of the mouse
+	 * @param[in] len - descriptor length in bytes
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	constexpr inline explicit BootMouse(const uint8_t * desc, const size_t len) noexcept:
+		buttons{NoField, NoField, NoField},
+		axes{NoField, NoField},
+		axisSize{0, 0},
+		axisSigned{false, false},
+		reportId{0},
+		needed{0}
+	{
+		for (uint32_t i = 0; i < 2; i++) {
+			const UsageMatch match = findUsage(desc, len, RT_INPUT, 0x10030 + i);
+			if ( this->record(match, this->axes[i]) ) {
+				this->axisSize[i] = (match.field.size > 32) ? 32 : match.field.size;
+				this->axisSigned[i] = match.field.isSigned();
+			}
+		}
+		for (uint32_t i = 0; i < 3; i++) {
+			this->record(findUsage(desc, len, RT_INPUT, 0x90001 + i), this->buttons[i]);
+		}
+	}
+	
+	/**
+	 * Returns the report ID of the converted Input report.
+	 * 
+	 * @return report ID or 0 if not used
+	 */
+	constexpr inline uint8_t getReportId() const noexcept {
+		return this->reportId;
+	}
+	
+	/**
+	 * Converts the given Input report into a boot protocol report.
+	 * 
+	 * @param[in] report - Input report including the report ID (if used)
+	 * @param[in] len - report size in bytes
+	 * @param[out] boot - receives `Size` bytes of boot protocol report
+	 * @return true on success, false if the report ID or size does not match
+	 */
+	constexpr inline bool convert(const uint8_t * report, const size_t len, uint8_t * boot) const noexcept {
+		size_t avail = len;
+		if (this->reportId != 0) {
+			if (avail < 1 || report[0] != this->reportId) {
+				return false;
+			}
+			report++;
+			avail--;
+		}
+		if (((this->needed + 7) / 8) > avail) {
+			return false;
+		}
+		uint8_t pressed = 0;
+		for (uint32_t i = 0; i < 3; i++) {
+			if (this->buttons[i] != NoField) {
+				pressed = uint8_t(pressed | (readBits(report, this->buttons[i], 1) << i));
+			}
+		}
+		boot[0] = pressed;
+		for (size_t i = 0; i < 2; i++) {
+			if (this->axes[i] == NoField) {
+				boot[1 + i] = 0;
+			} else if ( this->axisSigned[i] ) {
+				boot[1 + i] = clamp(readSignedBits(report, this->axes[i], this->axisSize[i]));
 			} else {
-				return errorMsg.at(n, E_Invalid_numeric_value);
+				const uint32_t val = readBits(report, this->axes[i], this->axisSize[i]);
+				boot[1 + i] = clamp((val > 127) ? 127 : int32_t(val));
+			}
+		}
+		return true;
+	}
+};
+
+
+/**
+ * USB descriptor types.
+ * 
+ * @see USB 2.0 ch. 9.4 table 9-5, HID 1.11 ch. 7.1
+ */
+enum DescriptorType : uint8_t {
+	DT_CONFIGURATION = 0x02, /**< Configuration descriptor */
+	DT_STRING        = 0x03, /**< String descriptor */
+	DT_INTERFACE     = 0x04, /**< Interface descriptor */
+	DT_ENDPOINT      = 0x05, /**< Endpoint descriptor */
+	DT_HID           = 0x21, /**< HID class descriptor */
+	DT_REPORT        = 0x22, /**< HID report descriptor */
+	DT_PHYSICAL      = 0x23  /**< HID physical descriptor */
+};
+
+
+/**
+ * Returns the number of distinct string arguments within the given source code.
+ * 
+ * @param[in] source - source code description
+ * @return number of string descriptors excluding the language ID list
+ */
+template <size_t S, size_t P>
+constexpr inline size_t stringCount(const ::hid::detail::Source<S, P> & source) noexcept {
+	StringReader strings(source.data(), source.size());
+	StringOrder order;
+	Token str{source.data(), 0};
+	size_t res = 0;
+	while ( strings.next(str) ) {
+		if ( order.isFirst(source.data(), str, SK_STRING) ) {
+			res++;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Returns the size of all string descriptors for the string arguments within the given source code.
+ * 
+ * @param[in] source - source code description
+ * @return size in bytes including the language ID list
+ */
+template <size_t S, size_t P>
+constexpr inline size_t stringTableSize(const ::hid::detail::Source<S, P> & source) noexcept {
+	StringReader strings(source.data(), source.size());
+	StringOrder order;
+	Token str{source.data(), 0};
+	size_t res = 4;
+	while ( strings.next(str) ) {
+		if ( order.isFirst(source.data(), str, SK_STRING) ) {
+			res += stringDescriptorSize(str);
+		}
+	}
+	return res;
+}
+
+
+/**
+ * USB string descriptors of all string arguments (e.g. `StringIndex("Left Trigger")`) of a
+ * HID descriptor source. Index 0 holds the language ID list. The other indices match the ones
+ * assigned by `compile()`.
+ * 
+ * @tparam C - number of strings (see `stringCount()`)
+ * @tparam N - total size in bytes (see `stringTableSize()`)
+ * @see USB 2.0 ch. 9.6.7
+ */
+template <size_t C, size_t N>
+struct StringTable {
+	uint8_t data[N]; /**< Concatenated string descriptors in UTF-16LE. */
+	uint16_t offsets[C + 1]; /**< Offset of each string descriptor within `data`. */
+	enum { Count = C, Size = N }; /**< String count and data size. */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @param[in] langId - language ID (defaults to US English)
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	template <size_t S, size_t P>
+	constexpr inline explicit StringTable(const ::hid::detail::Source<S, P> & source, const uint16_t langId = 0x0409) noexcept:
+		data{0},
+		offsets{0}
+	{
+		size_t pos = 0;
+		this->put(pos, 4);
+		this->put(pos, DT_STRING);
+		this->putWord(pos, langId);
+		StringReader strings(source.data(), source.size());
+		StringOrder order;
+		Token str{source.data(), 0};
+		size_t index = 1;
+		while (index <= C && strings.next(str)) {
+			if ( ! order.isFirst(source.data(), str, SK_STRING) ) {
+				continue;
 			}
-		} else if ( _HID_WITHIN(ARG_LIST) ) {
-			if ( hasArg ) {
-				if (*ptr == ')') {
-					/* end of argument list */
-					flags &= ~(HID_WITHIN_ARG_LIST | HID_WITHIN_UNIT_SYS);
-					if (encMap->arg == signedNumArg) {
-						item |= encodedSizeValue(encodedSize(int32_t(arg)));
-						encodeUnsigned(out, item);
-						encodeSigned(out, int32_t(arg));
-					} else if (encMap->arg == unitExpMap) {
-						/* UnitExponent */
-						const int32_t sArg = int32_t(arg);
-						if (sArg > 7 || sArg < -8) {
-							return errorMsg.at(n, E_Argument_value_out_of_range);
-						}
-						encodeUnsigned(out, item | 1); /* encoding one byte data */
-						encodeUnsigned(out, uint32_t(sArg & 0xF)); /* see unitExpMap */
-					} else {
-						if (encMap->arg == delimMap) {
-							if (arg == 0) {
-								/* Delimiter(Close) */
-								if (delimLevel <= 0) {
-									return errorMsg.at(n, E_Unexpected_DelimiterClose);
-								}
-								delimLevel--;
-							} else if (arg == 1) {
-								/* Delimiter(Open) */
-								delimLevel++;
-							} else {
-								return errorMsg.at(n, E_Unexpected_Delimiter_value);
-							}
-						} else if (encMap->arg == usagePageMap || encMap->arg == usageArg) {
-							/* UsagePage/Usage/UsageMinimum/UsageMaximum */
-							if (arg > 0xFFFF) {
-								return errorMsg.at(n, E_Argument_value_out_of_range);
-							}
-							if (encMap->arg == usagePageMap) {
-								/* UsagePage */
-								hasUsagePage = true;
-							}
-						} else if (encMap->value == 0x74) {
-							/* ReportSize */
-							reportSizes++;
-						} else if (encMap->value == 0x94) {
-							/* ReportCount */
-							reportCounts++;
-						}
-						item |= encodedSizeValue(encodedSize(arg));
-						encodeUnsigned(out, item);
-						encodeUnsigned(out, arg);
-					}
-					/* commas are only allowed within argument lists */
-					multiArg = false;
-				} else if (multiArg && *ptr == ',') {
-					hasArg = false;
-				} else if ( ! isWhitespace(*ptr) ) {
-					return errorMsg.at(n, E_Unexpected_token);
+			this->offsets[index] = uint16_t(pos);
+			this->put(pos, uint8_t(stringDescriptorSize(str)));
+			this->put(pos, DT_STRING);
+			for (size_t n = 0; n < str.length; ) {
+				uint32_t cp = 0;
+				const size_t step = decodeUtf8(str.start + n, str.length - n, cp);
+				if (step == 0) {
+					break;
 				}
-			} else {
-				if ( isItemChar(*ptr) ) {
-					/* start of argument */
-					flags |= HID_WITHIN_ARG;
-					tArg.start = ptr;
-					tArg.length = 1;
-				} else if (ptr[0] == '0' && (n + 1) < len && ptr[1] == 'x') {
-					/* start of hex literal */
-					flags |= HID_WITHIN_HEX_LIT;
-					if ((n + 2) >= len) {
-						return errorMsg.at(n + 2, E_Unexpected_end_of_source);
-					}
-					if ( ! isHexDigit(ptr[2]) ) {
-						return errorMsg.at(n + 2, E_Invalid_hex_value);
-					}
-					lit = 0;
-					n++;
-					ptr++;
-				} else if (*ptr == '-') {
-					/* start of negative number literal */
-					if (encMap->arg != signedNumArg && encMap->arg != unitExpMap) {
-						return errorMsg.at(n, E_Negative_numbers_are_not_allowed_in_this_context);
-					}
-					flags |= HID_WITHIN_NUM_LIT;
-					lit = 0;
-					negLit = true;
-				} else if ( isDigit(*ptr) ) {
-					/* start of number literal */
-					flags |= HID_WITHIN_NUM_LIT;
-					lit = 0;
-					continue; /* re-parse as number literal */
-				} else if (*ptr == '{') {
-					/* start of user parameter */
-					flags |= HID_WITHIN_PARAM;
-					tArg.start = ptr + 1;
-					tArg.length = 0;
-				} else if (*ptr == ')') {
-					/* end of argument list */
-					return errorMsg.at(n, E_Missing_argument);
-				} else if ( ! isWhitespace(*ptr) ) {
-					return errorMsg.at(n, E_Unexpected_argument_name_character);
+				if (cp > 0xFFFF) {
+					/* UTF-16 surrogate pair */
+					cp -= 0x10000;
+					this->putWord(pos, uint16_t(0xD800 | (cp >> 10)));
+					this->putWord(pos, uint16_t(0xDC00 | (cp & 0x3FF)));
+				} else {
+					this->putWord(pos, uint16_t(cp));
 				}
+				n += step;
 			}
+			index++;
 		}
-		n++;
-		ptr++;
 	}
-	/* end of source code */
-	if (_HID_WITHIN(HEX_LIT) || _HID_WITHIN(NUM_LIT)) {
-		/* end of hex/number literal */
-		flags &= ~(HID_WITHIN_HEX_LIT | HID_WITHIN_NUM_LIT);
-		if (flags == HID_START) {
-			encodeUnsigned(out, lit);
+	
+	/**
+	 * Returns the string descriptor with the given index (e.g. for GET_DESCRIPTOR(String)).
+	 * 
+	 * @param[in] index - string descriptor index
+	 * @return string descriptor (size is the first byte) or `nullptr` for unknown indices
+	 */
+	constexpr inline const uint8_t * get(const size_t index) const noexcept {
+		return (index <= C) ? (this->data + this->offsets[index]) : nullptr;
+	}
+	
+	/**
+	 * Returns the number of strings excluding the language ID list.
+	 * 
+	 * @return string count
+	 */
+	constexpr inline size_t count() const noexcept {
+		return C;
+	}
+	
+	/**
+	 * Returns the data size.
+	 * 
+	 * @return data size
+	 */
+	constexpr inline size_t size() const noexcept {
+		return N;
+	}
+private:
+	/**
+	 * Writes the given byte.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in] val - byte to write
+	 */
+	constexpr inline void put(size_t & pos, const uint8_t val) noexcept {
+		if (pos < N) {
+			this->data[pos] = val;
+		}
+		pos++;
+	}
+	
+	/**
+	 * Writes the given 16-bit value in little endian byte order.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in] val - value to write
+	 */
+	constexpr inline void putWord(size_t & pos, const uint16_t val) noexcept {
+		this->put(pos, uint8_t(val));
+		this->put(pos, uint8_t(val >> 8));
+	}
+};
+
+
+/**
+ * Returns the number of physical descriptor sets (`PhysicalSet` items) within the given source code.
+ * 
+ * @param[in] source - source code description
+ * @return number of physical descriptor sets excluding set 0
+ */
+template <size_t S, size_t P>
+constexpr inline size_t physicalSetCount(const ::hid::detail::Source<S, P> & source) noexcept {
+	::hid::error::Info error;
+	NullWriter out;
+	NullTracer tracer;
+	CompileState state;
+	compile(SourceView(source), out, error, state, CM_ALL, tracer);
+	return state.physicalSets;
+}
+
+
+/**
+ * Returns the number of distinct designator names within the given source code.
+ * 
+ * @param[in] source - source code description
+ * @return number of physical descriptors per set
+ */
+template <size_t S, size_t P>
+constexpr inline size_t designatorCount(const ::hid::detail::Source<S, P> & source) noexcept {
+	StringReader names(source.data(), source.size(), SK_DESIGNATOR);
+	StringOrder order;
+	Token str{source.data(), 0};
+	size_t res = 0;
+	while ( names.next(str) ) {
+		if ( order.isFirst(source.data(), str, SK_DESIGNATOR) ) {
+			res++;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Tracer which records the physical descriptor sets.
+ * 
+ * @tparam S - number of physical descriptor sets
+ * @tparam D - number of designators per set
+ * @see ::hid::detail::NullTracer
+ */
+template <size_t S, size_t D>
+struct PhysicalRecorder : NullTracer {
+	uint8_t * data; /**< output array starting at set 1 */
+	size_t set; /**< current physical descriptor set */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[out] d - output array for `S` sets of `1 + 2 * D` bytes each
+	 */
+	constexpr inline explicit PhysicalRecorder(uint8_t * d) noexcept:
+		data{d},
+		set{0}
+	{}
+	
+	/**
+	 * @copydoc NullTracer::physical()
+	 */
+	constexpr inline void physical(const size_t /* pos */, const uint32_t prefix, const size_t index, const uint32_t value) noexcept {
+		if (prefix == 0x0C) {
+			this->set = index;
+			if (index > 0 && index <= S) {
+				this->data[(index - 1) * (1 + 2 * D)] = uint8_t(value);
+			}
+		} else if (this->set > 0 && this->set <= S && index > 0 && index <= D) {
+			const size_t offset = ((this->set - 1) * (1 + 2 * D)) + (2 * index) - 1;
+			this->data[offset] = uint8_t(value >> 8);
+			this->data[offset + 1] = uint8_t(value);
+		}
+	}
+};
+
+
+/**
+ * HID physical descriptor sets of all `PhysicalSet` and `Designator` items of a HID descriptor
+ * source. Set 0 holds the number and the size of the other sets. Each set holds one physical
+ * descriptor per designator index as assigned by `compile()`. Designators not given within a set
+ * are left as `None`. The last `Designator` with the same name within a set takes precedence.
+ * 
+ * @tparam S - number of physical descriptor sets (see `physicalSetCount()`)
+ * @tparam D - number of designators per set (see `designatorCount()`)
+ * @see HID 1.11 ch. 6.2.3
+ */
+template <size_t S, size_t D>
+struct PhysicalTable {
+	uint8_t data[3 + (S * (1 + 2 * D))]; /**< Concatenated physical descriptor sets. */
+	enum { Sets = S, Designators = D, SetSize = 1 + 2 * D, Size = 3 + (S * (1 + 2 * D)) }; /**< Set count, designator count, set size and data size. */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] source - source code description
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	template <size_t N, size_t P>
+	constexpr inline explicit PhysicalTable(const ::hid::detail::Source<N, P> & source) noexcept:
+		data{0}
+	{
+		this->data[0] = uint8_t(S);
+		this->data[1] = uint8_t(SetSize);
+		this->data[2] = uint8_t(SetSize >> 8);
+		::hid::error::Info error;
+		NullWriter out;
+		PhysicalRecorder<S, D> tracer{this->data + 3};
+		CompileState state;
+		compile(SourceView(source), out, error, state, CM_ALL, tracer);
+	}
+	
+	/**
+	 * Returns the physical descriptor set with the given index (e.g. for GET_DESCRIPTOR(Physical)).
+	 * 
+	 * @param[in] index - physical descriptor set index
+	 * @return physical descriptor set or `nullptr` for unknown indices
+	 * @see length()
+	 */
+	constexpr inline const uint8_t * get(const size_t index) const noexcept {
+		if (index == 0) {
+			return this->data;
+		}
+		return (index <= S) ? (this->data + 3 + ((index - 1) * SetSize)) : nullptr;
+	}
+	
+	/**
+	 * Returns the size of the physical descriptor set with the given index.
+	 * 
+	 * @param[in] index - physical descriptor set index
+	 * @return size in bytes or 0 for unknown indices
+	 */
+	constexpr inline size_t length(const size_t index) const noexcept {
+		if (index == 0) {
+			return 3;
+		}
+		return (index <= S) ? size_t(SetSize) : 0;
+	}
+	
+	/**
+	 * Returns the number of physical descriptor sets excluding set 0.
+	 * 
+	 * @return set count
+	 */
+	constexpr inline size_t count() const noexcept {
+		return S;
+	}
+	
+	/**
+	 * Returns the data size.
+	 * 
+	 * @return data size
+	 */
+	constexpr inline size_t size() const noexcept {
+		return Size;
+	}
+};
+
+
+/**
+ * Boot interface protocols.
+ * 
+ * @see HID 1.11 ch. 4.3
+ */
+enum BootProtocol : uint8_t {
+	BP_NONE     = 0x00, /**< No boot interface */
+	BP_KEYBOARD = 0x01, /**< Boot keyboard */
+	BP_MOUSE    = 0x02  /**< Boot mouse */
+};
+
+
+/**
+ * Configuration attributes.
+ * 
+ * @see USB 2.0 ch. 9.6.3
+ */
+enum ConfigurationAttribute : uint8_t {
+	CA_BUS_POWERED  = 0x80, /**< Bus-powered device */
+	CA_SELF_POWERED = 0xC0, /**< Self-powered device */
+	CA_REMOTE_WAKEUP = 0x20 /**< Device supports remote wakeup (combine with one of the above) */
+};
+
+
+/**
+ * HID interface definition for `Configuration`. The endpoint packet sizes are
+ * derived from the largest Input and Output report of the given report descriptor.
+ * 
+ * @see HID 1.11 ch. 6.2
+ */
+struct Interface {
+	const uint8_t * report; /**< compiled HID report descriptor */
+	size_t reportLength; /**< report descriptor length in bytes */
+	uint8_t bootProtocol; /**< boot protocol or `BP_NONE` */
+	uint8_t endpoint; /**< endpoint number or 0 to use the interface number plus one */
+	uint8_t interval; /**< polling interval in frames */
+	uint8_t countryCode; /**< HID country code */
+	uint8_t stringIndex; /**< interface string descriptor index */
+	bool hasOutEndpoint; /**< true to add an interrupt OUT endpoint */
+	uint16_t maxPacketSize; /**< upper limit for the endpoint packet sizes */
+	uint16_t physicalLength; /**< physical descriptor size in bytes or 0 if none */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID report descriptor
+	 */
+	template <size_t N, size_t A>
+	constexpr inline explicit Interface(const Descriptor<N, A> & desc) noexcept:
+		report{desc.data},
+		reportLength{N},
+		bootProtocol{BP_NONE},
+		endpoint{0},
+		interval{10},
+		countryCode{0},
+		stringIndex{0},
+		hasOutEndpoint{false},
+		maxPacketSize{64},
+		physicalLength{0}
+	{}
+	
+	/**
+	 * Sets the boot protocol. This also sets the boot interface subclass.
+	 * 
+	 * @param[in] protocol - boot protocol
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withBoot(const BootProtocol protocol) const noexcept {
+		Interface res{*this};
+		res.bootProtocol = protocol;
+		return res;
+	}
+	
+	/**
+	 * Sets the endpoint number used for the IN and OUT endpoint.
+	 * 
+	 * @param[in] number - endpoint number (1 to 15)
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withEndpoint(const uint8_t number) const noexcept {
+		Interface res{*this};
+		res.endpoint = uint8_t(number & 0x0F);
+		return res;
+	}
+	
+	/**
+	 * Adds an interrupt OUT endpoint for Output reports.
+	 * 
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withOutEndpoint() const noexcept {
+		Interface res{*this};
+		res.hasOutEndpoint = true;
+		return res;
+	}
+	
+	/**
+	 * Sets the polling interval.
+	 * 
+	 * @param[in] frames - polling interval in frames
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withInterval(const uint8_t frames) const noexcept {
+		Interface res{*this};
+		res.interval = frames;
+		return res;
+	}
+	
+	/**
+	 * Sets the HID country code.
+	 * 
+	 * @param[in] code - country code
+	 * @return modified interface definition
+	 * @see HID 1.11 ch. 6.2.1
+	 */
+	constexpr inline Interface withCountryCode(const uint8_t code) const noexcept {
+		Interface res{*this};
+		res.countryCode = code;
+		return res;
+	}
+	
+	/**
+	 * Sets the interface string descriptor index.
+	 * 
+	 * @param[in] index - string descriptor index
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withString(const uint8_t index) const noexcept {
+		Interface res{*this};
+		res.stringIndex = index;
+		return res;
+	}
+	
+	/**
+	 * Sets the upper limit for the endpoint packet sizes. Larger reports are transferred
+	 * in multiple packets of this size.
+	 * 
+	 * @param[in] size - maximum packet size in bytes (64 for full-speed)
+	 * @return modified interface definition
+	 */
+	constexpr inline Interface withMaxPacketSize(const uint16_t size) const noexcept {
+		Interface res{*this};
+		res.maxPacketSize = size;
+		return res;
+	}
+	
+	/**
+	 * Lists the given physical descriptor sets in the HID class descriptor.
+	 * 
+	 * @param[in] table - physical descriptor sets
+	 * @return modified interface definition
+	 * @see HID 1.11 ch. 6.2.1
+	 */
+	template <size_t S, size_t D>
+	constexpr inline Interface withPhysical(const PhysicalTable<S, D> & table) const noexcept {
+		Interface res{*this};
+		res.physicalLength = uint16_t(table.size());
+		return res;
+	}
+	
+	/**
+	 * Returns the endpoint packet size for the given report type. The size is clamped to
+	 * `maxPacketSize`. Larger reports span multiple transactions (USB 2.0 ch. 5.7.3).
+	 * 
+	 * @param[in] type - report type (`RT_INPUT` or `RT_OUTPUT`)
+	 * @return packet size in bytes
+	 */
+	constexpr inline uint16_t packetSize(const uint8_t type) const noexcept {
+		const size_t size = maxReportSize(this->report, this->reportLength, type);
+		if (size < 1) {
+			return 1;
+		} else if (size > this->maxPacketSize) {
+			return this->maxPacketSize;
 		}
+		return uint16_t(size);
 	}
-	if ( _HID_WITHIN(ITEM) ) {
-		flags &= ~HID_WITHIN_ITEM;
-		subError = E_Invalid_item_name;
-		encMap = findEncoding(tItem, itemMap, dynMap, subError);
-		if (encMap == NULL) {
-			return errorMsg.at(n, subError);
-		} else if (encMap->arg == colArgMap) {
-			/* Collection */
-			if (usageAtLevel != colLevel) {
-				return errorMsg.at(n, E_Missing_Usage_for_Collection);
+	
+	/**
+	 * Returns the size of the interface, HID and endpoint descriptors.
+	 * 
+	 * @return size in bytes
+	 */
+	constexpr inline size_t size() const noexcept {
+		return size_t(9 + 9 + 7) + (this->hasOutEndpoint ? 7 : 0) + ((this->physicalLength != 0) ? 3 : 0);
+	}
+};
+
+
+/**
+ * Returns the size of the configuration descriptor including all subordinate descriptors.
+ * 
+ * @param[in] interfaces - HID interface definitions
+ * @return configuration descriptor size in bytes
+ * @see USB 2.0 ch. 9.6.3
+ */
+template <size_t M>
+constexpr inline size_t configurationSize(const Interface (& interfaces)[M]) noexcept {
+	size_t res = 9;
+	for (size_t i = 0; i < M; i++) {
+		res += interfaces[i].size();
+	}
+	return res;
+}
+
+
+/**
+ * Complete USB configuration descriptor with the interface, HID class and endpoint
+ * descriptors of all given HID interfaces. Interfaces are numbered in the given order.
+ * `valid` is false if two interfaces use the same endpoint number.
+ * 
+ * @tparam N - configuration descriptor size
+ * @see USB 2.0 ch. 9.6.3, HID 1.11 ch. 7.1
+ */
+template <size_t N>
+struct Configuration {
+	uint8_t data[N]; /**< Configuration descriptor data. */
+	bool valid; /**< true if all endpoint addresses are distinct */
+	enum { Size = N }; /**< Data size. */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] interfaces - HID interface definitions
+	 * @param[in] attributes - configuration attributes (see `ConfigurationAttribute`)
+	 * @param[in] maxPower - maximum power consumption in mA
+	 * @param[in] value - configuration value
+	 * @param[in] stringIndex - configuration string descriptor index
+	 * @remarks This should be processed at compile time (i.e. used as constexpr).
+	 */
+	template <size_t M>
+	constexpr inline explicit Configuration(const Interface (& interfaces)[M], const uint8_t attributes = CA_BUS_POWERED, const uint16_t maxPower = 100, const uint8_t value = 1, const uint8_t stringIndex = 0) noexcept:
+		data{0},
+		valid{true}
+	{
+		size_t pos = 0;
+		uint16_t used = 0;
+		this->put(pos, 9, DT_CONFIGURATION);
+		this->putWord(pos, uint16_t(N));
+		this->put(pos, uint8_t(M), value, stringIndex, uint8_t(attributes | 0x80), uint8_t((maxPower > 510) ? 255 : (maxPower + 1) / 2));
+		for (size_t i = 0; i < M; i++) {
+			const Interface & intf = interfaces[i];
+			const uint8_t ep = uint8_t((intf.endpoint != 0) ? intf.endpoint : (i + 1));
+			if ((used & (1 << (ep & 0x0F))) != 0 || (ep & 0x0F) == 0) {
+				this->valid = false;
 			}
-			colLevel++;
-		} else if (encMap->arg == endCol) {
-			/* EndCollection */
-			if (colLevel <= 0) {
-				return errorMsg.at(n, E_Unexpected_EndCollection);
+			used = uint16_t(used | (1 << (ep & 0x0F)));
+			/* interface descriptor */
+			this->put(pos, 9, DT_INTERFACE, uint8_t(i), 0, uint8_t(intf.hasOutEndpoint ? 2 : 1), 0x03, uint8_t((intf.bootProtocol != BP_NONE) ? 1 : 0), intf.bootProtocol, intf.stringIndex);
+			/* HID class descriptor */
+			const bool physical = (intf.physicalLength != 0);
+			this->put(pos, uint8_t(physical ? 12 : 9), DT_HID);
+			this->putWord(pos, 0x0111);
+			this->put(pos, intf.countryCode, uint8_t(physical ? 2 : 1), DT_REPORT);
+			this->putWord(pos, uint16_t(intf.reportLength));
+			if ( physical ) {
+				this->put(pos, DT_PHYSICAL);
+				this->putWord(pos, intf.physicalLength);
 			}
-			if (reportSizes < reportCounts) {
-				return errorMsg.at(n, E_Missing_ReportSize);
-			} else if (reportCounts < reportSizes) {
-				return errorMsg.at(n, E_Missing_ReportCount);
+			/* interrupt IN endpoint descriptor */
+			this->put(pos, 7, DT_ENDPOINT, uint8_t(0x80 | ep), 0x03);
+			this->putWord(pos, intf.packetSize(RT_INPUT));
+			this->put(pos, intf.interval);
+			if ( intf.hasOutEndpoint ) {
+				/* interrupt OUT endpoint descriptor */
+				this->put(pos, 7, DT_ENDPOINT, ep, 0x03);
+				this->putWord(pos, intf.packetSize(RT_OUTPUT));
+				this->put(pos, intf.interval);
 			}
-			colLevel--;
-			usageAtLevel--;
 		}
-		/* end of item */
-		if (encMap->arg != NULL && (encMap->arg->name != NULL || encMap->arg == usageArg)) {
-			return errorMsg.at(n, E_Missing_argument);
+	}
+	
+	/**
+	 * Returns the data size.
+	 * 
+	 * @return data size
+	 */
+	constexpr inline size_t size() const noexcept {
+		return N;
+	}
+	
+	/**
+	 * Returns the offset of the HID class descriptor for the given interface.
+	 * This is needed to answer GET_DESCRIPTOR requests for the HID class descriptor.
+	 * 
+	 * @param[in] number - interface number
+	 * @return offset within `data` or `N` if not found
+	 * @see HID 1.11 ch. 7.1.1
+	 */
+	constexpr inline size_t hidOffset(const uint8_t number) const noexcept {
+		bool found = false;
+		for (size_t pos = 0; (pos + 2) < N && this->data[pos] > 0; pos += this->data[pos]) {
+			if (this->data[pos + 1] == DT_INTERFACE) {
+				found = (this->data[pos + 2] == number);
+			} else if (this->data[pos + 1] == DT_HID && found) {
+				return pos;
+			}
 		}
-		if (flags == HID_START) {
-			encodeUnsigned(out, encMap->value);
+		return N;
+	}
+private:
+	/**
+	 * Writes the given bytes.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in] val - byte to write
+	 */
+	constexpr inline void put(size_t & pos, const uint8_t val) noexcept {
+		if (pos < N) {
+			this->data[pos] = val;
 		}
+		pos++;
 	}
-	if (colLevel > 0) {
-		return errorMsg.at(n, E_Missing_EndCollection);
+	
+	/**
+	 * Writes the given bytes.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in] val - byte to write
+	 * @param[in] vals - subsequent bytes to write
+	 */
+	template <typename... Vals>
+	constexpr inline void put(size_t & pos, const uint8_t val, const Vals... vals) noexcept {
+		this->put(pos, val);
+		this->put(pos, static_cast<uint8_t>(vals)...);
 	}
-	if (delimLevel > 0) {
-		return errorMsg.at(n, E_Missing_DelimiterClose);
+	
+	/**
+	 * Writes the given 16-bit value in little endian byte order.
+	 * 
+	 * @param[in,out] pos - output position
+	 * @param[in] val - value to write
+	 */
+	constexpr inline void putWord(size_t & pos, const uint16_t val) noexcept {
+		this->put(pos, uint8_t(val), uint8_t(val >> 8));
 	}
-	if (flags != HID_START && flags != HID_WITHIN_COMMENT) {
-		return errorMsg.at(n, E_Unexpected_end_of_source);
+};
+
+
+/**
+ * Reference to a compiled HID descriptor.
+ */
+struct DescriptorRef {
+	const uint8_t * data; /**< compiled HID descriptor */
+	size_t length; /**< descriptor length in bytes */
+	
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] desc - compiled HID descriptor
+	 */
+	template <size_t N, size_t A>
+	constexpr inline DescriptorRef(const Descriptor<N, A> & desc) noexcept:
+		data{desc.data},
+		length{N}
+	{}
+};
+
+
+/**
+ * Contiguous part of a descriptor.
+ */
+struct Segment {
+	const uint8_t * data; /**< segment data */
+	size_t length; /**< segment length in bytes */
+};
+
+
+/**
+ * Returns the end of the fragment at the given position. Fragments end after
+ * each top-level collection or at the end of the descriptor.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] pos - fragment start position
+ * @return fragment end position
+ */
+constexpr inline size_t fragmentEnd(const uint8_t * desc, const size_t len, size_t pos) noexcept {
+	int level = 0;
+	while (pos < len) {
+		const Item item = readItem(desc, len, pos);
+		pos = item.next();
+		if (item.tag == 0xA0) {
+			/* Collection */
+			level++;
+		} else if (item.tag == 0xC0 && level > 0) {
+			/* EndCollection */
+			level--;
+			if (level == 0) {
+				break;
+			}
+		}
 	}
-	error = ::hid::error::Info();
-	return true;
-#undef _HID_WITHIN
+	return pos;
 }
 
 
 /**
- * Returns the byte size of the compiled HID descriptor.
+ * Checks whether the given byte ranges are equal.
  * 
- * @param[in] source - source code description
- * @return compiled HID descriptor size
+ * @param[in] lhs - left-hand side bytes
+ * @param[in] rhs - right-hand side bytes
+ * @param[in] len - number of bytes to compare
+ * @return true if equal, else false
  */
-template <size_t S, size_t P>
-constexpr inline size_t compiledSize(const ::hid::detail::Source<S, P> & source) noexcept {
-	::hid::error::Info error;
-	SizeEstimator out;
-	compile(source, out, error);
-	return out.getPosition();
+constexpr inline bool equalBytes(const uint8_t * lhs, const uint8_t * rhs, const size_t len) noexcept {
+	for (size_t i = 0; i < len; i++) {
+		if (lhs[i] != rhs[i]) {
+			return false;
+		}
+	}
+	return true;
 }
 
 
 /**
- * Returns the byte size of the compiled HID descriptor.
+ * Storage sizes of a descriptor family.
+ */
+struct FamilyLayout {
+	size_t fragments; /**< number of unique fragments */
+	size_t pool; /**< total size of the unique fragments in bytes */
+	size_t list; /**< total number of fragment references */
+	size_t largest; /**< size of the largest descriptor in bytes */
+};
+
+
+/**
+ * Returns the storage sizes needed to store the given descriptors as deduplicated fragments.
  * 
- * @param[in] source - source code description
- * @return compiled HID descriptor size
+ * @param[in] family - compiled HID descriptors
+ * @return storage sizes
  */
-template <size_t S, size_t P>
-constexpr inline ::hid::error::Info compileError(const ::hid::detail::Source<S, P> & source) noexcept {
-	::hid::error::Info error;
-	NullWriter out;
-	compile(source, out, error);
-	return error;
+template <size_t M>
+constexpr inline FamilyLayout familyLayout(const DescriptorRef (& family)[M]) noexcept {
+	FamilyLayout res{0, 0, 0, 0};
+	for (size_t d = 0; d < M; d++) {
+		const DescriptorRef & desc = family[d];
+		if (desc.length > res.largest) {
+			res.largest = desc.length;
+		}
+		for (size_t pos = 0; pos < desc.length; ) {
+			const size_t end = fragmentEnd(desc.data, desc.length, pos);
+			bool unique = true;
+			/* compare with all previous fragments */
+			for (size_t d2 = 0; d2 <= d && unique; d2++) {
+				const DescriptorRef & desc2 = family[d2];
+				for (size_t pos2 = 0; pos2 < desc2.length && (d2 < d || pos2 < pos); ) {
+					const size_t end2 = fragmentEnd(desc2.data, desc2.length, pos2);
+					if ((end2 - pos2) == (end - pos) && equalBytes(desc2.data + pos2, desc.data + pos, end - pos)) {
+						unique = false;
+						break;
+					}
+					pos2 = end2;
+				}
+			}
+			if ( unique ) {
+				res.fragments++;
+				res.pool += end - pos;
+			}
+			res.list++;
+			pos = end;
+		}
+	}
+	return res;
 }
 
 
 /**
- * Compiled HID descriptor instance.
+ * Family of compiled HID descriptors stored as deduplicated fragments. Each descriptor
+ * is split after every top-level collection. Identical fragments are stored only once
+ * and each descriptor refers to its fragments via a fragment list.
  * 
- * @tparam N - HID descriptor size
+ * @tparam M - number of descriptors
+ * @tparam F - number of unique fragments
+ * @tparam B - total size of the unique fragments in bytes
+ * @tparam L - total number of fragment references
+ * @see DEF_HID_FAMILY_AS
  */
-template <size_t N>
-struct Descriptor {
-    uint8_t data[N]; /**< Compiled HID descriptor data. */
-    enum { Size = N }; /**< Data size. */
+template <size_t M, size_t F, size_t B, size_t L>
+struct DescriptorFamily {
+	static_assert(B <= 0xFFFF && L <= 0xFFFF, "Descriptor family exceeds the 16-bit storage limits.");
+	uint8_t pool[(B > 0) ? B : 1]; /**< Unique fragment data. */
+	uint16_t offset[(F > 0) ? F : 1]; /**< Fragment start within `pool`. */
+	uint16_t length[(F > 0) ? F : 1]; /**< Fragment length in bytes. */
+	uint16_t list[(L > 0) ? L : 1]; /**< Fragment indices of all descriptors. */
+	uint16_t listStart[M + 1]; /**< First fragment list entry of each descriptor. */
+	uint16_t total[M]; /**< Descriptor size in bytes (see `FamilyLayout::largest`). */
+	enum { Size = M }; /**< Number of descriptors. */
 	
 	/**
 	 * Constructor.
 	 * 
-	 * @param[in] source - source code description
+	 * @param[in] family - compiled HID descriptors
 	 * @remarks This should be processed at compile time (i.e. used as constexpr).
-	 * @see ::hid::detail::compile()
 	 */
-	template <size_t S, size_t P>
-    constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & source) noexcept:
-		data{0}
+	constexpr inline explicit DescriptorFamily(const DescriptorRef (& family)[M]) noexcept:
+		pool{0},
+		offset{0},
+		length{0},
+		list{0},
+		listStart{0},
+		total{0}
 	{
-		::hid::error::Info error;
-		BufferWriter out(this->data, N);
-		compile(source, out, error);
+		size_t fragments = 0;
+		size_t poolPos = 0;
+		size_t listPos = 0;
+		for (size_t d = 0; d < M; d++) {
+			const DescriptorRef & desc = family[d];
+			this->listStart[d] = uint16_t(listPos);
+			this->total[d] = uint16_t(desc.length);
+			for (size_t pos = 0; pos < desc.length; ) {
+				const size_t end = fragmentEnd(desc.data, desc.length, pos);
+				const size_t len = end - pos;
+				size_t f = 0;
+				for (; f < fragments; f++) {
+					if (this->length[f] == len && equalBytes(this->pool + this->offset[f], desc.data + pos, len)) {
+						break;
+					}
+				}
+				if (f == fragments && f < F && (poolPos + len) <= B) {
+					/* new unique fragment */
+					this->offset[f] = uint16_t(poolPos);
+					this->length[f] = uint16_t(len);
+					for (size_t i = 0; i < len; i++) {
+						this->pool[poolPos++] = desc.data[pos + i];
+					}
+					fragments++;
+				}
+				if (listPos < L) {
+					this->list[listPos++] = uint16_t(f);
+				}
+				pos = end;
+			}
+		}
+		this->listStart[M] = uint16_t(listPos);
 	}
 	
 	/**
-	 * Returns the data size.
+	 * Returns the number of descriptors.
 	 * 
-	 * @return data size
+	 * @return number of descriptors
 	 */
-	constexpr inline size_t size() const {
-		return N;
+	constexpr inline size_t size() const noexcept {
+		return M;
 	}
-};
-
-
-/**
- * Compiled HID descriptor instance.
- * 
- * @tparam N - HID descriptor size
- */
-template <>
-struct Descriptor<0> {
-    uint8_t * data; /**< Compiled HID descriptor data. */
-    enum { Size = 0 }; /**< Data size. */
 	
 	/**
-	 * Constructor.
+	 * Returns the size of the given descriptor.
 	 * 
-	 * @param[in] source - source code description
-	 * @remarks This should be processed at compile time (i.e. used as constexpr).
-	 * @see ::hid::detail::compile()
+	 * @param[in] index - descriptor index
+	 * @return descriptor size in bytes or 0 for an invalid index
 	 */
-	template <size_t S, size_t P>
-    constexpr inline explicit Descriptor(const ::hid::detail::Source<S, P> & /* source */) noexcept:
-		data{NULL}
-	{}
+	constexpr inline size_t size(const size_t index) const noexcept {
+		return (index < M) ? this->total[index] : 0;
+	}
 	
 	/**
-	 * Returns the data size.
+	 * Returns the contiguous part of the given descriptor at the passed offset.
 	 * 
-	 * @return data size
+	 * @param[in] index - descriptor index
+	 * @param[in] pos - byte offset within the descriptor
+	 * @return segment data up to the end of the fragment (zero length if out of range)
 	 */
-	constexpr inline size_t size() const noexcept {
-		return 0;
+	constexpr inline Segment segment(const size_t index, size_t pos) const noexcept {
+		if (index < M) {
+			for (size_t n = this->listStart[index]; n < this->listStart[index + 1]; n++) {
+				const size_t f = this->list[n];
+				if (pos < this->length[f]) {
+					return Segment{this->pool + this->offset[f] + pos, this->length[f] - pos};
+				}
+				pos -= this->length[f];
+			}
+		}
+		return Segment{this->pool, 0};
+	}
+	
+	/**
+	 * Copies a part of the given descriptor. This can be used to serve GET_DESCRIPTOR requests
+	 * in multiple transactions.
+	 * 
+	 * @param[in] index - descriptor index
+	 * @param[in] pos - byte offset within the descriptor
+	 * @param[out] buffer - output buffer
+	 * @param[in] len - maximum number of bytes to copy
+	 * @return number of bytes copied
+	 */
+	constexpr inline size_t read(const size_t index, size_t pos, uint8_t * buffer, const size_t len) const noexcept {
+		size_t res = 0;
+		while (res < len) {
+			const Segment seg = this->segment(index, pos);
+			if (seg.length == 0) {
+				break;
+			}
+			for (size_t i = 0; i < seg.length && res < len; i++, res++, pos++) {
+				buffer[res] = seg.data[i];
+			}
+		}
+		return res;
 	}
 };
 
@@ -4901,31 +11416,61 @@ struct Descriptor<0> {
 } /* namespace detail */
 
 
-using Error = ::hid::error::Info;
-using ::hid::error::reporter;
-using ::hid::detail::compile;
-using ::hid::detail::compiledSize;
-using ::hid::detail::compileError;
-using ::hid::detail::Descriptor;
-
-
-/**
- * Creates a HidDescriptor source instance from the given source code.
- * Fill out the parameters (if any) and call compile on it to create
- * the byte representation.
- * 
- * @param[in] source - HID descriptor source code
- * @return HID descriptor source code object
- */
-template <size_t N>
-static constexpr ::hid::detail::Source<N + 1> fromSource(const char (&source)[N]) noexcept {
-	::hid::detail::Source<N + 1> tmp;
-	for (size_t n = 0; n < N; n++) {
-		tmp.code[n] = source[n];
-	}
-	tmp.code[N] = 0; /* ensure null-termination */
-	return tmp;
-}
+using ::hid::detail::ReportType;
+using ::hid::detail::RT_INPUT;
+using ::hid::detail::RT_OUTPUT;
+using ::hid::detail::RT_FEATURE;
+using ::hid::detail::ReportField;
+using ::hid::detail::FieldReader;
+using ::hid::detail::UsageReader;
+using ::hid::detail::UsageMatch;
+using ::hid::detail::usageAt;
+using ::hid::detail::findUsage;
+using ::hid::detail::fieldCount;
+using ::hid::detail::reportSize;
+using ::hid::detail::maxReportSize;
+using ::hid::detail::readBits;
+using ::hid::detail::readSignedBits;
+using ::hid::detail::writeBits;
+using ::hid::detail::reportIdCount;
+using ::hid::detail::NullReportStats;
+using ::hid::detail::ReportStats;
+using ::hid::detail::ReportQueue;
+using ::hid::detail::ReportMerger;
+using ::hid::detail::bootKeyboardDescriptor;
+using ::hid::detail::bootMouseDescriptor;
+using ::hid::detail::BootKeyboard;
+using ::hid::detail::BootMouse;
+using ::hid::detail::DescriptorType;
+using ::hid::detail::DT_CONFIGURATION;
+using ::hid::detail::DT_STRING;
+using ::hid::detail::DT_INTERFACE;
+using ::hid::detail::DT_ENDPOINT;
+using ::hid::detail::DT_HID;
+using ::hid::detail::DT_REPORT;
+using ::hid::detail::DT_PHYSICAL;
+using ::hid::detail::stringCount;
+using ::hid::detail::stringTableSize;
+using ::hid::detail::StringTable;
+using ::hid::detail::physicalSetCount;
+using ::hid::detail::designatorCount;
+using ::hid::detail::PhysicalTable;
+using ::hid::detail::BootProtocol;
+using ::hid::detail::BP_NONE;
+using ::hid::detail::BP_KEYBOARD;
+using ::hid::detail::BP_MOUSE;
+using ::hid::detail::ConfigurationAttribute;
+using ::hid::detail::CA_BUS_POWERED;
+using ::hid::detail::CA_SELF_POWERED;
+using ::hid::detail::CA_REMOTE_WAKEUP;
+using ::hid::detail::Interface;
+using ::hid::detail::configurationSize;
+using ::hid::detail::Configuration;
+using ::hid::detail::DescriptorRef;
+using ::hid::detail::Segment;
+using ::hid::detail::FamilyLayout;
+using ::hid::detail::familyLayout;
+using ::hid::detail::DescriptorFamily;
 
 
 } /* namespace hid */
@@ -0,0 +1,1040 @@
+/**
+ * @file HidPipeline.hpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ * 
+ * Host side pipeline to decode the Input reports of many devices in parallel.
+ * Each device has its own compiled HID descriptor and ingestion queue. The reports are decoded
+ * with a per descriptor layout on a work-stealing thread pool and batched per report ID.
+ * Use `hid::Pipeline`.
+ * 
+ * @remarks This requires a hosted C++14 environment with thread support.
+ * @see ::hid::detail::Pipeline
+ */
+#ifndef __HIDPIPELINE_HPP__
+#define __HIDPIPELINE_HPP__
+
+#include "HidDescriptor.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace hid {
+namespace detail {
+namespace {
+
+
+/** Assumed cache line size in bytes. Used to keep concurrently accessed variables apart. */
+enum { CacheLineSize = 64 };
+
+
+/**
+ * Lock-free bounded single producer single consumer queue.
+ * 
+ * @tparam T - element type
+ * @tparam Size - queue capacity (power of two)
+ */
+template <typename T, size_t Size>
+class SpscQueue {
+private:
+	static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "Size needs to be a power of two.");
+	std::atomic<size_t> head; /**< next element to read */
+	char padHead[CacheLineSize]; /**< keeps `head` and `tail` on different cache lines */
+	std::atomic<size_t> tail; /**< next element to write */
+	char padTail[CacheLineSize]; /**< keeps `tail` and `items` on different cache lines */
+	T items[Size]; /**< queue elements */
+public:
+	/**
+	 * Constructor.
+	 */
+	inline SpscQueue() noexcept:
+		head{0},
+		padHead{},
+		tail{0},
+		padTail{}
+	{}
+	
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue & operator= (const SpscQueue &) = delete;
+	
+	/**
+	 * Adds an element. Shall only be called by the producer.
+	 * 
+	 * @param[in] item - element to add
+	 * @return true on success, false if the queue is full
+	 */
+	inline bool push(const T & item) noexcept {
+		const size_t t = this->tail.load(std::memory_order_relaxed);
+		if ((t - this->head.load(std::memory_order_acquire)) >= Size) {
+			return false;
+		}
+		this->items[t & (Size - 1)] = item;
+		this->tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+	
+	/**
+	 * Returns the element at the front without removing it. Shall only be called by the consumer.
+	 * 
+	 * @return pointer to the front element or `nullptr` if the queue is empty
+	 */
+	inline const T * front() const noexcept {
+		const size_t h = this->head.load(std::memory_order_relaxed);
+		if (h == this->tail.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		return this->items + (h & (Size - 1));
+	}
+	
+	/**
+	 * Removes the front element. Shall only be called by the consumer after a successful `front()`.
+	 */
+	inline void drop() noexcept {
+		this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	
+	/**
+	 * Removes the front element. Shall only be called by the consumer.
+	 * 
+	 * @param[out] item - receives the removed element
+	 * @return true on success, false if the queue is empty
+	 */
+	inline bool pop(T & item) noexcept {
+		const T * res = this->front();
+		if (res == nullptr) {
+			return false;
+		}
+		item = *res;
+		this->drop();
+		return true;
+	}
+	
+	/**
+	 * Checks whether the queue is empty.
+	 * 
+	 * @return true if empty, else false
+	 */
+	inline bool empty() const noexcept {
+		return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+	}
+};
+
+
+/**
+ * Lock-free bounded multiple producer multiple consumer queue.
+ * 
+ * @tparam T - element type
+ * @tparam Size - queue capacity (power of two)
+ * @see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+template <typename T, size_t Size>
+class MpmcQueue {
+private:
+	static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "Size needs to be a power of two.");
+	/** Queue element with its sequence number. */
+	struct Cell {
+		std::atomic<size_t> sequence; /**< position at which this cell can be written (`pos`) or read (`pos + 1`) */
+		T item; /**< element */
+	};
+	Cell cells[Size]; /**< queue elements */
+	char padCells[CacheLineSize]; /**< keeps `cells` and `head` on different cache lines */
+	std::atomic<size_t> head; /**< next element to read */
+	char padHead[CacheLineSize]; /**< keeps `head` and `tail` on different cache lines */
+	std::atomic<size_t> tail; /**< next element to write */
+public:
+	/**
+	 * Constructor.
+	 */
+	inline MpmcQueue() noexcept:
+		padCells{},
+		head{0},
+		padHead{},
+		tail{0}
+	{
+		for (size_t i = 0; i < Size; i++) {
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	
+	MpmcQueue(const MpmcQueue &) = delete;
+	MpmcQueue & operator= (const MpmcQueue &) = delete;
+	
+	/**
+	 * Adds an element.
+	 * 
+	 * @param[in] item - element to add
+	 * @return true on success, false if the queue is full
+	 */
+	inline bool push(const T & item) noexcept {
+		size_t pos = this->tail.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell & cell = this->cells[pos & (Size - 1)];
+			const size_t seq = cell.sequence.load(std::memory_order_acquire);
+			if (seq == pos) {
+				if ( this->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+					cell.item = item;
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (seq < pos) {
+				return false;
+			} else {
+				pos = this->tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	
+	/**
+	 * Removes the front element.
+	 * 
+	 * @param[out] item - receives the removed element
+	 * @return true on success, false if the queue is empty
+	 */
+	inline bool pop(T & item) noexcept {
+		size_t pos = this->head.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell & cell = this->cells[pos & (Size - 1)];
+			const size_t seq = cell.sequence.load(std::memory_order_acquire);
+			if (seq == (pos + 1)) {
+				if ( this->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+					item = cell.item;
+					cell.sequence.store(pos + Size, std::memory_order_release);
+					return true;
+				}
+			} else if (seq < (pos + 1)) {
+				return false;
+			} else {
+				pos = this->head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+};
+
+
+/** Pipeline limits. */
+enum {
+	MaxPipelineReportSize = 64, /**< maximum report size in bytes including the report ID */
+	MaxBatchValues = 512, /**< values per batch; enough for a single report with 1 bit fields */
+	OpenBatches = 4 /**< number of report IDs with an open batch per device */
+};
+
+
+/**
+ * Single Input report as passed to the ingestion queue.
+ */
+struct RawReport {
+	uint16_t length; /**< report length in bytes including the report ID */
+	uint8_t data[MaxPipelineReportSize]; /**< report data */
+};
+
+
+/**
+ * Decoded reports of a single device and report ID. Each record holds the values of all
+ * non-constant fields in descriptor order.
+ */
+struct Batch {
+	uint32_t device; /**< device index */
+	uint8_t reportId; /**< report ID or 0 if not used */
+	uint16_t fields; /**< values per record */
+	uint16_t records; /**< number of records */
+	int32_t values[MaxBatchValues]; /**< record values */
+	
+	/**
+	 * Returns the values of the given record.
+	 * 
+	 * @param[in] index - record index
+	 * @return pointer to the record values
+	 */
+	inline const int32_t * record(const size_t index) const noexcept {
+		return this->values + (index * this->fields);
+	}
+};
+
+
+/**
+ * Instructions of the decode program. Each instruction stores `count` consecutive values
+ * of `size` bits starting at `bitOffset` to the next output slots.
+ */
+enum DecodeOpCode {
+	DO_U8,         /**< byte aligned unsigned 8-bit values */
+	DO_S8,         /**< byte aligned signed 8-bit values */
+	DO_U16,        /**< byte aligned unsigned little-endian 16-bit values */
+	DO_S16,        /**< byte aligned signed little-endian 16-bit values */
+	DO_32,         /**< byte aligned little-endian 32-bit values */
+	DO_BITS,       /**< unsigned values read via a 64-bit window */
+	DO_SBITS,      /**< signed values read via a 64-bit window */
+	DO_TAIL_BITS,  /**< unsigned values within the 64-bit window at the report end */
+	DO_TAIL_SBITS  /**< signed values within the 64-bit window at the report end */
+};
+
+
+/** Single instruction of the decode program. */
+struct DecodeOp {
+	uint8_t code; /**< instruction (see `DecodeOpCode`) */
+	uint8_t size; /**< value size in bits (1 to 32) */
+	uint16_t count; /**< number of consecutive values */
+	uint32_t bitOffset; /**< bit offset of the first value excluding the report ID byte */
+};
+
+
+/**
+ * Reads 8 bytes in little-endian order. Compiles to a single load on common hosts.
+ * 
+ * @param[in] data - input data
+ * @return read value
+ */
+inline uint64_t loadWindow(const uint8_t * data) noexcept {
+	uint64_t res = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy(&res, data, sizeof(res));
+#else
+	for (size_t i = 0; i < 8; i++) {
+		res |= uint64_t(data[i]) << (8 * i);
+	}
+#endif
+	return res;
+}
+
+
+/**
+ * Input report layout derived from a compiled HID descriptor. The non-constant values of each
+ * report are compiled into a compact decode program once. Adjacent values of equal size and
+ * signedness are fused into a single instruction.
+ */
+class Layout {
+public:
+	/** Decode program of a single report ID. */
+	struct Report {
+		uint32_t first; /**< index of the first instruction */
+		uint16_t ops; /**< number of instructions */
+		uint16_t count; /**< number of values */
+		uint16_t bytes; /**< report size in bytes excluding the report ID */
+	};
+private:
+	std::vector<uint8_t> desc; /**< compiled HID descriptor */
+	std::vector<DecodeOp> program; /**< all instructions ordered by report ID */
+	Report reports[256]; /**< decode program per report ID */
+	bool useIds; /**< true if report IDs are used */
+	
+	/**
+	 * Appends the given value to the decode program of the current report.
+	 * 
+	 * @param[in,out] report - current report
+	 * @param[in] bitOffset - bit offset excluding the report ID byte
+	 * @param[in] size - size in bits
+	 * @param[in] isSigned - true to sign extend the value
+	 */
+	inline void addValue(Report & report, const uint32_t bitOffset, const uint8_t size, const bool isSigned) {
+		uint8_t code;
+		if ((bitOffset & 7) == 0 && size == 8) {
+			code = isSigned ? DO_S8 : DO_U8;
+		} else if ((bitOffset & 7) == 0 && size == 16) {
+			code = isSigned ? DO_S16 : DO_U16;
+		} else if ((bitOffset & 7) == 0 && size == 32) {
+			code = DO_32;
+		} else if (((bitOffset >> 3) + 8) <= report.bytes) {
+			code = isSigned ? DO_SBITS : DO_BITS;
+		} else {
+			/* too close to the report end for a window at the value */
+			code = isSigned ? DO_TAIL_SBITS : DO_TAIL_BITS;
+		}
+		if (report.ops > 0) {
+			DecodeOp & last = this->program.back();
+			if (last.code == code && last.size == size && last.count < 0xFFFF && (last.bitOffset + (uint32_t(last.count) * size)) == bitOffset) {
+				last.count++;
+				report.count++;
+				return;
+			}
+		}
+		this->program.push_back(DecodeOp{code, size, 1, bitOffset});
+		report.ops++;
+		report.count++;
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] data - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 */
+	inline explicit Layout(const uint8_t * data, const size_t len):
+		desc(data, data + len),
+		program(),
+		reports{},
+		useIds{false}
+	{
+		FieldReader fields(data, len);
+		ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		std::vector<ReportField> inputs;
+		while ( fields.next(field) ) {
+			if (field.type != RT_INPUT) {
+				continue;
+			}
+			this->useIds = this->useIds || field.reportId != 0;
+			inputs.push_back(field);
+		}
+		for (size_t id = 0; id < 256; id++) {
+			Report & report = this->reports[id];
+			report.first = uint32_t(this->program.size());
+			uint32_t bits = 0;
+			for (const ReportField & f : inputs) {
+				if (f.reportId == id) {
+					bits = f.bitOffset + f.bits();
+				}
+			}
+			/* the report size is needed first to select the instructions */
+			report.bytes = uint16_t((bits + 7) / 8);
+			for (const ReportField & f : inputs) {
+				if (f.reportId != id || f.isConstant() || f.size == 0 || f.size > 32) {
+					continue;
+				}
+				for (uint32_t i = 0; i < f.count; i++) {
+					this->addValue(report, f.bitOffset + (i * f.size), uint8_t(f.size), f.isSigned());
+				}
+			}
+		}
+	}
+	
+	/**
+	 * Checks whether this layout belongs to the given descriptor.
+	 * 
+	 * @param[in] data - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 * @return true on match, else false
+	 */
+	inline bool matches(const uint8_t * data, const size_t len) const noexcept {
+		return this->desc.size() == len && memcmp(this->desc.data(), data, len) == 0;
+	}
+	
+	/**
+	 * Returns the layout of the given report ID.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @return report layout (`count` is zero for unknown report IDs)
+	 */
+	inline const Report & report(const uint8_t reportId) const noexcept {
+		return this->reports[reportId];
+	}
+	
+	/**
+	 * Returns whether the reports start with a report ID byte.
+	 * 
+	 * @return true if report IDs are used, else false
+	 */
+	inline bool usesReportIds() const noexcept {
+		return this->useIds;
+	}
+	
+	/**
+	 * Returns the first instruction of the decode program of the given report.
+	 * 
+	 * @param[in] report - report layout
+	 * @return pointer to `report.ops` instructions
+	 */
+	inline const DecodeOp * instructions(const Report & report) const noexcept {
+		return this->program.data() + report.first;
+	}
+	
+	/**
+	 * Decodes the values of the given report by running its decode program.
+	 * 
+	 * @param[in] report - report layout
+	 * @param[in] data - report data without report ID (at least `report.bytes`)
+	 * @param[out] out - receives `report.count` values
+	 */
+	inline void decode(const Report & report, const uint8_t * data, int32_t * out) const noexcept {
+		this->decodeEach(report, data, [out] (const size_t index, const int32_t value) {
+			out[index] = value;
+		});
+	}
+	
+	/**
+	 * Decodes the values of the given report by running its decode program and passes each
+	 * value to the given function. This allows to store the values in a different order or to
+	 * collect statistics while decoding.
+	 * 
+	 * @param[in] report - report layout
+	 * @param[in] data - report data without report ID (at least `report.bytes`)
+	 * @param[in] fn - called as `fn(size_t index, int32_t value)` for each value in ascending index order
+	 * @tparam Fn - function type
+	 */
+	template <typename Fn>
+	inline void decodeEach(const Report & report, const uint8_t * data, Fn && fn) const noexcept {
+		const DecodeOp * op = this->program.data() + report.first;
+		const DecodeOp * const end = op + report.ops;
+		/* last 8 bytes of the report or the whole report padded with zeros if shorter */
+		uint64_t tail = 0;
+		uint32_t tailStart = 0;
+		if (report.bytes >= 8) {
+			tail = loadWindow(data + report.bytes - 8);
+			tailStart = (uint32_t(report.bytes) - 8) * 8;
+		} else {
+			for (size_t i = 0; i < report.bytes; i++) {
+				tail |= uint64_t(data[i]) << (8 * i);
+			}
+		}
+		size_t out = 0;
+		for (; op != end; op++) {
+			const uint8_t * in = data + (op->bitOffset >> 3);
+			const size_t count = op->count;
+			switch (op->code) {
+			case DO_U8:
+				for (size_t i = 0; i < count; i++) {
+					fn(out + i, int32_t(in[i]));
+				}
+				break;
+			case DO_S8:
+				for (size_t i = 0; i < count; i++) {
+					fn(out + i, int32_t(int8_t(in[i])));
+				}
+				break;
+			case DO_U16:
+				for (size_t i = 0; i < count; i++, in += 2) {
+					fn(out + i, int32_t(uint32_t(in[0]) | (uint32_t(in[1]) << 8)));
+				}
+				break;
+			case DO_S16:
+				for (size_t i = 0; i < count; i++, in += 2) {
+					fn(out + i, int32_t(int16_t(uint16_t(in[0] | (in[1] << 8)))));
+				}
+				break;
+			case DO_32:
+				for (size_t i = 0; i < count; i++, in += 4) {
+					fn(out + i, int32_t(uint32_t(in[0]) | (uint32_t(in[1]) << 8) | (uint32_t(in[2]) << 16) | (uint32_t(in[3]) << 24)));
+				}
+				break;
+			case DO_BITS:
+			case DO_SBITS: {
+				const uint32_t size = op->size;
+				const uint32_t unused = 32 - size;
+				uint32_t bit = op->bitOffset;
+				for (size_t i = 0; i < count; i++, bit += size) {
+					/* move the value to the upper bits and shift back for the optional sign extension */
+					const uint32_t val = uint32_t(loadWindow(data + (bit >> 3)) >> (bit & 7)) << unused;
+					fn(out + i, (op->code == DO_SBITS) ? (int32_t(val) >> unused) : int32_t(val >> unused));
+				}
+				break;
+			}
+			default: {
+				const uint32_t size = op->size;
+				const uint32_t unused = 32 - size;
+				uint32_t bit = op->bitOffset - tailStart;
+				for (size_t i = 0; i < count; i++, bit += size) {
+					const uint32_t val = uint32_t(tail >> bit) << unused;
+					fn(out + i, (op->code == DO_TAIL_SBITS) ? (int32_t(val) >> unused) : int32_t(val >> unused));
+				}
+				break;
+			}
+			}
+			out += count;
+		}
+	}
+};
+
+
+/**
+ * Caches the layout of each distinct descriptor. Devices with equal descriptors share the same layout.
+ */
+class LayoutCache {
+private:
+	std::mutex mutex; /**< guards `layouts` */
+	std::vector<std::unique_ptr<Layout>> layouts; /**< known layouts */
+public:
+	/**
+	 * Returns the layout for the given descriptor. The layout is created on first use.
+	 * 
+	 * @param[in] data - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 * @return layout which stays valid for the lifetime of the cache
+	 */
+	inline const Layout & get(const uint8_t * data, const size_t len) {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		for (const std::unique_ptr<Layout> & layout : this->layouts) {
+			if ( layout->matches(data, len) ) {
+				return *layout;
+			}
+		}
+		this->layouts.emplace_back(new Layout(data, len));
+		return *this->layouts.back();
+	}
+	
+	/**
+	 * Returns the number of distinct layouts.
+	 * 
+	 * @return layout count
+	 */
+	inline size_t size() {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->layouts.size();
+	}
+};
+
+
+/** Pipeline statistics. */
+struct PipelineStats {
+	uint64_t reports; /**< decoded reports */
+	uint64_t dropped; /**< reports with unknown report ID or invalid length */
+	uint64_t batches; /**< emitted batches */
+	uint64_t steals; /**< device runs taken from another worker */
+};
+
+
+/**
+ * Decodes the Input reports of many devices on a work-stealing thread pool.
+ * 
+ * Stages:
+ * - `push()` adds a report to the lock-free ingestion queue of the device (one producer per device).
+ * - The device is scheduled on the ready queue of its home worker. Idle workers steal devices from
+ *   other workers. A device is processed by at most one worker at a time.
+ * - The reports are decoded with the cached layout of the device descriptor and collected in
+ *   batches per report ID.
+ * - Full batches and the batches of drained devices are passed to the output queue which is read
+ *   via `pop()`.
+ * 
+ * @tparam QueueSize - ingestion queue capacity per device (power of two)
+ * @tparam OutputSize - output queue capacity in batches (power of two)
+ */
+template <size_t QueueSize = 256, size_t OutputSize = 256>
+class Pipeline {
+private:
+	enum {
+		ReadySize = 1024, /**< ready queue capacity per worker */
+		Quantum = 64, /**< reports processed per device run */
+		Spins = 64 /**< yields before an idle or blocked worker sleeps */
+	};
+	/** Device state. */
+	struct Device {
+		SpscQueue<RawReport, QueueSize> queue; /**< ingestion queue */
+		std::atomic<bool> scheduled; /**< true while on a ready queue or being processed */
+		const Layout * layout; /**< decoding layout */
+		Batch open[OpenBatches]; /**< open batches; only accessed by the processing worker */
+		uint32_t index; /**< device index */
+		
+		/**
+		 * Constructor.
+		 * 
+		 * @param[in] l - decoding layout
+		 * @param[in] i - device index
+		 */
+		inline explicit Device(const Layout & l, const uint32_t i) noexcept:
+			queue(),
+			scheduled{false},
+			layout{&l},
+			index{i}
+		{
+			for (Batch & batch : this->open) {
+				batch.records = 0;
+			}
+		}
+	};
+	/** Worker state. */
+	struct Worker {
+		MpmcQueue<uint32_t, ReadySize> ready; /**< devices ready for processing */
+		std::thread thread; /**< worker thread */
+		uint64_t reports; /**< decoded reports */
+		uint64_t dropped; /**< dropped reports */
+		uint64_t batches; /**< emitted batches */
+		uint64_t steals; /**< stolen device runs */
+		char pad[CacheLineSize]; /**< keeps the counters of different workers apart */
+	};
+	LayoutCache cache; /**< descriptor layouts */
+	std::vector<std::unique_ptr<Device>> devices; /**< registered devices */
+	std::vector<std::unique_ptr<Worker>> workers; /**< thread pool */
+	MpmcQueue<Batch, OutputSize> output; /**< decoded batches */
+	std::atomic<size_t> pending; /**< number of scheduled devices */
+	std::atomic<size_t> signals; /**< incremented for each ready queue entry */
+	std::atomic<size_t> sleepers; /**< number of parked workers */
+	std::mutex idleMutex; /**< guards parking on `wakeup` */
+	std::condition_variable wakeup; /**< wakes parked workers */
+	std::atomic<bool> stopping; /**< set by `stop()` */
+	std::atomic<bool> running; /**< true between `start()` and `stop()` */
+public:
+	/**
+	 * Constructor.
+	 */
+	inline Pipeline():
+		cache(),
+		devices(),
+		workers(),
+		output(),
+		pending{0},
+		signals{0},
+		sleepers{0},
+		idleMutex(),
+		wakeup(),
+		stopping{false},
+		running{false}
+	{}
+	
+	Pipeline(const Pipeline &) = delete;
+	Pipeline & operator= (const Pipeline &) = delete;
+	
+	/**
+	 * Destructor. Stops all workers.
+	 */
+	inline ~Pipeline() {
+		this->stop();
+	}
+	
+	/**
+	 * Registers a new device. Shall not be called while the pipeline is running.
+	 * 
+	 * @param[in] desc - compiled HID descriptor of the device
+	 * @param[in] len - descriptor length in bytes
+	 * @return device index
+	 */
+	inline uint32_t addDevice(const uint8_t * desc, const size_t len) {
+		const uint32_t index = uint32_t(this->devices.size());
+		this->devices.emplace_back(new Device(this->cache.get(desc, len), index));
+		return index;
+	}
+	
+	/**
+	 * Registers a new device. Shall not be called while the pipeline is running.
+	 * 
+	 * @param[in] desc - compiled HID descriptor of the device
+	 * @return device index
+	 */
+	template <size_t N, size_t A>
+	inline uint32_t addDevice(const Descriptor<N, A> & desc) {
+		return this->addDevice(desc.data, desc.size());
+	}
+	
+	/**
+	 * Returns the number of registered devices.
+	 * 
+	 * @return device count
+	 */
+	inline size_t deviceCount() const noexcept {
+		return this->devices.size();
+	}
+	
+	/**
+	 * Returns the number of distinct descriptor layouts.
+	 * 
+	 * @return layout count
+	 */
+	inline size_t layoutCount() {
+		return this->cache.size();
+	}
+	
+	/**
+	 * Starts the given number of workers.
+	 * 
+	 * @param[in] count - number of worker threads (0 for the number of hardware threads)
+	 */
+	inline void start(size_t count = 0) {
+		if ( this->running ) {
+			return;
+		}
+		if (count == 0) {
+			count = std::thread::hardware_concurrency();
+			count = (count > 0) ? count : 1;
+		}
+		this->stopping = false;
+		this->running = true;
+		this->workers.clear();
+		for (size_t i = 0; i < count; i++) {
+			this->workers.emplace_back(new Worker());
+		}
+		for (size_t i = 0; i < count; i++) {
+			Worker & worker = *this->workers[i];
+			worker.reports = 0;
+			worker.dropped = 0;
+			worker.batches = 0;
+			worker.steals = 0;
+			worker.thread = std::thread([this, i] { this->work(i); });
+		}
+	}
+	
+	/**
+	 * Adds a report to the ingestion queue of the given device. Only one thread may push reports
+	 * for the same device. The pipeline needs to be running.
+	 * 
+	 * @param[in] device - device index
+	 * @param[in] data - report data including the report ID byte if used
+	 * @param[in] len - report length in bytes
+	 * @return true on success, false if the queue is full or the report is too large
+	 */
+	inline bool push(const uint32_t device, const uint8_t * data, const size_t len) noexcept {
+		if (len > MaxPipelineReportSize || device >= this->devices.size() || ( ! this->running.load(std::memory_order_relaxed) )) {
+			return false;
+		}
+		Device & dev = *this->devices[device];
+		RawReport report;
+		report.length = uint16_t(len);
+		memcpy(report.data, data, len);
+		if ( ! dev.queue.push(report) ) {
+			return false;
+		}
+		/* pairs with the fence in `work()`: either the worker sees the report or we see `scheduled` cleared */
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		this->schedule(dev, device % this->workers.size());
+		return true;
+	}
+	
+	/**
+	 * Removes the next decoded batch from the output queue.
+	 * 
+	 * @param[out] batch - receives the batch
+	 * @return true on success, false if no batch is available
+	 */
+	inline bool pop(Batch & batch) noexcept {
+		return this->output.pop(batch);
+	}
+	
+	/**
+	 * Processes all queued reports, emits all open batches and stops the workers.
+	 * Shall be called after the last `push()` returned. The output queue needs to be read
+	 * concurrently if more than `OutputSize` batches are pending.
+	 */
+	inline void stop() {
+		if ( ! this->running ) {
+			return;
+		}
+		this->stopping = true;
+		{
+			std::lock_guard<std::mutex> lock(this->idleMutex);
+			this->wakeup.notify_all();
+		}
+		for (std::unique_ptr<Worker> & worker : this->workers) {
+			worker->thread.join();
+		}
+		Worker & first = *this->workers.front();
+		for (std::unique_ptr<Device> & device : this->devices) {
+			this->process(first, *device, true);
+		}
+		this->running = false;
+	}
+	
+	/**
+	 * Returns the accumulated statistics of all workers. Shall not be called while the pipeline is running.
+	 * 
+	 * @return statistics
+	 */
+	inline PipelineStats stats() const noexcept {
+		PipelineStats res{0, 0, 0, 0};
+		for (const std::unique_ptr<Worker> & worker : this->workers) {
+			res.reports += worker->reports;
+			res.dropped += worker->dropped;
+			res.batches += worker->batches;
+			res.steals += worker->steals;
+		}
+		return res;
+	}
+private:
+	/**
+	 * Puts the device on a ready queue unless it is already scheduled.
+	 * 
+	 * @param[in,out] dev - device
+	 * @param[in] home - preferred worker
+	 */
+	inline void schedule(Device & dev, const size_t home) noexcept {
+		bool expected = false;
+		if ( ! dev.scheduled.compare_exchange_strong(expected, true, std::memory_order_acq_rel) ) {
+			return;
+		}
+		this->pending.fetch_add(1, std::memory_order_acq_rel);
+		const size_t count = this->workers.size();
+		for (size_t i = 0; ! this->workers[(home + i) % count]->ready.push(dev.index); i++) {
+			if ((i % count) == (count - 1)) {
+				pause(i / count);
+			}
+		}
+		this->signals.fetch_add(1, std::memory_order_seq_cst);
+		if (this->sleepers.load(std::memory_order_seq_cst) > 0) {
+			std::lock_guard<std::mutex> lock(this->idleMutex);
+			this->wakeup.notify_one();
+		}
+	}
+	
+	/**
+	 * Waits a little while a queue is full. Yields first and sleeps after `Spins` attempts.
+	 * 
+	 * @param[in] attempt - number of previous attempts
+	 */
+	static inline void pause(const size_t attempt) noexcept {
+		if (attempt < Spins) {
+			std::this_thread::yield();
+		} else {
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+	
+	/**
+	 * Worker thread function.
+	 * 
+	 * @param[in] self - worker index
+	 */
+	inline void work(const size_t self) noexcept {
+		Worker & worker = *this->workers[self];
+		const size_t count = this->workers.size();
+		uint32_t device = 0;
+		size_t idle = 0;
+		for (;;) {
+			const size_t seen = this->signals.load(std::memory_order_seq_cst);
+			bool found = worker.ready.pop(device);
+			for (size_t i = 1; ( ! found ) && i < count; i++) {
+				found = this->workers[(self + i) % count]->ready.pop(device);
+				worker.steals += found ? 1 : 0;
+			}
+			if ( ! found ) {
+				if (this->stopping.load(std::memory_order_acquire) && this->pending.load(std::memory_order_acquire) == 0) {
+					break;
+				}
+				if (++idle < Spins) {
+					std::this_thread::yield();
+					continue;
+				}
+				/* park until a device gets scheduled */
+				std::unique_lock<std::mutex> lock(this->idleMutex);
+				this->sleepers.fetch_add(1, std::memory_order_seq_cst);
+				this->wakeup.wait(lock, [this, seen] {
+					return this->signals.load(std::memory_order_seq_cst) != seen || this->stopping.load(std::memory_order_acquire);
+				});
+				this->sleepers.fetch_sub(1, std::memory_order_seq_cst);
+				idle = 0;
+				continue;
+			}
+			idle = 0;
+			Device & dev = *this->devices[device];
+			const bool drained = this->process(worker, dev, false);
+			dev.scheduled.store(false, std::memory_order_release);
+			/* pairs with the fence in `push()` */
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if ( ! drained ) {
+				this->schedule(dev, self);
+			} else if ( ! dev.queue.empty() ) {
+				/* report pushed after draining but before the device was unscheduled */
+				this->schedule(dev, self);
+			}
+			this->pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+	
+	/**
+	 * Decodes the queued reports of the given device.
+	 * 
+	 * @param[in,out] worker - processing worker
+	 * @param[in,out] dev - device to process
+	 * @param[in] all - true to process all reports, false to process at most `Quantum` reports
+	 * @return true if the ingestion queue was drained, else false
+	 */
+	inline bool process(Worker & worker, Device & dev, const bool all) noexcept {
+		const Layout & layout = *dev.layout;
+		size_t done = 0;
+		for (const RawReport * report; (all || done < Quantum) && (report = dev.queue.front()) != nullptr; done++) {
+			const uint8_t * data = report->data;
+			size_t len = report->length;
+			uint8_t reportId = 0;
+			if ( layout.usesReportIds() ) {
+				if (len < 1) {
+					worker.dropped++;
+					dev.queue.drop();
+					continue;
+				}
+				reportId = *data++;
+				len--;
+			}
+			const Layout::Report & format = layout.report(reportId);
+			if (format.count == 0 || len < format.bytes) {
+				worker.dropped++;
+				dev.queue.drop();
+				continue;
+			}
+			Batch & batch = this->batchFor(worker, dev, reportId, format.count);
+			layout.decode(format, data, batch.values + (size_t(batch.records) * batch.fields));
+			batch.records++;
+			worker.reports++;
+			dev.queue.drop();
+			if (((size_t(batch.records) + 1) * batch.fields) > MaxBatchValues) {
+				this->emit(worker, batch);
+			}
+		}
+		const bool drained = dev.queue.empty();
+		if ( drained ) {
+			for (Batch & batch : dev.open) {
+				if (batch.records > 0) {
+					this->emit(worker, batch);
+				}
+			}
+		}
+		return drained;
+	}
+	
+	/**
+	 * Returns the open batch for the given report ID. The fullest batch is emitted if all are in use.
+	 * 
+	 * @param[in,out] worker - processing worker
+	 * @param[in,out] dev - device
+	 * @param[in] reportId - report ID
+	 * @param[in] fields - values per record
+	 * @return open batch with space for at least one record
+	 */
+	inline Batch & batchFor(Worker & worker, Device & dev, const uint8_t reportId, const uint16_t fields) noexcept {
+		Batch * fullest = dev.open;
+		for (Batch & batch : dev.open) {
+			if (batch.records > 0 && batch.reportId == reportId) {
+				return batch;
+			}
+		}
+		for (Batch & batch : dev.open) {
+			if (batch.records == 0) {
+				fullest = &batch;
+				break;
+			}
+			if (batch.records > fullest->records) {
+				fullest = &batch;
+			}
+		}
+		if (fullest->records > 0) {
+			this->emit(worker, *fullest);
+		}
+		fullest->device = dev.index;
+		fullest->reportId = reportId;
+		fullest->fields = fields;
+		return *fullest;
+	}
+	
+	/**
+	 * Passes the given batch to the output queue and resets it. Blocks while the output queue is full.
+	 * 
+	 * @param[in,out] worker - processing worker
+	 * @param[in,out] batch - batch to emit
+	 */
+	inline void emit(Worker & worker, Batch & batch) noexcept {
+		for (size_t i = 0; ! this->output.push(batch); i++) {
+			pause(i);
+		}
+		worker.batches++;
+		batch.records = 0;
+	}
+};
+
+
+} /* anonymous namespace */
+} /* namespace detail */
+
+
+using ::hid::detail::SpscQueue;
+using ::hid::detail::MpmcQueue;
+using ::hid::detail::RawReport;
+using ::hid::detail::Batch;
+using ::hid::detail::Layout;
+using ::hid::detail::LayoutCache;
+using ::hid::detail::PipelineStats;
+using ::hid::detail::Pipeline;
+
+
+} /* namespace hid */
+
+
+#endif /* __HIDPIPELINE_HPP__ */
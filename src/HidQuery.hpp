@@ -0,0 +1,678 @@
+/**
+ * @file HidQuery.hpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ * 
+ * Filter and aggregate queries over trace files (see `HidTrace.hpp`).
+ * Fields are named by usage and resolved from the descriptor of each trace file. The value columns
+ * are evaluated block by block. Blocks which cannot match are skipped via the column minimum and
+ * maximum without decoding. The remaining blocks of all files are evaluated in parallel.
+ * Use `hid::Query`.
+ * 
+ * Query syntax (keywords and names are case in-sensitive):
+ * @verbatim
+ * query     = aggregate "(" [ field ] ")" [ "where" predicate { "and" predicate } ]
+ * aggregate = "count" | "min" | "max" | "sum" | "avg"
+ * predicate = field ( "=" | "==" | "!=" | "<" | "<=" | ">" | ">=" ) number
+ * field     = [ usage page "." ] usage | extended usage as hexadecimal number
+ * @endverbatim
+ * Example: `max(GenericDesktop.X) where Button.Button1 = 1 and Y > 0`
+ * 
+ * @remarks This requires a hosted C++14 environment with thread support.
+ * @see ::hid::detail::Query
+ */
+#ifndef __HIDQUERY_HPP__
+#define __HIDQUERY_HPP__
+
+#include "HidTrace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace hid {
+namespace detail {
+namespace {
+
+
+/** Query aggregate functions. */
+enum QueryAggregate {
+	QA_COUNT, /**< number of matching records */
+	QA_MIN,   /**< minimum field value of the matching records */
+	QA_MAX,   /**< maximum field value of the matching records */
+	QA_SUM,   /**< sum of the field values of the matching records */
+	QA_AVG    /**< average field value of the matching records */
+};
+
+
+/** Query predicate operators. */
+enum QueryOperator {
+	QO_EQ, /**< equal */
+	QO_NE, /**< not equal */
+	QO_LT, /**< less than */
+	QO_LE, /**< less than or equal */
+	QO_GT, /**< greater than */
+	QO_GE  /**< greater than or equal */
+};
+
+
+/** Single filter condition of a query. */
+struct QueryPredicate {
+	std::string field; /**< field name */
+	uint8_t op; /**< operator (see `QueryOperator`) */
+	int32_t value; /**< compared value */
+};
+
+
+/** Query result of a single trace file. */
+struct QueryResult {
+	uint64_t records; /**< records of all report IDs containing the queried fields */
+	uint64_t matches; /**< records passing the filter */
+	int64_t sum; /**< sum of the field values of the matching records */
+	int32_t min; /**< minimum field value of the matching records */
+	int32_t max; /**< maximum field value of the matching records */
+	uint32_t blocks; /**< number of blocks with at least one decoded column */
+	uint32_t skipped; /**< number of blocks evaluated by the column headers only */
+	uint32_t invalid; /**< number of blocks with invalid column payloads */
+};
+
+
+/**
+ * Returns the extended usage of the given column.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] column - value column
+ * @return extended usage or 0 for array fields and fields without usage
+ */
+inline uint32_t columnUsage(const uint8_t * desc, const size_t len, const TraceField & column) noexcept {
+	if ( ! column.field.isVariable() ) {
+		return 0;
+	}
+	return usageAt(desc, len, column.field, column.index);
+}
+
+
+/**
+ * Checks whether the given field name refers to the passed extended usage. The usage page may be
+ * omitted. Names are resolved via the encoding maps of the usage pages.
+ * 
+ * @param[in] name - field name (e.g. `GenericDesktop.X`, `X` or `0x10030`)
+ * @param[in] usage - extended usage (usage page in the upper 16 bits)
+ * @return true on match, else false
+ */
+inline bool usageMatches(const Token & name, const uint32_t usage) noexcept {
+	if (usage == 0 || name.length == 0) {
+		return false;
+	}
+	if (name.length > 2 && name.start[0] == '0' && (name.start[1] == 'x' || name.start[1] == 'X')) {
+		uint32_t value = 0;
+		for (size_t i = 2; i < name.length; i++) {
+			if (( ! isHexDigit(name.start[i]) ) || i >= 10) {
+				return false;
+			}
+			value = (value << 4) | uint32_t(isDigit(name.start[i]) ? (name.start[i] - '0') : (toLower(name.start[i]) - 'a' + 10));
+		}
+		return value == usage;
+	}
+	size_t dot = 0;
+	while (dot < name.length && name.start[dot] != '.') {
+		dot++;
+	}
+	error::EMessage error = error::E_NO_ERROR;
+	EncodingRef page, item;
+	const size_t skip = (dot < name.length) ? (dot + 1) : 0;
+	if (skip > 0) {
+		if (( ! findEncoding(Token{name.start, dot}, EM_USAGE_PAGE, page, error) ) || page.value != (usage >> 16)) {
+			return false;
+		}
+	} else {
+		const size_t last = encodingTable.end(EM_USAGE_PAGE);
+		size_t e = encodingTable.begin(EM_USAGE_PAGE);
+		while (e < last && encodingTable.value[e] != (usage >> 16)) {
+			e++;
+		}
+		if (e == last) {
+			return false;
+		}
+		page = EncodingRef(e);
+	}
+	return findEncoding(Token{name.start + skip, name.length - skip}, page.arg, item, error) && item.value == (usage & 0xFFFF);
+}
+
+
+/**
+ * Returns the column of the given field name. The first matching column wins if the usage page
+ * was omitted and multiple columns match.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] columns - value columns (see `traceFields()`)
+ * @param[in] name - field name (see `usageMatches()`)
+ * @return column index or -1 if not found
+ */
+inline int findColumn(const uint8_t * desc, const size_t len, const std::vector<TraceField> & columns, const std::string & name) noexcept {
+	for (size_t c = 0; c < columns.size(); c++) {
+		if ( usageMatches(Token{name.c_str(), name.size()}, columnUsage(desc, len, columns[c])) ) {
+			return int(c);
+		}
+	}
+	return -1;
+}
+
+
+/**
+ * Compiled filter and aggregate query.
+ */
+class Query {
+private:
+	/** Columns of the query fields within the reports of a single report ID. */
+	struct Plan {
+		uint32_t trace; /**< trace index */
+		int column; /**< aggregated column or -1 for `count()` */
+		std::vector<int> predicates; /**< column per predicate */
+	};
+	/** Single unit of work. */
+	struct Task {
+		uint32_t plan; /**< plan index */
+		uint32_t block; /**< block index */
+	};
+	/** Per thread decoding buffers. */
+	struct Scratch {
+		std::vector<int32_t> values; /**< decoded aggregated column */
+		std::vector<int32_t> filter; /**< decoded predicate column */
+		std::vector<uint8_t> mask; /**< 1 for matching records, else 0 */
+	};
+	uint8_t function; /**< aggregate function (see `QueryAggregate`) */
+	std::string field; /**< aggregated field or empty for `count()` */
+	std::vector<QueryPredicate> predicates; /**< conjunction of filter conditions */
+	const char * message; /**< parsing error or `nullptr` */
+	size_t position; /**< parsing error position */
+	
+	/**
+	 * Parses the given query.
+	 * 
+	 * @param[in] text - query text
+	 * @return true on success, else false
+	 */
+	inline bool parse(const char * text) {
+		const char * ptr = text;
+		const auto fail = [&](const char * msg) {
+			this->message = msg;
+			this->position = size_t(ptr - text);
+			return false;
+		};
+		const auto skipSpace = [&]() {
+			while ( isWhitespace(*ptr) ) {
+				ptr++;
+			}
+		};
+		const auto word = [&]() {
+			skipSpace();
+			const char * start = ptr;
+			while (isArgChar(*ptr) || *ptr == '.') {
+				ptr++;
+			}
+			return Token{start, size_t(ptr - start)};
+		};
+		const Token func = word();
+		const char * const names[] = {"count", "min", "max", "sum", "avg"};
+		this->function = 0xFF;
+		for (uint8_t i = 0; i < 5; i++) {
+			if ( equalsI(func, names[i]) ) {
+				this->function = i;
+			}
+		}
+		if (this->function == 0xFF) {
+			ptr = func.start;
+			return fail("Unknown aggregate function.");
+		}
+		skipSpace();
+		if (*ptr != '(') {
+			return fail("Expected '('.");
+		}
+		ptr++;
+		const Token name = word();
+		this->field.assign(name.start, name.length);
+		skipSpace();
+		if (*ptr != ')') {
+			return fail("Expected ')'.");
+		}
+		if (this->field.empty() && this->function != QA_COUNT) {
+			return fail("Missing field name.");
+		}
+		ptr++;
+		const Token where = word();
+		if (where.length == 0 && *ptr == 0) {
+			return true;
+		} else if ( ! equalsI(where, "where") ) {
+			ptr = where.start;
+			return fail("Expected 'where'.");
+		}
+		for (;;) {
+			const Token pred = word();
+			if (pred.length == 0) {
+				return fail("Missing field name.");
+			}
+			skipSpace();
+			uint8_t op;
+			if (ptr[0] == '=') {
+				op = QO_EQ;
+				ptr += (ptr[1] == '=') ? 2 : 1;
+			} else if (ptr[0] == '!' && ptr[1] == '=') {
+				op = QO_NE;
+				ptr += 2;
+			} else if (ptr[0] == '<') {
+				op = (ptr[1] == '=') ? QO_LE : QO_LT;
+				ptr += (ptr[1] == '=') ? 2 : 1;
+			} else if (ptr[0] == '>') {
+				op = (ptr[1] == '=') ? QO_GE : QO_GT;
+				ptr += (ptr[1] == '=') ? 2 : 1;
+			} else {
+				return fail("Expected comparison operator.");
+			}
+			skipSpace();
+			const char * start = ptr;
+			const bool negative = *ptr == '-';
+			ptr += negative ? 1 : 0;
+			const bool hex = ptr[0] == '0' && (ptr[1] == 'x' || ptr[1] == 'X');
+			ptr += hex ? 2 : 0;
+			int64_t num = 0;
+			const char * digits = ptr;
+			while (hex ? isHexDigit(*ptr) : isDigit(*ptr)) {
+				num = (num * (hex ? 16 : 10)) + (isDigit(*ptr) ? (*ptr - '0') : (toLower(*ptr) - 'a' + 10));
+				ptr++;
+				if (num > 0x80000000LL) {
+					ptr = start;
+					return fail("Number out of range.");
+				}
+			}
+			if (ptr == digits) {
+				return fail("Expected number.");
+			}
+			num = negative ? -num : num;
+			if (num > 0x7FFFFFFFLL) {
+				ptr = start;
+				return fail("Number out of range.");
+			}
+			this->predicates.push_back(QueryPredicate{std::string(pred.start, pred.length), op, int32_t(num)});
+			const Token next = word();
+			if (next.length == 0 && *ptr == 0) {
+				return true;
+			} else if ( ! equalsI(next, "and") ) {
+				ptr = next.start;
+				return fail("Expected 'and'.");
+			}
+		}
+	}
+	
+	/**
+	 * Checks the given predicate against a value range.
+	 * 
+	 * @param[in] pred - predicate
+	 * @param[in] min - minimum value
+	 * @param[in] max - maximum value
+	 * @return 0 if no value matches, 1 if all values match, 2 if some values may match
+	 */
+	static inline int rangeMatch(const QueryPredicate & pred, const int32_t min, const int32_t max) noexcept {
+		const int32_t v = pred.value;
+		switch (pred.op) {
+		case QO_EQ: return (v < min || v > max) ? 0 : ((min == max) ? 1 : 2);
+		case QO_NE: return (v < min || v > max) ? 1 : ((min == max) ? 0 : 2);
+		case QO_LT: return (max < v) ? 1 : ((min >= v) ? 0 : 2);
+		case QO_LE: return (max <= v) ? 1 : ((min > v) ? 0 : 2);
+		case QO_GT: return (min > v) ? 1 : ((max <= v) ? 0 : 2);
+		default: return (min >= v) ? 1 : ((max < v) ? 0 : 2);
+		}
+	}
+	
+	/**
+	 * Clears the mask entries of all values not matching the given predicate. The loops operate
+	 * on groups of 64 values without branches to allow the compiler to vectorize them.
+	 * 
+	 * @param[in] pred - predicate
+	 * @param[in] values - decoded values
+	 * @param[in,out] mask - record mask
+	 * @param[in] count - number of values (multiple of 64)
+	 */
+	static inline void filter(const QueryPredicate & pred, const int32_t * values, uint8_t * mask, const size_t count) noexcept {
+		const int32_t v = pred.value;
+#define HID_QUERY_FILTER(op, expr) \
+		case op: \
+			for (size_t i = 0; i < count; i += 64, values += 64, mask += 64) { \
+				uint8_t keep[64]; \
+				for (size_t k = 0; k < 64; k++) { \
+					keep[k] = uint8_t(expr); \
+				} \
+				for (size_t k = 0; k < 64; k++) { \
+					mask[k] = uint8_t(mask[k] & keep[k]); \
+				} \
+			} \
+			break;
+		switch (pred.op) {
+		HID_QUERY_FILTER(QO_EQ, values[k] == v)
+		HID_QUERY_FILTER(QO_NE, values[k] != v)
+		HID_QUERY_FILTER(QO_LT, values[k] < v)
+		HID_QUERY_FILTER(QO_LE, values[k] <= v)
+		HID_QUERY_FILTER(QO_GT, values[k] > v)
+		default:
+		HID_QUERY_FILTER(QO_GE, values[k] >= v)
+		}
+#undef HID_QUERY_FILTER
+	}
+	
+	/**
+	 * Adds the given matching values to the result.
+	 * 
+	 * @param[in] values - decoded values
+	 * @param[in] mask - record mask
+	 * @param[in] count - number of values (multiple of 64)
+	 * @param[in,out] res - result
+	 */
+	static inline void aggregate(const int32_t * values, const uint8_t * mask, const size_t count, QueryResult & res) noexcept {
+		uint32_t matches = 0;
+		int64_t sum = 0;
+		int32_t lo = res.min, hi = res.max;
+		for (size_t i = 0; i < count; i += 64) {
+			for (size_t k = i; k < (i + 64); k++) {
+				const int32_t keep = -int32_t(mask[k]);
+				const int32_t val = values[k] & keep;
+				matches += mask[k];
+				sum += val;
+				lo = std::min(lo, val | (~keep & 0x7FFFFFFF));
+				hi = std::max(hi, val | (~keep & int32_t(0x80000000)));
+			}
+		}
+		res.matches += matches;
+		res.sum += sum;
+		res.min = lo;
+		res.max = hi;
+	}
+	
+	/**
+	 * Evaluates a single block.
+	 * 
+	 * @param[in] trace - trace file of the block
+	 * @param[in] plan - columns of the block
+	 * @param[in] block - block index
+	 * @param[in,out] scratch - decoding buffers
+	 * @param[in,out] res - result of the trace file
+	 */
+	inline void evaluate(const TraceReader & trace, const Plan & plan, const size_t block, Scratch & scratch, QueryResult & res) const {
+		const size_t records = trace.block(block).records;
+		const size_t padded = (records + 63) & ~size_t(63);
+		const size_t columns = trace.columnCount(block);
+		res.records += records;
+		/* evaluate the predicates on the column headers first */
+		bool decoded = false, all = true;
+		for (size_t p = 0; p < this->predicates.size(); p++) {
+			if (size_t(plan.predicates[p]) >= columns) {
+				res.invalid++;
+				return;
+			}
+			const TraceColumn col = trace.column(block, size_t(plan.predicates[p]));
+			const int match = rangeMatch(this->predicates[p], col.min, col.max);
+			if (match == 0) {
+				res.skipped++;
+				return;
+			}
+			all = all && match == 1;
+		}
+		if (plan.column >= 0 && size_t(plan.column) >= columns) {
+			res.invalid++;
+			return;
+		}
+		if ( all ) {
+			/* all records match */
+			res.matches += records;
+			if (plan.column >= 0) {
+				const TraceColumn col = trace.column(block, size_t(plan.column));
+				res.min = std::min(res.min, col.min);
+				res.max = std::max(res.max, col.max);
+				if (col.codec == TC_CONST) {
+					res.sum += int64_t(col.base) * int64_t(records);
+				} else if (this->function == QA_SUM || this->function == QA_AVG) {
+					if ( ! trace.decodeColumn(block, size_t(plan.column), scratch.values.data()) ) {
+						res.invalid++;
+						return;
+					}
+					decoded = true;
+					int64_t sum = 0;
+					for (size_t r = 0; r < records; r++) {
+						sum += scratch.values[r];
+					}
+					res.sum += sum;
+				}
+			}
+			(decoded ? res.blocks : res.skipped)++;
+			return;
+		}
+		memset(scratch.mask.data(), 1, records);
+		memset(scratch.mask.data() + records, 0, padded - records);
+		for (size_t p = 0; p < this->predicates.size(); p++) {
+			const TraceColumn col = trace.column(block, size_t(plan.predicates[p]));
+			if (rangeMatch(this->predicates[p], col.min, col.max) == 1) {
+				continue;
+			}
+			if ( ! trace.decodeColumn(block, size_t(plan.predicates[p]), scratch.filter.data()) ) {
+				res.invalid++;
+				return;
+			}
+			filter(this->predicates[p], scratch.filter.data(), scratch.mask.data(), padded);
+		}
+		res.blocks++;
+		if (plan.column < 0) {
+			uint32_t matches = 0;
+			for (size_t r = 0; r < padded; r++) {
+				matches += scratch.mask[r];
+			}
+			res.matches += matches;
+		} else if ( trace.decodeColumn(block, size_t(plan.column), scratch.values.data()) ) {
+			aggregate(scratch.values.data(), scratch.mask.data(), padded, res);
+		} else {
+			res.invalid++;
+		}
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] text - query text (see file description)
+	 */
+	inline explicit Query(const char * text):
+		function{QA_COUNT},
+		field(),
+		predicates(),
+		message{nullptr},
+		position{0}
+	{
+		if ( ! this->parse(text) ) {
+			this->field.clear();
+			this->predicates.clear();
+		}
+	}
+	
+	/**
+	 * Checks whether the query was parsed successfully.
+	 * 
+	 * @return true if valid, else false
+	 */
+	inline bool valid() const noexcept {
+		return this->message == nullptr;
+	}
+	
+	/**
+	 * Returns the parsing error.
+	 * 
+	 * @return error message or `nullptr`
+	 */
+	inline const char * error() const noexcept {
+		return this->message;
+	}
+	
+	/**
+	 * Returns the character position of the parsing error.
+	 * 
+	 * @return error position
+	 */
+	inline size_t errorPosition() const noexcept {
+		return this->position;
+	}
+	
+	/**
+	 * Returns the value of the aggregate function from the given result.
+	 * 
+	 * @param[in] res - query result
+	 * @return aggregated value or 0 if there were no matches
+	 */
+	inline double value(const QueryResult & res) const noexcept {
+		if (res.matches == 0 && this->function != QA_COUNT) {
+			return 0.0;
+		}
+		switch (this->function) {
+		case QA_COUNT: return double(res.matches);
+		case QA_MIN: return double(res.min);
+		case QA_MAX: return double(res.max);
+		case QA_SUM: return double(res.sum);
+		default: return double(res.sum) / double(res.matches);
+		}
+	}
+	
+	/**
+	 * Runs the query over the given trace files. The field names are resolved per trace file and
+	 * report ID. Only report IDs which contain all queried fields are evaluated.
+	 * 
+	 * @param[in] traces - valid trace files
+	 * @param[in] threads - number of threads (0 for the number of hardware threads)
+	 * @return result per trace file
+	 */
+	inline std::vector<QueryResult> run(const std::vector<const TraceReader *> & traces, size_t threads = 0) const {
+		const QueryResult init{0, 0, 0, 0x7FFFFFFF, int32_t(0x80000000), 0, 0, 0};
+		std::vector<QueryResult> res(traces.size(), init);
+		if ( ! this->valid() ) {
+			return res;
+		}
+		/* resolve the field names */
+		std::vector<Plan> plans;
+		std::vector<Task> tasks;
+		for (size_t t = 0; t < traces.size(); t++) {
+			const TraceReader & trace = *traces[t];
+			for (size_t id = 0; id < 256; id++) {
+				const std::vector<uint32_t> & blocks = trace.blocks(uint8_t(id));
+				if ( blocks.empty() ) {
+					continue;
+				}
+				const std::vector<TraceField> columns = traceFields(trace.descriptor(), trace.descriptorSize(), uint8_t(id));
+				Plan plan{uint32_t(t), -1, {}};
+				bool found = true;
+				if ( ! this->field.empty() ) {
+					plan.column = findColumn(trace.descriptor(), trace.descriptorSize(), columns, this->field);
+					found = plan.column >= 0;
+				}
+				for (const QueryPredicate & pred : this->predicates) {
+					plan.predicates.push_back(findColumn(trace.descriptor(), trace.descriptorSize(), columns, pred.field));
+					found = found && plan.predicates.back() >= 0;
+				}
+				if ( ! found ) {
+					continue;
+				}
+				for (const uint32_t block : blocks) {
+					tasks.push_back(Task{uint32_t(plans.size()), block});
+				}
+				plans.push_back(std::move(plan));
+			}
+		}
+		/* evaluate the blocks */
+		if (threads == 0) {
+			threads = std::thread::hardware_concurrency();
+			threads = (threads > 0) ? threads : 1;
+		}
+		threads = std::min(threads, (tasks.size() + 15) / 16);
+		std::atomic<size_t> next{0};
+		std::vector<std::vector<QueryResult>> partial(threads, res);
+		const auto work = [&](const size_t worker) {
+			Scratch scratch{
+				std::vector<int32_t>(TraceBlockRecords),
+				std::vector<int32_t>(TraceBlockRecords),
+				std::vector<uint8_t>(TraceBlockRecords)
+			};
+			std::vector<QueryResult> & out = partial[worker];
+			for (size_t start = next.fetch_add(16); start < tasks.size(); start = next.fetch_add(16)) {
+				const size_t last = std::min(start + 16, tasks.size());
+				for (size_t i = start; i < last; i++) {
+					const Plan & plan = plans[tasks[i].plan];
+					this->evaluate(*traces[plan.trace], plan, tasks[i].block, scratch, out[plan.trace]);
+				}
+			}
+		};
+		std::vector<std::thread> pool;
+		for (size_t i = 1; i < threads; i++) {
+			pool.emplace_back(work, i);
+		}
+		if (threads > 0) {
+			work(0);
+		}
+		for (std::thread & thread : pool) {
+			thread.join();
+		}
+		for (const std::vector<QueryResult> & part : partial) {
+			for (size_t t = 0; t < res.size(); t++) {
+				res[t].records += part[t].records;
+				res[t].matches += part[t].matches;
+				res[t].sum += part[t].sum;
+				res[t].min = std::min(res[t].min, part[t].min);
+				res[t].max = std::max(res[t].max, part[t].max);
+				res[t].blocks += part[t].blocks;
+				res[t].skipped += part[t].skipped;
+				res[t].invalid += part[t].invalid;
+			}
+		}
+		return res;
+	}
+	
+	/**
+	 * Runs the query over the given trace file.
+	 * 
+	 * @param[in] trace - valid trace file
+	 * @param[in] threads - number of threads (0 for the number of hardware threads)
+	 * @return query result
+	 */
+	inline QueryResult run(const TraceReader & trace, const size_t threads = 0) const {
+		return this->run(std::vector<const TraceReader *>{&trace}, threads).front();
+	}
+};
+
+
+} /* anonymous namespace */
+} /* namespace detail */
+
+
+using ::hid::detail::QueryAggregate;
+using ::hid::detail::QA_COUNT;
+using ::hid::detail::QA_MIN;
+using ::hid::detail::QA_MAX;
+using ::hid::detail::QA_SUM;
+using ::hid::detail::QA_AVG;
+using ::hid::detail::QueryOperator;
+using ::hid::detail::QO_EQ;
+using ::hid::detail::QO_NE;
+using ::hid::detail::QO_LT;
+using ::hid::detail::QO_LE;
+using ::hid::detail::QO_GT;
+using ::hid::detail::QO_GE;
+using ::hid::detail::QueryPredicate;
+using ::hid::detail::QueryResult;
+using ::hid::detail::columnUsage;
+using ::hid::detail::usageMatches;
+using ::hid::detail::findColumn;
+using ::hid::detail::Query;
+
+
+} /* namespace hid */
+
+
+#endif /* __HIDQUERY_HPP__ */
@@ -0,0 +1,1128 @@
+/**
+ * @file HidTrace.hpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ * 
+ * Compressed columnar trace file format for decoded Input report streams.
+ * The reports are decoded with the `Layout` of the compiled HID descriptor. Each report ID is stored
+ * in blocks of up to `TraceBlockRecords` records with one column per decoded value. The columns are
+ * compressed with codecs selected per field and block. A block index at the end of the file allows
+ * time range seeks per report ID. Use `hid::TraceWriter` and `hid::TraceReader`.
+ * 
+ * File layout (all values little-endian):
+ * - header: magic `HIDT`, version (16 bit), flags (16 bit), descriptor hash (32 bit),
+ *   descriptor length (32 bit), compiled HID descriptor
+ * - blocks: block header, time column header, value column headers, column payloads, 8 padding bytes
+ * - index: one `TraceBlock` entry per block
+ * - footer: index offset (64 bit), block count (32 bit), magic `HIDT`
+ * 
+ * @remarks This requires a hosted C++14 environment.
+ * @see ::hid::detail::TraceWriter
+ * @see ::hid::detail::TraceReader
+ */
+#ifndef __HIDTRACE_HPP__
+#define __HIDTRACE_HPP__
+
+#include "HidPipeline.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else /* not _WIN32 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* not _WIN32 */
+
+
+namespace hid {
+namespace detail {
+namespace {
+
+
+/** Trace format constants. */
+enum {
+	TraceVersion = 1, /**< file format version */
+	TraceBlockRecords = 4096, /**< maximum records per block */
+	TraceHeaderSize = 16, /**< file header size in bytes without descriptor */
+	TraceBlockHeaderSize = 24, /**< block header size in bytes */
+	TraceColumnHeaderSize = 28, /**< column header size in bytes */
+	TraceIndexEntrySize = 36, /**< block index entry size in bytes */
+	TraceFooterSize = 16, /**< file footer size in bytes */
+	TracePadding = 8, /**< zero bytes after the column payloads of each block */
+	TraceColumnStride = TraceBlockRecords + 16 /**< writer values per column; not a multiple of the page size to avoid cache set conflicts */
+};
+
+
+/** Column codecs. */
+enum TraceCodec {
+	TC_CONST, /**< all values equal `base`; no payload */
+	TC_PACK,  /**< `value - base` bit-packed with `width` bits */
+	TC_DELTA, /**< first value `base`, then `value - previous - step` bit-packed with `width` bits */
+	TC_RLE    /**< first value `base`, then the run lengths as LEB128 (values alternate between `min` and `max`) */
+};
+
+
+/** Single column of a report: a decoded value of a report field. */
+struct TraceField {
+	ReportField field; /**< report field */
+	uint32_t index; /**< element index within the field */
+};
+
+
+/** Block index entry. */
+struct TraceBlock {
+	uint64_t offset; /**< block offset within the file */
+	uint32_t bytes; /**< block size in bytes including the padding */
+	uint32_t records; /**< number of records */
+	uint64_t firstTime; /**< timestamp of the first record */
+	uint64_t lastTime; /**< timestamp of the last record */
+	uint8_t reportId; /**< report ID or 0 if not used */
+};
+
+
+/** Column header within a block. */
+struct TraceColumn {
+	uint8_t codec; /**< codec (see `TraceCodec`) */
+	uint8_t width; /**< bit-packed value width (0 to 32) */
+	int32_t min; /**< minimum value within the block */
+	int32_t max; /**< maximum value within the block */
+	int32_t base; /**< codec specific base value */
+	int32_t step; /**< minimum difference between two values for `TC_DELTA` */
+	const uint8_t * payload; /**< encoded values */
+	uint32_t bytes; /**< payload size in bytes */
+};
+
+
+/**
+ * Returns the hash of the given compiled HID descriptor (FNV-1a). Trace files are keyed by this value.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @return descriptor hash
+ */
+constexpr inline uint32_t descriptorHash(const uint8_t * desc, const size_t len) noexcept {
+	uint32_t res = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		res = (res ^ desc[i]) * 16777619u;
+	}
+	return res;
+}
+
+
+/**
+ * Returns the columns of the given Input report in the value order of `Layout::decode()`.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] reportId - report ID or 0 if not used
+ * @return report field and element index per column
+ */
+inline std::vector<TraceField> traceFields(const uint8_t * desc, const size_t len, const uint8_t reportId) {
+	std::vector<TraceField> res;
+	FieldReader fields(desc, len);
+	ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	while ( fields.next(field) ) {
+		if (field.type != RT_INPUT || field.reportId != reportId || field.isConstant() || field.size == 0 || field.size > 32) {
+			continue;
+		}
+		for (uint32_t i = 0; i < field.count; i++) {
+			res.push_back(TraceField{field, i});
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Writes the given value in little-endian order.
+ * 
+ * @param[out] out - output buffer
+ * @param[in] value - value to write
+ * @param[in] bytes - number of bytes to write
+ */
+inline void storeLittle(uint8_t * out, const uint64_t value, const size_t bytes) noexcept {
+	for (size_t i = 0; i < bytes; i++) {
+		out[i] = uint8_t(value >> (8 * i));
+	}
+}
+
+
+/**
+ * Reads a value in little-endian order.
+ * 
+ * @param[in] in - input buffer
+ * @param[in] bytes - number of bytes to read
+ * @return read value
+ */
+inline uint64_t loadLittle(const uint8_t * in, const size_t bytes) noexcept {
+	uint64_t res = 0;
+	for (size_t i = 0; i < bytes; i++) {
+		res |= uint64_t(in[i]) << (8 * i);
+	}
+	return res;
+}
+
+
+/**
+ * Returns the number of bits needed to store the given value.
+ * 
+ * @param[in] value - value
+ * @return bits (0 to 64)
+ */
+inline uint8_t bitWidth(uint64_t value) noexcept {
+	uint8_t res = 0;
+	while (value != 0) {
+		value >>= 1;
+		res++;
+	}
+	return res;
+}
+
+
+/**
+ * Appends `count` values of `width` bits each to the output. Each value is offset by `-base`.
+ * 
+ * @param[in,out] out - output buffer
+ * @param[in] values - values
+ * @param[in] count - number of values
+ * @param[in] base - subtracted from each value
+ * @param[in] width - bits per value (0 to 32)
+ */
+inline void packBits(std::vector<uint8_t> & out, const uint32_t * values, const size_t count, const uint32_t base, const uint8_t width) {
+	if (width == 0) {
+		return;
+	}
+	const size_t start = out.size();
+	const size_t bytes = ((count * width) + 7) / 8;
+	/* whole 32-bit words are stored; the excess is cut off afterwards */
+	out.resize(start + bytes + 4);
+	uint8_t * ptr = out.data() + start;
+	uint64_t acc = 0;
+	uint32_t bits = 0;
+	for (size_t i = 0; i < count; i++) {
+		acc |= uint64_t(uint32_t(values[i] - base)) << bits;
+		bits += width;
+		if (bits >= 32) {
+			storeLittle(ptr, acc, 4);
+			ptr += 4;
+			acc >>= 32;
+			bits -= 32;
+		}
+	}
+	storeLittle(ptr, acc, 4);
+	out.resize(start + bytes);
+}
+
+
+/**
+ * Reads `count` values of `Width` bits each and adds `base`. Groups of 8 values start at a byte
+ * boundary and are unpacked with constant shifts.
+ * 
+ * @param[in] in - packed data
+ * @param[in] count - number of values
+ * @param[in] base - added to each value
+ * @param[out] out - receives the values
+ * @tparam Width - bits per value (1 to 32)
+ */
+template <unsigned Width>
+inline void unpackWidth(const uint8_t * in, const size_t count, const uint32_t base, uint32_t * out) noexcept {
+	const uint64_t mask = (uint64_t(1) << Width) - 1;
+	size_t i = 0;
+	for (; (i + 8) <= count; i += 8, in += Width) {
+		for (unsigned k = 0; k < 8; k++) {
+			out[i + k] = base + uint32_t((loadWindow(in + ((k * Width) >> 3)) >> ((k * Width) & 7)) & mask);
+		}
+	}
+	for (unsigned k = 0; i < count; i++, k++) {
+		out[i] = base + uint32_t((loadWindow(in + ((k * Width) >> 3)) >> ((k * Width) & 7)) & mask);
+	}
+}
+
+
+/**
+ * Reads `count` values of `width` bits each and adds `base`. Reads up to 7 bytes behind the
+ * packed data.
+ * 
+ * @param[in] in - packed data
+ * @param[in] count - number of values
+ * @param[in] base - added to each value
+ * @param[in] width - bits per value (0 to 32)
+ * @param[out] out - receives the values
+ */
+inline void unpackBits(const uint8_t * in, const size_t count, const uint32_t base, const uint8_t width, uint32_t * out) noexcept {
+	switch (width) {
+	case 0:
+		for (size_t i = 0; i < count; i++) {
+			out[i] = base;
+		}
+		break;
+#define HID_TRACE_UNPACK(w) case w: unpackWidth<w>(in, count, base, out); break;
+	HID_TRACE_UNPACK(1) HID_TRACE_UNPACK(2) HID_TRACE_UNPACK(3) HID_TRACE_UNPACK(4)
+	HID_TRACE_UNPACK(5) HID_TRACE_UNPACK(6) HID_TRACE_UNPACK(7) HID_TRACE_UNPACK(8)
+	HID_TRACE_UNPACK(9) HID_TRACE_UNPACK(10) HID_TRACE_UNPACK(11) HID_TRACE_UNPACK(12)
+	HID_TRACE_UNPACK(13) HID_TRACE_UNPACK(14) HID_TRACE_UNPACK(15) HID_TRACE_UNPACK(16)
+	HID_TRACE_UNPACK(17) HID_TRACE_UNPACK(18) HID_TRACE_UNPACK(19) HID_TRACE_UNPACK(20)
+	HID_TRACE_UNPACK(21) HID_TRACE_UNPACK(22) HID_TRACE_UNPACK(23) HID_TRACE_UNPACK(24)
+	HID_TRACE_UNPACK(25) HID_TRACE_UNPACK(26) HID_TRACE_UNPACK(27) HID_TRACE_UNPACK(28)
+	HID_TRACE_UNPACK(29) HID_TRACE_UNPACK(30) HID_TRACE_UNPACK(31) HID_TRACE_UNPACK(32)
+#undef HID_TRACE_UNPACK
+	default:
+		break;
+	}
+}
+
+
+/**
+ * Appends the given value as LEB128.
+ * 
+ * @param[in,out] out - output buffer
+ * @param[in] value - value to write
+ */
+inline void putVarint(std::vector<uint8_t> & out, uint32_t value) {
+	while (value >= 0x80) {
+		out.push_back(uint8_t(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(uint8_t(value));
+}
+
+
+/**
+ * Returns the number of bytes needed to store the given value as LEB128.
+ * 
+ * @param[in] value - value
+ * @return bytes (1 to 5)
+ */
+inline size_t varintSize(uint32_t value) noexcept {
+	size_t res = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		res++;
+	}
+	return res;
+}
+
+
+/**
+ * Writes trace files. Only Input reports are recorded. Records of each report ID are collected
+ * until the block is full, the timestamp decreases or the timestamp difference exceeds 32 bits.
+ * The reports are decoded with the `Layout` decode program directly into one buffer per column.
+ * The value ranges and runs needed to select the codecs are collected in the same pass.
+ * The codec of each column is selected per block:
+ * - `TC_CONST` if all values are equal
+ * - `TC_RLE` for 1 bit fields (e.g. buttons) if smaller than bit-packing
+ * - `TC_DELTA` for absolute variable fields (e.g. axes) if smaller than bit-packing
+ * - `TC_PACK` otherwise with the bit width of `max - min`, which never exceeds the ReportSize
+ * 
+ * @tparam Sink - output type with `bool write(const uint8_t * data, size_t len)`
+ */
+template <typename Sink>
+class TraceWriter {
+private:
+	/** Statistics of a column within the current block. */
+	struct Stats {
+		int32_t min; /**< minimum value (not for `single`) */
+		int32_t max; /**< maximum value (not for `single`) */
+		int64_t lo; /**< minimum difference between two consecutive values (not for `single`) */
+		int64_t hi; /**< maximum difference between two consecutive values (not for `single`) */
+		int32_t last; /**< last value */
+		uint32_t runStart; /**< record index of the first value of the current run (only for `single`) */
+		uint32_t runBytes; /**< LEB128 size of all completed runs in bytes (only for `single`) */
+		bool single; /**< true for 1 bit fields which only need the runs */
+	};
+	/** Records of a report ID which were not written yet. */
+	struct Open {
+		std::vector<TraceField> fields; /**< columns */
+		std::vector<Stats> stats; /**< statistics per column of the current block */
+		std::vector<uint64_t> times; /**< record timestamps */
+		std::vector<uint32_t> values; /**< record values (column-major with `TraceColumnStride` values per column) */
+		uint32_t timeLo; /**< minimum timestamp difference */
+		uint32_t timeHi; /**< maximum timestamp difference */
+		size_t records; /**< number of records */
+	};
+	Sink & sink; /**< output */
+	Layout layout; /**< report layout */
+	std::vector<Open> open; /**< records per report ID */
+	std::vector<TraceBlock> index; /**< written blocks */
+	std::vector<uint8_t> buffer; /**< encoded block */
+	std::vector<uint32_t> diffs; /**< timestamp or value differences of the current column */
+	uint64_t offset; /**< current file offset */
+	uint64_t dropped; /**< reports with unknown report ID or invalid length */
+	bool ok; /**< false after a write error */
+	bool finished; /**< true after `finish()` */
+	
+	/**
+	 * Passes the given data to the sink.
+	 * 
+	 * @param[in] data - data to write
+	 * @param[in] len - data length in bytes
+	 */
+	inline void put(const uint8_t * data, const size_t len) {
+		if (this->ok && len > 0) {
+			this->ok = this->sink.write(data, len);
+		}
+		this->offset += len;
+	}
+	
+	/**
+	 * Encodes the given column values and appends the payload to `buffer`.
+	 * 
+	 * @param[in] info - column field
+	 * @param[in] values - column values
+	 * @param[in] stats - column statistics
+	 * @param[in] count - number of values
+	 * @param[in] headerPos - position of the column header within `buffer`
+	 */
+	inline void encode(const ReportField & info, const uint32_t * values, const Stats & stats, const size_t count, const size_t headerPos) {
+		int32_t min = stats.min, max = stats.max;
+		if ( stats.single ) {
+			/* both values are present once a run ended */
+			min = (stats.runBytes == 0) ? int32_t(values[0]) : (info.isSigned() ? -1 : 0);
+			max = (stats.runBytes == 0) ? int32_t(values[0]) : (min + 1);
+		}
+		uint8_t codec = TC_PACK;
+		uint8_t width = bitWidth(uint32_t(max) - uint32_t(min));
+		int32_t base = min, step = 0;
+		const size_t start = this->buffer.size();
+		const size_t packed = ((count * width) + 7) / 8;
+		if (min == max) {
+			codec = TC_CONST;
+			width = 0;
+		} else if (stats.single && (stats.runBytes + varintSize(uint32_t(count - stats.runStart))) < packed) {
+			/* buttons: runs of equal values if this is smaller */
+			codec = TC_RLE;
+			base = int32_t(values[0]);
+			uint32_t run = 1;
+			for (size_t i = 1; i < count; i++) {
+				if (values[i] == values[i - 1]) {
+					run++;
+				} else {
+					putVarint(this->buffer, run);
+					run = 1;
+				}
+			}
+			putVarint(this->buffer, run);
+		} else if (( ! stats.single ) && info.isVariable() && ( ! info.isRelative() ) && count > 1 && stats.lo >= INT32_MIN && bitWidth(uint64_t(stats.hi - stats.lo)) < width) {
+			/* axes: differences between consecutive values if this is smaller */
+			codec = TC_DELTA;
+			width = bitWidth(uint64_t(stats.hi - stats.lo));
+			base = int32_t(values[0]);
+			step = int32_t(stats.lo);
+			this->diffs.resize(count);
+			for (size_t i = 1; i < count; i++) {
+				this->diffs[i - 1] = values[i] - values[i - 1];
+			}
+			packBits(this->buffer, this->diffs.data(), count - 1, uint32_t(step), width);
+		}
+		if (codec == TC_PACK) {
+			packBits(this->buffer, values, count, uint32_t(base), width);
+		}
+		uint8_t * header = this->buffer.data() + headerPos;
+		header[0] = codec;
+		header[1] = width;
+		header[2] = 0;
+		header[3] = 0;
+		storeLittle(header + 4, uint32_t(min), 4);
+		storeLittle(header + 8, uint32_t(max), 4);
+		storeLittle(header + 12, uint32_t(base), 4);
+		storeLittle(header + 16, uint32_t(step), 4);
+		storeLittle(header + 20, start, 4);
+		storeLittle(header + 24, this->buffer.size() - start, 4);
+	}
+	
+	/**
+	 * Writes the collected records of the given report ID as a new block.
+	 * 
+	 * @param[in] reportId - report ID
+	 */
+	inline void flush(const uint8_t reportId) {
+		Open & rec = this->open[reportId];
+		const size_t records = rec.records;
+		if (records == 0) {
+			return;
+		}
+		const size_t columns = rec.fields.size();
+		const size_t headers = TraceBlockHeaderSize + ((columns + 1) * TraceColumnHeaderSize);
+		std::vector<uint8_t> & out = this->buffer;
+		out.assign(headers, 0);
+		out[0] = reportId;
+		storeLittle(out.data() + 2, columns, 2);
+		storeLittle(out.data() + 4, records, 4);
+		storeLittle(out.data() + 8, rec.times.front(), 8);
+		storeLittle(out.data() + 16, rec.times[records - 1], 8);
+		/* timestamp differences bit-packed with the smallest difference as base */
+		this->diffs.resize(records);
+		for (size_t i = 1; i < records; i++) {
+			this->diffs[i - 1] = uint32_t(rec.times[i] - rec.times[i - 1]);
+		}
+		const uint32_t lo = (records > 1) ? rec.timeLo : 0;
+		const uint8_t width = bitWidth(rec.timeHi - lo);
+		uint8_t * header = out.data() + TraceBlockHeaderSize;
+		header[0] = TC_PACK;
+		header[1] = width;
+		storeLittle(header + 12, lo, 4);
+		storeLittle(header + 20, headers, 4);
+		packBits(out, this->diffs.data(), records - 1, lo, width);
+		storeLittle(out.data() + TraceBlockHeaderSize + 24, out.size() - headers, 4);
+		for (size_t c = 0; c < columns; c++) {
+			const uint32_t * in = rec.values.data() + (c * size_t(TraceColumnStride));
+			this->encode(rec.fields[c].field, in, rec.stats[c], records, TraceBlockHeaderSize + ((c + 1) * TraceColumnHeaderSize));
+		}
+		out.insert(out.end(), TracePadding, 0);
+		this->index.push_back(TraceBlock{this->offset, uint32_t(out.size()), uint32_t(records), rec.times[0], rec.times[records - 1], reportId});
+		this->put(out.data(), out.size());
+		rec.records = 0;
+	}
+public:
+	/**
+	 * Constructor. Writes the file header.
+	 * 
+	 * @param[in,out] output - output sink
+	 * @param[in] desc - compiled HID descriptor
+	 * @param[in] len - descriptor length in bytes
+	 */
+	inline explicit TraceWriter(Sink & output, const uint8_t * desc, const size_t len):
+		sink(output),
+		layout(desc, len),
+		open(256),
+		index(),
+		buffer(),
+		diffs(),
+		offset{0},
+		dropped{0},
+		ok{true},
+		finished{false}
+	{
+		for (size_t id = 0; id < 256; id++) {
+			Open & rec = this->open[id];
+			rec.timeLo = 0;
+			rec.timeHi = 0;
+			rec.records = 0;
+			if (this->layout.report(uint8_t(id)).count > 0) {
+				rec.fields = traceFields(desc, len, uint8_t(id));
+			}
+		}
+		uint8_t header[TraceHeaderSize] = {'H', 'I', 'D', 'T'};
+		storeLittle(header + 4, TraceVersion, 2);
+		storeLittle(header + 8, descriptorHash(desc, len), 4);
+		storeLittle(header + 12, len, 4);
+		this->put(header, sizeof(header));
+		this->put(desc, len);
+	}
+	
+	TraceWriter(const TraceWriter &) = delete;
+	TraceWriter & operator= (const TraceWriter &) = delete;
+	
+	/**
+	 * Adds a report.
+	 * 
+	 * @param[in] time - timestamp (e.g. in microseconds)
+	 * @param[in] data - report data including the report ID byte if used
+	 * @param[in] len - report length in bytes
+	 * @return true on success, false for unknown report IDs, too short reports or after `finish()`
+	 */
+	inline bool add(const uint64_t time, const uint8_t * data, size_t len) {
+		uint8_t reportId = 0;
+		if (this->layout.usesReportIds() && len > 0) {
+			reportId = *data++;
+			len--;
+		}
+		const Layout::Report & format = this->layout.report(reportId);
+		if (this->finished || format.count == 0 || len < format.bytes) {
+			this->dropped++;
+			return false;
+		}
+		Open & rec = this->open[reportId];
+		if (rec.records > 0) {
+			const uint64_t last = rec.times[rec.records - 1];
+			if (time < last || (time - last) > 0xFFFFFFFF) {
+				this->flush(reportId);
+			}
+		} else if ( rec.times.empty() ) {
+			rec.times.resize(TraceBlockRecords);
+			rec.values.resize(size_t(TraceColumnStride) * format.count);
+			rec.stats.resize(format.count);
+			for (size_t c = 0; c < format.count; c++) {
+				rec.stats[c].single = rec.fields[c].field.size == 1;
+			}
+		}
+		const size_t r = rec.records++;
+		uint32_t * const values = rec.values.data() + r;
+		Stats * const stats = rec.stats.data();
+		rec.times[r] = time;
+		if (r == 0) {
+			rec.timeLo = 0xFFFFFFFF;
+			rec.timeHi = 0;
+			this->layout.decodeEach(format, data, [values, stats] (const size_t c, const int32_t val) {
+				Stats & col = stats[c];
+				values[c * size_t(TraceColumnStride)] = uint32_t(val);
+				col.min = val;
+				col.max = val;
+				col.lo = INT64_MAX;
+				col.hi = INT64_MIN;
+				col.last = val;
+				col.runStart = 0;
+				col.runBytes = 0;
+			});
+		} else {
+			const uint32_t diff = uint32_t(time - rec.times[r - 1]);
+			rec.timeLo = (diff < rec.timeLo) ? diff : rec.timeLo;
+			rec.timeHi = (diff > rec.timeHi) ? diff : rec.timeHi;
+			this->layout.decodeEach(format, data, [values, stats, r] (const size_t c, const int32_t val) {
+				Stats & col = stats[c];
+				values[c * size_t(TraceColumnStride)] = uint32_t(val);
+				if ( col.single ) {
+					/* LEB128 size of the ended run without branches; runs never exceed 2^21 values */
+					const uint32_t ended = uint32_t(val != col.last);
+					const uint32_t run = uint32_t(r) - col.runStart;
+					col.runBytes += ended * (1 + uint32_t(run >= 0x80) + uint32_t(run >= 0x4000));
+					col.runStart = ended ? uint32_t(r) : col.runStart;
+				} else {
+					const int64_t delta = int64_t(val) - col.last;
+					col.min = (val < col.min) ? val : col.min;
+					col.max = (val > col.max) ? val : col.max;
+					col.lo = (delta < col.lo) ? delta : col.lo;
+					col.hi = (delta > col.hi) ? delta : col.hi;
+				}
+				col.last = val;
+			});
+		}
+		if (rec.records >= TraceBlockRecords) {
+			this->flush(reportId);
+		}
+		return true;
+	}
+	
+	/**
+	 * Writes all collected records, the block index and the footer.
+	 * 
+	 * @return true on success, false if the sink failed
+	 */
+	inline bool finish() {
+		if ( this->finished ) {
+			return this->ok;
+		}
+		for (size_t id = 0; id < 256; id++) {
+			this->flush(uint8_t(id));
+		}
+		const uint64_t indexOffset = this->offset;
+		uint8_t entry[TraceIndexEntrySize];
+		for (const TraceBlock & block : this->index) {
+			memset(entry, 0, sizeof(entry));
+			storeLittle(entry, block.offset, 8);
+			storeLittle(entry + 8, block.bytes, 4);
+			storeLittle(entry + 12, block.records, 4);
+			storeLittle(entry + 16, block.firstTime, 8);
+			storeLittle(entry + 24, block.lastTime, 8);
+			entry[32] = block.reportId;
+			this->put(entry, sizeof(entry));
+		}
+		uint8_t footer[TraceFooterSize] = {0};
+		storeLittle(footer, indexOffset, 8);
+		storeLittle(footer + 8, this->index.size(), 4);
+		memcpy(footer + 12, "HIDT", 4);
+		this->put(footer, sizeof(footer));
+		this->finished = true;
+		return this->ok;
+	}
+	
+	/**
+	 * Returns the number of rejected reports.
+	 * 
+	 * @return rejected reports
+	 */
+	inline uint64_t droppedReports() const noexcept {
+		return this->dropped;
+	}
+	
+	/**
+	 * Returns the number of written bytes.
+	 * 
+	 * @return file size so far
+	 */
+	inline uint64_t size() const noexcept {
+		return this->offset;
+	}
+};
+
+
+/**
+ * Trace writer output to a `std::FILE`.
+ */
+struct TraceFileSink {
+	std::FILE * fd; /**< output file */
+	
+	/**
+	 * Writes the given data.
+	 * 
+	 * @param[in] data - data to write
+	 * @param[in] len - data length in bytes
+	 * @return true on success, else false
+	 */
+	inline bool write(const uint8_t * data, const size_t len) {
+		return fwrite(data, 1, len, this->fd) == len;
+	}
+};
+
+
+/**
+ * Trace writer output to memory.
+ */
+struct TraceVectorSink {
+	std::vector<uint8_t> data; /**< written data */
+	
+	/**
+	 * Appends the given data.
+	 * 
+	 * @param[in] buf - data to write
+	 * @param[in] len - data length in bytes
+	 * @return true
+	 */
+	inline bool write(const uint8_t * buf, const size_t len) {
+		this->data.insert(this->data.end(), buf, buf + len);
+		return true;
+	}
+};
+
+
+/**
+ * Reads trace files from memory (e.g. a `MappedFile`). The data is validated on construction
+ * and needs to stay valid for the lifetime of the reader.
+ */
+class TraceReader {
+private:
+	const uint8_t * data; /**< file data */
+	size_t length; /**< file size in bytes */
+	uint32_t hash; /**< descriptor hash */
+	uint32_t descLength; /**< descriptor length in bytes */
+	std::vector<TraceBlock> index; /**< block index */
+	std::vector<std::vector<uint32_t>> byId; /**< block indices per report ID in ascending order of the first timestamp */
+	std::vector<std::vector<uint64_t>> reach; /**< latest timestamp up to each position of `byId` */
+	bool ok; /**< true if the file is valid */
+	
+	/**
+	 * Returns the column header at the given position within the block.
+	 * 
+	 * @param[in] block - block index
+	 * @param[in] pos - 0 for the time column, value column index + 1 otherwise
+	 * @return column header
+	 */
+	inline TraceColumn header(const size_t block, const size_t pos) const noexcept {
+		const uint8_t * start = this->data + this->index[block].offset;
+		const uint8_t * col = start + TraceBlockHeaderSize + (pos * TraceColumnHeaderSize);
+		return TraceColumn{
+			col[0],
+			col[1],
+			int32_t(uint32_t(loadLittle(col + 4, 4))),
+			int32_t(uint32_t(loadLittle(col + 8, 4))),
+			int32_t(uint32_t(loadLittle(col + 12, 4))),
+			int32_t(uint32_t(loadLittle(col + 16, 4))),
+			start + loadLittle(col + 20, 4),
+			uint32_t(loadLittle(col + 24, 4))
+		};
+	}
+	
+	/**
+	 * Parses and validates the file.
+	 * 
+	 * @return true on success, else false
+	 */
+	inline bool parse() {
+		if (this->length < (TraceHeaderSize + TraceFooterSize) || memcmp(this->data, "HIDT", 4) != 0 || loadLittle(this->data + 4, 2) != TraceVersion) {
+			return false;
+		}
+		this->hash = uint32_t(loadLittle(this->data + 8, 4));
+		this->descLength = uint32_t(loadLittle(this->data + 12, 4));
+		const uint8_t * footer = this->data + this->length - TraceFooterSize;
+		const uint64_t indexOffset = loadLittle(footer, 8);
+		const uint64_t blocks = loadLittle(footer + 8, 4);
+		const uint64_t blocksStart = uint64_t(TraceHeaderSize) + this->descLength;
+		if (memcmp(footer + 12, "HIDT", 4) != 0 || blocksStart > indexOffset || indexOffset > (this->length - TraceFooterSize)
+			|| (blocks * TraceIndexEntrySize) != (this->length - TraceFooterSize - indexOffset)
+			|| ::hid::detail::descriptorHash(this->data + TraceHeaderSize, this->descLength) != this->hash) {
+			return false;
+		}
+		this->index.reserve(size_t(blocks));
+		for (const uint8_t * entry = this->data + indexOffset; entry < footer; entry += TraceIndexEntrySize) {
+			const TraceBlock block{loadLittle(entry, 8), uint32_t(loadLittle(entry + 8, 4)), uint32_t(loadLittle(entry + 12, 4)), loadLittle(entry + 16, 8), loadLittle(entry + 24, 8), entry[32]};
+			if (block.offset < blocksStart || block.bytes < (TraceBlockHeaderSize + TraceColumnHeaderSize + TracePadding) || block.offset > indexOffset || block.bytes > (indexOffset - block.offset)) {
+				return false;
+			}
+			const uint8_t * header = this->data + block.offset;
+			const size_t columns = size_t(loadLittle(header + 2, 2));
+			if (header[0] != block.reportId || loadLittle(header + 4, 4) != block.records || block.records == 0 || block.records > TraceBlockRecords
+				|| (TraceBlockHeaderSize + ((columns + 1) * TraceColumnHeaderSize) + TracePadding) > block.bytes) {
+				return false;
+			}
+			for (size_t c = 0; c <= columns; c++) {
+				const uint8_t * col = header + TraceBlockHeaderSize + (c * TraceColumnHeaderSize);
+				const uint64_t start = loadLittle(col + 20, 4), bytes = loadLittle(col + 24, 4);
+				const uint64_t values = (c == 0) ? (block.records - 1) : block.records;
+				if (col[0] > TC_RLE || (c == 0 && col[0] != TC_PACK) || col[1] > 32 || (start + bytes) > (block.bytes - TracePadding)
+					|| ((col[0] == TC_PACK || col[0] == TC_DELTA) && bytes < ((values * col[1]) + 7) / 8)) {
+					return false;
+				}
+			}
+			this->byId[block.reportId].push_back(uint32_t(this->index.size()));
+			this->index.push_back(block);
+		}
+		/* blocks overlap in time if the clock jumped backwards */
+		for (size_t id = 0; id < 256; id++) {
+			std::vector<uint32_t> & list = this->byId[id];
+			std::stable_sort(list.begin(), list.end(), [this] (const uint32_t lhs, const uint32_t rhs) {
+				return this->index[lhs].firstTime < this->index[rhs].firstTime;
+			});
+			uint64_t last = 0;
+			this->reach[id].reserve(list.size());
+			for (const uint32_t block : list) {
+				last = (this->index[block].lastTime > last) ? this->index[block].lastTime : last;
+				this->reach[id].push_back(last);
+			}
+		}
+		return true;
+	}
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] file - trace file data
+	 * @param[in] len - trace file size in bytes
+	 */
+	inline explicit TraceReader(const uint8_t * file, const size_t len):
+		data{file},
+		length{len},
+		hash{0},
+		descLength{0},
+		index(),
+		byId(256),
+		reach(256),
+		ok{false}
+	{
+		this->ok = file != nullptr && this->parse();
+	}
+	
+	/**
+	 * Checks whether the trace file is valid.
+	 * 
+	 * @return true if valid, else false
+	 */
+	inline bool valid() const noexcept {
+		return this->ok;
+	}
+	
+	/**
+	 * Returns the descriptor hash (see `descriptorHash()`).
+	 * 
+	 * @return descriptor hash
+	 */
+	inline uint32_t descriptorHash() const noexcept {
+		return this->hash;
+	}
+	
+	/**
+	 * Returns the compiled HID descriptor.
+	 * 
+	 * @return descriptor data
+	 */
+	inline const uint8_t * descriptor() const noexcept {
+		return this->data + TraceHeaderSize;
+	}
+	
+	/**
+	 * Returns the compiled HID descriptor size.
+	 * 
+	 * @return descriptor length in bytes
+	 */
+	inline size_t descriptorSize() const noexcept {
+		return this->descLength;
+	}
+	
+	/**
+	 * Returns the number of blocks.
+	 * 
+	 * @return block count
+	 */
+	inline size_t blockCount() const noexcept {
+		return this->index.size();
+	}
+	
+	/**
+	 * Returns the given block index entry.
+	 * 
+	 * @param[in] block - block index
+	 * @return block index entry
+	 */
+	inline const TraceBlock & block(const size_t block) const noexcept {
+		return this->index[block];
+	}
+	
+	/**
+	 * Returns the blocks of the given report ID in ascending order of their first timestamp.
+	 * Blocks are in file order for equal first timestamps. Blocks may overlap in time if the
+	 * clock jumped backwards.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @return block indices
+	 */
+	inline const std::vector<uint32_t> & blocks(const uint8_t reportId) const noexcept {
+		return this->byId[reportId];
+	}
+	
+	/**
+	 * Returns the position within `blocks(reportId)` from which on all records at or after the
+	 * given time are found. No block before this position has records at or after the given time.
+	 * Later blocks may still contain earlier records if the clock jumped backwards.
+	 * 
+	 * @param[in] reportId - report ID or 0 if not used
+	 * @param[in] time - timestamp
+	 * @return position or `blocks(reportId).size()` if there is no such block
+	 */
+	inline size_t seek(const uint8_t reportId, const uint64_t time) const noexcept {
+		const std::vector<uint64_t> & list = this->reach[reportId];
+		size_t lo = 0, hi = list.size();
+		while (lo < hi) {
+			const size_t mid = lo + ((hi - lo) / 2);
+			if (list[mid] < time) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		return lo;
+	}
+	
+	/**
+	 * Returns the number of value columns of the given block.
+	 * 
+	 * @param[in] block - block index
+	 * @return value columns
+	 */
+	inline size_t columnCount(const size_t block) const noexcept {
+		return size_t(loadLittle(this->data + this->index[block].offset + 2, 2));
+	}
+	
+	/**
+	 * Returns the header of the given value column without decoding it. Use `min` and `max`
+	 * to skip blocks.
+	 * 
+	 * @param[in] block - block index
+	 * @param[in] column - value column index
+	 * @return column header
+	 */
+	inline TraceColumn column(const size_t block, const size_t column) const noexcept {
+		return this->header(block, column + 1);
+	}
+	
+	/**
+	 * Decodes the timestamps of the given block.
+	 * 
+	 * @param[in] block - block index
+	 * @param[out] out - receives `block(block).records` timestamps
+	 */
+	inline void decodeTimes(const size_t block, uint64_t * out) const noexcept {
+		const TraceBlock & entry = this->index[block];
+		const TraceColumn col = this->header(block, 0);
+		uint32_t diff[64];
+		uint64_t time = entry.firstTime;
+		out[0] = time;
+		for (size_t r = 1; r < entry.records; r += 64) {
+			const size_t n = ((entry.records - r) < 64) ? (entry.records - r) : 64;
+			/* chunks of 64 values always start at a byte boundary */
+			unpackBits(col.payload + (((r - 1) * col.width) / 8), n, uint32_t(col.base), col.width, diff);
+			for (size_t i = 0; i < n; i++) {
+				time += diff[i];
+				out[r + i] = time;
+			}
+		}
+	}
+	
+	/**
+	 * Decodes the given value column.
+	 * 
+	 * @param[in] block - block index
+	 * @param[in] column - value column index
+	 * @param[out] out - receives `block(block).records` values
+	 * @return false if the payload is invalid, else true
+	 */
+	inline bool decodeColumn(const size_t block, const size_t column, int32_t * out) const noexcept {
+		const size_t records = this->index[block].records;
+		const TraceColumn col = this->column(block, column);
+		uint32_t * res = reinterpret_cast<uint32_t *>(out);
+		switch (col.codec) {
+		case TC_CONST:
+			for (size_t r = 0; r < records; r++) {
+				out[r] = col.base;
+			}
+			return true;
+		case TC_PACK:
+			unpackBits(col.payload, records, uint32_t(col.base), col.width, res);
+			return true;
+		case TC_DELTA: {
+			unpackBits(col.payload, records - 1, uint32_t(col.step), col.width, res + 1);
+			uint32_t val = uint32_t(col.base);
+			res[0] = val;
+			for (size_t r = 1; r < records; r++) {
+				val += res[r];
+				res[r] = val;
+			}
+			return true;
+		}
+		default: {
+			const uint8_t * in = col.payload;
+			const uint8_t * const end = in + col.bytes;
+			int32_t val = col.base;
+			size_t r = 0;
+			while (r < records && in < end) {
+				uint32_t run = 0;
+				for (uint32_t shift = 0; in < end && shift < 32; shift += 7) {
+					const uint8_t b = *in++;
+					run |= uint32_t(b & 0x7F) << shift;
+					if ((b & 0x80) == 0) {
+						break;
+					}
+				}
+				if (run > (records - r)) {
+					return false;
+				}
+				for (const size_t last = r + run; r < last; r++) {
+					out[r] = val;
+				}
+				val = (val == col.min) ? col.max : col.min;
+			}
+			return r == records;
+		}
+		}
+	}
+};
+
+
+/**
+ * Read-only memory mapping of a file.
+ */
+class MappedFile {
+private:
+	const uint8_t * ptr; /**< mapped data */
+	size_t length; /**< file size in bytes */
+#ifdef _WIN32
+	HANDLE file; /**< file handle */
+	HANDLE mapping; /**< mapping handle */
+#endif /* _WIN32 */
+public:
+	/**
+	 * Constructor.
+	 * 
+	 * @param[in] path - file path
+	 */
+	inline explicit MappedFile(const char * path) noexcept:
+		ptr{nullptr},
+		length{0}
+#ifdef _WIN32
+		, file{INVALID_HANDLE_VALUE},
+		mapping{NULL}
+#endif /* _WIN32 */
+	{
+#ifdef _WIN32
+		this->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		LARGE_INTEGER size;
+		if (this->file == INVALID_HANDLE_VALUE || ( ! GetFileSizeEx(this->file, &size) ) || size.QuadPart == 0) {
+			return;
+		}
+		this->mapping = CreateFileMappingA(this->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (this->mapping == NULL) {
+			return;
+		}
+		this->ptr = static_cast<const uint8_t *>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+		this->length = (this->ptr != nullptr) ? size_t(size.QuadPart) : 0;
+#else /* not _WIN32 */
+		const int fd = open(path, O_RDONLY);
+		struct stat info;
+		if (fd < 0) {
+			return;
+		}
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void * map = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map != MAP_FAILED) {
+				this->ptr = static_cast<const uint8_t *>(map);
+				this->length = size_t(info.st_size);
+			}
+		}
+		close(fd);
+#endif /* not _WIN32 */
+	}
+	
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator= (const MappedFile &) = delete;
+	
+	/**
+	 * Destructor.
+	 */
+	inline ~MappedFile() {
+#ifdef _WIN32
+		if (this->ptr != nullptr) {
+			UnmapViewOfFile(this->ptr);
+		}
+		if (this->mapping != NULL) {
+			CloseHandle(this->mapping);
+		}
+		if (this->file != INVALID_HANDLE_VALUE) {
+			CloseHandle(this->file);
+		}
+#else /* not _WIN32 */
+		if (this->ptr != nullptr) {
+			munmap(const_cast<uint8_t *>(this->ptr), this->length);
+		}
+#endif /* not _WIN32 */
+	}
+	
+	/**
+	 * Returns the mapped data.
+	 * 
+	 * @return file data or `nullptr` on error
+	 */
+	inline const uint8_t * data() const noexcept {
+		return this->ptr;
+	}
+	
+	/**
+	 * Returns the file size.
+	 * 
+	 * @return file size in bytes
+	 */
+	inline size_t size() const noexcept {
+		return this->length;
+	}
+};
+
+
+} /* anonymous namespace */
+} /* namespace detail */
+
+
+using ::hid::detail::TraceBlockRecords;
+using ::hid::detail::TraceCodec;
+using ::hid::detail::TC_CONST;
+using ::hid::detail::TC_PACK;
+using ::hid::detail::TC_DELTA;
+using ::hid::detail::TC_RLE;
+using ::hid::detail::TraceField;
+using ::hid::detail::TraceBlock;
+using ::hid::detail::TraceColumn;
+using ::hid::detail::descriptorHash;
+using ::hid::detail::traceFields;
+using ::hid::detail::TraceWriter;
+using ::hid::detail::TraceFileSink;
+using ::hid::detail::TraceVectorSink;
+using ::hid::detail::TraceReader;
+using ::hid::detail::MappedFile;
+
+
+} /* namespace hid */
+
+
+#endif /* __HIDTRACE_HPP__ */
@@ -0,0 +1,695 @@
+/**
+ * @file bench.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ */
+#include "../src/HidPipeline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+
+/** Mouse with report ID and signed relative axes. */
+DEF_HID_DESCRIPTOR_AS(
+	static mouseDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) Usage(Pointer) Collection(Physical)
+		UsagePage(Button) UsageMinimum(1) UsageMaximum(5) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(5) Input(Data, Var, Abs) ReportSize(3) ReportCount(1) Input(Cnst)
+		UsagePage(GenericDesktop) Usage(X) Usage(Y) Usage(Wheel) LogicalMinimum(-127) LogicalMaximum(127)
+		ReportSize(8) ReportCount(3) Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+UsagePage(Consumer) Usage(ConsumerControl) Collection(Application)
+	ReportId(2) LogicalMinimum(0) LogicalMaximum(0x3FF) UsageMinimum(0) UsageMaximum(0x3FF)
+	ReportSize(16) ReportCount(1) Input(Data, Ary, Abs)
+EndCollection
+)")
+);
+
+
+/** Keyboard without report ID. */
+DEF_HID_DESCRIPTOR_AS(
+	static keyboardDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Keyboard) Collection(Application)
+	UsagePage(Keyboard) UsageMinimum(224) UsageMaximum(231) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(8) Input(Data, Var, Abs)
+	ReportSize(8) ReportCount(1) Input(Cnst)
+	UsageMinimum(0) UsageMaximum(101) LogicalMaximum(101) ReportSize(8) ReportCount(6) Input(Data, Ary, Abs)
+EndCollection
+)")
+);
+
+
+/** Gamepad with 12 bit axes. */
+DEF_HID_DESCRIPTOR_AS(
+	static gamepadDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application)
+	ReportId(3) Usage(X) Usage(Y) Usage(Z) Usage(Rz) LogicalMinimum(-2048) LogicalMaximum(2047)
+	ReportSize(12) ReportCount(4) Input(Data, Var, Abs)
+	UsagePage(Button) UsageMinimum(1) UsageMaximum(16) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(16) Input(Data, Var, Abs)
+EndCollection
+)")
+);
+
+
+/** Sensor with aligned 16-bit runs followed by misaligned values up to the report end. */
+DEF_HID_DESCRIPTOR_AS(
+	static sensorDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(MultiAxisController) Collection(Application)
+	ReportId(4) Usage(X) Usage(Y) Usage(Z) Usage(Rx) Usage(Ry) Usage(Rz)
+	LogicalMinimum(-32768) LogicalMaximum(32767) ReportSize(16) ReportCount(6) Input(Data, Var, Abs)
+	Usage(Slider) Usage(Dial) LogicalMinimum(0) LogicalMaximum(1023) ReportSize(10) ReportCount(2) Input(Data, Var, Abs)
+	Usage(Vx) Usage(Vy) Usage(Vz) LogicalMinimum(-2048) LogicalMaximum(2047) ReportSize(12) ReportCount(3) Input(Data, Var, Abs)
+	ReportSize(4) ReportCount(1) Input(Cnst)
+EndCollection
+)")
+);
+
+
+/** Source code for the compiler benchmark. */
+constexpr static const char compileSrc[] = R"(
+# composite device with comments and all literal types
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) Usage(Pointer) Collection(Physical)
+		UsagePage(Button) UsageMinimum(Button1) UsageMaximum(Button5) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(5) Input(Data, Var, Abs) ReportSize(3) ReportCount(1) Input(Cnst)
+		UsagePage(GenericDesktop) Usage(X) Usage(Y) Usage(Wheel) LogicalMinimum(-127) LogicalMaximum(127)
+		ReportSize(8) ReportCount(3) Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+UsagePage(GenericDesktop) Usage(Keyboard) Collection(Application) ; boot compatible
+	ReportId(2) UsagePage(Keyboard) UsageMinimum(224) UsageMaximum(231) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(8) Input(Data, Var, Abs) ReportSize(8) ReportCount(1) Input(Cnst)
+	UsageMinimum(0) UsageMaximum(0x65) LogicalMaximum(0x65) ReportSize(8) ReportCount(6) Input(Data, Ary, Abs)
+	UsagePage(Led) UsageMinimum(NumLock) UsageMaximum(Kana) ReportSize(1) ReportCount(5) Output(Data, Var, Abs)
+	ReportSize(3) ReportCount(1) Output(Cnst)
+EndCollection
+UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application)
+	ReportId(3) Usage(X) Usage(Y) LogicalMinimum(-2048) LogicalMaximum(2047) PhysicalMinimum(-90) PhysicalMaximum(90)
+	Unit(EngRot(Length)) UnitExponent(-2) ReportSize(12) ReportCount(2) Input(Data, Var, Abs)
+	Unit(None) UsagePage(Button) UsageMinimum(1) UsageMaximum(16) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(16) Input(Data, Var, Abs)
+EndCollection
+)";
+
+
+#ifdef BENCH_CONSTEXPR_STEPS
+/**
+ * Concatenates copies of the given source code at compile time.
+ *
+ * @param[in] text - source code
+ * @return source with `R` copies of `text`
+ * @tparam R - number of copies
+ */
+template <size_t R, size_t N>
+constexpr hid::detail::Source<((N - 1) * R) + 1> repeatSource(const char (& text)[N]) noexcept {
+	hid::detail::Source<((N - 1) * R) + 1> res;
+	for (size_t r = 0; r < R; r++) {
+		for (size_t i = 0; (i + 1) < N; i++) {
+			res.code[(r * (N - 1)) + i] = text[i];
+		}
+	}
+	return res;
+}
+
+
+/* `make steps` searches for the lowest -fconstexpr-ops-limit which still compiles this */
+constexpr static const auto stepsSrc = repeatSource<BENCH_CONSTEXPR_STEPS>(compileSrc);
+constexpr static const hid::Descriptor<hid::compiledSize(stepsSrc)> stepsDesc(stepsSrc);
+#endif /* BENCH_CONSTEXPR_STEPS */
+
+
+/** Source code for the compile policy benchmark. Uses only syntax which all policies accept. */
+static const char leanSrc[] = R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) Usage(Pointer) Collection(Physical)
+		UsagePage(Button) UsageMinimum(Button1) UsageMaximum(Button5) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(5) Input(Data, Var, Abs) ReportSize(3) ReportCount(1) Input(Cnst)
+		UsagePage(GenericDesktop) Usage(X) Usage(Y) Usage(Wheel) LogicalMinimum(-127) LogicalMaximum(127)
+		ReportSize(8) ReportCount(3) Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+UsagePage(GenericDesktop) Usage(Keyboard) Collection(Application)
+	ReportId(2) UsagePage(Keyboard) UsageMinimum(224) UsageMaximum(231) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(8) Input(Data, Var, Abs) ReportSize(8) ReportCount(1) Input(Cnst)
+	UsageMinimum(0) UsageMaximum(101) LogicalMaximum(101) ReportSize(8) ReportCount(6) Input(Data, Ary, Abs)
+	UsagePage(Led) UsageMinimum(NumLock) UsageMaximum(Kana) ReportSize(1) ReportCount(5) Output(Data, Var, Abs)
+	ReportSize(3) ReportCount(1) Output(Cnst)
+EndCollection
+UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application)
+	ReportId(3) Usage(X) Usage(Y) LogicalMinimum(-2048) LogicalMaximum(2047) PhysicalMinimum(-90) PhysicalMaximum(90)
+	Unit(EngRot) UnitExponent(-2) ReportSize(12) ReportCount(2) Input(Data, Var, Abs)
+	Unit(None) UsagePage(Button) UsageMinimum(1) UsageMaximum(16) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(16) Input(Data, Var, Abs)
+EndCollection
+)";
+
+
+/** Source code with parameters for the item list benchmark (one parameter set per product variant). */
+static const char variantSrc[] = R"(
+UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application)
+	ReportId({id}) Usage(X) Usage(Y) Usage(Z) Usage(Rz) LogicalMinimum({axisMin}) LogicalMaximum({axisMax})
+	ReportSize({axisBits}) ReportCount(4) Input(Data, Var, Abs)
+	UsagePage(Button) UsageMinimum(1) UsageMaximum({buttons}) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount({buttons}) Input(Data, Var, Abs)
+	ReportSize({padding}) ReportCount(1) Input(Cnst)
+	UsagePage(Led) UsageMinimum(1) UsageMaximum({leds}) ReportSize(1) ReportCount({leds}) Output(Data, Var, Abs)
+	ReportSize(8) ReportCount(1) Output(Cnst)
+EndCollection
+UsagePage(Consumer) Usage(ConsumerControl) Collection(Application)
+	ReportId({consumerId}) LogicalMinimum(0) LogicalMaximum({keys}) UsageMinimum(0) UsageMaximum({keys})
+	ReportSize(16) ReportCount(1) Input(Data, Ary, Abs)
+EndCollection
+)";
+
+
+/** Compile policies with a single disabled feature group. */
+struct NoUnitsPolicy : hid::FullPolicy { static constexpr bool units = false; };
+struct NoParamsPolicy : hid::FullPolicy { static constexpr bool params = false; };
+struct NoHexPolicy : hid::FullPolicy { static constexpr bool hex = false; };
+struct NoCommentsPolicy : hid::FullPolicy { static constexpr bool comments = false; };
+struct NoChecksPolicy : hid::FullPolicy { static constexpr bool checks = false; };
+
+
+/** Source code container for runtime compilation. */
+struct TextSource {
+	const char * text; /**< source code */
+	size_t length; /**< source code length */
+
+	const char * data() const noexcept {
+		return this->text;
+	}
+
+	size_t size() const noexcept {
+		return this->length;
+	}
+
+	hid::detail::ParamMatch find(const hid::detail::Token &) const noexcept {
+		return hid::detail::ParamMatch{0, false};
+	}
+};
+
+
+/**
+ * Measures the runtime compiler throughput.
+ *
+ * @param[in] repeat - number of concatenated copies of `compileSrc`
+ * @return true on success, else false
+ */
+static bool benchCompile(const size_t repeat) {
+	std::vector<char> text;
+	for (size_t i = 0; i < repeat; i++) {
+		text.insert(text.end(), compileSrc, compileSrc + sizeof(compileSrc) - 1);
+	}
+	const TextSource source{text.data(), text.size()};
+	std::vector<uint8_t> buffer(text.size());
+	size_t rounds = 0, size = 0;
+	const auto start = std::chrono::steady_clock::now();
+	double seconds = 0.0;
+	do {
+		hid::error::Info error;
+		hid::detail::BufferWriter out(buffer.data(), buffer.size());
+		if ( ! hid::compile(source, out, error) ) {
+			printf("Error: %s at %u:%u\n", hid::error::EMessageStr[error.message], unsigned(error.line), unsigned(error.column));
+			return false;
+		}
+		size = out.getPosition();
+		rounds++;
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (seconds < 1.0);
+	printf("compile: %u bytes source, %u bytes output, %.2f MB/s\n", unsigned(text.size()), unsigned(size), double(rounds * text.size()) / seconds / 1e6);
+	return true;
+}
+
+
+/**
+ * Compiles the given source with the given compile policy. All called functions are inlined
+ * here. Hence, the symbol size equals the code size of the compiler with this policy.
+ *
+ * @param[in] source - source code
+ * @param[out] out - output writer
+ * @param[out] error - possible error
+ * @return true on success, else false
+ * @tparam Policy - compile policy (see `hid::FullPolicy`)
+ */
+template <typename Policy>
+__attribute__((noinline, flatten)) bool compileWith(const TextSource & source, hid::detail::BufferWriter & out, hid::error::Info & error) {
+	return hid::compile<Policy>(source, out, error);
+}
+
+
+/**
+ * Measures the runtime compiler throughput with the given compile policy. The code size of each
+ * policy is printed by `make bench` from the symbol table (see `compileWith()`). The fastest
+ * round is reported as the average is dominated by scheduling noise.
+ *
+ * @param[in] name - policy name
+ * @param[in] repeat - number of concatenated copies of `leanSrc`
+ * @param[in,out] expected - compiled output of the first policy; all other policies shall match
+ * @return true on success, else false
+ * @tparam Policy - compile policy (see `hid::FullPolicy`)
+ */
+template <typename Policy>
+static bool benchPolicy(const char * name, const size_t repeat, std::vector<uint8_t> & expected) {
+	std::vector<char> text;
+	for (size_t i = 0; i < repeat; i++) {
+		text.insert(text.end(), leanSrc, leanSrc + sizeof(leanSrc) - 1);
+	}
+	const TextSource source{text.data(), text.size()};
+	std::vector<uint8_t> buffer(text.size());
+	size_t size = 0;
+	const auto start = std::chrono::steady_clock::now();
+	double seconds = 0.0, best = 0.0;
+	do {
+		hid::error::Info error;
+		hid::detail::BufferWriter out(buffer.data(), buffer.size());
+		const auto round = std::chrono::steady_clock::now();
+		if ( ! compileWith<Policy>(source, out, error) ) {
+			printf("Error: %s at %u:%u with %s\n", hid::error::EMessageStr[error.message], unsigned(error.line), unsigned(error.column), name);
+			return false;
+		}
+		const auto now = std::chrono::steady_clock::now();
+		const double elapsed = std::chrono::duration<double>(now - round).count();
+		if (best <= 0.0 || elapsed < best) {
+			best = elapsed;
+		}
+		size = out.getPosition();
+		seconds = std::chrono::duration<double>(now - start).count();
+	} while (seconds < 0.5);
+	buffer.resize(size);
+	if ( expected.empty() ) {
+		expected = buffer;
+	} else if (buffer != expected) {
+		printf("Error: Compiled output differs with %s.\n", name);
+		return false;
+	}
+	printf("compile<%s>: %.2f MB/s\n", name, double(text.size()) / best / 1e6);
+	return true;
+}
+
+
+/**
+ * Measures the build cost of many product variants of the same source code. Compares
+ * compiling each parameter set with lowering once to a `hid::ItemList` and binding each set.
+ *
+ * @param[in] variants - number of parameter sets
+ * @return true on success, else false
+ */
+static bool benchVariants(const size_t variants) {
+	enum { ParamCount = 10 };
+	std::vector<hid::detail::Param> params;
+	for (size_t v = 0; v < variants; v++) {
+		const int64_t bits = int64_t(8 + (v % 9));
+		const int64_t buttons = int64_t(4 + (v % 29));
+		const hid::detail::Param set[ParamCount] = {
+			{"id", int64_t(1 + (v % 3))},
+			{"axisMin", -(INT64_C(1) << (bits - 1))},
+			{"axisMax", (INT64_C(1) << (bits - 1)) - 1},
+			{"axisBits", bits},
+			{"buttons", buttons},
+			{"padding", (8 - (buttons % 8)) % 8 + 8},
+			{"leds", int64_t(1 + (v % 5))},
+			{"consumerId", int64_t(4 + (v % 3))},
+			{"keys", int64_t(0xFF << (v % 3))},
+			{"unused", int64_t(v)}
+		};
+		params.insert(params.end(), set, set + ParamCount);
+	}
+	std::vector<uint8_t> compiled(variants * 256), bound(variants * 256);
+	std::vector<size_t> compiledSize(variants), boundSize(variants);
+	hid::error::Info error;
+	/* compile each parameter set */
+	size_t rounds = 0;
+	auto start = std::chrono::steady_clock::now();
+	double compileSeconds = 0.0;
+	do {
+		for (size_t v = 0; v < variants; v++) {
+			hid::detail::BufferWriter out(compiled.data() + (v * 256), 256);
+			if ( ! hid::compile(hid::SourceView(variantSrc, sizeof(variantSrc) - 1, params.data() + (v * ParamCount), ParamCount), out, error) ) {
+				printf("Error: %s at %u:%u\n", hid::error::EMessageStr[error.message], unsigned(error.line), unsigned(error.column));
+				return false;
+			}
+			compiledSize[v] = out.getPosition();
+		}
+		rounds++;
+		compileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (compileSeconds < 0.5);
+	compileSeconds /= double(rounds);
+	/* lower once and bind each parameter set */
+	rounds = 0;
+	start = std::chrono::steady_clock::now();
+	double bindSeconds = 0.0;
+	do {
+		const hid::ItemList<256, 32, 32> list(hid::SourceView(variantSrc, sizeof(variantSrc) - 1));
+		for (size_t v = 0; v < variants; v++) {
+			hid::detail::BufferWriter out(bound.data() + (v * 256), 256);
+			if ( ! list.bind(params.data() + (v * ParamCount), ParamCount, out, error) ) {
+				printf("Error: %s at %u:%u with hid::ItemList\n", hid::error::EMessageStr[error.message], unsigned(error.line), unsigned(error.column));
+				return false;
+			}
+			boundSize[v] = out.getPosition();
+		}
+		rounds++;
+		bindSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (bindSeconds < 0.5);
+	bindSeconds /= double(rounds);
+	if (compiledSize != boundSize || compiled != bound) {
+		printf("Error: Bound variants differ from the compiled ones.\n");
+		return false;
+	}
+	printf(
+		"variants: %u parameter sets, compile %.1f us, lower and bind %.1f us (%.1fx)\n",
+		unsigned(variants),
+		compileSeconds * 1e6,
+		bindSeconds * 1e6,
+		compileSeconds / bindSeconds
+	);
+	return true;
+}
+
+
+/**
+ * Decodes the given report by walking the descriptor items. Reference for `benchDecode()`.
+ * 
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] reportId - report ID or 0 if not used
+ * @param[in] data - report data without report ID
+ * @param[out] out - receives the decoded values
+ * @return number of decoded values
+ */
+static size_t naiveDecode(const uint8_t * desc, const size_t len, const uint8_t reportId, const uint8_t * data, int32_t * out) {
+	hid::FieldReader fields(desc, len);
+	hid::ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	size_t n = 0;
+	while ( fields.next(field) ) {
+		if (field.type != hid::RT_INPUT || field.reportId != reportId || field.isConstant() || field.size == 0 || field.size > 32) {
+			continue;
+		}
+		for (uint32_t i = 0; i < field.count; i++) {
+			const uint32_t offset = field.bitOffset + (i * field.size);
+			out[n++] = field.isSigned() ? hid::readSignedBits(data, offset, field.size) : int32_t(hid::readBits(data, offset, field.size));
+		}
+	}
+	return n;
+}
+
+
+/**
+ * Compares the decode program of the given descriptor against a naive walk of its items.
+ * 
+ * @param[in] name - descriptor name for the output
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @param[in] reportId - report ID or 0 if not used
+ * @return true on equal results, else false
+ */
+static bool benchDecode(const char * name, const uint8_t * desc, const size_t len, const uint8_t reportId) {
+	enum { REPORTS = 1024 };
+	const hid::Layout layout(desc, len);
+	const hid::Layout::Report & report = layout.report(reportId);
+	std::vector<uint8_t> data(size_t(REPORTS) * report.bytes);
+	uint32_t seed = 7;
+	for (uint8_t & value : data) {
+		seed = (seed * 1103515245) + 12345;
+		value = uint8_t(seed >> 16);
+	}
+	std::vector<int32_t> expected(size_t(REPORTS) * report.count), actual(expected.size());
+	for (size_t r = 0; r < REPORTS; r++) {
+		if (naiveDecode(desc, len, reportId, data.data() + (r * report.bytes), expected.data() + (r * report.count)) != report.count) {
+			printf("Error: Value count mismatch for %s.\n", name);
+			return false;
+		}
+		layout.decode(report, data.data() + (r * report.bytes), actual.data() + (r * report.count));
+	}
+	if (expected != actual) {
+		printf("Error: Decoded values differ for %s.\n", name);
+		return false;
+	}
+	double seconds[2] = {0.0, 0.0};
+	uint64_t checksum = 0;
+	size_t rounds[2] = {0, 0};
+	for (size_t m = 0; m < 2; m++) {
+		const auto start = std::chrono::steady_clock::now();
+		do {
+			for (size_t r = 0; r < REPORTS; r++) {
+				int32_t * out = actual.data() + (r * report.count);
+				if (m == 0) {
+					naiveDecode(desc, len, reportId, data.data() + (r * report.bytes), out);
+				} else {
+					layout.decode(report, data.data() + (r * report.bytes), out);
+				}
+			}
+			checksum += uint64_t(int64_t(actual[rounds[m] % actual.size()]));
+			rounds[m]++;
+			seconds[m] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} while (seconds[m] < 0.25);
+	}
+	const double fields = double(REPORTS) * report.count;
+	printf(
+		"decode %-8s: %2u values, %2u instructions, naive %6.2f ns/value, program %6.2f ns/value (checksum %u)\n",
+		name,
+		unsigned(report.count),
+		unsigned(report.ops),
+		seconds[0] * 1e9 / (fields * double(rounds[0])),
+		seconds[1] * 1e9 / (fields * double(rounds[1])),
+		unsigned(checksum & 0xFF)
+	);
+	return true;
+}
+
+
+/** Synthetic report stream of a single device. */
+struct Stream {
+	std::vector<uint8_t> data; /**< concatenated reports */
+	std::vector<uint8_t> lengths; /**< report lengths */
+};
+
+
+/** Benchmark result. */
+struct Result {
+	double seconds; /**< elapsed wall clock time */
+	uint64_t records; /**< received records */
+	uint64_t checksum; /**< sum of all received values */
+	hid::PipelineStats stats; /**< pipeline statistics */
+};
+
+
+/**
+ * Creates a pseudo random report stream for the given device type.
+ * 
+ * @param[in] type - 0 for mouse, 1 for keyboard, 2 for gamepad
+ * @param[in] count - number of reports
+ * @param[in,out] seed - random number generator state
+ * @return report stream
+ */
+static Stream makeStream(const unsigned type, const size_t count, uint32_t & seed) {
+	Stream res;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t report[16];
+		size_t len = 0;
+		for (size_t n = 0; n < sizeof(report); n++) {
+			seed = (seed * 1103515245) + 12345;
+			report[n] = uint8_t(seed >> 16);
+		}
+		switch (type) {
+		case 0:
+			if ((report[1] & 7) == 0) {
+				report[0] = 2;
+				len = 3;
+			} else {
+				report[0] = 1;
+				len = 5;
+			}
+			break;
+		case 1:
+			len = 8;
+			break;
+		default:
+			report[0] = 3;
+			len = 9;
+			break;
+		}
+		res.data.insert(res.data.end(), report, report + len);
+		res.lengths.push_back(uint8_t(len));
+	}
+	return res;
+}
+
+
+/**
+ * Feeds all streams through a new pipeline.
+ * 
+ * @param[in] streams - report stream per device
+ * @param[in] workers - number of worker threads
+ * @param[in] producers - number of producer threads
+ * @return benchmark result
+ */
+static Result run(const std::vector<Stream> & streams, const size_t workers, const size_t producers) {
+	std::unique_ptr<hid::Pipeline<>> pipeline(new hid::Pipeline<>());
+	for (size_t d = 0; d < streams.size(); d++) {
+		switch (d % 3) {
+		case 0: pipeline->addDevice(mouseDesc); break;
+		case 1: pipeline->addDevice(keyboardDesc); break;
+		default: pipeline->addDevice(gamepadDesc); break;
+		}
+	}
+	Result res{0.0, 0, 0, hid::PipelineStats{0, 0, 0, 0}};
+	std::atomic<bool> done{false};
+	const auto start = std::chrono::steady_clock::now();
+	pipeline->start(workers);
+	std::thread consumer([&] {
+		std::unique_ptr<hid::Batch> batch(new hid::Batch());
+		for (;;) {
+			if ( pipeline->pop(*batch) ) {
+				res.records += batch->records;
+				const size_t values = size_t(batch->records) * batch->fields;
+				for (size_t i = 0; i < values; i++) {
+					res.checksum += uint64_t(int64_t(batch->values[i]));
+				}
+			} else if ( done ) {
+				break;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	});
+	std::vector<std::thread> feeders;
+	for (size_t p = 0; p < producers; p++) {
+		feeders.emplace_back([&, p] {
+			/* each producer owns the devices d with d % producers == p and interleaves them */
+			std::vector<size_t> offset(streams.size(), 0), index(streams.size(), 0);
+			for (bool more = true; more; ) {
+				more = false;
+				for (size_t d = p; d < streams.size(); d += producers) {
+					const Stream & stream = streams[d];
+					if (index[d] >= stream.lengths.size()) {
+						continue;
+					}
+					const uint8_t len = stream.lengths[index[d]];
+					while ( ! pipeline->push(uint32_t(d), stream.data.data() + offset[d], len) ) {
+						std::this_thread::yield();
+					}
+					offset[d] += len;
+					index[d]++;
+					more = true;
+				}
+			}
+		});
+	}
+	for (std::thread & feeder : feeders) {
+		feeder.join();
+	}
+	pipeline->stop();
+	done = true;
+	consumer.join();
+	res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	res.stats = pipeline->stats();
+	return res;
+}
+
+
+/**
+ * Measures the CPU time used by idle workers.
+ * 
+ * @param[in] workers - number of worker threads
+ * @return true if the idle workers are parked, else false
+ */
+static bool benchIdle(const size_t workers) {
+	std::unique_ptr<hid::Pipeline<>> pipeline(new hid::Pipeline<>());
+	pipeline->addDevice(mouseDesc);
+	pipeline->start(workers);
+	const std::clock_t start = std::clock();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	const double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+	pipeline->stop();
+	printf("idle workers: %2u, %.1f ms CPU time within 200 ms\n", unsigned(workers), seconds * 1000.0);
+	if (seconds > 0.02) {
+		printf("Error: Idle workers are not parked.\n");
+		return false;
+	}
+	return true;
+}
+
+
+int main(int argc, char ** argv) {
+	const size_t devices = (argc > 1) ? size_t(strtoul(argv[1], nullptr, 10)) : 300;
+	const size_t reports = (argc > 2) ? size_t(strtoul(argv[2], nullptr, 10)) : 2000;
+	const size_t producers = 2;
+	size_t maxWorkers = (argc > 3) ? size_t(strtoul(argv[3], nullptr, 10)) : size_t(std::thread::hardware_concurrency());
+	maxWorkers = (maxWorkers > 0) ? maxWorkers : 1;
+	if ( ! benchCompile(100) ) {
+		printf("Error: Failed to compile the benchmark source.\n");
+		return EXIT_FAILURE;
+	}
+	std::vector<uint8_t> expected;
+	if ( ! (benchPolicy<hid::FullPolicy>("FullPolicy", 100, expected)
+		&& benchPolicy<NoUnitsPolicy>("NoUnitsPolicy", 100, expected)
+		&& benchPolicy<NoParamsPolicy>("NoParamsPolicy", 100, expected)
+		&& benchPolicy<NoHexPolicy>("NoHexPolicy", 100, expected)
+		&& benchPolicy<NoCommentsPolicy>("NoCommentsPolicy", 100, expected)
+		&& benchPolicy<NoChecksPolicy>("NoChecksPolicy", 100, expected)
+		&& benchPolicy<hid::LeanPolicy>("LeanPolicy", 100, expected)) ) {
+		return EXIT_FAILURE;
+	}
+	if ( ! benchVariants(40) ) {
+		return EXIT_FAILURE;
+	}
+	if ( ! (benchDecode("mouse", mouseDesc.data, mouseDesc.size(), 1)
+		&& benchDecode("keyboard", keyboardDesc.data, keyboardDesc.size(), 0)
+		&& benchDecode("gamepad", gamepadDesc.data, gamepadDesc.size(), 3)
+		&& benchDecode("sensor", sensorDesc.data, sensorDesc.size(), 4)) ) {
+		return EXIT_FAILURE;
+	}
+	uint32_t seed = 1;
+	std::vector<Stream> streams;
+	for (size_t d = 0; d < devices; d++) {
+		streams.push_back(makeStream(unsigned(d % 3), reports, seed));
+	}
+	printf("devices: %u, reports per device: %u, producers: %u\n", unsigned(devices), unsigned(reports), unsigned(producers));
+	uint64_t checksum = 0;
+	bool ok = true;
+	for (size_t workers = 1; ; workers *= 2) {
+		if (workers > maxWorkers) {
+			workers = maxWorkers;
+		}
+		const Result res = run(streams, workers, producers);
+		printf(
+			"workers: %2u, %10.0f reports/s, records: %u, batches: %u, steals: %u, dropped: %u\n",
+			unsigned(workers),
+			double(res.records) / res.seconds,
+			unsigned(res.records),
+			unsigned(res.stats.batches),
+			unsigned(res.stats.steals),
+			unsigned(res.stats.dropped)
+		);
+		if (workers == 1) {
+			checksum = res.checksum;
+		}
+		ok = ok && res.records == (devices * reports) && res.stats.dropped == 0 && res.checksum == checksum;
+		if (workers >= maxWorkers) {
+			break;
+		}
+	}
+	if ( ! ok ) {
+		printf("Error: Decoded reports differ between runs.\n");
+		return EXIT_FAILURE;
+	}
+	if ( ! benchIdle(maxWorkers) ) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,754 @@
+/**
+ * @file grammar.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ *
+ * Generates valid random descriptor sources from the encoding maps and the rules of `compile()`.
+ * Each source is compiled at once, via `hid::Compiler` in random pieces and via `hid::ItemList`.
+ * The compiled descriptor is then checked with `hid::FieldReader` and `hid::Layout`.
+ * Descriptor `i` only depends on the seed and `i`. Hence, the results do not depend on the
+ * number of threads.
+ *
+ * Usage: grammar [-c] [-p] [-s seed] [-t threads] [-i index] [count]
+ * -c only compiles the sources at once (no cross-checks).
+ * -p prints the sources with their compiled bytes (single thread).
+ * -i starts at the given descriptor index (e.g. to reproduce a failure).
+ */
+#include "../src/HidPipeline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using hid::detail::encodingTable;
+
+
+/** Named argument of an encoding map. */
+struct Name {
+	std::string name; /**< name without index */
+	uint32_t first; /**< value of the name or first value of the indexed name */
+	uint32_t last; /**< value of the name or last value of the indexed name */
+};
+
+
+/** Usable names per encoding map ID. */
+static std::vector<Name> names[hid::detail::EncodingMapCount + 1];
+
+
+/**
+ * Collects the names of all encoding maps which can be written as argument.
+ */
+static void collectNames() {
+	for (uint8_t map = 1; map <= hid::detail::EncodingMapCount; map++) {
+		const size_t first = encodingTable.begin(map);
+		const size_t last = encodingTable.end(map);
+		for (size_t e = first; e < last; e++) {
+			const hid::detail::Token token = encodingTable.name(e);
+			std::string name(token.start, token.length);
+			const size_t idx = name.find('#');
+			if (idx != std::string::npos) {
+				/* only indexed names at the map start are resolved (see `findEncoding()`) */
+				if ((e - first) < 3 && (idx + 1) == name.size() && (e + 1) < last && name == std::string(encodingTable.name(e + 1).start, encodingTable.name(e + 1).length)) {
+					names[map].push_back(Name{name.substr(0, idx), encodingTable.value[e], encodingTable.value[e + 1]});
+					e++;
+				}
+				continue;
+			}
+			bool valid = name.size() > 0 && hid::detail::isItemChar(name[0]);
+			for (const char c : name) {
+				valid = valid && hid::detail::isArgChar(c);
+			}
+			if ( valid ) {
+				names[map].push_back(Name{name, encodingTable.value[e], encodingTable.value[e]});
+			}
+		}
+	}
+}
+
+
+/** Pseudo random number generator (SplitMix64). */
+class Random {
+private:
+	uint64_t state; /**< generator state */
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param[in] seed - initial state
+	 */
+	explicit Random(const uint64_t seed):
+		state{seed}
+	{}
+
+	/**
+	 * Returns the next random number.
+	 *
+	 * @return random number
+	 */
+	uint64_t next() {
+		uint64_t z = (this->state += UINT64_C(0x9E3779B97F4A7C15));
+		z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+		z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+		return z ^ (z >> 31);
+	}
+
+	/**
+	 * Returns a random number below the given limit.
+	 *
+	 * @param[in] limit - upper limit (exclusive)
+	 * @return random number
+	 */
+	uint32_t below(const uint32_t limit) {
+		return uint32_t(this->next() % limit);
+	}
+
+	/**
+	 * Returns true with the given probability.
+	 *
+	 * @param[in] percent - probability in percent
+	 * @return random boolean
+	 */
+	bool chance(const uint32_t percent) {
+		return this->below(100) < percent;
+	}
+};
+
+
+/** Number of user parameters per source. */
+enum { ParamCount = 4 };
+
+
+/**
+ * Random descriptor source generator. Only emits sources which pass `compile()` and which are
+ * semantically sound for the host parsers (e.g. report sizes of 1 to 32 bits).
+ */
+class Generator {
+private:
+	Random rnd; /**< random number generator */
+	std::string out; /**< generated source */
+	uint8_t page; /**< map ID of the last named usage page or 0 */
+	int level; /**< collection level */
+	bool useIds; /**< true if report IDs are used */
+	size_t strings; /**< number of distinct strings */
+	size_t designators; /**< number of designator names */
+	size_t mains; /**< number of main items */
+	bool used[ParamCount]; /**< true for user parameters with assigned value */
+public:
+	hid::detail::Param params[ParamCount]; /**< user parameters */
+private:
+	/** Appends a random separator. */
+	void space() {
+		static const char * const separators[] = {" ", " ", "\n", "\t", "\n\t", "  ", "\r\n"};
+		this->out += separators[this->rnd.below(7)];
+	}
+
+	/**
+	 * Appends the given item name with random letter case.
+	 *
+	 * @param[in] name - item name
+	 */
+	void item(const char * name) {
+		const bool mangle = this->rnd.chance(5);
+		for (const char * ptr = name; *ptr != 0; ptr++) {
+			this->out += (mangle && this->rnd.chance(50)) ? char(hid::detail::toLower(*ptr)) : *ptr;
+		}
+		if ( this->rnd.chance(5) ) {
+			this->out += ' ';
+		}
+	}
+
+	/**
+	 * Appends an unsigned number as decimal or hexadecimal literal.
+	 *
+	 * @param[in] value - value
+	 */
+	void number(const uint32_t value) {
+		char buf[16];
+		snprintf(buf, sizeof(buf), this->rnd.chance(30) ? (this->rnd.chance(50) ? "0x%X" : "0x%x") : "%u", unsigned(value));
+		this->out += buf;
+	}
+
+	/**
+	 * Appends a signed number as decimal or hexadecimal literal.
+	 *
+	 * @param[in] value - value
+	 */
+	void signedNumber(const int32_t value) {
+		if (value < 0) {
+			char buf[16];
+			snprintf(buf, sizeof(buf), "%d", int(value));
+			this->out += buf;
+		} else {
+			this->number(uint32_t(value));
+		}
+	}
+
+	/**
+	 * Appends an unsigned item argument list with the given value. Uses a user parameter in some
+	 * cases.
+	 *
+	 * @param[in] name - item name
+	 * @param[in] value - value
+	 */
+	void numItem(const char * name, const uint32_t value) {
+		this->item(name);
+		this->out += '(';
+		const size_t p = this->rnd.below(ParamCount);
+		if (this->rnd.chance(10) && (( ! this->used[p] ) || this->params[p].value == int64_t(value))) {
+			/* all uses of a parameter share its value */
+			this->used[p] = true;
+			this->params[p].value = int64_t(value);
+			this->out += '{';
+			this->out += this->params[p].name;
+			this->out += '}';
+		} else {
+			this->number(value);
+		}
+		this->out += ')';
+		this->space();
+	}
+
+	/**
+	 * Appends a signed item argument list with the given value.
+	 *
+	 * @param[in] name - item name
+	 * @param[in] value - value
+	 */
+	void signedItem(const char * name, const int32_t value) {
+		this->item(name);
+		this->out += '(';
+		this->signedNumber(value);
+		this->out += ')';
+		this->space();
+	}
+
+	/**
+	 * Appends a named argument of the given map.
+	 *
+	 * @param[in] map - encoding map ID
+	 * @return encoded value
+	 */
+	uint32_t name(const uint8_t map) {
+		const Name & entry = names[map][this->rnd.below(uint32_t(names[map].size()))];
+		this->out += entry.name;
+		if (entry.first == entry.last) {
+			return entry.first;
+		}
+		const uint32_t value = entry.first + this->rnd.below(entry.last - entry.first + 1);
+		this->out += std::to_string(value);
+		return value;
+	}
+
+	/**
+	 * Appends a usage argument.
+	 *
+	 * @return usage value
+	 */
+	uint32_t usageArg() {
+		if (this->page != 0 && ( ! names[this->page].empty() ) && this->rnd.chance(75)) {
+			return this->name(this->page);
+		}
+		const uint32_t value = this->rnd.below(0x10000);
+		this->number(value);
+		return value;
+	}
+
+	/** Appends a UsagePage item. */
+	void usagePage() {
+		this->item("UsagePage");
+		this->out += '(';
+		if ( this->rnd.chance(85) ) {
+			const Name & entry = names[hid::detail::EM_USAGE_PAGE][this->rnd.below(uint32_t(names[hid::detail::EM_USAGE_PAGE].size()))];
+			size_t e = encodingTable.begin(hid::detail::EM_USAGE_PAGE);
+			while (encodingTable.value[e] != entry.first) {
+				e++;
+			}
+			this->out += entry.name;
+			/* only named usage pages select the map for named usages */
+			this->page = encodingTable.arg[e];
+		} else {
+			this->number(0xFF00 + this->rnd.below(0x100));
+		}
+		this->out += ')';
+		this->space();
+	}
+
+	/** Appends a Usage item. */
+	void usage() {
+		this->item("Usage");
+		this->out += '(';
+		this->usageArg();
+		this->out += ')';
+		this->space();
+	}
+
+	/** Appends local usage items for the next main item. */
+	void usages() {
+		switch (this->rnd.below(4)) {
+		case 0:
+			break;
+		case 1: {
+			/* usage range */
+			const uint32_t first = this->rnd.below(0x100);
+			this->numItem("UsageMinimum", first);
+			this->numItem("UsageMaximum", first + this->rnd.below(0x20));
+			break;
+		}
+		case 2:
+			if ( this->rnd.chance(20) ) {
+				/* alternative usages */
+				this->signedItem("Delimiter", 1);
+				for (uint32_t i = 1 + this->rnd.below(3); i > 0; i--) {
+					this->usage();
+				}
+				this->item("Delimiter");
+				this->out += "(Close)";
+				this->space();
+			}
+			break;
+		default:
+			for (uint32_t i = 1 + this->rnd.below(4); i > 0; i--) {
+				this->usage();
+			}
+			break;
+		}
+	}
+
+	/** Appends a Unit item. */
+	void unit() {
+		this->item("Unit");
+		this->out += '(';
+		if ( this->rnd.chance(10) ) {
+			this->number(this->rnd.below(0x10000000));
+		} else {
+			this->name(hid::detail::EM_UNIT_SYSTEM);
+			this->out += this->rnd.chance(10) ? " (" : "(";
+			for (const Name & unit : names[hid::detail::encodingMapId(hid::detail::unitMap)]) {
+				if ( this->rnd.chance(70) ) {
+					continue;
+				}
+				this->out += unit.name;
+				if ( this->rnd.chance(60) ) {
+					this->out += '^';
+					this->out += std::to_string(int(this->rnd.below(16)) - 8);
+				}
+				this->out += ' ';
+			}
+			this->out += ')';
+		}
+		this->out += ')';
+		this->space();
+	}
+
+	/** Appends random global items. */
+	void globals() {
+		const uint32_t mask = this->rnd.below(64);
+		if ((mask & 1) != 0) {
+			this->usagePage();
+		}
+		if ((mask & 2) != 0) {
+			int32_t lo = int32_t(this->rnd.below(0x1000)) - 0x800;
+			int32_t hi = lo + int32_t(this->rnd.below(0x1000));
+			if ( this->rnd.chance(20) ) {
+				lo = this->rnd.chance(50) ? int32_t(0x80000000) : 0;
+				hi = 0x7FFFFFFF;
+			}
+			this->signedItem("LogicalMinimum", lo);
+			this->signedItem("LogicalMaximum", hi);
+		}
+		if ((mask & 4) != 0) {
+			const int32_t lo = int32_t(this->rnd.below(0x10000)) - 0x8000;
+			this->signedItem("PhysicalMinimum", lo);
+			this->signedItem("PhysicalMaximum", lo + int32_t(this->rnd.below(0x10000)));
+		}
+		if ((mask & 8) != 0) {
+			this->unit();
+		}
+		if ((mask & 16) != 0) {
+			this->signedItem("UnitExponent", int32_t(this->rnd.below(16)) - 8);
+		}
+		if ((mask & 32) != 0 && this->useIds) {
+			this->numItem("ReportId", 1 + this->rnd.below(255));
+		}
+	}
+
+	/** Appends a main item with its report size and count. */
+	void main() {
+		static const uint32_t sizes[] = {1, 1, 2, 3, 4, 7, 8, 8, 12, 16, 16, 24, 32};
+		this->usages();
+		if ( this->rnd.chance(10) ) {
+			this->item("StringIndex");
+			this->out += "(\"Label " + std::to_string(this->rnd.below(8)) + "\")";
+			this->space();
+			this->strings++;
+		}
+		if (this->designators > 0 && this->rnd.chance(10)) {
+			this->item("DesignatorIndex");
+			this->out += "(\"d" + std::to_string(this->rnd.below(uint32_t(this->designators))) + "\")";
+			this->space();
+		}
+		/* ReportSize and ReportCount are needed in pairs */
+		if ( this->rnd.chance(50) ) {
+			this->numItem("ReportCount", 1 + this->rnd.below(8));
+			this->numItem("ReportSize", sizes[this->rnd.below(13)]);
+		} else {
+			this->numItem("ReportSize", sizes[this->rnd.below(13)]);
+			this->numItem("ReportCount", 1 + this->rnd.below(8));
+		}
+		const uint32_t type = this->rnd.below(5);
+		this->item((type < 3) ? "Input" : ((type == 3) ? "Output" : "Feature"));
+		this->out += '(';
+		if ( this->rnd.chance(10) ) {
+			this->number(this->rnd.below(0x200));
+		} else {
+			/* flags are listed as pairs of clear and set name */
+			const std::vector<Name> & flags = names[(type < 3) ? hid::detail::EM_INPUT_ARG : hid::detail::EM_OUTPUT_FEATURE_ARG];
+			const uint32_t pick = 1 + this->rnd.below((1 << (flags.size() / 2)) - 1);
+			const char * sep = "";
+			for (size_t f = 0; f < flags.size(); f += 2) {
+				if (((pick >> (f / 2)) & 1) != 0) {
+					this->out += sep;
+					this->out += flags[f + this->rnd.below(2)].name;
+					sep = this->rnd.chance(20) ? " , " : ", ";
+				}
+			}
+		}
+		this->out += ')';
+		this->mains++;
+		if ( this->rnd.chance(10) ) {
+			this->out += " @field" + std::to_string(this->mains);
+		}
+		this->space();
+	}
+
+	/**
+	 * Appends a collection with its content.
+	 *
+	 * @param[in] type - collection type (e.g. 1 for application collections)
+	 */
+	void collection(const uint32_t type) {
+		/* each collection needs a preceding Usage item */
+		if ( this->rnd.chance(30) ) {
+			this->usagePage();
+		}
+		this->usage();
+		this->item("Collection");
+		this->out += '(';
+		if (type == 1 || this->rnd.chance(80)) {
+			this->out += names[hid::detail::EM_COL_ARG][type].name;
+		} else {
+			this->number(type);
+		}
+		this->out += ')';
+		this->space();
+		this->level++;
+		if (this->level == 1 && this->useIds) {
+			this->numItem("ReportId", 1 + this->rnd.below(255));
+		}
+		for (uint32_t i = 1 + this->rnd.below(6); i > 0; i--) {
+			switch (this->rnd.below(10)) {
+			case 0:
+				if (this->level < 4) {
+					this->collection(this->rnd.below(7));
+					break;
+				}
+				/* fall-through */
+			case 1:
+				this->item("Push");
+				this->space();
+				this->globals();
+				this->main();
+				this->item("Pop");
+				this->space();
+				break;
+			case 2:
+				this->out += "# comment ";
+				this->out += std::to_string(i);
+				this->out += '\n';
+				break;
+			default:
+				this->globals();
+				this->main();
+				break;
+			}
+		}
+		this->level--;
+		this->item("EndCollection");
+		this->space();
+	}
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param[in] seed - generator seed
+	 * @param[in] index - descriptor index
+	 */
+	Generator(const uint64_t seed, const uint64_t index):
+		rnd(seed ^ (index * UINT64_C(0xD1B54A32D192ED03))),
+		out(),
+		page{0},
+		level{0},
+		useIds{false},
+		strings{0},
+		designators{0},
+		mains{0},
+		used{false, false, false, false},
+		params{{"p0", 0}, {"p1", 0}, {"p2", 0}, {"p3", 0}}
+	{}
+
+	/**
+	 * Generates the descriptor source.
+	 *
+	 * @return descriptor source
+	 */
+	const std::string & generate() {
+		this->useIds = this->rnd.chance(50);
+		if ( this->rnd.chance(10) ) {
+			this->out += "# generated descriptor\n";
+		}
+		if ( this->rnd.chance(10) ) {
+			/* physical descriptor sets with designator names for DesignatorIndex */
+			this->item("PhysicalSet");
+			this->out += '(';
+			this->name(hid::detail::EM_PHYSICAL_SET);
+			this->out += ", " + std::to_string(this->rnd.below(32)) + ')';
+			this->space();
+			for (uint32_t i = 1 + this->rnd.below(3); i > 0; i--) {
+				this->item("Designator");
+				this->out += "(\"d" + std::to_string(this->designators++) + "\", ";
+				this->out += names[hid::detail::EM_DESIGNATOR][this->rnd.below(38)].name;
+				this->out += ')';
+				this->space();
+			}
+		}
+		this->usagePage();
+		for (uint32_t i = 1 + this->rnd.below(3); i > 0; i--) {
+			this->collection(1);
+		}
+		return this->out;
+	}
+};
+
+
+/** Statistics of a worker thread. */
+struct Stats {
+	uint64_t sources; /**< checked sources */
+	uint64_t sourceBytes; /**< total source size */
+	uint64_t descBytes; /**< total compiled size */
+	uint64_t fields; /**< total report fields */
+};
+
+
+/**
+ * Checks the given source with the compilers and host parsers.
+ *
+ * @param[in] source - descriptor source
+ * @param[in] params - user parameters
+ * @param[in,out] rnd - random number generator for the piece sizes and report data
+ * @param[out] desc - receives the compiled descriptor
+ * @param[in,out] stats - statistics
+ * @param[in] full - also check the resumable compiler and the host parsers
+ * @return error message or `nullptr` on success
+ */
+static const char * checkSource(const std::string & source, const hid::detail::Param * params, Random & rnd, std::vector<uint8_t> & desc, Stats & stats, const bool full) {
+	static thread_local uint8_t buf[65536], pushBuf[65536];
+	static thread_local char msg[128];
+	const hid::SourceView view(source.data(), source.size(), params, ParamCount);
+	hid::detail::BufferWriter out(buf, sizeof(buf));
+	hid::Error error;
+	if (( ! hid::compile(view, out, error) ) || error.message != hid::error::E_NO_ERROR) {
+		snprintf(msg, sizeof(msg), "compile() failed at %u:%u with error %u", unsigned(error.line), unsigned(error.column), unsigned(error.message));
+		return msg;
+	}
+	desc.assign(buf, buf + out.getPosition());
+	stats.sources++;
+	stats.sourceBytes += source.size();
+	stats.descBytes += desc.size();
+	if ( ! full ) {
+		return nullptr;
+	}
+	/* resumable compiler with random piece sizes */
+	hid::detail::BufferWriter pushOut(pushBuf, sizeof(pushBuf));
+	hid::Compiler<hid::detail::BufferWriter, hid::SourceView> compiler(pushOut, view);
+	bool ok = true;
+	for (size_t n = 0; n < source.size(); ) {
+		const size_t piece = std::min(size_t(1 + rnd.below(64)), source.size() - n);
+		ok = compiler.feed(source.data() + n, piece) && ok;
+		n += piece;
+	}
+	ok = compiler.finish() && ok;
+	if (( ! ok ) || pushOut.getPosition() != desc.size() || memcmp(pushBuf, desc.data(), desc.size()) != 0) {
+		return "hid::Compiler output differs from compile()";
+	}
+	/* item list bound with the same parameters */
+	static thread_local std::unique_ptr<hid::ItemList<4096, 64, 64>> list;
+	list.reset(new hid::ItemList<4096, 64, 64>(hid::SourceView(source.data(), source.size())));
+	hid::detail::BufferWriter boundOut(pushBuf, sizeof(pushBuf));
+	if (( ! list->bind(params, ParamCount, boundOut, error) ) || boundOut.getPosition() != desc.size() || memcmp(pushBuf, desc.data(), desc.size()) != 0) {
+		snprintf(msg, sizeof(msg), "hid::ItemList output differs from compile() (error %u)", unsigned(error.message));
+		return msg;
+	}
+	/* decoded Input reports */
+	const hid::Layout layout(desc.data(), desc.size());
+	std::vector<hid::ReportField> inputs;
+	{
+		hid::FieldReader fields(desc.data(), desc.size());
+		hid::ReportField field{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		while ( fields.next(field) ) {
+			stats.fields++;
+			if (field.type == hid::RT_INPUT && ( ! field.isConstant() ) && field.size > 0 && field.size <= 32) {
+				inputs.push_back(field);
+			}
+		}
+	}
+	std::vector<uint8_t> report;
+	std::vector<int32_t> values;
+	for (size_t id = 0; id < 256; id++) {
+		const hid::Layout::Report & format = layout.report(uint8_t(id));
+		if (format.count == 0) {
+			continue;
+		}
+		report.resize(format.bytes);
+		for (uint8_t & b : report) {
+			b = uint8_t(rnd.next());
+		}
+		values.resize(format.count);
+		layout.decode(format, report.data(), values.data());
+		size_t v = 0;
+		for (const hid::ReportField & field : inputs) {
+			if (field.reportId != id) {
+				continue;
+			}
+			for (uint32_t i = 0; i < field.count; i++, v++) {
+				const uint32_t bit = field.bitOffset + (i * field.size);
+				const int32_t expected = field.isSigned() ? hid::readSignedBits(report.data(), bit, field.size) : int32_t(hid::readBits(report.data(), bit, field.size));
+				if (v >= values.size() || values[v] != expected) {
+					return "hid::Layout decoded value differs from hid::FieldReader";
+				}
+			}
+		}
+		if (v != values.size()) {
+			return "hid::Layout value count differs from hid::FieldReader";
+		}
+	}
+	return nullptr;
+}
+
+
+/**
+ * Prints the given source with its parameters and compiled bytes.
+ *
+ * @param[in] index - descriptor index
+ * @param[in] source - descriptor source
+ * @param[in] params - user parameters
+ * @param[in] desc - compiled descriptor
+ */
+static void printSource(const uint64_t index, const std::string & source, const hid::detail::Param * params, const std::vector<uint8_t> & desc) {
+	printf("# descriptor %llu:", static_cast<unsigned long long>(index));
+	for (size_t p = 0; p < ParamCount; p++) {
+		printf(" %s=%lld", params[p].name, static_cast<long long>(params[p].value));
+	}
+	printf("\n%s\n#", source.c_str());
+	for (size_t i = 0; i < desc.size(); i++) {
+		printf(" %02X", unsigned(desc[i]));
+	}
+	printf("\n\n");
+}
+
+
+int main(int argc, char ** argv) {
+	uint64_t seed = 1, first = 0, count = 100000;
+	size_t threads = 0;
+	bool full = true, print = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-c") == 0) {
+			full = false;
+		} else if (strcmp(argv[i], "-p") == 0) {
+			print = true;
+		} else if (strcmp(argv[i], "-s") == 0 && (i + 1) < argc) {
+			seed = strtoull(argv[++i], nullptr, 0);
+		} else if (strcmp(argv[i], "-t") == 0 && (i + 1) < argc) {
+			threads = size_t(strtoul(argv[++i], nullptr, 10));
+		} else if (strcmp(argv[i], "-i") == 0 && (i + 1) < argc) {
+			first = strtoull(argv[++i], nullptr, 10);
+		} else if (argv[i][0] != '-') {
+			count = strtoull(argv[i], nullptr, 10);
+		} else {
+			fprintf(stderr, "Usage: %s [-c] [-p] [-s seed] [-t threads] [-i index] [count]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+		threads = (threads > 0) ? threads : 1;
+	}
+	threads = print ? 1 : threads;
+	collectNames();
+	std::atomic<uint64_t> next{first};
+	std::atomic<uint64_t> failed{UINT64_MAX};
+	std::vector<Stats> stats(threads, Stats{0, 0, 0, 0});
+	const auto work = [&](const size_t worker) {
+		std::vector<uint8_t> desc;
+		for (uint64_t index = next++; index < (first + count) && index < failed; index = next++) {
+			Generator gen(seed, index);
+			const std::string & source = gen.generate();
+			Random rnd(seed + index);
+			const char * error = checkSource(source, gen.params, rnd, desc, stats[worker], full);
+			if (error != nullptr) {
+				uint64_t prev = failed;
+				while (index < prev && ( ! failed.compare_exchange_weak(prev, index) )) {}
+				continue;
+			}
+			if ( print ) {
+				printSource(index, source, gen.params, desc);
+			}
+		}
+	};
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (size_t i = 1; i < threads; i++) {
+		pool.emplace_back(work, i);
+	}
+	work(0);
+	for (std::thread & thread : pool) {
+		thread.join();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (failed != UINT64_MAX) {
+		/* reproduce the first failure */
+		Generator gen(seed, failed);
+		const std::string & source = gen.generate();
+		Random rnd(seed + failed);
+		std::vector<uint8_t> desc;
+		Stats unused{0, 0, 0, 0};
+		fprintf(stderr, "Error: Descriptor %llu of seed %llu: %s\n", static_cast<unsigned long long>(failed.load()), static_cast<unsigned long long>(seed), checkSource(source, gen.params, rnd, desc, unused, full));
+		printSource(failed, source, gen.params, desc);
+		return EXIT_FAILURE;
+	}
+	Stats total{0, 0, 0, 0};
+	for (const Stats & s : stats) {
+		total.sources += s.sources;
+		total.sourceBytes += s.sourceBytes;
+		total.descBytes += s.descBytes;
+		total.fields += s.fields;
+	}
+	fprintf(
+		print ? stderr : stdout,
+		"grammar: %llu descriptors with %llu fields, %u threads, %.2f M descriptors/min (%.1f MB/s source, %.1f MB/s compiled)\n",
+		static_cast<unsigned long long>(total.sources),
+		static_cast<unsigned long long>(total.fields),
+		unsigned(threads),
+		double(total.sources) * 60.0 / (seconds * 1e6),
+		double(total.sourceBytes) / (seconds * 1e6),
+		double(total.descBytes) / (seconds * 1e6)
+	);
+	return EXIT_SUCCESS;
+}
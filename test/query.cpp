@@ -0,0 +1,325 @@
+/**
+ * @file query.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ */
+#include "../src/HidQuery.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+/** Mouse with buttons, relative axes and a consumer control report. */
+DEF_HID_DESCRIPTOR_AS(
+	static mouseDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) Usage(Pointer) Collection(Physical)
+		UsagePage(Button) UsageMinimum(1) UsageMaximum(5) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(5) Input(Data, Var, Abs) ReportSize(3) ReportCount(1) Input(Cnst)
+		UsagePage(GenericDesktop) Usage(X) Usage(Y) Usage(Wheel) LogicalMinimum(-127) LogicalMaximum(127)
+		ReportSize(8) ReportCount(3) Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+UsagePage(Consumer) Usage(ConsumerControl) Collection(Application)
+	ReportId(2) LogicalMinimum(0) LogicalMaximum(0x3FF) UsageMinimum(0) UsageMaximum(0x3FF)
+	ReportSize(16) ReportCount(1) Input(Data, Ary, Abs)
+EndCollection
+)")
+);
+
+
+/** Later revision of the mouse with a different report layout. */
+DEF_HID_DESCRIPTOR_AS(
+	static mouseV2Desc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(7) Usage(Pointer) Collection(Physical)
+		Usage(Wheel) Usage(Y) Usage(X) LogicalMinimum(-32767) LogicalMaximum(32767)
+		ReportSize(16) ReportCount(3) Input(Data, Var, Rel)
+		UsagePage(Button) UsageMinimum(1) UsageMaximum(3) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(3) Input(Data, Var, Abs) ReportSize(5) ReportCount(1) Input(Cnst)
+	EndCollection
+EndCollection
+)")
+);
+
+
+/** Decoded mouse report. */
+struct Motion {
+	uint8_t buttons; /**< button 1 to 3 in bit 0 to 2 */
+	int32_t x; /**< X axis */
+	int32_t y; /**< Y axis */
+	int32_t wheel; /**< wheel */
+};
+
+
+/** Expected query result. */
+struct Expected {
+	uint64_t records; /**< records with all queried fields */
+	uint64_t matches; /**< matching records */
+	double value; /**< aggregated value */
+};
+
+
+/**
+ * Returns the next pseudo random number.
+ *
+ * @param[in,out] seed - random number generator state
+ * @return random number
+ */
+static uint32_t nextRandom(uint32_t & seed) {
+	seed = (seed * 1103515245) + 12345;
+	return seed >> 8;
+}
+
+
+/**
+ * Creates a mouse motion stream with long button presses.
+ *
+ * @param[in] count - number of reports
+ * @param[in,out] seed - random number generator state
+ * @return motion stream
+ */
+static std::vector<Motion> motionCapture(const size_t count, uint32_t & seed) {
+	std::vector<Motion> res;
+	uint8_t buttons = 0;
+	for (size_t i = 0; i < count; i++) {
+		if ((nextRandom(seed) % 6000) == 0) {
+			buttons = uint8_t(buttons ^ (1 << (nextRandom(seed) % 3)));
+		}
+		res.push_back(Motion{buttons, int32_t(nextRandom(seed) % 41) - 20, int32_t(nextRandom(seed) % 9) - 4, ((nextRandom(seed) % 50) == 0) ? 1 : 0});
+	}
+	return res;
+}
+
+
+/**
+ * Writes the motion stream as trace file in the layout of the given descriptor version.
+ *
+ * @param[in] motion - motion stream
+ * @param[in] version - 1 for `mouseDesc` or 2 for `mouseV2Desc`
+ * @return trace file data
+ */
+static std::vector<uint8_t> writeTrace(const std::vector<Motion> & motion, const int version) {
+	hid::TraceVectorSink sink;
+	const uint8_t * desc = (version == 1) ? mouseDesc.data : mouseV2Desc.data;
+	const size_t len = (version == 1) ? mouseDesc.size() : mouseV2Desc.size();
+	hid::TraceWriter<hid::TraceVectorSink> writer(sink, desc, len);
+	uint64_t time = 0;
+	for (size_t i = 0; i < motion.size(); i++) {
+		const Motion & m = motion[i];
+		uint8_t report[8] = {0};
+		time += 1000;
+		if (version == 1) {
+			if ((i % 97) == 0) {
+				/* consumer control reports do not contain the queried fields */
+				const uint8_t consumer[] = {2, 0xE9, 0x00};
+				writer.add(time, consumer, sizeof(consumer));
+			}
+			report[0] = 1;
+			report[1] = m.buttons;
+			report[2] = uint8_t(int8_t(m.x));
+			report[3] = uint8_t(int8_t(m.y));
+			report[4] = uint8_t(int8_t(m.wheel));
+			writer.add(time, report, 5);
+		} else {
+			report[0] = 7;
+			hid::writeBits(report + 1, 0, 16, uint32_t(m.wheel));
+			hid::writeBits(report + 1, 16, 16, uint32_t(m.y));
+			hid::writeBits(report + 1, 32, 16, uint32_t(m.x));
+			report[7] = m.buttons;
+			writer.add(time, report, 8);
+		}
+	}
+	writer.finish();
+	return sink.data;
+}
+
+
+/**
+ * Returns the expected result of the given query.
+ *
+ * @param[in] motion - motion stream
+ * @param[in] function - aggregate function
+ * @param[in] field - aggregated value
+ * @param[in] filter - record filter
+ * @return expected result
+ */
+static Expected expect(const std::vector<Motion> & motion, const hid::QueryAggregate function, int32_t (* field)(const Motion &), bool (* filter)(const Motion &)) {
+	Expected res{motion.size(), 0, 0.0};
+	int64_t sum = 0;
+	int32_t lo = INT32_MAX, hi = INT32_MIN;
+	for (const Motion & m : motion) {
+		if ( ! filter(m) ) {
+			continue;
+		}
+		const int32_t val = field(m);
+		res.matches++;
+		sum += val;
+		lo = (val < lo) ? val : lo;
+		hi = (val > hi) ? val : hi;
+	}
+	switch (function) {
+	case hid::QA_COUNT: res.value = double(res.matches); break;
+	case hid::QA_MIN: res.value = double(lo); break;
+	case hid::QA_MAX: res.value = double(hi); break;
+	case hid::QA_SUM: res.value = double(sum); break;
+	default: res.value = double(sum) / double(res.matches); break;
+	}
+	res.value = (res.matches == 0 && function != hid::QA_COUNT) ? 0.0 : res.value;
+	return res;
+}
+
+
+/**
+ * Checks the query result of each trace file.
+ *
+ * @param[in] text - query text
+ * @param[in] traces - trace files
+ * @param[in] expected - expected result per trace file
+ * @return true on success, else false
+ */
+static bool checkQuery(const char * text, const std::vector<const hid::TraceReader *> & traces, const std::vector<Expected> & expected) {
+	const hid::Query query(text);
+	if ( ! query.valid() ) {
+		printf("Error: Failed to parse \"%s\": %s\n", text, query.error());
+		return false;
+	}
+	for (const size_t threads : {size_t(1), size_t(3)}) {
+		const std::vector<hid::QueryResult> results = query.run(traces, threads);
+		for (size_t t = 0; t < traces.size(); t++) {
+			const hid::QueryResult & res = results[t];
+			if (res.records != expected[t].records || res.matches != expected[t].matches || query.value(res) != expected[t].value || res.invalid != 0) {
+				printf(
+					"Error: Query \"%s\" on trace %u returned %u/%u records with %g instead of %u/%u records with %g.\n",
+					text,
+					unsigned(t),
+					unsigned(res.matches),
+					unsigned(res.records),
+					query.value(res),
+					unsigned(expected[t].matches),
+					unsigned(expected[t].records),
+					expected[t].value
+				);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Checks that the given query is rejected.
+ *
+ * @param[in] text - query text
+ * @param[in] position - expected error position
+ * @return true on success, else false
+ */
+static bool checkInvalid(const char * text, const size_t position) {
+	const hid::Query query(text);
+	if (query.valid() || query.errorPosition() != position) {
+		printf("Error: Invalid query \"%s\" was not rejected at %u.\n", text, unsigned(position));
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * Measures the query throughput.
+ *
+ * @param[in] text - query text
+ * @param[in] traces - trace files
+ * @param[in] threads - number of threads (0 for the number of hardware threads)
+ */
+static void benchQuery(const char * text, const std::vector<const hid::TraceReader *> & traces, const size_t threads) {
+	const hid::Query query(text);
+	std::vector<hid::QueryResult> results;
+	double seconds = 0.0;
+	size_t rounds = 0;
+	const auto start = std::chrono::steady_clock::now();
+	do {
+		results = query.run(traces, threads);
+		rounds++;
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (seconds < 0.25);
+	uint64_t records = 0;
+	uint32_t blocks = 0, skipped = 0;
+	for (const hid::QueryResult & res : results) {
+		records += res.records;
+		blocks += res.blocks;
+		skipped += res.skipped;
+	}
+	printf(
+		"query %-45s: %u threads, %7.0f M records/s, %4u decoded, %4u skipped blocks\n",
+		text,
+		unsigned(threads),
+		double(records) * double(rounds) / (seconds * 1e6),
+		unsigned(blocks),
+		unsigned(skipped)
+	);
+}
+
+
+int main(int argc, char ** argv) {
+	const size_t reports = (argc > 1) ? size_t(strtoul(argv[1], nullptr, 10)) : 200000;
+	uint32_t seed = 1;
+	const std::vector<Motion> motion[3] = {motionCapture(reports, seed), motionCapture(reports, seed), motionCapture(reports / 3, seed)};
+	const std::vector<uint8_t> data[3] = {writeTrace(motion[0], 1), writeTrace(motion[1], 2), writeTrace(motion[2], 2)};
+	const hid::TraceReader reader[3] = {
+		hid::TraceReader(data[0].data(), data[0].size()),
+		hid::TraceReader(data[1].data(), data[1].size()),
+		hid::TraceReader(data[2].data(), data[2].size())
+	};
+	const std::vector<const hid::TraceReader *> traces{&reader[0], &reader[1], &reader[2]};
+	int32_t (* const x)(const Motion &) = [](const Motion & m) { return m.x; };
+	int32_t (* const y)(const Motion &) = [](const Motion & m) { return m.y; };
+	int32_t (* const wheel)(const Motion &) = [](const Motion & m) { return m.wheel; };
+	bool (* const all)(const Motion &) = [](const Motion &) { return true; };
+	bool (* const button1)(const Motion &) = [](const Motion & m) { return (m.buttons & 1) != 0; };
+	const auto expectAll = [&](const hid::QueryAggregate function, int32_t (* field)(const Motion &), bool (* filter)(const Motion &)) {
+		std::vector<Expected> res;
+		for (const std::vector<Motion> & m : motion) {
+			res.push_back(expect(m, function, field, filter));
+		}
+		return res;
+	};
+	const std::vector<Expected> none(3, Expected{0, 0, 0.0});
+	bool ok = reader[0].valid() && reader[1].valid() && reader[2].valid();
+	/* field names resolve per descriptor */
+	ok = ok && checkQuery("count(X)", traces, expectAll(hid::QA_COUNT, x, all));
+	ok = ok && checkQuery("max(X) where Button1 = 1", traces, expectAll(hid::QA_MAX, x, button1));
+	ok = ok && checkQuery("MAX(GenericDesktop.X) WHERE Button.Button1 == 1", traces, expectAll(hid::QA_MAX, x, button1));
+	ok = ok && checkQuery("min(0x10031) where 0x90001 != 0", traces, expectAll(hid::QA_MIN, y, button1));
+	ok = ok && checkQuery("sum(Wheel)", traces, expectAll(hid::QA_SUM, wheel, all));
+	ok = ok && checkQuery("min(X)", traces, expectAll(hid::QA_MIN, x, all));
+	ok = ok && checkQuery("count(Y) where Y > 0 and Button2 = 0", traces, expectAll(hid::QA_COUNT, y, [](const Motion & m) { return m.y > 0 && (m.buttons & 2) == 0; }));
+	ok = ok && checkQuery("avg(X) where Y <= -2 and Wheel >= 0", traces, expectAll(hid::QA_AVG, x, [](const Motion & m) { return m.y <= -2; }));
+	ok = ok && checkQuery("sum(Y) where X < -15 and Button3 = 1", traces, expectAll(hid::QA_SUM, y, [](const Motion & m) { return m.x < -15 && (m.buttons & 4) != 0; }));
+	ok = ok && checkQuery("max(Wheel) where X = 5 and Y != 0", traces, expectAll(hid::QA_MAX, wheel, [](const Motion & m) { return m.x == 5 && m.y != 0; }));
+	ok = ok && checkQuery("max(X) where Wheel > 1", traces, expectAll(hid::QA_MAX, x, [](const Motion &) { return false; }));
+	/* fields which do not exist */
+	ok = ok && checkQuery("max(Rz)", traces, none);
+	ok = ok && checkQuery("count() where Button4 = 1", traces, {expectAll(hid::QA_COUNT, x, [](const Motion &) { return false; })[0], none[1], none[2]});
+	ok = ok && checkQuery("count() where Consumer.X = 1", traces, none);
+	/* parsing errors */
+	ok = ok && checkInvalid("", 0) && checkInvalid("median(X)", 0) && checkInvalid("max()", 4) && checkInvalid("max(X", 5);
+	ok = ok && checkInvalid("max(X) when", 7) && checkInvalid("max(X) where", 12) && checkInvalid("max(X) where X ~ 1", 15);
+	ok = ok && checkInvalid("max(X) where X > -", 18) && checkInvalid("max(X) where X > 2147483648", 17) && checkInvalid("max(X) where X > 1 or Y > 1", 19);
+	ok = ok && hid::Query("count() where X > -2147483648").valid();
+	if ( ! ok ) {
+		return EXIT_FAILURE;
+	}
+	benchQuery("count()", traces, 1);
+	benchQuery("max(X) where Button1 = 1", traces, 1);
+	benchQuery("max(X) where Button1 = 1", traces, 0);
+	benchQuery("avg(X) where Y <= -2 and Wheel >= 0", traces, 1);
+	benchQuery("avg(X) where Y <= -2 and Wheel >= 0", traces, 0);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file stress.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ */
+#include "../src/HidDescriptor.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+
+/** Device with a button report, a replaceable position report and a mergeable motion report. */
+DEF_HID_DESCRIPTOR_AS(
+	static stressDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) UsagePage(Button) UsageMinimum(1) UsageMaximum(32) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(32) Input(Data, Var, Abs)
+	ReportId(2) UsagePage(GenericDesktop) Usage(X) Usage(Y) LogicalMinimum(0) LogicalMaximum(0x7FFFFFFF)
+	ReportSize(32) ReportCount(2) Input(Data, Var, Abs)
+	ReportId(3) Usage(Wheel) LogicalMinimum(-32767) LogicalMaximum(32767)
+	ReportSize(16) ReportCount(1) Input(Data, Var, Rel)
+EndCollection
+)")
+);
+
+
+/** Counts the position reports replaced by `pushLatest()`. */
+struct PositionStats : hid::NullReportStats {
+	uint32_t positions; /**< number of suppressed position reports; only written by the producer */
+	
+	/** Constructor. */
+	PositionStats() noexcept:
+		positions{0}
+	{}
+	
+	/**
+	 * @copydoc hid::NullReportStats::suppressed()
+	 */
+	inline void suppressed(const uint8_t reportId) noexcept {
+		if (reportId == 2) {
+			this->positions++;
+		}
+	}
+};
+
+
+/** Queue with slots sized from the descriptor. */
+typedef hid::ReportQueue<8, hid::maxReportSize(stressDesc.data, stressDesc.size(), hid::RT_INPUT), PositionStats> Queue;
+
+
+/** Merger of the motion report. */
+constexpr static const hid::ReportMerger<Queue::ReportSize> motionMerger(stressDesc.data, stressDesc.size(), 3);
+
+
+/**
+ * Writes a 32-bit value in little endian order.
+ * 
+ * @param[out] out - output buffer
+ * @param[in] val - value to write
+ */
+static void put32(uint8_t * out, const uint32_t val) {
+	for (size_t i = 0; i < 4; i++) {
+		out[i] = uint8_t(val >> (8 * i));
+	}
+}
+
+
+/**
+ * Reads a 32-bit value in little endian order.
+ * 
+ * @param[in] in - input buffer
+ * @return read value
+ */
+static uint32_t get32(const uint8_t * in) {
+	uint32_t res = 0;
+	for (size_t i = 0; i < 4; i++) {
+		res |= uint32_t(in[i]) << (8 * i);
+	}
+	return res;
+}
+
+
+/**
+ * Waits for the other thread. Yields first and sleeps after repeated attempts to
+ * make progress on single core hosts.
+ * 
+ * @param[in,out] attempts - number of previous attempts
+ */
+static void backoff(size_t & attempts) {
+	if (++attempts < 64) {
+		std::this_thread::yield();
+	} else {
+		std::this_thread::sleep_for(std::chrono::microseconds(1));
+	}
+}
+
+
+int main(int argc, char ** argv) {
+	const uint32_t count = (argc > 1) ? uint32_t(strtoul(argv[1], nullptr, 10)) : 2000000;
+	static Queue queue;
+	static_assert(Queue::ReportSize == 9, "unexpected slot size");
+	std::atomic<bool> done{false};
+	bool ok = true;
+	uint32_t received = 0, positions = 0, lastPosition = 0, motions = 0;
+	int64_t motion = 0, expectedMotion = 0;
+	/* consumer: plays the role of the USB interrupt service routine */
+	std::thread consumer([&] {
+		uint32_t next = 0;
+		size_t attempts = 0;
+		for (;;) {
+			const bool finished = done.load();
+			size_t len = 0;
+			const uint8_t * report = queue.front(len);
+			if (report == nullptr) {
+				if ( finished ) {
+					break;
+				}
+				backoff(attempts);
+				continue;
+			}
+			attempts = 0;
+			if (report[0] == 1) {
+				/* every button report needs to arrive in order */
+				ok = ok && len == 5 && get32(report + 1) == next;
+				next++;
+				received++;
+			} else if (report[0] == 2) {
+				/* position reports may be replaced but never reordered or torn */
+				const uint32_t x = get32(report + 1);
+				ok = ok && len == 9 && x == ~get32(report + 5) && (positions == 0 || x > lastPosition);
+				lastPosition = x;
+				positions++;
+			} else if (report[0] == 3) {
+				/* motion reports may be merged but the sum of all deltas is kept */
+				ok = ok && len == 3;
+				motion += int16_t(uint16_t(report[1] | (report[2] << 8)));
+				motions++;
+			} else {
+				ok = false;
+			}
+			queue.pop();
+		}
+	});
+	/* producer: plays the role of the main loop */
+	uint8_t report[8];
+	size_t attempts = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		put32(report, i);
+		for (attempts = 0; ! queue.push(1, report, 4); ) {
+			backoff(attempts);
+		}
+		put32(report, i + 1);
+		put32(report + 4, ~(i + 1));
+		for (attempts = 0; ! queue.pushLatest(2, report, 8); ) {
+			backoff(attempts);
+		}
+		for (uint32_t n = 0; n < 3; n++) {
+			const int16_t delta = int16_t(int32_t((i + n) % 5) - 1);
+			report[0] = uint8_t(delta);
+			report[1] = uint8_t(uint16_t(delta) >> 8);
+			for (attempts = 0; ! queue.pushMerged(3, report, 2, motionMerger); ) {
+				backoff(attempts);
+			}
+			expectedMotion += delta;
+		}
+	}
+	done = true;
+	consumer.join();
+	/* each position report is either sent or suppressed, never both */
+	const uint32_t suppressed = queue.stats().positions;
+	ok = ok && received == count && lastPosition == count && (positions + suppressed) == count && motion == expectedMotion && motions <= (3 * count);
+	printf("button reports: %u, position reports: %u sent, %u suppressed of %u, motion reports: %u of %u\n", unsigned(received), unsigned(positions), unsigned(suppressed), unsigned(count), unsigned(motions), unsigned(3 * count));
+	if ( ! ok ) {
+		printf("Error: Report queue stress test failed.\n");
+		return EXIT_FAILURE;
+	}
+	printf("OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,450 @@
+/**
+ * @file trace.cpp
+ * @author Daniel Starke
+ * @copyright Copyright 2026 Daniel Starke
+ * @date 2026-10-17
+ * @version 2026-10-17
+ */
+#include "../src/HidTrace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+/** Mouse with buttons, relative axes and a consumer control report. */
+DEF_HID_DESCRIPTOR_AS(
+	static mouseDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Mouse) Collection(Application)
+	ReportId(1) Usage(Pointer) Collection(Physical)
+		UsagePage(Button) UsageMinimum(1) UsageMaximum(5) LogicalMinimum(0) LogicalMaximum(1)
+		ReportSize(1) ReportCount(5) Input(Data, Var, Abs) ReportSize(3) ReportCount(1) Input(Cnst)
+		UsagePage(GenericDesktop) Usage(X) Usage(Y) Usage(Wheel) LogicalMinimum(-127) LogicalMaximum(127)
+		ReportSize(8) ReportCount(3) Input(Data, Var, Rel)
+	EndCollection
+EndCollection
+UsagePage(Consumer) Usage(ConsumerControl) Collection(Application)
+	ReportId(2) LogicalMinimum(0) LogicalMaximum(0x3FF) UsageMinimum(0) UsageMaximum(0x3FF)
+	ReportSize(16) ReportCount(1) Input(Data, Ary, Abs)
+EndCollection
+)")
+);
+
+
+/** Gamepad with 12 bit absolute axes and 16 buttons. */
+DEF_HID_DESCRIPTOR_AS(
+	static gamepadDesc,
+	(R"(
+UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application)
+	Usage(X) Usage(Y) Usage(Z) Usage(Rz) LogicalMinimum(-2048) LogicalMaximum(2047)
+	ReportSize(12) ReportCount(4) Input(Data, Var, Abs)
+	UsagePage(Button) UsageMinimum(1) UsageMaximum(16) LogicalMinimum(0) LogicalMaximum(1)
+	ReportSize(1) ReportCount(16) Input(Data, Var, Abs)
+	UsagePage(GenericDesktop) Usage(Slider) LogicalMinimum(0) LogicalMaximum(0x7FFFFFFF)
+	ReportSize(32) ReportCount(1) Input(Data, Var, Abs)
+EndCollection
+)")
+);
+
+
+/** Recorded report stream. */
+struct Capture {
+	std::vector<uint64_t> times; /**< report timestamps */
+	std::vector<uint8_t> data; /**< concatenated reports */
+	std::vector<uint8_t> lengths; /**< report lengths */
+};
+
+
+/**
+ * Returns the next pseudo random number.
+ *
+ * @param[in,out] seed - random number generator state
+ * @return random number
+ */
+static uint32_t nextRandom(uint32_t & seed) {
+	seed = (seed * 1103515245) + 12345;
+	return seed >> 8;
+}
+
+
+/**
+ * Creates a mouse capture with occasional consumer control reports.
+ *
+ * @param[in] count - number of reports
+ * @param[in] noise - true for random report data, false for realistic data
+ * @param[in,out] seed - random number generator state
+ * @return capture
+ */
+static Capture mouseCapture(const size_t count, const bool noise, uint32_t & seed) {
+	Capture res;
+	uint64_t time = 1000;
+	uint8_t buttons = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t report[5];
+		size_t len = 5;
+		for (uint8_t & value : report) {
+			value = uint8_t(nextRandom(seed));
+		}
+		if ((nextRandom(seed) % 16) == 0) {
+			report[0] = 2;
+			len = 3;
+		} else if ( noise ) {
+			report[0] = 1;
+		} else {
+			report[0] = 1;
+			buttons = ((nextRandom(seed) % 64) == 0) ? uint8_t(buttons ^ 1) : buttons;
+			report[1] = buttons;
+			report[2] = uint8_t(int8_t(int(nextRandom(seed) % 9) - 4));
+			report[3] = uint8_t(int8_t(int(nextRandom(seed) % 9) - 4));
+			report[4] = 0;
+		}
+		/* 1 ms polling with rare pauses and a clock jump backwards */
+		time += ((i % 5000) == 4999) ? 0x100000000ULL : 1000;
+		if (i == (count / 2)) {
+			time -= 500000;
+		}
+		res.times.push_back(time);
+		res.data.insert(res.data.end(), report, report + len);
+		res.lengths.push_back(uint8_t(len));
+	}
+	return res;
+}
+
+
+/**
+ * Creates a gamepad capture.
+ *
+ * @param[in] count - number of reports
+ * @param[in] noise - true for random report data, false for realistic data
+ * @param[in,out] seed - random number generator state
+ * @return capture
+ */
+static Capture gamepadCapture(const size_t count, const bool noise, uint32_t & seed) {
+	Capture res;
+	int32_t axis[4] = {0, 100, -100, 2000};
+	uint16_t buttons = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t report[12];
+		for (uint8_t & value : report) {
+			value = uint8_t(nextRandom(seed));
+		}
+		if ( ! noise ) {
+			memset(report, 0, sizeof(report));
+			for (size_t a = 0; a < 4; a++) {
+				axis[a] += int32_t(nextRandom(seed) % 7) - 3;
+				axis[a] = (axis[a] < -2048) ? -2048 : ((axis[a] > 2047) ? 2047 : axis[a]);
+				hid::writeBits(report, uint32_t(a * 12), 12, uint32_t(axis[a]));
+			}
+			buttons = ((nextRandom(seed) % 128) == 0) ? uint16_t(buttons ^ (1 << (nextRandom(seed) % 16))) : buttons;
+			hid::writeBits(report, 48, 16, buttons);
+			hid::writeBits(report, 64, 32, 12345);
+		}
+		report[11] &= 0x7F;
+		res.times.push_back(uint64_t(i) * 125);
+		res.data.insert(res.data.end(), report, report + sizeof(report));
+		res.lengths.push_back(uint8_t(sizeof(report)));
+	}
+	return res;
+}
+
+
+/**
+ * Writes the capture as trace file.
+ *
+ * @param[in] capture - report stream
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @return trace file data
+ */
+static std::vector<uint8_t> writeTrace(const Capture & capture, const uint8_t * desc, const size_t len) {
+	hid::TraceVectorSink sink;
+	hid::TraceWriter<hid::TraceVectorSink> writer(sink, desc, len);
+	size_t offset = 0;
+	for (size_t i = 0; i < capture.times.size(); i++) {
+		writer.add(capture.times[i], capture.data.data() + offset, capture.lengths[i]);
+		offset += capture.lengths[i];
+	}
+	writer.finish();
+	return sink.data;
+}
+
+
+/**
+ * Checks that the trace file contains the records of the capture.
+ *
+ * @param[in] name - test name for the output
+ * @param[in] capture - report stream
+ * @param[in] trace - trace file data
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ * @return true on success, else false
+ */
+static bool checkTrace(const char * name, const Capture & capture, const std::vector<uint8_t> & trace, const uint8_t * desc, const size_t len) {
+	const hid::TraceReader reader(trace.data(), trace.size());
+	if (( ! reader.valid() ) || reader.descriptorHash() != hid::descriptorHash(desc, len) || reader.descriptorSize() != len || memcmp(reader.descriptor(), desc, len) != 0) {
+		printf("Error: Invalid trace header for %s.\n", name);
+		return false;
+	}
+	const hid::Layout layout(desc, len);
+	std::vector<uint64_t> times(hid::TraceBlockRecords);
+	std::vector<int32_t> values(hid::TraceBlockRecords), expected;
+	uint32_t codecs = 0;
+	for (size_t id = 0; id < 256; id++) {
+		const uint8_t reportId = uint8_t(id);
+		const hid::Layout::Report & format = layout.report(reportId);
+		/* expected records of this report ID in capture order */
+		std::vector<uint64_t> expectedTimes;
+		expected.clear();
+		size_t offset = 0;
+		for (size_t i = 0; i < capture.times.size(); offset += capture.lengths[i], i++) {
+			const uint8_t * data = capture.data.data() + offset;
+			if ((layout.usesReportIds() ? data[0] : 0) != reportId || format.count == 0) {
+				continue;
+			}
+			expectedTimes.push_back(capture.times[i]);
+			expected.resize(expected.size() + format.count);
+			layout.decode(format, data + (layout.usesReportIds() ? 1 : 0), expected.data() + expected.size() - format.count);
+		}
+		size_t record = 0;
+		for (size_t block = 0; block < reader.blockCount(); block++) {
+			/* file order equals capture order */
+			const hid::TraceBlock & entry = reader.block(block);
+			if (entry.reportId != reportId) {
+				continue;
+			}
+			if (reader.columnCount(block) != format.count || (record + entry.records) > expectedTimes.size()) {
+				printf("Error: Invalid block layout for %s.\n", name);
+				return false;
+			}
+			reader.decodeTimes(block, times.data());
+			for (size_t r = 0; r < entry.records; r++) {
+				if (times[r] != expectedTimes[record + r]) {
+					printf("Error: Timestamp mismatch for %s.\n", name);
+					return false;
+				}
+			}
+			for (size_t c = 0; c < format.count; c++) {
+				const hid::TraceColumn column = reader.column(block, c);
+				codecs |= uint32_t(1) << column.codec;
+				if ( ! reader.decodeColumn(block, c, values.data()) ) {
+					printf("Error: Failed to decode column %u for %s.\n", unsigned(c), name);
+					return false;
+				}
+				for (size_t r = 0; r < entry.records; r++) {
+					const int32_t val = expected[((record + r) * format.count) + c];
+					if (values[r] != val || val < column.min || val > column.max) {
+						printf("Error: Value mismatch in column %u for %s.\n", unsigned(c), name);
+						return false;
+					}
+				}
+			}
+			record += entry.records;
+		}
+		if (record != expectedTimes.size()) {
+			printf("Error: Record count mismatch for %s.\n", name);
+			return false;
+		}
+	}
+	printf("trace %-16s: %7u bytes, %4u blocks, codecs 0x%X\n", name, unsigned(trace.size()), unsigned(reader.blockCount()), unsigned(codecs));
+	return true;
+}
+
+
+/**
+ * Checks the time range seek. The trace is expected to contain a clock jump backwards.
+ *
+ * @param[in] trace - trace file data
+ * @return true on success, else false
+ */
+static bool checkSeek(const std::vector<uint8_t> & trace) {
+	const hid::TraceReader reader(trace.data(), trace.size());
+	const std::vector<uint32_t> & blocks = reader.blocks(1);
+	if (blocks.size() < 3 || reader.seek(1, 0) != 0 || reader.seek(1, UINT64_MAX) != blocks.size()) {
+		return false;
+	}
+	bool overlap = false;
+	for (size_t i = 1; i < blocks.size(); i++) {
+		const hid::TraceBlock & block = reader.block(blocks[i]);
+		const hid::TraceBlock & prev = reader.block(blocks[i - 1]);
+		if (block.firstTime < prev.firstTime) {
+			return false;
+		}
+		overlap = overlap || block.firstTime <= prev.lastTime;
+	}
+	if ( ! overlap ) {
+		printf("Error: Missing clock jump in the seek test.\n");
+		return false;
+	}
+	for (size_t i = 0; i < blocks.size(); i++) {
+		const hid::TraceBlock & block = reader.block(blocks[i]);
+		const uint64_t times[] = {block.firstTime, block.firstTime + 1, block.lastTime, block.lastTime + 1};
+		for (const uint64_t time : times) {
+			/* first position without any later record before it */
+			size_t expected = 0;
+			for (size_t j = 0; j < blocks.size(); j++) {
+				if (reader.block(blocks[j]).lastTime >= time) {
+					break;
+				}
+				expected = j + 1;
+			}
+			if (reader.seek(1, time) != expected) {
+				printf("Error: Seek to %llu returned block %u instead of %u.\n", static_cast<unsigned long long>(time), unsigned(reader.seek(1, time)), unsigned(expected));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Checks that corrupted trace files are rejected.
+ *
+ * @param[in] trace - valid trace file data
+ * @return true on success, else false
+ */
+static bool checkCorrupted(const std::vector<uint8_t> & trace) {
+	for (size_t cut = 0; cut < trace.size(); cut += 1 + (cut / 4)) {
+		if ( hid::TraceReader(trace.data(), cut).valid() ) {
+			printf("Error: Truncated trace file at %u was accepted.\n", unsigned(cut));
+			return false;
+		}
+	}
+	std::vector<uint8_t> bad(trace);
+	bad[20] ^= 1; /* descriptor */
+	if ( hid::TraceReader(bad.data(), bad.size()).valid() ) {
+		printf("Error: Trace file with changed descriptor was accepted.\n");
+		return false;
+	}
+	bad = trace;
+	bad[bad.size() - 12] ^= 1; /* block count */
+	if ( hid::TraceReader(bad.data(), bad.size()).valid() ) {
+		printf("Error: Trace file with changed block count was accepted.\n");
+		return false;
+	}
+	bad = trace;
+	/* time column of the first block as TC_CONST without payload */
+	const size_t descLength = size_t(trace[12]) | (size_t(trace[13]) << 8) | (size_t(trace[14]) << 16) | (size_t(trace[15]) << 24);
+	const size_t timeColumn = hid::detail::TraceHeaderSize + descLength + hid::detail::TraceBlockHeaderSize;
+	bad[timeColumn] = hid::TC_CONST;
+	memset(bad.data() + timeColumn + 24, 0, 4);
+	if ( hid::TraceReader(bad.data(), bad.size()).valid() ) {
+		printf("Error: Trace file with unpacked time column was accepted.\n");
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * Measures the writer and reader throughput.
+ *
+ * @param[in] name - test name for the output
+ * @param[in] capture - report stream
+ * @param[in] desc - compiled HID descriptor
+ * @param[in] len - descriptor length in bytes
+ */
+static void benchTrace(const char * name, const Capture & capture, const uint8_t * desc, const size_t len) {
+	double seconds[2] = {0.0, 0.0};
+	size_t rounds[2] = {0, 0};
+	std::vector<uint8_t> trace;
+	auto start = std::chrono::steady_clock::now();
+	do {
+		trace = writeTrace(capture, desc, len);
+		rounds[0]++;
+		seconds[0] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (seconds[0] < 0.25);
+	const hid::TraceReader reader(trace.data(), trace.size());
+	std::vector<uint64_t> times(hid::TraceBlockRecords);
+	std::vector<int32_t> values(hid::TraceBlockRecords);
+	uint64_t decoded = 0, checksum = 0;
+	start = std::chrono::steady_clock::now();
+	do {
+		for (size_t b = 0; b < reader.blockCount(); b++) {
+			const size_t records = reader.block(b).records;
+			reader.decodeTimes(b, times.data());
+			checksum += times[records - 1];
+			for (size_t c = 0; c < reader.columnCount(b); c++) {
+				reader.decodeColumn(b, c, values.data());
+				checksum += uint64_t(int64_t(values[records - 1]));
+				decoded += records;
+			}
+		}
+		rounds[1]++;
+		seconds[1] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (seconds[1] < 0.25);
+	const double raw = double(capture.data.size() + (8 * capture.times.size()));
+	printf(
+		"trace %-16s: ratio %5.1f, write %6.0f MB/s, read %7.0f MB/s (%5.0f M values/s, checksum %u)\n",
+		name,
+		raw / double(trace.size()),
+		raw * double(rounds[0]) / (seconds[0] * 1e6),
+		raw * double(rounds[1]) / (seconds[1] * 1e6),
+		double(decoded) / (seconds[1] * 1e6),
+		unsigned(checksum & 0xFF)
+	);
+}
+
+
+int main(int argc, char ** argv) {
+	const size_t reports = (argc > 1) ? size_t(strtoul(argv[1], nullptr, 10)) : 200000;
+	uint32_t seed = 1;
+	const Capture mouse = mouseCapture(reports, false, seed);
+	const Capture mouseNoise = mouseCapture(reports / 10, true, seed);
+	const Capture gamepad = gamepadCapture(reports, false, seed);
+	const Capture gamepadNoise = gamepadCapture(reports / 10, true, seed);
+	const std::vector<uint8_t> mouseTrace = writeTrace(mouse, mouseDesc.data, mouseDesc.size());
+	bool ok = checkTrace("mouse", mouse, mouseTrace, mouseDesc.data, mouseDesc.size())
+		&& checkTrace("mouse noise", mouseNoise, writeTrace(mouseNoise, mouseDesc.data, mouseDesc.size()), mouseDesc.data, mouseDesc.size())
+		&& checkTrace("gamepad", gamepad, writeTrace(gamepad, gamepadDesc.data, gamepadDesc.size()), gamepadDesc.data, gamepadDesc.size())
+		&& checkTrace("gamepad noise", gamepadNoise, writeTrace(gamepadNoise, gamepadDesc.data, gamepadDesc.size()), gamepadDesc.data, gamepadDesc.size());
+	if (ok && ( ! checkSeek(mouseTrace) )) {
+		printf("Error: Trace seek failed.\n");
+		ok = false;
+	}
+	ok = ok && checkCorrupted(writeTrace(gamepadCapture(100, false, seed), gamepadDesc.data, gamepadDesc.size()));
+	{
+		/* unknown report IDs and short reports are rejected */
+		hid::TraceVectorSink sink;
+		hid::TraceWriter<hid::TraceVectorSink> writer(sink, mouseDesc.data, mouseDesc.size());
+		const uint8_t unknown[] = {3, 0, 0, 0, 0};
+		const uint8_t consumer[] = {2, 0x10, 0x00};
+		ok = ok && ( ! writer.add(0, unknown, sizeof(unknown)) ) && ( ! writer.add(0, consumer, 2) ) && writer.add(0, consumer, 3);
+		ok = ok && writer.finish() && ( ! writer.add(1, consumer, 3) ) && writer.droppedReports() == 3 && writer.size() == sink.data.size();
+		if ( ! ok ) {
+			printf("Error: Trace writer accepted invalid reports.\n");
+		}
+	}
+	if ( ok ) {
+		/* round trip via a memory mapped file */
+		const char * path = "trace.hidt";
+		std::FILE * fd = fopen(path, "wb");
+		hid::TraceFileSink sink{fd};
+		ok = fd != nullptr;
+		if ( ok ) {
+			hid::TraceWriter<hid::TraceFileSink> writer(sink, gamepadDesc.data, gamepadDesc.size());
+			size_t offset = 0;
+			for (size_t i = 0; i < gamepad.times.size(); i++) {
+				writer.add(gamepad.times[i], gamepad.data.data() + offset, gamepad.lengths[i]);
+				offset += gamepad.lengths[i];
+			}
+			ok = writer.finish();
+			ok = (fclose(fd) == 0) && ok;
+		}
+		const hid::MappedFile file(path);
+		ok = ok && file.data() != nullptr && checkTrace("gamepad mapped", gamepad, std::vector<uint8_t>(file.data(), file.data() + file.size()), gamepadDesc.data, gamepadDesc.size());
+		remove(path);
+		if ( ! ok ) {
+			printf("Error: Memory mapped trace file failed.\n");
+		}
+	}
+	if ( ! ok ) {
+		return EXIT_FAILURE;
+	}
+	benchTrace("mouse", mouse, mouseDesc.data, mouseDesc.size());
+	benchTrace("gamepad", gamepad, gamepadDesc.data, gamepadDesc.size());
+	benchTrace("gamepad noise", gamepadNoise, gamepadDesc.data, gamepadDesc.size());
+	return EXIT_SUCCESS;
+}
@@ -3,7 +3,7 @@
  * @author Daniel Starke
  * @copyright Copyright 2022 Daniel Starke
  * @date 2022-07-07
- * @version 2022-07-21
+ * @version 2026-10-17
  */
 #include "../src/HidDescriptor.hpp"
 #include <cstdio>
@@ -43,9 +43,57 @@ DEF_HID_DESCRIPTOR_AS(
 static const uint8_t sanityCheckData[] = {
 	0x05, 0x09, 0x09, 0x14, 0xA1, 0x01, 0x66, 0x11, 0x02, 0x81, 0x07, 0x13, 0x01, 0xC0
 };
+
+
+/** Source code with multiple top-level collections for chunked compilation sanity check. */
+static constexpr const char sanityChunkSrc[] = R"(
+UsagePage(GenericDesktop)
+Usage(Mouse)
+Collection(Application)
+	ReportId(1) ReportSize(8) ReportCount(2)
+	Usage(X) Usage(Y) Input(Data, Var, Rel) @motion
+EndCollection # first chunk
+Usage(Keyboard)
+Collection(Application)
+	ReportId({id})
+	Usage(Pointer) Collection(Physical) Usage(X) EndCollection
+	Output(Cnst) @pad
+EndCollection
+Usage(Joystick)Collection(Application)EndCollection)";
+
+
+/** Compile time compiled descriptor for chunked compilation sanity check. */
+DEF_HID_DESCRIPTOR_AS(
+	static sanityChunkDesc,
+	(sanityChunkSrc)
+	("id", 2)
+);
+
+
+/** Compile time lowered item list for the item list sanity check. */
+DEF_HID_ITEM_LIST_AS(static sanityCheckItems, (sanityCheckSrc));
 #endif /* not NSANITY */
 
 
+/** Source code with string arguments for the string table tests. */
+#define STRING_TEST_SOURCE "UsagePage(Button) UsageMinimum(1) UsageMaximum(2) StringIndex(\"Left\") Usage(1) " \
+	"StringIndex(\"\xC3\x84\xF0\x9F\x8E\xAE\") Usage(2) StringMinimum(\"Left\") StringMaximum(\"#{x}\") Usage(3) StringIndex({x})"
+
+
+/** String descriptors of `STRING_TEST_SOURCE`. */
+DEF_HID_STRINGS_AS(static strings, (STRING_TEST_SOURCE));
+
+
+/** Source code with physical descriptor sets for the physical descriptor tests. */
+#define PHYSICAL_TEST_SOURCE "PhysicalSet(RightHand, 2) Designator(\"trigger\", IndexFinger, Right, 5) Designator(\"grip\", Palm, Right)\n" \
+	"PhysicalSet(LeftHand) Designator(\"grip\", Palm, Left)\n" \
+	"UsagePage(Button) DesignatorIndex(\"trigger\") Usage(1) DesignatorIndex(\"grip\") StringIndex(\"Grip\") Usage(2)"
+
+
+/** Physical descriptor sets of `PHYSICAL_TEST_SOURCE`. */
+DEF_HID_PHYSICAL_AS(static physical, (PHYSICAL_TEST_SOURCE));
+
+
 /** Source code management helper class. */
 struct Source {
 	const char * const source;
@@ -85,6 +133,20 @@ struct Source {
 };
 
 
+/** Manually advanced clock for the report statistics. */
+struct TestClock {
+	static uint32_t ticks;
+	
+	/** Return the current ticks. */
+	static uint32_t now() {
+		return ticks;
+	}
+};
+
+
+uint32_t TestClock::ticks = 0;
+
+
 /** Single test vector. */
 struct Test {
 	const char * const source;
@@ -198,6 +260,32 @@ static void hexDump(const uint8_t * buf, const size_t len) {
 }
 
 
+/**
+ * Compares the given buffers and prints both on mismatch.
+ * 
+ * @param[in] name - test name
+ * @param[in] data - received data
+ * @param[in] check - expected data
+ * @return true on match, else false
+ */
+static bool checkData(const char * name, const uint8_t * data, std::initializer_list<uint8_t> check) {
+	if (memcmp(data, check.begin(), check.size()) == 0) {
+		return true;
+	}
+	printf("###############################################################################\n");
+	printf("test:     %s\n", name);
+	printf("data:     "); hexDump(check.begin(), check.size());
+	printf("mismatching data:           "); hexDump(data, check.size());
+	return false;
+}
+
+
+/** Compile policy without comments. */
+struct NoCommentsPolicy : hid::FullPolicy {
+	static constexpr bool comments = false;
+};
+
+
 /** Entry point. */
 int main() {
 	enum {
@@ -221,6 +309,25 @@ int main() {
 			return EXIT_FAILURE;
 		}
 	}
+	{
+		/* chunked compilation sanity check */
+		const auto source = hid::fromSource(sanityChunkSrc)("id", 2);
+		hid::detail::BufferWriter out(buf, sizeof(buf));
+		hid::compile(source, out, error);
+		if (sanityChunkDesc.size() != out.getPosition() || memcmp(sanityChunkDesc.data, buf, sanityChunkDesc.size()) != 0) {
+			printf("Error: Chunked compilation sanity check failed.\n");
+			return EXIT_FAILURE;
+		}
+	}
+	{
+		/* item list sanity check */
+		const hid::detail::Param params[] = {{"arg1", 1}, {"arg2", 2}, {"arg3", 3}};
+		hid::detail::BufferWriter out(buf, sizeof(buf));
+		if (( ! sanityCheckItems.bind(params, 3, out, error) ) || out.getPosition() != sizeof(sanityCheckData) || memcmp(sanityCheckData, buf, sizeof(sanityCheckData)) != 0) {
+			printf("Error: Item list sanity check failed.\n");
+			return EXIT_FAILURE;
+		}
+	}
 #endif /* not NSANITY */
 	/* unit tests, see `struct Test` */
 	const Test tests[] = {
@@ -474,6 +581,50 @@ int main() {
 		Test("Delimiter(Close)", E_Unexpected_DelimiterClose, 15),
 		Test("Delimiter(Open)", E_Missing_DelimiterClose, 15, {0xA9, 0x01}),
 		Test("Delimiter(Open) ", E_Missing_DelimiterClose, 16, {0xA9, 0x01}),
+		/* field annotations */
+		Test("Input(Cnst) @pad", E_NO_ERROR, {0x81, 0x01}),
+		Test("Input(Cnst)@pad#x\nOutput(Cnst) @out_1", E_NO_ERROR, {0x81, 0x01, 0x91, 0x01}),
+		Test("@pad", E_Missing_main_item_for_annotation, 0),
+		Test("Usage(1) @x", E_Missing_main_item_for_annotation, 9, {0x09, 0x01}),
+		Test("Input(Cnst) 1 @x", E_Missing_main_item_for_annotation, 14, {0x81, 0x01, 0x01}),
+		Test("Input(Cnst) @a @b", E_Missing_main_item_for_annotation, 15, {0x81, 0x01}),
+		Test("Input(Cnst) @", E_Invalid_annotation_name, 13, {0x81, 0x01}),
+		Test("Input(Cnst) @1x", E_Invalid_annotation_name, 13, {0x81, 0x01}),
+		/* string arguments */
+		Test("StringIndex(\"a\")", E_NO_ERROR, {0x79, 0x01}),
+		Test("StringIndex(\"\")", E_NO_ERROR, {0x79, 0x01}),
+		Test("StringIndex(\"a\") StringMinimum( \"b c\" ) StringMaximum(\"a\")", E_NO_ERROR, {0x79, 0x01, 0x89, 0x02, 0x99, 0x01}),
+		Test("# \"x\"\nStringIndex(\"y\") StringIndex(\"#;\") StringIndex(\"y\")", E_NO_ERROR, {0x79, 0x01, 0x79, 0x02, 0x79, 0x01}),
+		Test("StringIndex(\"\xC3\x84\xF0\x9F\x8E\xAE\")", E_NO_ERROR, {0x79, 0x01}),
+		/* "costarring" and "liquid" share the same `nameHash()` */
+		Test("StringIndex(\"costarring\") StringIndex(\"liquid\") StringIndex(\"costarring\")", E_NO_ERROR, {0x79, 0x01, 0x79, 0x02, 0x79, 0x01}),
+		Test("PhysicalSet(0) Designator(\"costarring\") DesignatorIndex(\"liquid\")", E_Unknown_designator_name, 57),
+		/* more distinct strings than recorded by `StringOrder` */
+		Test("StringIndex(\"s1\") StringIndex(\"s2\") StringIndex(\"s3\") StringIndex(\"s4\") StringIndex(\"s5\") StringIndex(\"s6\") StringIndex(\"s7\") StringIndex(\"s8\") StringIndex(\"s9\") StringIndex(\"s10\") StringIndex(\"s11\") StringIndex(\"s12\") StringIndex(\"s13\") StringIndex(\"s14\") StringIndex(\"s15\") StringIndex(\"s16\") StringIndex(\"s17\") StringIndex(\"s18\") StringIndex(\"s17\") StringIndex(\"s\") StringIndex(\"s2\") StringIndex(\"s18\")", E_NO_ERROR, {0x79, 0x01, 0x79, 0x02, 0x79, 0x03, 0x79, 0x04, 0x79, 0x05, 0x79, 0x06, 0x79, 0x07, 0x79, 0x08, 0x79, 0x09, 0x79, 0x0A, 0x79, 0x0B, 0x79, 0x0C, 0x79, 0x0D, 0x79, 0x0E, 0x79, 0x0F, 0x79, 0x10, 0x79, 0x11, 0x79, 0x12, 0x79, 0x11, 0x79, 0x13, 0x79, 0x02, 0x79, 0x12}),
+		Test("Usage(\"a\")", E_Strings_are_not_allowed_in_this_context, 6),
+		Test("\"a\"", E_Unexpected_token, 0),
+		Test("StringIndex(\"a", E_Missing_closing_quote, 14),
+		Test("StringIndex(\"a\n\")", E_Missing_closing_quote, 14),
+		Test("StringIndex(\"a\" 1)", E_Unexpected_token, 16),
+		Test("StringIndex(\"\xFF\")", E_Invalid_string, 13),
+		Test("StringIndex(\"\xC0\x80\")", E_Invalid_string, 13),
+		Test("StringIndex(\"\xED\xA0\x80\")", E_Invalid_string, 13),
+		/* physical descriptor sets */
+		Test("PhysicalSet(RightHand, 2) Designator(\"a\", IndexFinger, Right, 5) DesignatorIndex(\"a\")", E_NO_ERROR, {0x39, 0x01}),
+		Test("PhysicalSet(None) Designator(\"a\", Thumb) Designator(\"b\") PhysicalSet(LeftHand) Designator(\"b\", Palm, Left) DesignatorMinimum(\"a\") DesignatorMaximum( \"b\" )", E_NO_ERROR, {0x49, 0x01, 0x59, 0x02}),
+		Test("PhysicalSet(0) Designator(\"a\") StringIndex(\"a\") DesignatorIndex(\"a\")", E_NO_ERROR, {0x79, 0x01, 0x39, 0x01}),
+		Test("Designator(\"a\", Thumb)", E_Missing_PhysicalSet, 21),
+		Test("PhysicalSet(0) Designator(Thumb)", E_Missing_designator_name, 31),
+		Test("PhysicalSet(0) Designator(Thumb, \"a\")", E_Strings_are_not_allowed_in_this_context, 33),
+		Test("PhysicalSet(0) Designator(\"a\", \"b\")", E_Strings_are_not_allowed_in_this_context, 31),
+		Test("PhysicalSet(0) Designator(\"a\", 0x10000)", E_Argument_value_out_of_range, 38),
+		Test("PhysicalSet(\"a\")", E_Strings_are_not_allowed_in_this_context, 12),
+		Test("PhysicalSet(0x100)", E_Argument_value_out_of_range, 17),
+		Test("PhysicalSet", E_Missing_argument, 11),
+		Test("DesignatorIndex(\"a\")", E_Unknown_designator_name, 17),
+		Test("PhysicalSet(0) Designator(\"d1\") Designator(\"d2\") Designator(\"d3\") Designator(\"d4\") Designator(\"d5\") Designator(\"d6\") Designator(\"d7\") Designator(\"d8\") Designator(\"d9\") Designator(\"d10\") Designator(\"d11\") Designator(\"d12\") Designator(\"d13\") Designator(\"d14\") Designator(\"d15\") Designator(\"d16\") Designator(\"d17\") DesignatorIndex(\"d17\") DesignatorIndex(\"d3\") DesignatorIndex(\"d\")", E_Unknown_designator_name, 374, {0x39, 0x11, 0x39, 0x03}),
+		Test("PhysicalSet(0) DesignatorIndex(\"a\") Designator(\"a\")", E_Unknown_designator_name, 32),
+		Test("PhysicalSet(0) Designator(\"a\") StringIndex(\"x\") DesignatorIndex(\"x\")", E_Unknown_designator_name, 65, {0x79, 0x01}),
 		/* miscellaneous error tests */
 		Test("", E_NO_ERROR),
 		Test("$", E_Unexpected_token, 0)
@@ -525,6 +676,691 @@ int main() {
 		}
 		total++;
 	}
+	/* chunked compilation tests */
+	{
+		const char * const multiSrc = "Usage(1) Collection(0) EndCollection\n#\nUsage(2)Collection(0)Usage(3)Collection(0)EndCollection EndCollection\tUsage(4)";
+		size_t mismatches = 0;
+		for (size_t i = 0; i <= (sizeof(tests) / sizeof(*tests)); i++) {
+			const char * const text = (i < (sizeof(tests) / sizeof(*tests))) ? tests[i].source : multiSrc;
+			Source src(text, strlen(text));
+			uint8_t chunkBuf[sizeof(buf)];
+			hid::detail::BufferWriter out(buf, sizeof(buf));
+			const bool result = hid::compile(src, out, error);
+			hid::detail::CompileState state;
+			hid::Error chunkError;
+			size_t chunkSize = 0;
+			size_t chunks = 0;
+			bool chunkResult = true;
+			while (chunkResult && ! state.finished) {
+				hid::detail::BufferWriter chunkOut(chunkBuf + chunkSize, sizeof(chunkBuf) - chunkSize);
+				chunkResult = hid::detail::compile(src, chunkOut, chunkError, state, hid::detail::CM_CHUNK);
+				chunkSize += chunkOut.getPosition();
+				chunks++;
+			}
+			if (result != chunkResult || error.message != chunkError.message || error.character != chunkError.character || out.getPosition() != chunkSize || memcmp(buf, chunkBuf, chunkSize) != 0) {
+				printf("Error: Chunked compilation mismatch for: "); quoteCode(text);
+				mismatches++;
+			} else if (text == multiSrc && chunks != 3) {
+				printf("Error: Unexpected number of chunks: %u\n", unsigned(chunks));
+				mismatches++;
+			}
+		}
+		if (mismatches > 0) {
+			failed++;
+		}
+		total++;
+	}
+	/* push parser tests */
+	{
+		static const size_t pieceSizes[] = {1, 2, 3, 7, 64, 65536};
+		size_t mismatches = 0;
+		for (const Test & test : tests) {
+			Source src(test.source, strlen(test.source));
+			hid::detail::BufferWriter out(buf, sizeof(buf));
+			const bool result = hid::compile(src, out, error);
+			for (const size_t pieceSize : pieceSizes) {
+				uint8_t pushBuf[sizeof(buf)];
+				hid::detail::BufferWriter pushOut(pushBuf, sizeof(pushBuf));
+				hid::Compiler<hid::detail::BufferWriter, Source, 128, 32> compiler(pushOut, src);
+				bool pushResult = true;
+				for (size_t n = 0; n < src.size(); n += pieceSize) {
+					pushResult = compiler.feed(src.data() + n, min(pieceSize, src.size() - n)) && pushResult;
+				}
+				pushResult = compiler.finish() && pushResult;
+				const hid::Error & pushError = compiler.getError();
+				if (result != pushResult || error.message != pushError.message || error.character != pushError.character || error.line != pushError.line || error.column != pushError.column || out.getPosition() != pushOut.getPosition() || memcmp(buf, pushBuf, out.getPosition()) != 0) {
+					printf("Error: Push parser mismatch for %u byte pieces of: ", unsigned(pieceSize)); quoteCode(test.source);
+					mismatches++;
+				}
+			}
+		}
+		{
+			/* single item exceeding the input buffer */
+			const char text[] = "Usage(1)\nUsagePage(                  GenericDesktop)";
+			hid::detail::BufferWriter pushOut(buf, sizeof(buf));
+			hid::Compiler<hid::detail::BufferWriter, hid::detail::NoParams, 16> compiler(pushOut);
+			const bool pushResult = compiler.feed(text, sizeof(text) - 1) || compiler.finish();
+			const hid::Error & pushError = compiler.getError();
+			if (pushResult || pushError.message != E_Input_buffer_overflow || pushError.line != 2 || pushError.column != 1 || pushOut.getPosition() != 2) {
+				printf("Error: Push parser input buffer overflow not detected.\n");
+				mismatches++;
+			}
+		}
+		if (mismatches > 0) {
+			failed++;
+		}
+		total++;
+	}
+	/* field annotation tests */
+	{
+		constexpr static const auto sticksSrc = hid::fromSource("UsagePage(GenericDesktop) Usage(Gamepad) Collection(Application) ReportId(3) "
+			"LogicalMinimum(-127) LogicalMaximum(127) ReportSize(8) ReportCount(2) "
+			"Usage(Pointer) Collection(Physical) Usage(X) Usage(Y) Input(Data, Var, Abs) @leftStick EndCollection "
+			"Usage(Pointer) Collection(Physical) Usage(X) Usage(Y) Input(Data, Var, Abs) @rightStick EndCollection "
+			"ReportSize(1) ReportCount(4) Output(Data, Var, Abs) @leds EndCollection");
+		static_assert(hid::annotationCount(sticksSrc) == 3, "unexpected annotation count");
+		constexpr static const hid::Descriptor<hid::compiledSize(sticksSrc), hid::annotationCount(sticksSrc)> sticks(sticksSrc);
+		static_assert(sticks.field("leftStick").valid && sticks.field("leftStick").bitOffset == 0, "unexpected leftStick field");
+		static_assert(sticks.field("rightStick").bitOffset == 16 && sticks.field("rightStick").field.reportId == 3, "unexpected rightStick field");
+		static_assert(sticks.field("leds").field.type == hid::RT_OUTPUT && sticks.field("leds").field.size == 1 && sticks.field("leds").field.count == 4, "unexpected leds field");
+		static_assert(( ! sticks.field("unknown").valid ) && ( ! hid::bootMouseDescriptor<>.field("leftStick").valid ), "unexpected field");
+		static_assert(sizeof(hid::bootMouseDescriptor<>) == hid::bootMouseDescriptor<>.size(), "field names shall not add to descriptors without annotations");
+#ifndef NSANITY
+		static_assert(sanityChunkDesc.field("motion").field.reportId == 1 && sanityChunkDesc.field("motion").field.count == 2, "unexpected motion field");
+		static_assert(sanityChunkDesc.field("pad").field.reportId == 2 && sanityChunkDesc.field("pad").field.type == hid::RT_OUTPUT, "unexpected pad field");
+#endif /* not NSANITY */
+		/* "costarring" and "liquid" share the same `nameHash()` */
+		static_assert(hid::compileError(hid::fromSource("Input(Cnst) @pad Input(Cnst) @pad")).message == E_Ambiguous_annotation_name, "repeated name not detected");
+		static_assert(hid::compileError(hid::fromSource("Input(Cnst) @pad Input(Cnst) @pad")).character == 30, "unexpected error position");
+		static_assert(hid::compileError(hid::fromSource("Input(Cnst) @costarring Input(Cnst) @liquid")).message == E_Ambiguous_annotation_name, "ambiguous name not detected");
+		static_assert(hid::compileError(hid::fromSource("Input(Cnst) @costarring Input(Cnst) @liquid")).character == 37, "unexpected error position");
+		uint8_t plain[sizeof(sticks.data)];
+		hid::detail::BufferWriter out(plain, sizeof(plain));
+		bool ok = hid::compile(sticksSrc, out, error) && out.getPosition() == sizeof(plain) && memcmp(plain, sticks.data, sizeof(plain)) == 0;
+		if ( ! ok ) {
+			printf("Error: Annotated descriptor mismatch.\n");
+		}
+		/* names beyond the recorded ones */
+		char manyNames[512] = "";
+		for (char c = 'a'; c <= 'p'; c++) {
+			snprintf(manyNames + strlen(manyNames), sizeof(manyNames) - strlen(manyNames), "Input(Cnst) @%c ", c);
+		}
+		const size_t clashPos = strlen(manyNames) + 37;
+		strcat(manyNames, "Input(Cnst) @costarring Input(Cnst) @liquid");
+		const Source manySrc(manyNames, strlen(manyNames));
+		uint8_t manyBuf[64];
+		hid::detail::BufferWriter manyOut(manyBuf, sizeof(manyBuf));
+		if (hid::compile(manySrc, manyOut, error) || error.message != E_Ambiguous_annotation_name || error.character != clashPos) {
+			printf("Error: Ambiguous annotation name not detected beyond the recorded names.\n");
+			ok = false;
+		}
+		manyNames[clashPos - 37] = 0;
+		strcat(manyNames, "Input(Cnst) @q Input(Cnst) @q");
+		const Source repeatSrc(manyNames, strlen(manyNames));
+		hid::detail::BufferWriter repeatOut(manyBuf, sizeof(manyBuf));
+		if (hid::compile(repeatSrc, repeatOut, error) || error.message != E_Ambiguous_annotation_name || error.character != clashPos - 37 + 28) {
+			printf("Error: Repeated annotation name not detected beyond the recorded names.\n");
+			ok = false;
+		}
+		if ( ! ok ) {
+			failed++;
+		}
+		total++;
+	}
+	/* string table tests */
+	{
+		constexpr static const auto stringsSrc = hid::fromSource(STRING_TEST_SOURCE)("x", 7);
+		constexpr static const hid::Descriptor<hid::compiledSize(stringsSrc)> stringsDesc(stringsSrc);
+		static_assert(strings.count() == 3 && strings.size() == (4 + 10 + 8 + 10), "unexpected string table size");
+		static_assert(strings.get(1) == strings.data + 4 && strings.get(4) == nullptr, "unexpected string table index");
+		bool ok = checkData("StringTable", strings.data, {
+			0x04, 0x03, 0x09, 0x04,
+			0x0A, 0x03, 'L', 0x00, 'e', 0x00, 'f', 0x00, 't', 0x00,
+			0x08, 0x03, 0xC4, 0x00, 0x3C, 0xD8, 0xAE, 0xDF,
+			0x0A, 0x03, '#', 0x00, '{', 0x00, 'x', 0x00, '}', 0x00
+		});
+		ok = checkData("StringIndex", stringsDesc.data, {
+			0x05, 0x09, 0x19, 0x01, 0x29, 0x02, 0x79, 0x01, 0x09, 0x01, 0x79, 0x02, 0x09, 0x02,
+			0x89, 0x01, 0x99, 0x03, 0x09, 0x03, 0x79, 0x07
+		}) && ok;
+		/* the push parser records the strings of the dropped source code */
+		uint8_t pushBuf[8];
+		hid::detail::BufferWriter pushOut(pushBuf, sizeof(pushBuf));
+		hid::Compiler<hid::detail::BufferWriter, hid::detail::NoParams, 16, 1> compiler(pushOut);
+		const char pushText[] = "StringIndex(\"a\") StringIndex(\"a\") StringIndex(\"b\")";
+		ok = ( ! compiler.feed(pushText, sizeof(pushText) - 1) ) && compiler.getError().message == E_Argument_value_out_of_range && pushOut.getPosition() == 4 && ok;
+		/* the strings need to fit into the string pool */
+		hid::detail::BufferWriter poolOut(pushBuf, sizeof(pushBuf));
+		hid::Compiler<hid::detail::BufferWriter, hid::detail::NoParams, 32, 4, 4> poolCompiler(poolOut);
+		const char poolText[] = "StringIndex(\"abc\") StringIndex(\"abc\") StringIndex(\"de\")";
+		ok = ( ! poolCompiler.feed(poolText, sizeof(poolText) - 1) ) && poolCompiler.getError().message == E_Argument_value_out_of_range && poolOut.getPosition() == 4 && ok;
+		if ( ! ok ) {
+			failed++;
+		}
+		total++;
+	}
+	/* physical descriptor tests */
+	{
+		constexpr static const auto physicalSrc = hid::fromSource(PHYSICAL_TEST_SOURCE);
+		constexpr static const hid::Descriptor<hid::compiledSize(physicalSrc)> physicalDesc(physicalSrc);
+		static_assert(physical.count() == 2 && physical.size() == (3 + 2 * 5) && hid::stringCount(physicalSrc) == 1, "unexpected physical descriptor size");
+		static_assert(physical.get(2) == physical.data + 8 && physical.get(3) == nullptr && physical.length(0) == 3 && physical.length(1) == 5, "unexpected physical descriptor index");
+		bool ok = checkData("PhysicalTable", physical.data, {
+			0x02, 0x05, 0x00,
+			0x22, 0x12, 0x25, 0x10, 0x20,
+			0x40, 0x00, 0x00, 0x10, 0x40
+		});
+		ok = physicalDesc.size() == 12 && checkData("DesignatorIndex", physicalDesc.data, {
+			0x05, 0x09, 0x39, 0x01, 0x09, 0x01, 0x39, 0x02, 0x79, 0x01, 0x09, 0x02
+		}) && ok;
+		/* the push parser records the designator names of the dropped source code */
+		uint8_t pushBuf[16];
+		hid::detail::BufferWriter pushOut(pushBuf, sizeof(pushBuf));
+		hid::Compiler<hid::detail::BufferWriter, hid::detail::NoParams, 64> compiler(pushOut);
+		const char pushText[] = PHYSICAL_TEST_SOURCE;
+		for (size_t i = 0; i < (sizeof(pushText) - 1); i += 7) {
+			ok = compiler.feed(pushText + i, ((i + 7) < (sizeof(pushText) - 1)) ? 7 : (sizeof(pushText) - 1 - i)) && ok;
+		}
+		ok = compiler.finish() && pushOut.getPosition() == physicalDesc.size() && memcmp(pushBuf, physicalDesc.data, physicalDesc.size()) == 0 && ok;
+		/* the HID class descriptor lists the physical descriptor */
+		constexpr static const hid::Interface interfaces[] = {
+			hid::Interface(hid::bootMouseDescriptor<>).withPhysical(physical)
+		};
+		const hid::Configuration<hid::configurationSize(interfaces)> config(interfaces);
+		ok = config.size() == 37 && checkData("Configuration", config.data + 18, {
+			0x0C, 0x21, 0x11, 0x01, 0x00, 0x02, 0x22, 0x32, 0x00, 0x23, 0x0D, 0x00
+		}) && ok;
+		if ( ! ok ) {
+			printf("Error: Physical descriptor mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* output overflow and arena writer tests */
+	{
+		const char text[] = "UsagePage(GenericDesktop) Usage(Mouse) Collection(Application) EndCollection";
+		const Source src(text, sizeof(text) - 1);
+		uint8_t small[3];
+		hid::detail::BufferWriter smallOut(small, sizeof(small));
+		bool ok = ( ! hid::compile(src, smallOut, error) ) && error.message == E_Output_buffer_overflow && error.column == 38 && smallOut.getPosition() == 3;
+		uint8_t mem[14];
+		hid::detail::Arena arena(mem, sizeof(mem));
+		hid::detail::ArenaWriter first(arena);
+		ok = ok && hid::compile(src, first, error) && first.getPosition() == 7;
+		const uint8_t * firstData = first.commit();
+		ok = ok && firstData == mem && arena.getUsed() == 7 && checkData("ArenaWriter", firstData, {0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0xC0});
+		/* a failed pass leaves the arena untouched */
+		hid::detail::ArenaWriter second(arena);
+		const char longer[] = "UsagePage(GenericDesktop) Usage(Mouse) Collection(Application) Usage(X) EndCollection";
+		ok = ok && ( ! hid::compile(Source(longer, sizeof(longer) - 1), second, error) ) && error.message == E_Output_buffer_overflow && arena.getUsed() == 7;
+		/* output is written up to the arena end */
+		ok = ok && second.getPosition() == 7 && ( ! second.reserve(1) ) && mem[13] == 0x09;
+		hid::detail::ArenaWriter third(arena);
+		ok = ok && hid::compile(src, third, error) && third.commit() == mem + 7 && arena.getAvailable() == 0 && arena.allocate(1) == nullptr;
+		arena.reset();
+		ok = ok && arena.allocate(14) == mem && arena.getUsed() == 14;
+		if ( ! ok ) {
+			printf("Error: Output buffer overflow not handled.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* compile policy tests */
+	{
+		/* the lean policy either rejects stripped syntax or compiles the same output */
+		size_t mismatches = 0;
+		for (const Test & test : tests) {
+			if (test.result != E_NO_ERROR) {
+				continue;
+			}
+			Source src(test.source, strlen(test.source));
+			uint8_t leanBuf[sizeof(buf)];
+			hid::detail::BufferWriter out(buf, sizeof(buf));
+			hid::detail::BufferWriter leanOut(leanBuf, sizeof(leanBuf));
+			hid::Error leanError;
+			const bool result = hid::compile(src, out, error);
+			const bool leanResult = hid::compile<hid::LeanPolicy>(src, leanOut, leanError);
+			if (leanResult != (leanError.message == E_NO_ERROR) || (result && leanResult && (out.getPosition() != leanOut.getPosition() || memcmp(buf, leanBuf, out.getPosition()) != 0))) {
+				printf("Error: Lean policy mismatch for: "); quoteCode(test.source);
+				mismatches++;
+			}
+		}
+		/* stripped feature groups */
+		static const struct {
+			const char * text;
+			EMessage full;
+			EMessage lean;
+			EMessage noComments;
+		} policyTests[] = {
+			{"Usage(1) Collection(0) ReportSize(8) Input(Cnst)", E_Missing_EndCollection, E_NO_ERROR, E_Missing_EndCollection},
+			{"Collection(0) ReportCount(2) EndCollection EndCollection", E_Missing_Usage_for_Collection, E_NO_ERROR, E_Missing_Usage_for_Collection},
+			{"Delimiter(Open) Usage(1)", E_Missing_DelimiterClose, E_NO_ERROR, E_Missing_DelimiterClose},
+			{"Usage(0x1)", E_NO_ERROR, E_Invalid_numeric_value, E_NO_ERROR},
+			{"0x09 1", E_NO_ERROR, E_Invalid_numeric_value, E_NO_ERROR},
+			{"Usage({arg1})", E_NO_ERROR, E_Unexpected_argument_name_character, E_NO_ERROR},
+			{"{arg1}", E_NO_ERROR, E_Unexpected_token, E_NO_ERROR},
+			{"Unit(SiLin(Length))", E_NO_ERROR, E_Unexpected_argument_name_character, E_NO_ERROR},
+			{"Unit(SiLin) Unit(17)", E_NO_ERROR, E_NO_ERROR, E_NO_ERROR},
+			{"Usage(1) # comment", E_NO_ERROR, E_Unexpected_token, E_Unexpected_token}
+		};
+		for (const auto & test : policyTests) {
+			Source src(test.text, strlen(test.text));
+			hid::detail::BufferWriter fullOut(buf, sizeof(buf));
+			hid::compile(src, fullOut, error);
+			const EMessage full = error.message;
+			hid::detail::BufferWriter leanOut(buf, sizeof(buf));
+			hid::compile<hid::LeanPolicy>(src, leanOut, error);
+			const EMessage lean = error.message;
+			hid::detail::BufferWriter noCommentsOut(buf, sizeof(buf));
+			hid::compile<NoCommentsPolicy>(src, noCommentsOut, error);
+			if (full != test.full || lean != test.lean || error.message != test.noComments) {
+				printf("Error: Compile policy mismatch (%s, %s, %s) for: ", EMessageStr[full], EMessageStr[lean], EMessageStr[error.message]); quoteCode(test.text);
+				mismatches++;
+			}
+		}
+		if (mismatches > 0) {
+			failed++;
+		}
+		total++;
+	}
+	/* item list tests */
+	{
+		/* binding the parameters of `Source::find()` equals compiling with them */
+		static const hid::detail::Param params[] = {{"arg1", 1}, {"arg2", 256}, {"arg3", -1}, {"arg4", 4294967295LL}, {" arg5 ", 4294967296LL}};
+		size_t mismatches = 0;
+		for (const Test & test : tests) {
+			Source src(test.source, strlen(test.source));
+			uint8_t boundBuf[sizeof(buf)];
+			hid::detail::BufferWriter out(buf, sizeof(buf));
+			hid::detail::BufferWriter boundOut(boundBuf, sizeof(boundBuf));
+			hid::Error boundError;
+			const bool result = hid::compile(src, out, error);
+			const hid::ItemList<1024, 16, 16> list(hid::SourceView(test.source, strlen(test.source)));
+			if (list.error.message != E_NO_ERROR) {
+				/* lowering errors do not depend on parameters */
+				if (list.error.message != error.message || list.error.character != error.character) {
+					printf("Error: Item list lowering mismatch for: "); quoteCode(test.source);
+					mismatches++;
+				}
+				continue;
+			}
+			const bool boundResult = list.bind(params, sizeof(params) / sizeof(*params), boundOut, boundError);
+			if (result != boundResult || error.message != boundError.message || error.character != boundError.character || error.line != boundError.line || error.column != boundError.column || out.getPosition() != boundOut.getPosition() || memcmp(buf, boundBuf, out.getPosition()) != 0) {
+				printf("Error: Item list binding mismatch for: "); quoteCode(test.source);
+				mismatches++;
+			}
+		}
+		/* re-encoding with changed value widths */
+		const char text[] = "LogicalMinimum({v}) UsagePage({v}) ReportCount({v}) UnitExponent({e}) {v} Input(Cnst, {v})";
+		const hid::ItemList<64, 8, 8> list(hid::SourceView(text, sizeof(text) - 1));
+		static const int64_t values[] = {0, 1, 127, 128, 255, 256, 0xFFFF, 0x10000, -1, -128, -129, -0x8000, -0x8001, 0x7FFFFFFF, INT64_C(0x80000000)};
+		for (const int64_t value : values) {
+			const hid::detail::Param valueParams[] = {{"e", value & 7}, {"v", 1}, {"v", value}};
+			uint8_t boundBuf[64];
+			hid::detail::BufferWriter out(buf, sizeof(buf));
+			hid::detail::BufferWriter boundOut(boundBuf, sizeof(boundBuf));
+			hid::Error boundError;
+			const bool result = hid::compile(hid::SourceView(text, sizeof(text) - 1, valueParams, 3), out, error);
+			const bool boundResult = list.bind(valueParams, 3, boundOut, boundError);
+			if (result != boundResult || error.message != boundError.message || error.character != boundError.character || out.getPosition() != boundOut.getPosition() || memcmp(buf, boundBuf, out.getPosition()) != 0) {
+				printf("Error: Item list re-encoding mismatch for value %lld.\n", static_cast<long long>(value));
+				mismatches++;
+			}
+		}
+		/* parameter dependent delimiters and capacity */
+		const char delim[] = "Delimiter(Open) Usage(1) Delimiter({close})";
+		const hid::ItemList<64, 8, 8> delimList(hid::SourceView(delim, sizeof(delim) - 1));
+		const hid::ItemList<64, 1, 1> smallList(hid::SourceView(text, sizeof(text) - 1));
+		hid::detail::BufferWriter out(buf, sizeof(buf));
+		if (delimList.error.message != E_Unexpected_Delimiter_value || delimList.error.column != 43 || smallList.error.message != E_Output_buffer_overflow || smallList.bind(NULL, 0, out, error) || error.message != E_Output_buffer_overflow) {
+			printf("Error: Item list lowering errors not detected.\n");
+			mismatches++;
+		}
+		static_assert(hid::loweredSize(hid::fromSource("Delimiter(Open) Usage(1) Delimiter({close})")).error.message == E_Unexpected_Delimiter_value, "lowering error not reported");
+		static_assert(hid::loweredSize(hid::fromSource("Usage({costarring}) Usage({liquid})")).error.column == 34, "unexpected lowering error position");
+		/* "costarring" and "liquid" share the same `nameHash()` */
+		const char clash[] = "Usage({costarring}) Usage({liquid})";
+		const char same[] = "Usage({costarring}) Usage({costarring})";
+		const hid::ItemList<64, 8, 8> clashList(hid::SourceView(clash, sizeof(clash) - 1));
+		const hid::ItemList<64, 8, 8> sameList(hid::SourceView(same, sizeof(same) - 1));
+		static const hid::detail::Param clashParams[] = {{"costarring", 1}, {"liquid", 2}};
+		hid::detail::BufferWriter clashOut(buf, sizeof(buf));
+		if (clashList.error.message != E_Ambiguous_parameter_name || clashList.error.column != 34 || sameList.error.message != E_NO_ERROR || sameList.bind(clashParams, 2, clashOut, error) || error.message != E_Ambiguous_parameter_name || error.column != 18) {
+			printf("Error: Item list parameter name hash collision not detected.\n");
+			mismatches++;
+		}
+		/* names beyond the recorded ones */
+		char manyParams[512] = "";
+		for (char c = 'a'; c <= 'p'; c++) {
+			snprintf(manyParams + strlen(manyParams), sizeof(manyParams) - strlen(manyParams), "Usage({%c}) ", c);
+		}
+		const size_t clashPos = strlen(manyParams) + 33;
+		strcat(manyParams, clash);
+		const hid::ItemList<64, 32, 32> manyList(hid::SourceView(manyParams, strlen(manyParams)));
+		if (manyList.error.message != E_Ambiguous_parameter_name || manyList.error.character != clashPos) {
+			printf("Error: Item list parameter name hash collision not detected beyond the recorded names.\n");
+			mismatches++;
+		}
+		if (mismatches > 0) {
+			failed++;
+		}
+		total++;
+	}
+	/* compact encoding table tests */
+	{
+		using namespace ::hid::detail;
+		size_t mismatches = 0;
+		for (size_t m = 0; m < EncodingMapCount; m++) {
+			for (const Encoding * enc = encodingMaps[m]; enc->name != NULL; enc++) {
+				const Token token{enc->name, strlen(enc->name)};
+				const Encoding * first = encodingMaps[m];
+				while ( ! equalsI(token, first->name) ) {
+					first++; /* duplicate names resolve to the first entry */
+				}
+				EncodingRef ref;
+				EMessage subError = E_NO_ERROR;
+				if (token.start[token.length - 1] == '#') {
+					continue; /* argument with index */
+				}
+				if (( ! findEncoding(token, uint8_t(m + 1), ref, subError) ) || ref.value != first->value || ref.type != first->type || ref.arg != encodingMapId(first->arg)) {
+					printf("Error: Encoding table mismatch for \"%s\".\n", enc->name);
+					mismatches++;
+				}
+			}
+		}
+		if (mismatches > 0) {
+			failed++;
+		}
+		total++;
+	}
+	/* boot protocol conversion tests */
+	{
+		const char * kbdSrc = R"(
+UsagePage(GenericDesktop)
+Usage(Keyboard)
+Collection(Application)
+	ReportId(2)
+	ReportSize(1)
+	ReportCount(8)
+	UsagePage(Keyboard)
+	UsageMinimum(KeyboardLeftControl)
+	UsageMaximum(KeyboardRightGui)
+	LogicalMinimum(0)
+	LogicalMaximum(1)
+	Input(Data, Var, Abs)
+	ReportCount(224)
+	ReportSize(1)
+	UsageMinimum(0)
+	UsageMaximum(223)
+	Input(Data, Var, Abs)
+EndCollection
+UsagePage(GenericDesktop)
+Usage(Mouse)
+Collection(Application)
+	ReportId(3)
+	UsagePage(Button)
+	UsageMinimum(Button1)
+	UsageMaximum(Button5)
+	ReportCount(5)
+	ReportSize(1)
+	Input(Data, Var, Abs)
+	ReportCount(1)
+	ReportSize(3)
+	Input(Cnst)
+	UsagePage(GenericDesktop)
+	Usage(X)
+	Usage(Y)
+	LogicalMinimum(-32767)
+	LogicalMaximum(32767)
+	ReportSize(16)
+	ReportCount(2)
+	Input(Data, Var, Rel)
+EndCollection
+)";
+		Source src(kbdSrc, strlen(kbdSrc));
+		hid::detail::BufferWriter out(buf, sizeof(buf));
+		hid::compile(src, out, error);
+		const hid::BootKeyboard keyboard(buf, out.getPosition());
+		const hid::BootMouse mouse(buf, out.getPosition());
+		uint8_t report[30] = {2, 0x81, 0x10};
+		uint8_t boot[8] = {0};
+		bool ok = error.message == E_NO_ERROR && keyboard.getReportId() == 2 && mouse.getReportId() == 3;
+		ok = ok && hid::reportSize(buf, out.getPosition(), hid::RT_INPUT, 2) == sizeof(report);
+		ok = ok && keyboard.convert(report, sizeof(report), boot) && checkData("BootKeyboard", boot, {0x81, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00});
+		memset(report + 5, 0x01, 7);
+		ok = ok && keyboard.convert(report, sizeof(report), boot) && checkData("BootKeyboard rollover", boot, {0x81, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01});
+		ok = ok && ( ! keyboard.convert(report, 29, boot) );
+		const uint8_t motion[] = {3, 0x1F, 0x00, 0x80, 0x05, 0x00};
+		ok = ok && mouse.convert(motion, sizeof(motion), boot) && checkData("BootMouse", boot, {0x07, 0x81, 0x05});
+		ok = ok && ( ! mouse.convert(report, sizeof(report), boot) );
+		if ( ! ok ) {
+			printf("Error: Boot protocol conversion failed.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* report queue tests */
+	{
+		hid::ReportQueue<4, hid::maxReportSize(hid::bootMouseDescriptor<>.data, hid::bootMouseDescriptor<>.size(), hid::RT_INPUT) + 1> queue;
+		const uint8_t report[] = {0x01, 0x02, 0x03};
+		size_t len = 0;
+		bool ok = queue.empty() && queue.front(len) == nullptr && len == 0;
+		ok = ok && queue.push(0, report, 3) && queue.push(5, report, 2) && ( ! queue.push(5, report, 4) );
+		ok = ok && queue.pushLatest(7, report, 1) && queue.pushLatest(7, report + 1, 1) && ( ! queue.push(0, report, 1) ) && queue.size() == 4;
+		const uint8_t * front = queue.front(len);
+		ok = ok && front != nullptr && len == 3 && checkData("ReportQueue without ID", front, {0x01, 0x02, 0x03});
+		queue.pop();
+		front = queue.front(len);
+		ok = ok && front != nullptr && len == 3 && checkData("ReportQueue with ID", front, {0x05, 0x01, 0x02});
+		queue.pop();
+		/* the first report with ID 7 was replaced by the second one */
+		front = queue.front(len);
+		ok = ok && front != nullptr && len == 2 && checkData("ReportQueue replaced", front, {0x07, 0x02});
+		queue.pop();
+		ok = ok && queue.empty() && queue.front(len) == nullptr;
+		queue.pop();
+		ok = ok && queue.empty() && queue.push(1, report, 1) && queue.size() == 1;
+		if ( ! ok ) {
+			printf("Error: Report queue mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* report merger tests */
+	{
+		constexpr static const auto mouseSrc = hid::fromSource("UsagePage(GenericDesktop) Usage(Mouse) Collection(Application) ReportId(2) "
+			"UsagePage(Button) UsageMinimum(1) UsageMaximum(3) LogicalMinimum(0) LogicalMaximum(1) ReportSize(1) ReportCount(3) Input(Data, Var, Abs) "
+			"ReportCount(5) Input(Cnst) UsagePage(GenericDesktop) Usage(X) Usage(Y) LogicalMinimum(-127) LogicalMaximum(127) ReportSize(8) ReportCount(2) Input(Data, Var, Rel) "
+			"Usage(Wheel) LogicalMinimum(0) LogicalMaximum(200) ReportCount(1) Input(Data, Var, Rel) EndCollection");
+		constexpr static const hid::Descriptor<hid::compiledSize(mouseSrc)> mouseDesc(mouseSrc);
+		constexpr static const hid::ReportMerger<8> merger(mouseDesc.data, mouseDesc.size(), 2);
+		static_assert(merger.getLength() == 5 && merger.getFieldCount() == 2, "unexpected report merger layout");
+		constexpr static const hid::ReportMerger<4> tooSmall(mouseDesc.data, mouseDesc.size(), 2);
+		uint8_t pending[] = {0x02, 0x01, 100, 0xFB, 150};
+		const uint8_t latest[] = {0x02, 0x06, 20, 0xF6, 10};
+		const uint8_t saturating[] = {0x02, 0x00, 100, 0x81, 100};
+		bool ok = merger.fits(pending, latest, 5) && ( ! merger.fits(pending, saturating, 5) );
+		ok = ok && ( ! tooSmall.merge(pending, latest, 5) ) && ( ! merger.merge(pending, latest, 4) );
+		ok = ok && merger.merge(pending, latest, 5) && checkData("ReportMerger", pending, {0x02, 0x06, 120, 0xF1, 160});
+		ok = ok && merger.merge(pending, saturating, 5) && checkData("ReportMerger saturated", pending, {0x02, 0x00, 127, 0x81, 200});
+		hid::ReportQueue<4, 5> queue;
+		const uint8_t motion[] = {0x01, 0x02, 0xFF, 0x01};
+		size_t len = 0;
+		/* merged into the queued report until it is taken */
+		ok = ok && queue.pushMerged(2, motion, 4, merger) && queue.pushMerged(2, motion, 4, merger) && queue.pushMerged(2, motion, 4, merger) && queue.size() == 1;
+		const uint8_t * front = queue.front(len);
+		ok = ok && front != nullptr && len == 5 && checkData("ReportQueue merged", front, {0x02, 0x01, 6, 0xFD, 3});
+		ok = ok && queue.pushMerged(2, motion, 4, merger) && queue.size() == 2;
+		/* saturation and other report IDs are queued separately */
+		ok = ok && queue.pushMerged(2, saturating + 1, 4, merger) && queue.pushMerged(3, motion, 4, merger) && queue.size() == 4;
+		ok = ok && ( ! queue.pushMerged(3, motion, 4, merger) );
+		queue.pop();
+		front = queue.front(len);
+		ok = ok && front != nullptr && len == 5 && checkData("ReportQueue appended", front, {0x02, 0x01, 2, 0xFF, 1});
+		if ( ! ok ) {
+			printf("Error: Report merger mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* report statistics tests */
+	{
+		constexpr static const auto statsSrc = hid::fromSource("UsagePage(GenericDesktop) Usage(Mouse) Collection(Application) ReportId(2) "
+			"Usage(X) Usage(Y) LogicalMinimum(-127) LogicalMaximum(127) ReportSize(8) ReportCount(2) Input(Data, Var, Rel) EndCollection "
+			"Usage(Keyboard) Collection(Application) ReportId(1) UsagePage(Keyboard) UsageMinimum(0) UsageMaximum(255) LogicalMinimum(0) LogicalMaximum(255) "
+			"ReportSize(8) ReportCount(1) Input(Data, Ary) EndCollection" HID_REPORT_STATS_SOURCE)
+			("hidStatsId", 0x7F)("hidStatsCount", 2 * (5 + 4));
+		constexpr static const hid::Descriptor<hid::compiledSize(statsSrc)> statsDesc(statsSrc);
+		typedef hid::ReportStats<hid::reportIdCount(statsDesc.data, statsDesc.size(), hid::RT_INPUT), TestClock, 4, 4> Stats;
+		constexpr static const Stats stats(statsDesc.data, statsDesc.size());
+		static_assert(Stats::IdCount == 2 && stats.reportId(0) == 1 && stats.reportId(1) == 2, "unexpected report statistics IDs");
+		static_assert(hid::reportSize(statsDesc.data, statsDesc.size(), hid::RT_FEATURE, 0x7F) == Stats::ReportSize + 1, "unexpected report statistics Feature report");
+		static_assert(sizeof(hid::ReportQueue<4, 5>) == sizeof(hid::ReportQueue<4, 5, hid::NullReportStats>) && sizeof(hid::ReportQueue<4, 5>) == (4 * 5) + (4 * 6) + 2, "report queue without statistics is not minimal");
+		constexpr static const hid::ReportMerger<4> merger(statsDesc.data, statsDesc.size(), 2);
+		hid::ReportQueue<4, 3, Stats> queue(stats);
+		const uint8_t motion[] = {0x01, 0x02};
+		const uint8_t key[] = {0x04};
+		size_t len = 0;
+		TestClock::ticks = 10;
+		bool ok = queue.push(1, key, 1) && queue.pushMerged(2, motion, 2, merger) && queue.pushMerged(2, motion, 2, merger);
+		ok = ok && queue.pushLatest(1, key, 1) && queue.pushLatest(1, key, 1) && ( ! queue.push(3, key, 1) ) && ( ! queue.push(2, motion, 2) );
+		/* the mouse report is sent after 0 ticks and the latest keyboard report after 990 ticks */
+		ok = ok && queue.front(len) != nullptr && len == 3;
+		queue.pop();
+		TestClock::ticks = 1000;
+		ok = ok && queue.front(len) != nullptr && len == 2;
+		queue.pop();
+		ok = ok && queue.empty();
+		const Stats & res = queue.stats();
+		ok = ok && res.get(1, Stats::RC_BUILT) == 3 && res.get(1, Stats::RC_SENT) == 1 && res.get(1, Stats::RC_SUPPRESSED) == 2;
+		ok = ok && res.get(2, Stats::RC_BUILT) == 1 && res.get(2, Stats::RC_COALESCED) == 1 && res.get(2, Stats::RC_DROPPED) == 1 && res.get(2, Stats::RC_SENT) == 1;
+		ok = ok && res.get(3, Stats::RC_DROPPED) == 0 && res.histogram(2, 0) == 1 && res.histogram(1, 3) == 1;
+		uint8_t report[Stats::ReportSize];
+		ok = ok && ( ! res.write(report, sizeof(report) - 1) ) && res.write(report, sizeof(report)) == sizeof(report);
+		ok = ok && checkData("ReportStats report ID 1", report, {3, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0});
+		ok = ok && checkData("ReportStats report ID 2", report + 36, {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+		/* a report taken by front() is neither replaced nor suppressed */
+		hid::ReportQueue<4, 3, Stats> latest(stats);
+		const uint8_t keys[] = {0x04, 0x05};
+		ok = ok && latest.pushLatest(1, keys, 1) && latest.front(len) != nullptr && latest.pushLatest(1, keys + 1, 1);
+		const uint8_t * front = latest.front(len);
+		ok = ok && front != nullptr && len == 2 && checkData("ReportQueue taken", front, {0x01, 0x04});
+		latest.pop();
+		front = latest.front(len);
+		ok = ok && front != nullptr && len == 2 && checkData("ReportQueue latest", front, {0x01, 0x05});
+		latest.pop();
+		ok = ok && latest.empty() && latest.stats().get(1, Stats::RC_BUILT) == 2 && latest.stats().get(1, Stats::RC_SENT) == 2 && latest.stats().get(1, Stats::RC_SUPPRESSED) == 0;
+		if ( ! ok ) {
+			printf("Error: Report statistics mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* descriptor family tests */
+	{
+#define KEYBOARD_BLOCK "UsagePage(GenericDesktop) Usage(Keyboard) Collection(Application) ReportId(1) ReportSize(1) ReportCount(8) UsagePage(Keyboard) UsageMinimum(224) UsageMaximum(231) LogicalMinimum(0) LogicalMaximum(1) Input(Data, Var, Abs) EndCollection\n"
+#define MOUSE_BLOCK "UsagePage(GenericDesktop) Usage(Mouse) Collection(Application) ReportId(2) Usage(X) Usage(Y) ReportSize(8) ReportCount(2) Input(Data, Var, Rel) EndCollection\n"
+#define CONSUMER_BLOCK "UsagePage(Consumer) Usage(ConsumerControl) Collection(Application) ReportId(3) LogicalMinimum(0) LogicalMaximum(0x3FF) UsageMinimum(0) UsageMaximum(0x3FF) ReportSize(16) ReportCount(1) Input(Data, Ary, Abs) EndCollection\n"
+		constexpr static const auto srcA = hid::fromSource(KEYBOARD_BLOCK CONSUMER_BLOCK);
+		constexpr static const auto srcB = hid::fromSource(MOUSE_BLOCK CONSUMER_BLOCK);
+		constexpr static const auto srcC = hid::fromSource(KEYBOARD_BLOCK MOUSE_BLOCK CONSUMER_BLOCK);
+#undef KEYBOARD_BLOCK
+#undef MOUSE_BLOCK
+#undef CONSUMER_BLOCK
+		constexpr static const hid::Descriptor<hid::compiledSize(srcA)> descA(srcA);
+		constexpr static const hid::Descriptor<hid::compiledSize(srcB)> descB(srcB);
+		constexpr static const hid::Descriptor<hid::compiledSize(srcC)> descC(srcC);
+		constexpr static const hid::DescriptorRef family[] = {descA, descB, descC};
+		constexpr static const hid::FamilyLayout layout = hid::familyLayout(family);
+		DEF_HID_FAMILY_AS(static stored, family);
+		static_assert(stored.size(0) == descA.size() && stored.size(1) == descB.size() && stored.size(2) == descC.size(), "Descriptor family member sizes need to fit.");
+		static_assert(stored.listStart[3] == 7 && stored.segment(2, 0).length == stored.length[0], "Descriptor family needs to be constexpr.");
+		bool ok = layout.fragments == 3 && layout.list == 7 && layout.pool == descC.size() && layout.largest == descC.size();
+		for (size_t d = 0; d < 3 && ok; d++) {
+			uint8_t out[256];
+			/* read in small pieces like GET_DESCRIPTOR transactions */
+			size_t pos = 0;
+			for (size_t n = 0; (n = stored.read(d, pos, out + pos, 7)) > 0; pos += n) {}
+			ok = stored.size(d) == family[d].length && pos == family[d].length && memcmp(out, family[d].data, pos) == 0;
+		}
+		ok = ok && stored.size(3) == 0 && stored.segment(0, descA.size()).length == 0 && stored.segment(2, 1).length == size_t(stored.length[0] - 1);
+		if ( ! ok ) {
+			printf("Error: Descriptor family mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* tracer tests */
+	{
+		const auto src = hid::fromSource("UsagePage(Button) Usage(Button20) 0x13");
+		const auto bad = hid::fromSource("UsagePage(Button)\n  Usage(Unknown)");
+		uint8_t traced[16];
+		Info traceError;
+		hid::detail::BufferWriter out(traced, sizeof(traced));
+		hid::detail::NullWriter none;
+		hid::StateCounter counter;
+		bool ok = hid::compile(src, out, traceError, counter) && checkData("StateCounter", traced, {0x05, 0x09, 0x09, 0x14, 0x13});
+		ok = ok && counter.start == 5 && counter.states[1] == 14 && counter.states[2] == 18 && counter.states[5] == 2 && counter.transitions == 11;
+		hid::LookupHistogram histogram;
+		ok = ok && ( ! hid::compile(bad, none, traceError, histogram) ) && histogram.found == 3 && histogram.missed == 1;
+		hid::EventLog<64> log;
+		ok = ok && ( ! hid::compile(bad, none, traceError, log) ) && ( ! log.overflow );
+		size_t offset = 0, items = 0, errors = 0;
+		hid::Event event{0, 0, 0};
+		while ( log.next(offset, event) ) {
+			items += (event.type == hid::TE_ITEM) ? 1 : 0;
+			if (event.type == hid::TE_ERROR) {
+				errors++;
+				ok = ok && event.position == 33 && traceError.line == 2 && traceError.column == 16 && event.value == uint32_t(traceError.message);
+			}
+		}
+		ok = ok && items == 1 && errors == 1;
+		hid::EventLog<8> small;
+		ok = ok && hid::compile(src, none, traceError, small) && small.overflow && small.length <= 8;
+		if ( ! ok ) {
+			printf("Error: Compiler tracer mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
+	/* configuration descriptor tests */
+	{
+		constexpr static const hid::Interface interfaces[] = {
+			hid::Interface(hid::bootKeyboardDescriptor<>).withBoot(hid::BP_KEYBOARD).withOutEndpoint(),
+			hid::Interface(hid::bootMouseDescriptor<>).withBoot(hid::BP_MOUSE).withInterval(1).withString(4)
+		};
+		constexpr static const hid::Configuration<hid::configurationSize(interfaces)> config(interfaces, hid::CA_BUS_POWERED | hid::CA_REMOTE_WAKEUP, 500);
+		static_assert(config.valid && config.hidOffset(1) == 50, "Configuration descriptor needs to be constexpr.");
+		/* explicit endpoint numbers shall not collide with the derived ones */
+		constexpr static const hid::Interface duplicates[] = {
+			hid::Interface(hid::bootKeyboardDescriptor<>).withEndpoint(2),
+			hid::Interface(hid::bootMouseDescriptor<>)
+		};
+		constexpr static const hid::Configuration<hid::configurationSize(duplicates)> duplicateConfig(duplicates);
+		static_assert( ! duplicateConfig.valid, "Duplicate endpoint addresses need to be rejected.");
+		/* larger reports are clamped to the maximum packet size */
+		constexpr static const hid::Interface limited[] = {
+			hid::Interface(hid::bootKeyboardDescriptor<>).withMaxPacketSize(4)
+		};
+		constexpr static const hid::Configuration<hid::configurationSize(limited)> limitedConfig(limited);
+		static_assert(limitedConfig.valid && limitedConfig.data[31] == 4, "Packet size needs to be clamped.");
+		bool ok = config.size() == 66 && checkData("Configuration", config.data, {
+			0x09, 0x02, 0x42, 0x00, 0x02, 0x01, 0x00, 0xA0, 0xFA,
+			0x09, 0x04, 0x00, 0x00, 0x02, 0x03, 0x01, 0x01, 0x00,
+			0x09, 0x21, 0x11, 0x01, 0x00, 0x01, 0x22, 0x40, 0x00,
+			0x07, 0x05, 0x81, 0x03, 0x08, 0x00, 0x0A,
+			0x07, 0x05, 0x01, 0x03, 0x01, 0x00, 0x0A,
+			0x09, 0x04, 0x01, 0x00, 0x01, 0x03, 0x01, 0x02, 0x04,
+			0x09, 0x21, 0x11, 0x01, 0x00, 0x01, 0x22, 0x32, 0x00,
+			0x07, 0x05, 0x82, 0x03, 0x03, 0x00, 0x01
+		});
+		ok = ok && config.hidOffset(0) == 18 && config.hidOffset(1) == 50 && config.hidOffset(2) == config.size();
+		if ( ! ok ) {
+			printf("Error: Configuration descriptor mismatch.\n");
+			failed++;
+		}
+		total++;
+	}
 	if (failed > 0) {
 		printf("\n");
 	}